@@ -33,6 +33,11 @@
 #include "core/module.h"
 #include "console/engineAPI.h"
 #include "platform/output/IDisplayDevice.h"
+#include "gfx/gfxDevice.h"
+#include "gfx/gfxTextureHandle.h"
+#include "gfx/gfxDeviceStatistics.h"
+#include "gfx/Null/gfxRecordingDevice.h"
+#include "postFx/postEffectManager.h"
 
 static void RegisterGameFunctions();
 static void Process3D();
@@ -417,6 +422,96 @@ void GameRenderWorld()
    PROFILE_END();
 }
 
+DefineEngineFunction( benchmarkRender, String, ( S32 frames, Point2I resolution ), ( 100, Point2I( 1280, 720 ) ),
+   "@brief Renders the world from the control camera into an offscreen target "
+   "a number of times and reports the average frame time.\n\n"
+   "Intended to be run on the device created by GFXInit::createRecordingDevice() "
+   "after a mission has been loaded, where it also reports the redundant commands "
+   "and the command hash of the last frame.  The hash is stable between runs "
+   "as long as the scene and the renderer don't change.\n\n"
+   "@param frames The number of frames to render.\n"
+   "@param resolution The size of the render target.\n"
+   "@return A summary of the results or an empty string if there is no camera.\n\n"
+   "@ingroup Game")
+{
+   CameraQuery query;
+   if ( !GFX || frames <= 0 || !GameProcessCameraQuery( &query ) )
+   {
+      Con::errorf( "benchmarkRender - There is no device or control camera!" );
+      return String();
+   }
+
+   query.ortho = false;
+
+   GFXTexHandle colorTex( resolution.x, resolution.y, GFXFormatR8G8B8A8, &GFXDefaultRenderTargetProfile, "benchmarkRender() - colorTex" );
+   GFXTexHandle depthTex( resolution.x, resolution.y, GFXFormatD24S8, &GFXDefaultZTargetProfile, "benchmarkRender() - depthTex" );
+
+   GFXTextureTargetRef target = GFX->allocRenderToTextureTarget();
+   target->attachTexture( GFXTextureTarget::Color0, colorTex );
+   target->attachTexture( GFXTextureTarget::DepthStencil, depthTex );
+
+   // Set up the frustum the same way GuiTSCtrl does.
+   const F32 aspectRatio = F32( resolution.x ) / F32( resolution.y );
+   const F32 wheight = query.nearPlane * mTan( query.fov / 2.0f );
+   const F32 wwidth = aspectRatio * wheight;
+
+   Frustum frustum;
+   frustum.set( false, -wwidth, wwidth, wheight, -wheight, query.nearPlane, query.farPlane );
+
+   MatrixF worldToCamera = query.cameraMatrix;
+   worldToCamera.inverse();
+
+   GFXRecordingDevice *recorder = dynamic_cast<GFXRecordingDevice*>( GFX );
+   if ( recorder )
+      recorder->resetTotals();
+
+   U32 drawCalls = 0;
+   U32 skippedBinds = 0;
+   const U32 start = Platform::getRealMilliseconds();
+
+   for ( S32 i = 0; i < frames; i++ )
+   {
+      GFX->beginScene();
+      GFX->pushActiveRenderTarget();
+      GFX->setActiveRenderTarget( target );
+
+      GFX->setViewport( RectI( Point2I::Zero, resolution ) );
+      GFX->clear( GFXClearTarget | GFXClearZBuffer | GFXClearStencil, ColorI( 0, 0, 0, 0 ), 1.0f, 0 );
+
+      GFX->setFrustum( frustum );
+      gClientSceneGraph->setDisplayTargetResolution( resolution );
+      GFX->setWorldMatrix( worldToCamera );
+      gClientSceneGraph->setNonClipProjection( GFX->getProjectionMatrix() );
+      PFXMGR->setFrameMatrices( worldToCamera, GFX->getProjectionMatrix() );
+
+      GameRenderWorld();
+
+      GFX->popActiveRenderTarget();
+
+      // The statistics are reset when the next frame begins.
+      const GFXDeviceStatistics *stats = GFX->getDeviceStatistics();
+      drawCalls += stats->mDrawCalls;
+      skippedBinds += stats->mSkippedTextureBinds + stats->mSkippedStateBlocks + stats->mSkippedConstBuffers;
+
+      GFX->endScene();
+   }
+
+   const F32 msPerFrame = F32( Platform::getRealMilliseconds() - start ) / F32( frames );
+
+   String result = String::ToString( "%d frames at %dx%d: %.3f ms/frame, %.1f draw calls/frame, %.1f skipped binds/frame",
+      frames, resolution.x, resolution.y, msPerFrame, F32( drawCalls ) / F32( frames ), F32( skippedBinds ) / F32( frames ) );
+
+   if ( recorder )
+   {
+      const GFXRecordingDevice::Counters &totals = recorder->getTotalCounters();
+      result += String::ToString( ", %.1f redundant commands/frame, frame hash %08x",
+         F32( totals.getRedundantTotal() ) / F32( frames ), recorder->getFrameHash() );
+   }
+
+   Con::printf( "benchmarkRender - %s", result.c_str() );
+   return result;
+}
+
 
 static void Process3D()
 {
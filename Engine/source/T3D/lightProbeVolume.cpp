@@ -0,0 +1,266 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "T3D/lightProbeVolume.h"
+
+#include "lighting/lightInfo.h"
+#include "scene/sceneContainer.h"
+#include "core/stream/bitStream.h"
+#include "core/stream/fileStream.h"
+#include "console/consoleTypes.h"
+#include "console/engineAPI.h"
+
+
+IMPLEMENT_CO_NETOBJECT_V1( LightProbeVolume );
+
+ConsoleDocClass( LightProbeVolume,
+   "@brief A volume in which objects get their ambient lighting from a grid of baked light probes.\n\n"
+
+   "Light probes capture how much of the sky is visible at each point of the volume and how much "
+   "sun light is bounced towards it by the surrounding geometry.  Objects rendered inside the volume "
+   "use the probes around them instead of the scene wide ambient color, which darkens covered areas "
+   "and brightens areas next to sun lit walls without placing fill lights by hand.\n\n"
+
+   "The probes are baked on the server by casting rays against the collision geometry of static "
+   "shapes and terrain, so baking works on dedicated servers.  Call bake() after changing the "
+   "level and save the mission to keep the probe file name.\n\n"
+
+   "@see $Scene::lightProbes\n"
+   "@ingroup enviroMisc"
+);
+
+
+//-----------------------------------------------------------------------------
+
+LightProbeVolume::LightProbeVolume()
+   :  mProbeSpacing( 4.0f ),
+      mRaysPerProbe( 64 ),
+      mRayLength( 100.0f ),
+      mBounceAlbedo( 0.4f, 0.4f, 0.4f )
+{
+   mObjScale.set( 1.f, 1.f, 1.f );
+   mObjBox.set(
+      Point3F( -0.5f, -0.5f, -0.5f ),
+      Point3F( 0.5f, 0.5f, 0.5f )
+   );
+
+   mObjToWorld.identity();
+   mWorldToObj.identity();
+
+   resetWorldBox();
+}
+
+//-----------------------------------------------------------------------------
+
+void LightProbeVolume::initPersistFields()
+{
+   addGroup( "Probes" );
+
+      addField( "probeSpacing",  TypeF32,             Offset( mProbeSpacing, LightProbeVolume ),
+         "The maximum distance between probes in meters." );
+      addField( "raysPerProbe",  TypeS32,             Offset( mRaysPerProbe, LightProbeVolume ),
+         "The number of rays cast from each probe when baking." );
+      addField( "rayLength",     TypeF32,             Offset( mRayLength, LightProbeVolume ),
+         "The distance in meters after which a ray is considered to reach the sky." );
+      addField( "bounceAlbedo",  TypeColorF,          Offset( mBounceAlbedo, LightProbeVolume ),
+         "The diffuse reflectance assumed for all the geometry around the probes." );
+      addField( "probeFile",     TypeStringFilename,  Offset( mProbeFile, LightProbeVolume ),
+         "The file the baked probes are saved to.  Set by bake() if empty." );
+
+   endGroup( "Probes" );
+
+   Parent::initPersistFields();
+}
+
+//-----------------------------------------------------------------------------
+
+void LightProbeVolume::consoleInit()
+{
+   // Disable rendering of probe volumes by default.
+   getStaticClassRep()->mIsRenderEnabled = false;
+}
+
+//-----------------------------------------------------------------------------
+
+bool LightProbeVolume::onAdd()
+{
+   if( !Parent::onAdd() )
+      return false;
+
+   if( isClientObject() )
+      _loadProbes();
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void LightProbeVolume::onRemove()
+{
+   mGrid.unregisterGrid();
+   Parent::onRemove();
+}
+
+//-----------------------------------------------------------------------------
+
+void LightProbeVolume::inspectPostApply()
+{
+   Parent::inspectPostApply();
+   setMaskBits( ProbeMask );
+}
+
+//-----------------------------------------------------------------------------
+
+void LightProbeVolume::_loadProbes()
+{
+   mGrid.unregisterGrid();
+
+   if( mProbeFile.isEmpty() || !Platform::isFile( mProbeFile ) )
+      return;
+
+   FileStream stream;
+   if( !stream.open( mProbeFile, Torque::FS::File::Read ) || !mGrid.read( stream ) )
+   {
+      Con::errorf( "LightProbeVolume::_loadProbes - Failed to read '%s'!", mProbeFile.c_str() );
+      return;
+   }
+
+   mGrid.registerGrid();
+}
+
+//-----------------------------------------------------------------------------
+
+String LightProbeVolume::_getDefaultProbeFile() const
+{
+   const char* missionFile = Con::getVariable( "$Server::MissionFile" );
+   const char* name = getName() ? getName() : "lightProbes";
+
+   return String::ToString( "%s.%s.probes", missionFile, name );
+}
+
+//-----------------------------------------------------------------------------
+
+LightInfo* LightProbeVolume::_findSunLight() const
+{
+   if( !mContainer )
+      return NULL;
+
+   Vector< SceneObject* > objects;
+   mContainer->findObjectList( getWorldBox(), EnvironmentObjectType | LightObjectType, &objects );
+
+   for( U32 i = 0; i < objects.size(); ++ i )
+   {
+      ISceneLight* sceneLight = dynamic_cast< ISceneLight* >( objects[ i ] );
+      if( sceneLight && sceneLight->getLight() && sceneLight->getLight()->getType() == LightInfo::Vector )
+         return sceneLight->getLight();
+   }
+
+   return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+bool LightProbeVolume::bake()
+{
+   if( !isServerObject() )
+   {
+      Con::errorf( "LightProbeVolume::bake - Probes can only be baked on the server!" );
+      return false;
+   }
+
+   if( mProbeSpacing <= 0.0f )
+   {
+      Con::errorf( "LightProbeVolume::bake - probeSpacing must be positive!" );
+      return false;
+   }
+
+   LightProbeGrid::BakeParams params;
+   params.raysPerProbe = mMax( mRaysPerProbe, 4 );
+   params.rayLength = mRayLength;
+   params.rayMask = StaticShapeObjectType | TerrainObjectType;
+   params.albedo = mBounceAlbedo;
+   params.sun = _findSunLight();
+
+   if( !params.sun )
+      Con::warnf( "LightProbeVolume::bake - No sun found; baking sky visibility only." );
+
+   LightProbeGrid grid;
+   grid.setBounds( getWorldBox(), mProbeSpacing );
+   grid.bake( getContainer(), params );
+
+   if( mProbeFile.isEmpty() )
+      mProbeFile = _getDefaultProbeFile();
+
+   FileStream stream;
+   if( !stream.open( mProbeFile, Torque::FS::File::Write ) || !grid.write( stream ) )
+   {
+      Con::errorf( "LightProbeVolume::bake - Failed to write '%s'!", mProbeFile.c_str() );
+      return false;
+   }
+
+   stream.close();
+
+   // Let the clients reload the probes.
+   setMaskBits( ProbeMask );
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 LightProbeVolume::packUpdate( NetConnection* connection, U32 mask, BitStream* stream )
+{
+   U32 retMask = Parent::packUpdate( connection, mask, stream );
+
+   if( stream->writeFlag( mask & ProbeMask ) )
+      stream->write( mProbeFile );
+
+   return retMask;
+}
+
+//-----------------------------------------------------------------------------
+
+void LightProbeVolume::unpackUpdate( NetConnection* connection, BitStream* stream )
+{
+   Parent::unpackUpdate( connection, stream );
+
+   if( stream->readFlag() ) // ProbeMask
+   {
+      stream->read( &mProbeFile );
+
+      if( isProperlyAdded() )
+         _loadProbes();
+   }
+}
+
+//=============================================================================
+//    Console Methods.
+//=============================================================================
+
+DefineEngineMethod( LightProbeVolume, bake, bool, (),,
+   "Bake the light probes of the volume and save them to the probe file.  Server objects only.\n\n"
+   "@return True if the probes were baked and saved." )
+{
+   return object->bake();
+}
@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _LIGHTPROBEVOLUME_H_
+#define _LIGHTPROBEVOLUME_H_
+
+#ifndef _SCENESPACE_H_
+#include "scene/sceneSpace.h"
+#endif
+
+#ifndef _LIGHTPROBEGRID_H_
+#include "lighting/lightProbeGrid.h"
+#endif
+
+
+/// A box in which the ambient lighting of objects comes from a grid of
+/// baked light probes.
+///
+/// The probes are baked on the server by bake() and saved to #mProbeFile.
+/// Client objects load the file and register the grid for rendering.
+class LightProbeVolume : public SceneSpace
+{
+   public:
+
+      typedef SceneSpace Parent;
+
+   protected:
+
+      enum
+      {
+         ProbeMask      = Parent::NextFreeMask << 0,   ///< Probe settings or file have changed.
+         NextFreeMask   = Parent::NextFreeMask << 1,
+      };
+
+      /// The maximum distance between probes.
+      F32 mProbeSpacing;
+
+      /// The number of rays cast from each probe when baking.
+      S32 mRaysPerProbe;
+
+      /// The distance after which a ray is considered to reach the sky.
+      F32 mRayLength;
+
+      /// The diffuse reflectance assumed for all the geometry in the volume.
+      ColorF mBounceAlbedo;
+
+      /// The file the probes are saved to and loaded from.
+      String mProbeFile;
+
+      /// The probes.  Only loaded on the client.
+      LightProbeGrid mGrid;
+
+      /// Loads the probes from #mProbeFile and registers the grid
+      /// if they could be loaded.
+      void _loadProbes();
+
+      /// Returns the file name used when #mProbeFile isn't set.
+      String _getDefaultProbeFile() const;
+
+      /// Returns the light of the first sun found in the scene or NULL.
+      LightInfo* _findSunLight() const;
+
+      // SceneSpace.
+      virtual ColorI _getDefaultEditorSolidColor() const { return ColorI( 255, 220, 120, 45 ); }
+
+   public:
+
+      LightProbeVolume();
+
+      /// Bakes the probes and saves them to #mProbeFile.  Server only.
+      bool bake();
+
+      // SimObject.
+      DECLARE_CONOBJECT( LightProbeVolume );
+      DECLARE_DESCRIPTION( "A volume of baked ambient light probes." );
+      DECLARE_CATEGORY( "3D Scene" );
+
+      static void initPersistFields();
+      static void consoleInit();
+
+      virtual bool onAdd();
+      virtual void onRemove();
+      virtual void inspectPostApply();
+
+      // NetObject.
+      virtual U32 packUpdate( NetConnection* connection, U32 mask, BitStream* stream );
+      virtual void unpackUpdate( NetConnection* connection, BitStream* stream );
+};
+
+#endif // !_LIGHTPROBEVOLUME_H_
@@ -36,6 +36,7 @@
 #include "ts/tsPartInstance.h"
 #include "ts/tsShapeInstance.h"
 #include "ts/tsMaterialList.h"
+#include "ts/tsAnimationBatch.h"
 #include "scene/sceneManager.h"
 #include "scene/sceneRenderState.h"
 #include "scene/sceneObjectLightingPlugin.h"
@@ -62,6 +63,7 @@
 #include "materials/materialManager.h"
 #include "materials/materialFeatureTypes.h"
 #include "renderInstance/renderOcclusionMgr.h"
+#include "gui/3d/guiTSControl.h"
 #include "core/stream/fileStream.h"
 
 IMPLEMENT_CO_DATABLOCK_V1(ShapeBaseData);
@@ -132,6 +134,7 @@ F32  ShapeBase::sWhiteoutDec = 0.007f;
 F32  ShapeBase::sDamageFlashDec = 0.02f;
 F32  ShapeBase::sFullCorrectionDistance = 0.5f;
 F32  ShapeBase::sCloakSpeed = 0.5;
+bool ShapeBase::sServerAnimRequiredNodesOnly = false;
 U32  ShapeBase::sLastRenderFrame = 0;
 
 static const char *sDamageStateName[] =
@@ -925,6 +928,8 @@ ShapeBase::ShapeBase()
 {
    mTypeMask |= ShapeBaseObjectType | LightObjectType;   
 
+   mLastPrepRenderFrame = 0;
+
    S32 i;
 
    for (i = 0; i < MaxSoundThreads; i++) {
@@ -1112,6 +1117,11 @@ bool ShapeBase::onNewDataBlock( GameBaseData *dptr, bool reload )
       if (isClientObject())
          mShapeInstance->cloneMaterialList();
 
+      TSIntegerSet requiredNodes;
+      getRequiredAnimationNodes( requiredNodes );
+      mShapeInstance->setRequiredNodes( requiredNodes );
+      mShapeInstance->setAnimateRequiredNodesOnly( isServerObject() && sServerAnimRequiredNodesOnly );
+
       mObjBox = mDataBlock->mShape->bounds;
       resetWorldBox();
 
@@ -1199,6 +1209,40 @@ bool ShapeBase::onNewDataBlock( GameBaseData *dptr, bool reload )
    return true;
 }
 
+void ShapeBase::getRequiredAnimationNodes( TSIntegerSet &nodes )
+{
+   const TSShape *shape = mDataBlock->mShape;
+   const S32 numNodes = shape->nodes.size();
+
+   const S32 codeNodes[] = { mDataBlock->eyeNode, mDataBlock->earNode, mDataBlock->cameraNode };
+   for ( U32 i = 0; i < sizeof( codeNodes ) / sizeof( codeNodes[0] ); i++ )
+   {
+      if ( codeNodes[i] >= 0 && codeNodes[i] < numNodes )
+         nodes.set( codeNodes[i] );
+   }
+
+   for ( U32 i = 0; i < SceneObject::NumMountPoints; i++ )
+   {
+      if ( mDataBlock->mountPointNode[i] >= 0 && mDataBlock->mountPointNode[i] < numNodes )
+         nodes.set( mDataBlock->mountPointNode[i] );
+   }
+
+   // Collision and LOS queries read the nodes of their details.
+   for ( U32 i = 0; i < mDataBlock->collisionDetails.size(); i++ )
+   {
+      const S32 dl = mDataBlock->collisionDetails[i];
+      if ( dl >= 0 && dl < shape->mDetailNodes.size() )
+         nodes.overlap( shape->mDetailNodes[dl] );
+   }
+
+   for ( U32 i = 0; i < mDataBlock->LOSDetails.size(); i++ )
+   {
+      const S32 dl = mDataBlock->LOSDetails[i];
+      if ( dl >= 0 && dl < shape->mDetailNodes.size() )
+         nodes.overlap( shape->mDetailNodes[dl] );
+   }
+}
+
 void ShapeBase::onDeleteNotify( SimObject *obj )
 {
    if ( obj == mCurrentWaterObject )
@@ -1400,6 +1444,12 @@ void ShapeBase::advanceTime(F32 dt)
             mFadeVal = 1 - mFadeVal;
       }
    }
+
+   // Shapes rendered in the last frame will most likely be rendered again,
+   // so queue their nodes to be animated together with the other instances
+   // of their shape before rendering.
+   if ( mShapeInstance && mLastPrepRenderFrame + 1 >= GuiTSCtrl::getFrameCount() )
+      TSAnimationBatch::queue( mShapeInstance );
 }
 
 void ShapeBase::setControllingClient( GameConnection* client )
@@ -2621,6 +2671,10 @@ void ShapeBase::_prepRenderImage(   SceneRenderState *state,
    }
 
    mLastRenderFrame = sLastRenderFrame;
+   mLastPrepRenderFrame = GuiTSCtrl::getFrameCount();
+
+   // Animate the nodes of the shapes queued in advanceTime.
+   TSAnimationBatch::flushQueue();
 
    // get shape detail...we might not even need to be drawn
    Point3F cameraOffset = getWorldBox().getClosestPoint( state->getDiffuseCameraPosition() ) - state->getDiffuseCameraPosition();
@@ -4947,6 +5001,13 @@ void ShapeBase::consoleInit()
    Con::addVariable("SB::CloakSpeed", TypeF32, &sCloakSpeed, 
       "@brief Time to cloak, in seconds.\n\n"
 	   "@ingroup gameObjects\n");
+   Con::addVariable("SB::ServerAnimRequiredNodesOnly", TypeBool, &sServerAnimRequiredNodesOnly, 
+      "@brief If true, server side shapes only animate the nodes which are used for "
+      "collision, line of sight queries, mounting and the eye and camera.\n\n"
+      "Only enable this if every ShapeBase class whose code reads other node transforms "
+      "reports them through getRequiredAnimationNodes().  Takes effect for shapes "
+      "created after it is changed.  The default value is false.\n"
+	   "@ingroup gameObjects\n");
 }
 
 void ShapeBase::_updateHiddenMeshes()
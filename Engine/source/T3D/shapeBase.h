@@ -1005,6 +1005,10 @@ protected:
    U32 mLastRenderFrame;
    F32 mLastRenderDistance;
 
+   /// The GuiTSCtrl frame in which the shape was last prepared for
+   /// rendering, used to pick the shapes to animate in batches.
+   U32 mLastPrepRenderFrame;
+
    /// Do a reskin if necessary.
    virtual void reSkin();
 
@@ -1178,6 +1182,7 @@ public:
    static F32  sDamageFlashDec;
    static F32  sFullCorrectionDistance;
    static F32  sCloakSpeed;               // Time to cloak, in seconds
+   static bool sServerAnimRequiredNodesOnly; // Animate only the required nodes on the server, off by default
       
    CubeReflector mCubeReflector;
 
@@ -1190,6 +1195,17 @@ public:
    static void consoleInit();
    bool onNewDataBlock( GameBaseData *dptr, bool reload );
 
+   /// Adds the nodes whose transforms are read by code, such as the eye,
+   /// camera and mount nodes and the collision details.  Animation LOD
+   /// never skips these nodes, but on the frames a distant client shape
+   /// is throttled they are interpolated like the others and lag up to
+   /// $pref::TS::animLODMaxInterval frames behind.
+   ///
+   /// Classes which read other node transforms, like weapon or jet nodes,
+   /// must override this and call the parent, or those nodes go stale on
+   /// the server when $SB::ServerAnimRequiredNodesOnly is enabled.
+   virtual void getRequiredAnimationNodes( TSIntegerSet &nodes );
+
    /// @}
 
    /// @name Name & Skin tags
@@ -293,6 +293,7 @@ bool TSStatic::_createShape()
    SAFE_DELETE( mShapeInstance );
    mAmbientThread = NULL;
    mShape = NULL;
+   mRetainedRender.invalidate();
 
    if (!mShapeName || mShapeName[0] == '\0') 
    {
@@ -410,9 +411,17 @@ void TSStatic::_onResourceChanged( const Torque::Path &path )
 {
    if ( path != Path( mShapeName ) )
       return;
+
+   // The new shape replaces any shadow cached from the old one.
+   SceneManager *sceneManager = getSceneManager();
+   if ( sceneManager && isStaticShadowCaster() )
+      sceneManager->notifyStaticGeometryChanged( getWorldBox() );
    
    _createShape();
    _updateShouldTick();
+
+   if ( sceneManager && isStaticShadowCaster() )
+      sceneManager->notifyStaticGeometryChanged( getWorldBox() );
 }
 
 void TSStatic::setSkinName( const char *name )
@@ -437,6 +446,8 @@ void TSStatic::setSkinName( const char *name )
 
 void TSStatic::reSkin()
 {
+   mRetainedRender.invalidate();
+
    if ( isGhost() && mShapeInstance && mSkinNameHandle.isValidString() )
    {
       Vector<String> skins;
@@ -512,40 +523,66 @@ void TSStatic::prepRenderImage( SceneRenderState* state )
    if ( mShapeInstance->getCurrentDetail() < 0 )
       return;
 
-   GFXTransformSaver saver;
-   
-   // Set up our TS render state.
-   TSRenderState rdata;
-   rdata.setSceneState( state );
-   rdata.setFadeOverride( 1.0f );
-   rdata.setOriginSort( mUseOriginSort );
-
-   // If we have submesh culling enabled then prepare
-   // the object space frustum to pass to the shape.
-   Frustum culler;
-   if ( mMeshCulling )
-   {
-      culler = state->getCullingFrustum();
-      MatrixF xfm( true );
-      xfm.scale( Point3F::One / getScale() );
-      xfm.mul( getRenderWorldTransform() );
-      xfm.mul( culler.getTransform() );
-      culler.setTransform( xfm );
-      rdata.setCuller( &culler );
-   }
+   MatrixF mat = getRenderTransform();
+   mat.scale( mObjScale );
 
    // We might have some forward lit materials
    // so pass down a query to gather lights.
    LightQuery query;
    query.init( getWorldSphere() );
-   rdata.setLightQuery( &query );
 
-   MatrixF mat = getRenderTransform();
-   mat.scale( mObjScale );
-   GFX->setWorldMatrix( mat );
+   // Unless the shape is animated, culled per submesh or blending
+   // between detail levels, the render instances only change when
+   // the transform or the detail level does.  In that case reuse
+   // the instances from the last frame.
+   const bool canRetain =  !mAmbientThread &&
+                           !mMeshCulling &&
+                           !mShapeInstance->isBlendingDetails() &&
+                           RetainedRenderInstList::canRetain( state );
 
-   mShapeInstance->animate();
-   mShapeInstance->render( rdata );
+   const S32 detail = mShapeInstance->getCurrentDetail();
+
+   if ( canRetain && mRetainedRender.canSubmit( state, mat, detail ) )
+      mRetainedRender.submit( state, &query );
+   else
+   {
+      GFXTransformSaver saver;
+      
+      // Set up our TS render state.
+      TSRenderState rdata;
+      rdata.setSceneState( state );
+      rdata.setFadeOverride( 1.0f );
+      rdata.setOriginSort( mUseOriginSort );
+      rdata.setLightQuery( &query );
+
+      // If we have submesh culling enabled then prepare
+      // the object space frustum to pass to the shape.
+      Frustum culler;
+      if ( mMeshCulling )
+      {
+         culler = state->getCullingFrustum();
+         MatrixF xfm( true );
+         xfm.scale( Point3F::One / getScale() );
+         xfm.mul( getRenderWorldTransform() );
+         xfm.mul( culler.getTransform() );
+         culler.setTransform( xfm );
+         rdata.setCuller( &culler );
+      }
+
+      GFX->setWorldMatrix( mat );
+
+      if ( canRetain )
+      {
+         mRetainedRender.beginCapture( state, mat, detail );
+         rdata.setRetainedList( &mRetainedRender );
+      }
+
+      mShapeInstance->animate();
+      mShapeInstance->render( rdata );
+
+      if ( canRetain )
+         mRetainedRender.endCapture();
+   }
 
    if ( mRenderNormalScalar > 0 )
    {
@@ -633,6 +670,8 @@ U32 TSStatic::packUpdate(NetConnection *con, U32 mask, BitStream *stream)
 
 void TSStatic::unpackUpdate(NetConnection *con, BitStream *stream)
 {
+   mRetainedRender.invalidate();
+
    Parent::unpackUpdate(con, stream);
 
    MatrixF mat;
@@ -667,6 +706,10 @@ void TSStatic::unpackUpdate(NetConnection *con, BitStream *stream)
       {
          mSkinNameHandle = skinDesiredNameHandle;
          reSkin();
+
+         // The new skin may change which parts are cut out of the shadow.
+         if ( getSceneManager() && isStaticShadowCaster() )
+            getSceneManager()->notifyStaticGeometryChanged( getWorldBox() );
       }
    }
 
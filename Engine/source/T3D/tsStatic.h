@@ -38,6 +38,9 @@
 #ifndef _TSSHAPE_H_
 #include "ts/tsShape.h"
 #endif
+#ifndef _RETAINEDRENDERINSTLIST_H_
+#include "renderInstance/retainedRenderInstList.h"
+#endif
 
 class TSShapeInstance;
 class TSThread;
@@ -170,6 +173,10 @@ protected:
 
    PhysicsBody *mPhysicsRep;
 
+   /// The render instances from the last diffuse pass which are
+   /// reused as long as the shape isn't animated and doesn't move.
+   RetainedRenderInstList mRetainedRender;
+
    // Debug stuff
    F32 mRenderNormalScalar;
    S32 mForceDetail;
@@ -198,6 +205,9 @@ public:
    void prepRenderImage( SceneRenderState *state );
    void inspectPostApply();
 
+   /// Shapes with an ambient animation change their shadow every frame.
+   bool isStaticShadowCaster() const { return !mAmbientThread; }
+
    /// The type of mesh data use for collision queries.
    MeshType getCollisionType() const { return mCollisionType; }
 
@@ -552,6 +552,17 @@ bool AITurretShape::onNewDataBlock(GameBaseData* dptr, bool reload)
    return true;
 }
 
+void AITurretShape::getRequiredAnimationNodes(TSIntegerSet &nodes)
+{
+   Parent::getRequiredAnimationNodes(nodes);
+
+   // Target scanning and aiming run on the server
+   if (mDataBlock->scanNode != -1)
+      nodes.set(mDataBlock->scanNode);
+   if (mDataBlock->aimNode != -1)
+      nodes.set(mDataBlock->aimNode);
+}
+
 //----------------------------------------------------------------------------
 
 void AITurretShape::addToIgnoreList(ShapeBase* obj)
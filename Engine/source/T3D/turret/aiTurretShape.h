@@ -254,6 +254,7 @@ public:
    bool onAdd();
    void onRemove();
    bool onNewDataBlock(GameBaseData *dptr, bool reload);
+   virtual void getRequiredAnimationNodes(TSIntegerSet &nodes);
 
    void addToIgnoreList(ShapeBase* obj);
    void removeFromIgnoreList(ShapeBase* obj);
@@ -447,6 +447,18 @@ bool TurretShape::onNewDataBlock(GameBaseData* dptr, bool reload)
    return true;
 }
 
+void TurretShape::getRequiredAnimationNodes(TSIntegerSet &nodes)
+{
+   Parent::getRequiredAnimationNodes(nodes);
+
+   // Weapons are mounted on these rather than the mount points
+   for (U32 i=0; i<ShapeBase::MaxMountedImages; ++i)
+   {
+      if (mDataBlock->weaponMountNode[i] != -1)
+         nodes.set(mDataBlock->weaponMountNode[i]);
+   }
+}
+
 //----------------------------------------------------------------------------
 
 void TurretShape::updateAnimation(F32 dt)
@@ -172,6 +172,7 @@ public:
    bool onAdd();
    void onRemove();
    bool onNewDataBlock(GameBaseData *dptr, bool reload);
+   virtual void getRequiredAnimationNodes(TSIntegerSet &nodes);
 
    const char* getStateName();
    virtual void updateDamageLevel();
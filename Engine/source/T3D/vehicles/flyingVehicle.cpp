@@ -397,6 +397,16 @@ bool FlyingVehicle::onNewDataBlock(GameBaseData* dptr, bool reload)
    return true;
 }
 
+void FlyingVehicle::getRequiredAnimationNodes(TSIntegerSet &nodes)
+{
+   Parent::getRequiredAnimationNodes(nodes);
+
+   // The jet emitters are placed on these
+   for (S32 j = 0; j < FlyingVehicleData::MaxJetNodes; j++)
+      if (mDataBlock->jetNode[j] != -1)
+         nodes.set(mDataBlock->jetNode[j]);
+}
+
 void FlyingVehicle::onRemove()
 {
    SFX_DELETE( mJetSound );
@@ -167,6 +167,7 @@ class FlyingVehicle: public Vehicle
 
    //
    bool onNewDataBlock(GameBaseData* dptr,bool reload);
+   virtual void getRequiredAnimationNodes(TSIntegerSet &nodes);
    void updateMove(const Move *move);
    void updateForces(F32);
 //   bool collideBody(const MatrixF& mat,Collision* info);
@@ -552,6 +552,16 @@ bool HoverVehicle::onNewDataBlock(GameBaseData* dptr, bool reload)
    return true;
 }
 
+void HoverVehicle::getRequiredAnimationNodes(TSIntegerSet &nodes)
+{
+   Parent::getRequiredAnimationNodes(nodes);
+
+   // The jet emitters are placed on these
+   for (S32 j = 0; j < HoverVehicleData::MaxJetNodes; j++)
+      if (mDataBlock->jetNode[j] != -1)
+         nodes.set(mDataBlock->jetNode[j]);
+}
+
 
 
 //--------------------------------------------------------------------------
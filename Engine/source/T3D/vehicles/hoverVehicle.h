@@ -137,6 +137,7 @@ class HoverVehicle : public Vehicle
    bool onAdd();
    void onRemove();
    bool onNewDataBlock(GameBaseData *dptr,bool reload);
+   virtual void getRequiredAnimationNodes(TSIntegerSet &nodes);
    void updateDustTrail( F32 dt );
 
    // Vehicle overrides
@@ -52,7 +52,7 @@ public:
 
    void insert(T* pObject, U32 key);
    T*   remove(U32 key);
-   T*   retreive(U32 key);
+   T*   retreive(U32 key) const;
 
    void clearTables();           // Note: _deletes_ the objects!
 };
@@ -132,7 +132,7 @@ inline T* SparseArray<T>::remove(U32 key)
 }
 
 template <class T>
-inline T* SparseArray<T>::retreive(U32 key)
+inline T* SparseArray<T>::retreive(U32 key) const
 {
    U32 retrieve = key % mModulus;
    Node* probe  = &mSentryTables[retrieve];
@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _TRADIXSORT_H_
+#define _TRADIXSORT_H_
+
+
+/// Stable LSD radix sort of @a count elements on an unsigned 64-bit key.
+///
+/// The elements are sorted in ascending key order; elements with equal keys
+/// keep their relative order.  The sort makes one pass over the data to build
+/// the histograms for all eight key bytes and then one scatter pass for each
+/// byte that is not the same across all elements, so keys that only use a few
+/// of their bits are cheap to sort.
+///
+/// @param elements Elements to sort.  Receives the sorted result.
+/// @param scratch Buffer with room for @a count elements.  Contents are undefined
+///   on return.  Callers should keep this around between sorts to avoid allocations.
+/// @param count Number of elements.
+/// @param getKey Functor or function returning the U64 key for an element.
+///
+/// @note T is copied with memcpy and thus must be POD.
+template< typename T, typename KeyFn >
+void radixSort( T* elements, T* scratch, U32 count, KeyFn getKey )
+{
+   if( count < 2 )
+      return;
+
+   enum
+   {
+      NUM_PASSES = 8,
+      NUM_BUCKETS = 256
+   };
+
+   U32 histograms[ NUM_PASSES ][ NUM_BUCKETS ];
+   dMemset( histograms, 0, sizeof( histograms ) );
+
+   for( U32 i = 0; i < count; ++ i )
+   {
+      const U64 key = getKey( elements[ i ] );
+      for( U32 pass = 0; pass < NUM_PASSES; ++ pass )
+         histograms[ pass ][ ( key >> ( pass * 8 ) ) & 0xFF ] ++;
+   }
+
+   T* src = elements;
+   T* dst = scratch;
+
+   for( U32 pass = 0; pass < NUM_PASSES; ++ pass )
+   {
+      U32* histogram = histograms[ pass ];
+      const U32 shift = pass * 8;
+
+      // Skip the pass if all keys have the same byte here.
+
+      if( histogram[ ( getKey( src[ 0 ] ) >> shift ) & 0xFF ] == count )
+         continue;
+
+      // Turn the counts into bucket offsets.
+
+      U32 offset = 0;
+      for( U32 i = 0; i < NUM_BUCKETS; ++ i )
+      {
+         const U32 num = histogram[ i ];
+         histogram[ i ] = offset;
+         offset += num;
+      }
+
+      for( U32 i = 0; i < count; ++ i )
+         dst[ histogram[ ( getKey( src[ i ] ) >> shift ) & 0xFF ] ++ ] = src[ i ];
+
+      T* temp = src;
+      src = dst;
+      dst = temp;
+   }
+
+   if( src != elements )
+      dMemcpy( elements, src, count * sizeof( T ) );
+}
+
+#endif // !_TRADIXSORT_H_
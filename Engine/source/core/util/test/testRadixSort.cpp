@@ -0,0 +1,142 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "core/util/tRadixSort.h"
+#include "core/util/tVector.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestRadixSort, "Util/RadixSort" )
+{
+   /// Same layout as the elements sorted by the render bins.
+   struct SortElem
+   {
+      void* inst;
+      U32 key;
+      U32 key2;
+   };
+
+   enum
+   {
+      NUM_ELEMENTS = 20000,
+      NUM_BENCHMARK_PASSES = 50
+   };
+
+   static U64 getKey( const SortElem& elem )
+   {
+      return ( U64( elem.key ) << 32 ) | elem.key2;
+   }
+
+   /// Reference order with the original position as the final tie breaker,
+   /// which is what a stable sort must produce.
+   static S32 FN_CDECL cmpElem( const void* p1, const void* p2 )
+   {
+      const SortElem* e1 = ( const SortElem* ) p1;
+      const SortElem* e2 = ( const SortElem* ) p2;
+
+      if( e1->key != e2->key )
+         return ( e1->key > e2->key ) ? 1 : -1;
+      if( e1->key2 != e2->key2 )
+         return ( e1->key2 > e2->key2 ) ? 1 : -1;
+      if( e1->inst != e2->inst )
+         return ( e1->inst > e2->inst ) ? 1 : -1;
+      return 0;
+   }
+
+   void fill( Vector< SortElem >& elements, MRandomLCG& rand )
+   {
+      // Few distinct primary keys, like material state hints, and
+      // distance-like secondary keys.
+
+      elements.setSize( NUM_ELEMENTS );
+      for( U32 i = 0; i < NUM_ELEMENTS; ++ i )
+      {
+         elements[ i ].inst = ( void* ) ( dsize_t ) ( i + 1 );
+         elements[ i ].key = rand.randI( 0, 63 ) * 0x01000193;
+         elements[ i ].key2 = rand.randI( 0, 1000 );
+      }
+   }
+
+   void run()
+   {
+      MRandomLCG rand( 2468 );
+
+      Vector< SortElem > elements;
+      Vector< SortElem > reference;
+      Vector< SortElem > scratch;
+
+      fill( elements, rand );
+      reference = elements;
+      scratch.setSize( elements.size() );
+
+      radixSort( elements.address(), scratch.address(), elements.size(), getKey );
+      dQsort( reference.address(), reference.size(), sizeof( SortElem ), cmpElem );
+
+      test( dMemcmp( elements.address(), reference.address(), elements.size() * sizeof( SortElem ) ) == 0,
+         "Radix sort order differs from stable reference order" );
+
+      // Keys that only differ in a single byte take a single pass.
+
+      for( U32 i = 0; i < elements.size(); ++ i )
+         elements[ i ].key = 0;
+      reference = elements;
+      radixSort( elements.address(), scratch.address(), elements.size(), getKey );
+      dQsort( reference.address(), reference.size(), sizeof( SortElem ), cmpElem );
+
+      test( dMemcmp( elements.address(), reference.address(), elements.size() * sizeof( SortElem ) ) == 0,
+         "Radix sort order differs from stable reference order on narrow keys" );
+
+      // Benchmark against dQsort on render bin sized lists.
+
+      Vector< SortElem > source;
+      fill( source, rand );
+
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < NUM_BENCHMARK_PASSES; ++ i )
+      {
+         elements = source;
+         dQsort( elements.address(), elements.size(), sizeof( SortElem ), cmpElem );
+      }
+      const U32 qsortTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < NUM_BENCHMARK_PASSES; ++ i )
+      {
+         elements = source;
+         radixSort( elements.address(), scratch.address(), elements.size(), getKey );
+      }
+      const U32 radixTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "RadixSort: %d elements x%d: dQsort %dms, radixSort %dms",
+         NUM_ELEMENTS, NUM_BENCHMARK_PASSES, qsortTime, radixTime );
+   }
+};
+
+#endif // !TORQUE_SHIPPING
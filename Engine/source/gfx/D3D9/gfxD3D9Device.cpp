@@ -639,8 +639,7 @@ void GFXD3D9Device::drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U
    // This is done to avoid the function call overhead if possible
    if( mStateDirty )
       updateStates();
-   if (mCurrentShaderConstBuffer)
-      setShaderConstBufferInternal(mCurrentShaderConstBuffer);
+   _updateShaderConstBuffer();
 
    if ( mVolatileVB )
       vertexStart += mVolatileVB->mVolatileStart;
@@ -666,8 +665,7 @@ void GFXD3D9Device::drawIndexedPrimitive( GFXPrimitiveType primType,
    // This is done to avoid the function call overhead if possible
    if( mStateDirty )
       updateStates();
-   if (mCurrentShaderConstBuffer)
-      setShaderConstBufferInternal(mCurrentShaderConstBuffer);
+   _updateShaderConstBuffer();
 
    AssertFatal( mCurrentPB != NULL, "Trying to call drawIndexedPrimitive with no current index buffer, call setIndexBuffer()" );
 
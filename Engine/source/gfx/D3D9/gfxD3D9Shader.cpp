@@ -458,7 +458,7 @@ void GFXD3D9ShaderConstBuffer::resurrect()
 {
 }
 
-bool GFXD3D9ShaderConstBuffer::isDirty()
+bool GFXD3D9ShaderConstBuffer::isDirty() const
 {
    bool ret = mVertexConstBufferF->isDirty();
    ret |= mVertexConstBufferI->isDirty();
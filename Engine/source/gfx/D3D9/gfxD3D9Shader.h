@@ -124,15 +124,13 @@ public:
    /// @param mPrevShaderBuffer The previously active buffer
    void activate( GFXD3D9ShaderConstBuffer *prevShaderBuffer );
    
-   /// Used internally by GXD3D9ShaderConstBuffer to determine if it's dirty.
-   bool isDirty();
-
    /// Called from GFXD3D9Shader when constants have changed and need
    /// to be the shader this buffer references is reloaded.
    void onShaderReload( GFXD3D9Shader *shader );
 
    // GFXShaderConstBuffer
    virtual GFXShader* getShader();
+   virtual bool isDirty() const;
    virtual void set(GFXShaderConstHandle* handle, const F32 fv);
    virtual void set(GFXShaderConstHandle* handle, const Point2F& fv);
    virtual void set(GFXShaderConstHandle* handle, const Point3F& fv);
@@ -112,6 +112,11 @@ protected:
 
          SAFE_DELETE( retTex->mBitmap );
          retTex->mBitmap = new GBitmap(width, height);
+
+         // Keep the requested size and format so that render
+         // targets and viewports derived from them are sane.
+         retTex->mTextureSize.set( width, height, depth );
+         retTex->mFormat = format;
          return retTex;
       };
 
@@ -152,13 +152,23 @@ public:
    virtual bool beginSceneInternal() { return true; };
    virtual void endSceneInternal() { };
 
-   virtual void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount ) { };
+   // Nothing is drawn, but the statistics are kept so
+   // that batching can be measured without a real device.
+   virtual void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount )
+   {
+      mDeviceStatistics.mDrawCalls++;
+      mDeviceStatistics.mPolyCount += primitiveCount;
+   };
    virtual void drawIndexedPrimitive(  GFXPrimitiveType primType, 
                                        U32 startVertex, 
                                        U32 minIndex, 
                                        U32 numVerts, 
                                        U32 startIndex, 
-                                       U32 primitiveCount ) { };
+                                       U32 primitiveCount )
+   {
+      mDeviceStatistics.mDrawCalls++;
+      mDeviceStatistics.mPolyCount += primitiveCount;
+   };
 
    virtual void setClipRect( const RectI &rect ) { };
    virtual const RectI &getClipRect() const { return clip; };
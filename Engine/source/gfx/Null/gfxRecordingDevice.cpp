@@ -0,0 +1,966 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/Null/gfxRecordingDevice.h"
+
+#include "gfx/gfxCubemap.h"
+#include "gfx/gfxOcclusionQuery.h"
+#include "gfx/gfxStateBlock.h"
+#include "gfx/gfxTextureManager.h"
+#include "gfx/bitmap/ddsFile.h"
+#include "core/util/hashFunction.h"
+#include "core/util/tDictionary.h"
+#include "core/strings/stringFunctions.h"
+#include "core/volume.h"
+#include "console/engineAPI.h"
+
+
+GFXAdapterType GFXRecordingDevice::smEmulatedAdapterType =
+#ifdef TORQUE_OS_WIN
+   Direct3D9;
+#else
+   OpenGL;
+#endif
+
+
+namespace {
+
+   /// Hashes a texture by its description so that the hash
+   /// doesn't change between runs.
+   U32 _hashTexture( const GFXTextureObject *texture )
+   {
+      if ( !texture )
+         return 0;
+
+      const Point3I &size = texture->getSize();
+      const U32 data[] = { (U32)size.x, (U32)size.y, (U32)size.z, (U32)texture->getFormat() };
+      return Torque::hash( (const U8*)data, sizeof( data ), texture->getPath().getHashCaseInsensitive() );
+   }
+
+   U32 _hashVertexBuffer( const GFXVertexBuffer *buffer )
+   {
+      if ( !buffer )
+         return 0;
+
+      const U32 data[] = { buffer->mNumVerts, buffer->mVertexSize, buffer->mBufferType };
+      return Torque::hash( (const U8*)data, sizeof( data ), buffer->mVertexFormat.getDescription().getHashCaseSensitive() );
+   }
+}
+
+
+//-----------------------------------------------------------------------------
+// Resources
+//-----------------------------------------------------------------------------
+
+class GFXRecordingStateBlock : public GFXStateBlock
+{
+public:
+
+   GFXRecordingStateBlock( const GFXStateBlockDesc &desc )
+      :  mDesc( desc ),
+         mHash( desc.getHashValue() )
+   {
+   }
+
+   // GFXStateBlock
+   virtual U32 getHashValue() const { return mHash; }
+   virtual const GFXStateBlockDesc& getDesc() const { return mDesc; }
+
+   // GFXResource
+   virtual void zombify() {}
+   virtual void resurrect() {}
+
+protected:
+
+   GFXStateBlockDesc mDesc;
+   U32 mHash;
+};
+
+
+class GFXRecordingShaderConstHandle : public GFXShaderConstHandle
+{
+   friend class GFXRecordingShader;
+
+public:
+
+   GFXRecordingShaderConstHandle( const String &name )
+      :  mName( name ),
+         mNameHash( name.getHashCaseSensitive() ),
+         mType( GFXSCT_Float4 ),
+         mArraySize( 1 ),
+         mSamplerRegister( -1 )
+   {
+   }
+
+   // GFXShaderConstHandle
+   virtual const String& getName() const { return mName; }
+   virtual GFXShaderConstType getType() const { return mType; }
+   virtual U32 getArraySize() const { return mArraySize; }
+   virtual S32 getSamplerRegister() const { return mSamplerRegister; }
+
+   U32 getNameHash() const { return mNameHash; }
+
+protected:
+
+   String mName;
+   U32 mNameHash;
+   GFXShaderConstType mType;
+   U32 mArraySize;
+   S32 mSamplerRegister;
+};
+
+
+class GFXRecordingShaderConstBuffer;
+
+/// A shader which is never compiled.  The constants and samplers
+/// are found by scanning the uniform declarations in the source.
+class GFXRecordingShader : public GFXShader
+{
+   friend class GFXRecordingShaderConstBuffer;
+
+public:
+
+   GFXRecordingShader();
+   virtual ~GFXRecordingShader();
+
+   /// Returns a hash of the shader files and macros.
+   U32 getDescHash() const { return mDescHash; }
+
+   // GFXShader
+   virtual GFXShaderConstBufferRef allocConstBuffer();
+   virtual const Vector<GFXShaderConstDesc>& getShaderConstDesc() const { return mConstDescs; }
+   virtual GFXShaderConstHandle* getShaderConstHandle( const String &name );
+   virtual U32 getAlignmentValue( const GFXShaderConstType constType ) const { return 16; }
+
+   // GFXResource
+   virtual void zombify() {}
+   virtual void resurrect() {}
+
+protected:
+
+   typedef Map<String, GFXRecordingShaderConstHandle*> HandleMap;
+
+   HandleMap mHandles;
+
+   Vector<GFXShaderConstDesc> mConstDescs;
+
+   /// The sampler register of each entry in mConstDescs or -1.
+   Vector<S32> mSamplerRegisters;
+
+   U32 mDescHash;
+
+   void _parseSource( const Torque::Path &path );
+
+   void _addConst( const String &type, const String &name, U32 arraySize, S32 samplerRegister );
+
+   static GFXShaderConstType _getConstType( const String &type );
+
+   // GFXShader
+   virtual bool _init();
+};
+
+
+class GFXRecordingShaderConstBuffer : public GFXShaderConstBuffer
+{
+public:
+
+   GFXRecordingShaderConstBuffer( GFXRecordingShader *shader )
+      :  mShader( shader ),
+         mContentHash( 0 ),
+         mNumSets( 0 )
+   {
+   }
+
+   virtual ~GFXRecordingShaderConstBuffer()
+   {
+      if ( mShader )
+         mShader->_unlinkBuffer( this );
+   }
+
+   /// Called by the shader when it is reloaded.
+   void markLost() { mWasLost = true; }
+
+   /// Called by the device when the buffer is uploaded.
+   /// @return True if any constants were set since the last upload.
+   bool flush( U32 *outHash, U32 *outNumSets )
+   {
+      *outHash = mContentHash;
+      *outNumSets = mNumSets;
+
+      const bool changed = mNumSets > 0 || mWasLost;
+      mNumSets = 0;
+      mWasLost = false;
+      return changed;
+   }
+
+   // GFXShaderConstBuffer
+   virtual GFXShader* getShader() { return mShader; }
+   virtual bool isDirty() const { return mNumSets > 0; }
+   virtual void set( GFXShaderConstHandle *handle, const F32 fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const Point2F &fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const Point3F &fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const Point4F &fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const PlaneF &fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const ColorF &fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const S32 fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const Point2I &fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const Point3I &fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const Point4I &fv ) { _set( handle, &fv, sizeof( fv ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const AlignedArray<F32> &fv ) { _set( handle, fv.getBuffer(), fv.getBufferSize() ); }
+   virtual void set( GFXShaderConstHandle *handle, const AlignedArray<Point2F> &fv ) { _set( handle, fv.getBuffer(), fv.getBufferSize() ); }
+   virtual void set( GFXShaderConstHandle *handle, const AlignedArray<Point3F> &fv ) { _set( handle, fv.getBuffer(), fv.getBufferSize() ); }
+   virtual void set( GFXShaderConstHandle *handle, const AlignedArray<Point4F> &fv ) { _set( handle, fv.getBuffer(), fv.getBufferSize() ); }
+   virtual void set( GFXShaderConstHandle *handle, const AlignedArray<S32> &fv ) { _set( handle, fv.getBuffer(), fv.getBufferSize() ); }
+   virtual void set( GFXShaderConstHandle *handle, const AlignedArray<Point2I> &fv ) { _set( handle, fv.getBuffer(), fv.getBufferSize() ); }
+   virtual void set( GFXShaderConstHandle *handle, const AlignedArray<Point3I> &fv ) { _set( handle, fv.getBuffer(), fv.getBufferSize() ); }
+   virtual void set( GFXShaderConstHandle *handle, const AlignedArray<Point4I> &fv ) { _set( handle, fv.getBuffer(), fv.getBufferSize() ); }
+   virtual void set( GFXShaderConstHandle *handle, const MatrixF &mat, const GFXShaderConstType matrixType ) { _set( handle, &mat, sizeof( mat ) ); }
+   virtual void set( GFXShaderConstHandle *handle, const MatrixF *mat, const U32 arraySize, const GFXShaderConstType matrixType ) { _set( handle, mat, sizeof( MatrixF ) * arraySize ); }
+
+   // GFXResource
+   virtual const String describeSelf() const { return String(); }
+   virtual void zombify() {}
+   virtual void resurrect() {}
+
+protected:
+
+   WeakRefPtr<GFXRecordingShader> mShader;
+
+   /// Hash of every constant set on this buffer.
+   U32 mContentHash;
+
+   /// The number of constants set since the last upload.
+   U32 mNumSets;
+
+   void _set( GFXShaderConstHandle *handle, const void *data, U32 size )
+   {
+      AssertFatal( handle, "GFXRecordingShaderConstBuffer::set - Got null handle!" );
+      if ( !handle->isValid() )
+         return;
+
+      const U32 nameHash = static_cast<GFXRecordingShaderConstHandle*>( handle )->getNameHash();
+      mContentHash = Torque::hash( (const U8*)data, size, mContentHash ^ nameHash );
+      mNumSets++;
+   }
+};
+
+
+GFXRecordingShader::GFXRecordingShader()
+   : mDescHash( 0 )
+{
+}
+
+GFXRecordingShader::~GFXRecordingShader()
+{
+   HandleMap::Iterator iter = mHandles.begin();
+   for ( ; iter != mHandles.end(); iter++ )
+      delete iter->value;
+}
+
+bool GFXRecordingShader::_init()
+{
+   mConstDescs.clear();
+   mSamplerRegisters.clear();
+
+   _parseSource( mVertexFile );
+   _parseSource( mPixelFile );
+
+   mDescHash = mVertexFile.getFullPath().getHashCaseInsensitive();
+   mDescHash = Torque::hash( (const U8*)mPixelFile.getFullPath().c_str(), mPixelFile.getFullPath().length(), mDescHash );
+   for ( U32 i = 0; i < mMacros.size(); i++ )
+   {
+      mDescHash ^= mMacros[i].name.getHashCaseSensitive();
+      mDescHash = Torque::hash( (const U8*)mMacros[i].value.c_str(), mMacros[i].value.length(), mDescHash );
+   }
+
+   // Update the handles we already gave out... the
+   // constants may have changed on a reload.
+   HandleMap::Iterator iter = mHandles.begin();
+   for ( ; iter != mHandles.end(); iter++ )
+      iter->value->mValid = false;
+
+   for ( U32 i = 0; i < mConstDescs.size(); i++ )
+   {
+      GFXRecordingShaderConstHandle *handle = static_cast<GFXRecordingShaderConstHandle*>( getShaderConstHandle( mConstDescs[i].name ) );
+      handle->mType = mConstDescs[i].constType;
+      handle->mArraySize = mConstDescs[i].arraySize;
+      handle->mSamplerRegister = mSamplerRegisters[i];
+      handle->mValid = true;
+   }
+
+   for ( U32 i = 0; i < mActiveBuffers.size(); i++ )
+      static_cast<GFXRecordingShaderConstBuffer*>( mActiveBuffers[i] )->markLost();
+
+   return true;
+}
+
+void GFXRecordingShader::_parseSource( const Torque::Path &path )
+{
+   if ( path.isEmpty() )
+      return;
+
+   void *data = NULL;
+   U32 dataSize = 0;
+   if ( !Torque::FS::ReadFile( path, data, dataSize, true ) )
+      return;
+
+   // Look for declarations of the form:
+   //
+   //    uniform <type> <name>[<size>] : register(<reg>)
+   //
+   // where the array size and register are optional.
+   const char *text = (const char*)data;
+   const char *itr = text;
+   while ( ( itr = dStrstr( itr, "uniform" ) ) != NULL )
+   {
+      const bool isWord = ( itr == text || ( !dIsalnum( itr[-1] ) && itr[-1] != '_' ) ) &&
+                          dIsspace( itr[7] );
+      itr += 7;
+      if ( !isWord )
+         continue;
+
+      String tokens[2];
+      for ( U32 i = 0; i < 2; i++ )
+      {
+         while ( *itr && dIsspace( *itr ) )
+            itr++;
+
+         const char *start = itr;
+         while ( *itr && ( dIsalnum( *itr ) || *itr == '_' ) )
+            itr++;
+
+         tokens[i] = String( start, itr - start );
+      }
+
+      if ( tokens[0].isEmpty() || tokens[1].isEmpty() )
+         continue;
+
+      while ( *itr && dIsspace( *itr ) )
+         itr++;
+
+      U32 arraySize = 1;
+      if ( *itr == '[' )
+         arraySize = getMax( dAtoi( itr + 1 ), 1 );
+
+      S32 samplerRegister = -1;
+      const char *end = itr;
+      while ( *end && *end != ';' && *end != ',' && *end != ')' && *end != '\n' )
+         end++;
+      const char *reg = dStrstr( itr, "register" );
+      if ( reg && reg < end )
+      {
+         reg = dStrchr( reg, '(' );
+         if ( reg && ( reg[1] == 'S' || reg[1] == 's' ) )
+            samplerRegister = dAtoi( reg + 2 );
+      }
+
+      _addConst( tokens[0], tokens[1], arraySize, samplerRegister );
+   }
+
+   delete [] (U8*)data;
+}
+
+void GFXRecordingShader::_addConst( const String &type, const String &name, U32 arraySize, S32 samplerRegister )
+{
+   // The vertex and pixel shader often share constants.
+   for ( U32 i = 0; i < mConstDescs.size(); i++ )
+   {
+      if ( mConstDescs[i].name == name )
+         return;
+   }
+
+   GFXShaderConstDesc desc;
+   desc.name = name;
+   desc.constType = _getConstType( type );
+   desc.arraySize = arraySize;
+
+   // Samplers without an explicit register get the next free
+   // one in the order they are declared like they do in GLSL.
+   if ( desc.constType >= GFXSCT_Sampler && samplerRegister == -1 )
+   {
+      samplerRegister = 0;
+      for ( U32 i = 0; i < mSamplerRegisters.size(); i++ )
+         samplerRegister = getMax( samplerRegister, mSamplerRegisters[i] + 1 );
+   }
+   else if ( desc.constType < GFXSCT_Sampler )
+      samplerRegister = -1;
+
+   if ( samplerRegister >= TEXTURE_STAGE_COUNT )
+      return;
+
+   mConstDescs.push_back( desc );
+   mSamplerRegisters.push_back( samplerRegister );
+}
+
+GFXShaderConstType GFXRecordingShader::_getConstType( const String &type )
+{
+   if ( type.compare( "sampler", 7 ) == 0 )
+      return type.find( "cube", 0, String::NoCase ) != String::NPos ? GFXSCT_SamplerCube : GFXSCT_Sampler;
+
+   static const struct
+   {
+      const char *name;
+      GFXShaderConstType type;
+
+   } smTypes[] =
+   {
+      { "float", GFXSCT_Float },
+      { "half", GFXSCT_Float },
+      { "float2", GFXSCT_Float2 },
+      { "vec2", GFXSCT_Float2 },
+      { "float3", GFXSCT_Float3 },
+      { "vec3", GFXSCT_Float3 },
+      { "float4", GFXSCT_Float4 },
+      { "vec4", GFXSCT_Float4 },
+      { "float2x2", GFXSCT_Float2x2 },
+      { "mat2", GFXSCT_Float2x2 },
+      { "float3x3", GFXSCT_Float3x3 },
+      { "mat3", GFXSCT_Float3x3 },
+      { "float4x4", GFXSCT_Float4x4 },
+      { "float4x3", GFXSCT_Float4x4 },
+      { "float3x4", GFXSCT_Float4x4 },
+      { "mat4", GFXSCT_Float4x4 },
+      { "int", GFXSCT_Int },
+      { "bool", GFXSCT_Int },
+      { "int2", GFXSCT_Int2 },
+      { "ivec2", GFXSCT_Int2 },
+      { "int3", GFXSCT_Int3 },
+      { "ivec3", GFXSCT_Int3 },
+      { "int4", GFXSCT_Int4 },
+      { "ivec4", GFXSCT_Int4 },
+   };
+
+   for ( U32 i = 0; i < sizeof( smTypes ) / sizeof( smTypes[0] ); i++ )
+   {
+      if ( type.equal( smTypes[i].name ) )
+         return smTypes[i].type;
+   }
+
+   return GFXSCT_Float4;
+}
+
+GFXShaderConstHandle* GFXRecordingShader::getShaderConstHandle( const String &name )
+{
+   HandleMap::Iterator iter = mHandles.find( name );
+   if ( iter != mHandles.end() )
+      return iter->value;
+
+   // Unknown constants get an invalid handle which
+   // becomes valid if it shows up after a reload.
+   GFXRecordingShaderConstHandle *handle = new GFXRecordingShaderConstHandle( name );
+   mHandles.insert( name, handle );
+   return handle;
+}
+
+GFXShaderConstBufferRef GFXRecordingShader::allocConstBuffer()
+{
+   GFXRecordingShaderConstBuffer *buffer = new GFXRecordingShaderConstBuffer( this );
+   mActiveBuffers.push_back( buffer );
+   buffer->registerResourceWithDevice( getOwningDevice() );
+   return buffer;
+}
+
+
+class GFXRecordingCubemap : public GFXCubemap
+{
+public:
+
+   GFXRecordingCubemap( GFXRecordingDevice *device )
+      :  mDevice( device ),
+         mSize( 0 ),
+         mFormat( GFXFormatR8G8B8A8 )
+   {
+   }
+
+   // GFXCubemap
+   virtual void initStatic( GFXTexHandle *faces )
+   {
+      if ( faces && faces[0].isValid() )
+      {
+         mSize = faces[0]->getWidth();
+         mFormat = faces[0]->getFormat();
+      }
+   }
+   virtual void initStatic( DDSFile *dds )
+   {
+      mSize = dds->getWidth();
+      mFormat = dds->getFormat();
+   }
+   virtual void initDynamic( U32 texSize, GFXFormat faceFormat )
+   {
+      mSize = texSize;
+      mFormat = faceFormat;
+   }
+   virtual U32 getSize() const { return mSize; }
+   virtual GFXFormat getFormat() const { return mFormat; }
+
+   // GFXResource
+   virtual void zombify() {}
+   virtual void resurrect() {}
+
+protected:
+
+   GFXRecordingDevice *mDevice;
+   U32 mSize;
+   GFXFormat mFormat;
+
+   virtual void setToTexUnit( U32 tuNum )
+   {
+      const U32 data[] = { mSize, mFormat };
+      mDevice->_recordCubemap( tuNum, this, Torque::hash( (const U8*)data, sizeof( data ), 0 ) );
+   }
+};
+
+
+class GFXRecordingTextureTarget : public GFXTextureTarget
+{
+public:
+
+   // GFXTarget
+   virtual const Point2I getSize()
+   {
+      for ( U32 i = 0; i < MaxRenderSlotId; i++ )
+      {
+         if ( mTextures[i].isValid() )
+            return Point2I( mTextures[i]->getWidth(), mTextures[i]->getHeight() );
+         if ( mCubemaps[i].isValid() )
+            return Point2I( mCubemaps[i]->getSize(), mCubemaps[i]->getSize() );
+      }
+
+      return Point2I( 1, 1 );
+   }
+
+   virtual GFXFormat getFormat()
+   {
+      if ( mTextures[Color0].isValid() )
+         return mTextures[Color0]->getFormat();
+
+      return GFXFormatR8G8B8A8;
+   }
+
+   // GFXTextureTarget
+   virtual void attachTexture( RenderSlot slot, GFXTextureObject *tex, U32 mipLevel, U32 zOffset )
+   {
+      // The sys memory depth texture means no depth.
+      if ( tex == GFXTextureTarget::sDefaultDepthStencil )
+         tex = NULL;
+
+      mTextures[slot] = tex;
+      mCubemaps[slot] = NULL;
+   }
+   virtual void attachTexture( RenderSlot slot, GFXCubemap *tex, U32 face, U32 mipLevel )
+   {
+      mTextures[slot] = NULL;
+      mCubemaps[slot] = tex;
+   }
+   virtual void resolve() {}
+
+   // GFXResource
+   virtual void zombify() {}
+   virtual void resurrect() {}
+
+protected:
+
+   GFXTexHandle mTextures[MaxRenderSlotId];
+   GFXCubemapHandle mCubemaps[MaxRenderSlotId];
+};
+
+
+class GFXRecordingOcclusionQuery : public GFXOcclusionQuery
+{
+public:
+
+   GFXRecordingOcclusionQuery( GFXDevice *device )
+      : GFXOcclusionQuery( device )
+   {
+   }
+
+   // GFXOcclusionQuery
+   virtual bool begin() { return true; }
+   virtual void end() {}
+
+   // Nothing is drawn, so report everything as fully
+   // visible to keep the results deterministic.
+   virtual OcclusionQueryStatus getStatus( bool block, U32 *data )
+   {
+      if ( data )
+         *data = 1;
+      return NotOccluded;
+   }
+
+   // GFXResource
+   virtual void zombify() {}
+   virtual void resurrect() {}
+   virtual const String describeSelf() const { return String(); }
+};
+
+
+//-----------------------------------------------------------------------------
+// GFXRecordingDevice
+//-----------------------------------------------------------------------------
+
+void GFXRecordingDevice::Counters::add( const Counters &counters )
+{
+   for ( U32 i = 0; i < CmdType_Count; i++ )
+   {
+      commands[i] += counters.commands[i];
+      redundant[i] += counters.redundant[i];
+   }
+
+   primitives += counters.primitives;
+}
+
+U32 GFXRecordingDevice::Counters::getRedundantTotal() const
+{
+   U32 total = 0;
+   for ( U32 i = 0; i < CmdType_Count; i++ )
+      total += redundant[i];
+
+   return total;
+}
+
+GFXDevice* GFXRecordingDevice::createInstance( U32 adapterIndex )
+{
+   return new GFXRecordingDevice();
+}
+
+GFXAdapter* GFXRecordingDevice::getRecordingAdapter()
+{
+   static GFXAdapter *smAdapter = NULL;
+   if ( !smAdapter )
+   {
+      smAdapter = new GFXAdapter();
+      smAdapter->mIndex = 0;
+      smAdapter->mType = NullDevice;
+      smAdapter->mShaderModel = 3.0f;
+      smAdapter->mCreateDeviceInstanceDelegate = GFXAdapter::CreateDeviceInstanceDelegate( &GFXRecordingDevice::createInstance );
+
+      GFXVideoMode vm;
+      vm.bitDepth = 32;
+      vm.resolution.set( 1280, 720 );
+      smAdapter->mAvailableModes.push_back( vm );
+
+      dStrcpy( smAdapter->mName, "GFX Recording Device" );
+   }
+
+   return smAdapter;
+}
+
+const char* GFXRecordingDevice::getCommandName( CommandType type )
+{
+   static const char *smNames[CmdType_Count] =
+   {
+      "setRenderTarget",
+      "clear",
+      "setStateBlock",
+      "setShader",
+      "setShaderConsts",
+      "setTexture",
+      "setVertexBuffer",
+      "draw",
+   };
+
+   AssertFatal( type < CmdType_Count, "GFXRecordingDevice::getCommandName - Bad command type!" );
+   return smNames[type];
+}
+
+GFXRecordingDevice::GFXRecordingDevice()
+   :  mPixelShaderVersion( 3.0f ),
+      mFrameHash( 0 ),
+      mNumFrames( 0 )
+{
+   VECTOR_SET_ASSOCIATION( mCommands );
+   _resetBoundState();
+}
+
+GFXRecordingDevice::~GFXRecordingDevice()
+{
+}
+
+void GFXRecordingDevice::resetTotals()
+{
+   mTotalCounters.clear();
+   mNumFrames = 0;
+}
+
+void GFXRecordingDevice::_resetBoundState()
+{
+   mBoundStateBlock = NULL;
+   mBoundShader = NULL;
+   mBoundConsts = NULL;
+   dMemset( mBoundTextures, 0, sizeof( mBoundTextures ) );
+   dMemset( mBoundVertexBuffers, 0, sizeof( mBoundVertexBuffers ) );
+}
+
+void GFXRecordingDevice::_record( CommandType type, U32 slot, U32 hash, U32 count, bool redundant )
+{
+   Command cmd;
+   cmd.type = type;
+   cmd.slot = slot;
+   cmd.hash = hash;
+   cmd.count = count;
+   mCommands.push_back( cmd );
+
+   mFrameCounters.commands[type]++;
+   if ( redundant )
+      mFrameCounters.redundant[type]++;
+
+   // Hash the fields and not the struct to skip the padding.
+   const U32 data[] = { type, slot, hash, count };
+   mFrameHash = Torque::hash( (const U8*)data, sizeof( data ), mFrameHash );
+}
+
+void GFXRecordingDevice::dumpFrameCommands() const
+{
+   for ( U32 i = 0; i < mCommands.size(); i++ )
+   {
+      const Command &cmd = mCommands[i];
+      Con::printf( "%5d %-16s %2d %08x %d", i, getCommandName( (CommandType)cmd.type ), cmd.slot, cmd.hash, cmd.count );
+   }
+
+   Con::printf( "%d commands, frame hash %08x", mCommands.size(), mFrameHash );
+}
+
+bool GFXRecordingDevice::beginSceneInternal()
+{
+   mCommands.clear();
+   mFrameCounters.clear();
+   mFrameHash = 0;
+   mCanCurrentlyRender = true;
+   return true;
+}
+
+void GFXRecordingDevice::endSceneInternal()
+{
+   mTotalCounters.add( mFrameCounters );
+   mNumFrames++;
+   mCanCurrentlyRender = false;
+}
+
+void GFXRecordingDevice::_updateRenderTargets()
+{
+   if ( mRTDirty || ( mCurrentRT && mCurrentRT->isPendingState() ) )
+   {
+      if ( mRTDeactivate )
+      {
+         mRTDeactivate->deactivate();
+         mRTDeactivate = NULL;
+      }
+
+      mDeviceStatistics.mRenderTargetChanges++;
+      mCurrentRT->activate();
+      mRTDirty = false;
+
+      const Point2I size = mCurrentRT->getSize();
+      const U32 data[] = { (U32)size.x, (U32)size.y, (U32)mCurrentRT->getFormat() };
+      _record( CmdSetRenderTarget, 0, Torque::hash( (const U8*)data, sizeof( data ), 0 ), 0, false );
+   }
+
+   mViewportDirty = false;
+}
+
+GFXStateBlockRef GFXRecordingDevice::createStateBlockInternal( const GFXStateBlockDesc &desc )
+{
+   return new GFXRecordingStateBlock( desc );
+}
+
+void GFXRecordingDevice::setStateBlockInternal( GFXStateBlock *block, bool force )
+{
+   _record( CmdSetStateBlock, 0, block->getHashValue(), 0, !force && block == mBoundStateBlock );
+   mBoundStateBlock = block;
+}
+
+GFXShader* GFXRecordingDevice::createShader()
+{
+   GFXRecordingShader *shader = new GFXRecordingShader();
+   shader->registerResourceWithDevice( this );
+   return shader;
+}
+
+void GFXRecordingDevice::setShader( GFXShader *shader )
+{
+   const U32 hash = shader ? static_cast<GFXRecordingShader*>( shader )->getDescHash() : 0;
+   _record( CmdSetShader, 0, hash, 0, shader == mBoundShader );
+   mBoundShader = shader;
+}
+
+void GFXRecordingDevice::disableShaders()
+{
+   setShader( NULL );
+   setShaderConstBuffer( NULL );
+}
+
+void GFXRecordingDevice::setShaderConstBufferInternal( GFXShaderConstBuffer *buffer )
+{
+   if ( buffer )
+   {
+      U32 hash, numSets;
+      const bool changed = static_cast<GFXRecordingShaderConstBuffer*>( buffer )->flush( &hash, &numSets );
+      _record( CmdSetShaderConsts, 0, hash, numSets, !changed && buffer == mBoundConsts );
+   }
+
+   mBoundConsts = buffer;
+}
+
+void GFXRecordingDevice::setTextureInternal( U32 textureUnit, const GFXTextureObject *texture )
+{
+   _record( CmdSetTexture, textureUnit, _hashTexture( texture ), 0, texture == mBoundTextures[textureUnit] );
+   mBoundTextures[textureUnit] = texture;
+}
+
+void GFXRecordingDevice::_recordCubemap( U32 unit, const GFXCubemap *cubemap, U32 hash )
+{
+   _record( CmdSetTexture, unit, hash, 0, cubemap == mBoundTextures[unit] );
+   mBoundTextures[unit] = cubemap;
+}
+
+void GFXRecordingDevice::setVertexStream( U32 stream, GFXVertexBuffer *buffer )
+{
+   _record( CmdSetVertexBuffer, stream, _hashVertexBuffer( buffer ), 0, buffer == mBoundVertexBuffers[stream] );
+   mBoundVertexBuffers[stream] = buffer;
+}
+
+GFXCubemap* GFXRecordingDevice::createCubemap()
+{
+   GFXRecordingCubemap *cubemap = new GFXRecordingCubemap( this );
+   cubemap->registerResourceWithDevice( this );
+   return cubemap;
+}
+
+GFXTextureTarget* GFXRecordingDevice::allocRenderToTextureTarget()
+{
+   GFXRecordingTextureTarget *target = new GFXRecordingTextureTarget();
+   target->registerResourceWithDevice( this );
+   return target;
+}
+
+GFXOcclusionQuery* GFXRecordingDevice::createOcclusionQuery()
+{
+   GFXRecordingOcclusionQuery *query = new GFXRecordingOcclusionQuery( this );
+   query->registerResourceWithDevice( this );
+   return query;
+}
+
+void GFXRecordingDevice::clear( U32 flags, ColorI color, F32 z, U32 stencil )
+{
+   _updateRenderTargets();
+   _record( CmdClear, 0, flags, 0, false );
+}
+
+void GFXRecordingDevice::_drawCommon( U32 primitiveCount )
+{
+   if ( mStateDirty )
+      updateStates();
+   _updateShaderConstBuffer();
+
+   if ( mVertexBufferFrequency[0] > 1 )
+      primitiveCount *= mVertexBufferFrequency[0];
+
+   mDeviceStatistics.mDrawCalls++;
+   mDeviceStatistics.mPolyCount += primitiveCount;
+   mFrameCounters.primitives += primitiveCount;
+}
+
+void GFXRecordingDevice::drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount )
+{
+   _drawCommon( primitiveCount );
+
+   const U32 data[] = { primType, vertexStart };
+   _record( CmdDraw, 0, Torque::hash( (const U8*)data, sizeof( data ), 0 ), primitiveCount, false );
+}
+
+void GFXRecordingDevice::drawIndexedPrimitive(  GFXPrimitiveType primType,
+                                                U32 startVertex,
+                                                U32 minIndex,
+                                                U32 numVerts,
+                                                U32 startIndex,
+                                                U32 primitiveCount )
+{
+   _drawCommon( primitiveCount );
+
+   const U32 data[] = { primType, startVertex, minIndex, numVerts, startIndex };
+   _record( CmdDraw, 0, Torque::hash( (const U8*)data, sizeof( data ), 0 ), primitiveCount, false );
+}
+
+
+//-----------------------------------------------------------------------------
+// Console API
+//-----------------------------------------------------------------------------
+
+static GFXRecordingDevice* _getRecordingDevice()
+{
+   GFXRecordingDevice *device = dynamic_cast<GFXRecordingDevice*>( GFX );
+   if ( !device )
+      Con::errorf( "The active GFX device is not a recording device." );
+
+   return device;
+}
+
+DefineEngineFunction( gfxRecordingDumpFrame, void, (),,
+   "Print the command log of the last frame rendered with the recording GFX device.\n"
+   "@see GFXInit::createRecordingDevice\n"
+   "@ingroup GFX\n" )
+{
+   GFXRecordingDevice *device = _getRecordingDevice();
+   if ( device )
+      device->dumpFrameCommands();
+}
+
+DefineEngineFunction( gfxRecordingGetFrameHash, String, (),,
+   "Return the hash of the commands of the last frame rendered with the recording GFX device.\n"
+   "Two runs which submit the same work to the device return the same hash.\n"
+   "@see GFXInit::createRecordingDevice\n"
+   "@ingroup GFX\n" )
+{
+   GFXRecordingDevice *device = _getRecordingDevice();
+   if ( !device )
+      return String::EmptyString;
+
+   return String::ToString( "%08x", device->getFrameHash() );
+}
+
+DefineEngineFunction( gfxRecordingPrintStats, void, (),,
+   "Print the per frame averages of the commands recorded by the recording GFX device since "
+   "the last call.\n"
+   "@see GFXInit::createRecordingDevice\n"
+   "@ingroup GFX\n" )
+{
+   GFXRecordingDevice *device = _getRecordingDevice();
+   if ( !device || device->getNumFrames() == 0 )
+      return;
+
+   const GFXRecordingDevice::Counters &totals = device->getTotalCounters();
+   const F32 invFrames = 1.0f / device->getNumFrames();
+
+   Con::printf( "GFX recording: %d frames", device->getNumFrames() );
+   for ( U32 i = 0; i < GFXRecordingDevice::CmdType_Count; i++ )
+   {
+      Con::printf( "   %-16s %10.1f per frame, %10.1f redundant",
+         GFXRecordingDevice::getCommandName( (GFXRecordingDevice::CommandType)i ),
+         totals.commands[i] * invFrames,
+         totals.redundant[i] * invFrames );
+   }
+   Con::printf( "   %-16s %10.1f per frame", "primitives", totals.primitives * invFrames );
+
+   device->resetTotals();
+}
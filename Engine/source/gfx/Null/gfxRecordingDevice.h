@@ -0,0 +1,216 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _GFXRECORDINGDEVICE_H_
+#define _GFXRECORDINGDEVICE_H_
+
+#ifndef _GFXNullDevice_H_
+#include "gfx/Null/gfxNullDevice.h"
+#endif
+
+
+/// A headless device which doesn't draw anything, but records what the
+/// renderer submits to it.
+///
+/// Unlike the null device it creates shaders, render targets and state
+/// blocks, so materials initialize and the full render path runs.  Every
+/// state block, shader, constant buffer upload, texture bind, vertex buffer
+/// bind and draw call which reaches the device is appended to a compact per
+/// frame command log.  Resources are identified in the log by hashes of their
+/// descriptions instead of their addresses, so the hash of a frame can be
+/// compared between runs to catch changes in what the renderer submits.
+///
+/// Binds of a resource which is already bound to the same slot are counted
+/// as redundant.
+///
+/// The device reports itself as #smEmulatedAdapterType so that ShaderGen and
+/// the lighting systems take the same paths they do on that device.
+///
+/// @see GFXInit::createRecordingDevice
+class GFXRecordingDevice : public GFXNullDevice
+{
+   typedef GFXNullDevice Parent;
+
+public:
+
+   enum CommandType
+   {
+      CmdSetRenderTarget,
+      CmdClear,
+      CmdSetStateBlock,
+      CmdSetShader,
+      CmdSetShaderConsts,
+      CmdSetTexture,
+      CmdSetVertexBuffer,
+      CmdDraw,
+      CmdType_Count
+   };
+
+   /// An entry in the command log.
+   struct Command
+   {
+      /// The CommandType.
+      U8 type;
+
+      /// The texture unit or vertex stream for binds.
+      U8 slot;
+
+      /// The description hash of the bound resource or the
+      /// content hash of uploaded shader constants.
+      U32 hash;
+
+      /// The primitive count for draws, the number of constants
+      /// set for constant uploads and zero otherwise.
+      U32 count;
+   };
+
+   struct Counters
+   {
+      /// The number of commands of each type.
+      U32 commands[CmdType_Count];
+
+      /// The number of commands of each type which bound a
+      /// resource that was already bound.
+      U32 redundant[CmdType_Count];
+
+      /// The number of primitives drawn.
+      U32 primitives;
+
+      Counters() { clear(); }
+
+      void clear() { dMemset( this, 0, sizeof( Counters ) ); }
+
+      void add( const Counters &counters );
+
+      /// Returns the total of the redundant commands.
+      U32 getRedundantTotal() const;
+   };
+
+   /// The adapter type reported by recording devices.
+   static GFXAdapterType smEmulatedAdapterType;
+
+   GFXRecordingDevice();
+   virtual ~GFXRecordingDevice();
+
+   static GFXDevice* createInstance( U32 adapterIndex );
+
+   /// Returns the adapter used to create a recording device.  It
+   /// isn't registered with GFXInit so that it is never chosen as
+   /// the fallback for a real device.
+   static GFXAdapter* getRecordingAdapter();
+
+   /// Returns the display name of the command type.
+   static const char* getCommandName( CommandType type );
+
+   /// @name Recording
+   /// @{
+
+   /// Returns the commands recorded in the current or last frame.
+   const Vector<Command>& getFrameCommands() const { return mCommands; }
+
+   /// Returns the counters of the current or last frame.
+   const Counters& getFrameCounters() const { return mFrameCounters; }
+
+   /// Returns the hash of all the commands of the current or last frame.
+   U32 getFrameHash() const { return mFrameHash; }
+
+   /// Returns the counters of all the frames since resetTotals().
+   const Counters& getTotalCounters() const { return mTotalCounters; }
+
+   /// Returns the number of frames since resetTotals().
+   U32 getNumFrames() const { return mNumFrames; }
+
+   void resetTotals();
+
+   /// Writes the commands of the last frame to the console.
+   void dumpFrameCommands() const;
+
+   /// @}
+
+   // GFXDevice
+   virtual GFXAdapterType getAdapterType() { return smEmulatedAdapterType; }
+   virtual F32 getPixelShaderVersion() const { return mPixelShaderVersion; }
+   virtual void setPixelShaderVersion( F32 version ) { mPixelShaderVersion = version; }
+   virtual U32 getNumSamplers() const { return TEXTURE_STAGE_COUNT; }
+   virtual U32 getNumRenderTargets() const { return 4; }
+   virtual GFXShader* createShader();
+   virtual void setShader( GFXShader *shader );
+   virtual void disableShaders();
+   virtual GFXCubemap* createCubemap();
+   virtual GFXTextureTarget* allocRenderToTextureTarget();
+   virtual GFXOcclusionQuery* createOcclusionQuery();
+   virtual void clear( U32 flags, ColorI color, F32 z, U32 stencil );
+   virtual void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount );
+   virtual void drawIndexedPrimitive(  GFXPrimitiveType primType,
+                                       U32 startVertex,
+                                       U32 minIndex,
+                                       U32 numVerts,
+                                       U32 startIndex,
+                                       U32 primitiveCount );
+
+   /// Called by recording cubemaps when they're bound.
+   void _recordCubemap( U32 unit, const GFXCubemap *cubemap, U32 hash );
+
+protected:
+
+   F32 mPixelShaderVersion;
+
+   Vector<Command> mCommands;
+
+   Counters mFrameCounters;
+
+   Counters mTotalCounters;
+
+   U32 mFrameHash;
+
+   U32 mNumFrames;
+
+   /// @name Bound State
+   /// The resources currently bound, used to detect redundant binds.
+   /// @{
+
+   const GFXStateBlock *mBoundStateBlock;
+   const GFXShader *mBoundShader;
+   const GFXShaderConstBuffer *mBoundConsts;
+   const void *mBoundTextures[TEXTURE_STAGE_COUNT];
+   const GFXVertexBuffer *mBoundVertexBuffers[VERTEX_STREAM_COUNT];
+
+   /// @}
+
+   void _record( CommandType type, U32 slot, U32 hash, U32 count, bool redundant );
+
+   void _resetBoundState();
+
+   void _drawCommon( U32 primitiveCount );
+
+   // GFXDevice
+   virtual bool beginSceneInternal();
+   virtual void endSceneInternal();
+   virtual void _updateRenderTargets();
+   virtual GFXStateBlockRef createStateBlockInternal( const GFXStateBlockDesc &desc );
+   virtual void setStateBlockInternal( GFXStateBlock *block, bool force );
+   virtual void setShaderConstBufferInternal( GFXShaderConstBuffer *buffer );
+   virtual void setTextureInternal( U32 textureUnit, const GFXTextureObject *texture );
+   virtual void setVertexStream( U32 stream, GFXVertexBuffer *buffer );
+};
+
+#endif // _GFXRECORDINGDEVICE_H_
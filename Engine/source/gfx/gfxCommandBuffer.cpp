@@ -0,0 +1,249 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "gfx/gfxCommandBuffer.h"
+
+#include "gfx/gfxDevice.h"
+#include "gfx/gfxCubemap.h"
+#include "gfx/gfxVertexBuffer.h"
+#include "gfx/gfxPrimitiveBuffer.h"
+#include "platform/profiler.h"
+#include "platform/threads/thread.h"
+
+
+namespace
+{
+   /// Exposes the protected interface of the vertex 
+   /// buffer handle for filling volatile buffers.
+   class VolatileVBHandle : public GFXVertexBufferHandleBase
+   {
+   public:
+      using GFXVertexBufferHandleBase::set;
+      using GFXVertexBufferHandleBase::lock;
+      using GFXVertexBufferHandleBase::unlock;
+   };
+}
+
+
+GFXCommandBuffer::GFXCommandBuffer()
+{
+   VECTOR_SET_ASSOCIATION( mCommands );
+   VECTOR_SET_ASSOCIATION( mVertexData );
+}
+
+void GFXCommandBuffer::clear()
+{
+   mCommands.clear();
+   mVertexData.clear();
+}
+
+GFXCommandBuffer::Command& GFXCommandBuffer::_addCommand( CommandType type, U32 slot )
+{
+   mCommands.increment();
+   Command &cmd = mCommands.last();
+   cmd.type = type;
+   cmd.slot = slot;
+   cmd.stateBlock = NULL;
+   return cmd;
+}
+
+U32 GFXCommandBuffer::getDrawCount( U32 start, U32 end ) const
+{
+   end = getMin( end, (U32)mCommands.size() );
+
+   U32 count = 0;
+   for ( U32 i = start; i < end; i++ )
+   {
+      const U32 type = mCommands[i].type;
+      if ( type == CmdDrawPrimitive || type == CmdDrawIndexedPrimitive )
+         count++;
+   }
+
+   return count;
+}
+
+void GFXCommandBuffer::setStateBlock( GFXStateBlock *block )
+{
+   _addCommand( CmdSetStateBlock ).stateBlock = block;
+}
+
+void GFXCommandBuffer::setShader( GFXShader *shader )
+{
+   _addCommand( CmdSetShader ).shader = shader;
+}
+
+void GFXCommandBuffer::setShaderConstBuffer( GFXShaderConstBuffer *buffer )
+{
+   _addCommand( CmdSetShaderConstBuffer ).constBuffer = buffer;
+}
+
+void GFXCommandBuffer::setTexture( U32 stage, GFXTextureObject *texture )
+{
+   _addCommand( CmdSetTexture, stage ).texture = texture;
+}
+
+void GFXCommandBuffer::setCubeTexture( U32 stage, GFXCubemap *cubemap )
+{
+   _addCommand( CmdSetCubeTexture, stage ).cubemap = cubemap;
+}
+
+void GFXCommandBuffer::setVertexBuffer( GFXVertexBuffer *buffer, U32 stream, U32 frequency )
+{
+   Command &cmd = _addCommand( CmdSetVertexBuffer, stream );
+   cmd.vertexBuffer = buffer;
+   cmd.args[0] = frequency;
+}
+
+void GFXCommandBuffer::setPrimitiveBuffer( GFXPrimitiveBuffer *buffer )
+{
+   _addCommand( CmdSetPrimitiveBuffer ).primBuffer = buffer;
+}
+
+void GFXCommandBuffer::drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount )
+{
+   Command &cmd = _addCommand( CmdDrawPrimitive );
+   cmd.args[0] = primType;
+   cmd.args[1] = vertexStart;
+   cmd.args[2] = primitiveCount;
+}
+
+void GFXCommandBuffer::drawPrimitive( const GFXPrimitive &prim )
+{
+   drawIndexedPrimitive(   prim.type, 
+                           prim.startVertex,
+                           prim.minIndex, 
+                           prim.numVertices, 
+                           prim.startIndex, 
+                           prim.numPrimitives );
+}
+
+void GFXCommandBuffer::drawIndexedPrimitive(  GFXPrimitiveType primType, 
+                                              U32 startVertex, 
+                                              U32 minIndex, 
+                                              U32 numVerts, 
+                                              U32 startIndex, 
+                                              U32 primitiveCount )
+{
+   Command &cmd = _addCommand( CmdDrawIndexedPrimitive );
+   cmd.args[0] = primType;
+   cmd.args[1] = startVertex;
+   cmd.args[2] = minIndex;
+   cmd.args[3] = numVerts;
+   cmd.args[4] = startIndex;
+   cmd.args[5] = primitiveCount;
+}
+
+void* GFXCommandBuffer::allocVolatileVertices( const GFXVertexFormat *format, U32 vertexSize, U32 numVerts )
+{
+   AssertFatal( numVerts > 0, "GFXCommandBuffer::allocVolatileVertices - Got no vertices!" );
+
+   const U32 offset = mVertexData.size();
+   const U32 bytes = vertexSize * numVerts;
+
+   Command &cmd = _addCommand( CmdSetVolatileVertices );
+   cmd.vertexFormat = format;
+   cmd.args[0] = offset;
+   cmd.args[1] = vertexSize;
+   cmd.args[2] = numVerts;
+
+   mVertexData.setSize( offset + bytes );
+   return mVertexData.address() + offset;
+}
+
+void GFXCommandBuffer::execute( U32 start, U32 end ) const
+{
+   PROFILE_SCOPE( GFXCommandBuffer_execute );
+
+   AssertFatal( ThreadManager::isMainThread(), "GFXCommandBuffer::execute - Must be called on the main thread!" );
+
+   end = getMin( end, (U32)mCommands.size() );
+
+   GFXDevice *device = GFX;
+   VolatileVBHandle vb;
+
+   for ( U32 i = start; i < end; i++ )
+   {
+      const Command &cmd = mCommands[i];
+
+      switch ( cmd.type )
+      {
+         case CmdSetStateBlock:
+            device->setStateBlock( cmd.stateBlock );
+            break;
+
+         case CmdSetShader:
+            device->setShader( cmd.shader );
+            break;
+
+         case CmdSetShaderConstBuffer:
+            device->setShaderConstBuffer( cmd.constBuffer );
+            break;
+
+         case CmdSetTexture:
+            device->setTexture( cmd.slot, cmd.texture );
+            break;
+
+         case CmdSetCubeTexture:
+            device->setCubeTexture( cmd.slot, cmd.cubemap );
+            break;
+
+         case CmdSetVertexBuffer:
+            device->setVertexBuffer( cmd.vertexBuffer, cmd.slot, cmd.args[0] );
+            break;
+
+         case CmdSetVolatileVertices:
+         {
+            const U32 numVerts = cmd.args[2];
+            const U32 bytes = cmd.args[1] * numVerts;
+
+            vb.set( device, numVerts, cmd.vertexFormat, cmd.args[1], GFXBufferTypeVolatile );
+            void *verts = vb.lock( 0, numVerts );
+            if ( verts )
+            {
+               dMemcpy( verts, mVertexData.address() + cmd.args[0], bytes );
+               vb.unlock();
+            }
+
+            device->setVertexBuffer( vb );
+            break;
+         }
+
+         case CmdSetPrimitiveBuffer:
+            device->setPrimitiveBuffer( cmd.primBuffer );
+            break;
+
+         case CmdDrawPrimitive:
+            device->drawPrimitive( (GFXPrimitiveType)cmd.args[0], cmd.args[1], cmd.args[2] );
+            break;
+
+         case CmdDrawIndexedPrimitive:
+            device->drawIndexedPrimitive( (GFXPrimitiveType)cmd.args[0], cmd.args[1], cmd.args[2], cmd.args[3], cmd.args[4], cmd.args[5] );
+            break;
+
+         default:
+            AssertFatal( false, "GFXCommandBuffer::execute - Unknown command!" );
+            break;
+      }
+   }
+}
@@ -0,0 +1,180 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _GFXCOMMANDBUFFER_H_
+#define _GFXCOMMANDBUFFER_H_
+
+#ifndef _GFXENUMS_H_
+#include "gfx/gfxEnums.h"
+#endif
+#ifndef _GFXSTRUCTS_H_
+#include "gfx/gfxStructs.h"
+#endif
+#ifndef _GFXVERTEXFORMAT_H_
+#include "gfx/gfxVertexFormat.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class GFXStateBlock;
+class GFXShader;
+class GFXShaderConstBuffer;
+class GFXTextureObject;
+class GFXCubemap;
+class GFXVertexBuffer;
+class GFXPrimitiveBuffer;
+
+
+/// A list of GFX commands which is recorded without touching the
+/// device and replayed on it later.
+///
+/// Recording only writes to the buffer itself, so buffers can be filled
+/// on worker threads as long as each buffer is recorded by one thread at
+/// a time.  The commands are replayed in the order they were recorded
+/// through the public GFXDevice interface on the main thread, so the
+/// replay works the same on every device.
+///
+/// Resources are stored as plain pointers and are not referenced by the
+/// buffer.  The recorder must make sure they stay alive until the buffer
+/// has been executed, which is the case for everything referenced by the
+/// render instances of the current frame.
+///
+/// Vertex data which is generated while recording is copied into the
+/// buffer and uploaded to a volatile vertex buffer during the replay.
+///
+/// @see RenderBinManager::recordCommands
+class GFXCommandBuffer
+{
+public:
+
+   enum CommandType
+   {
+      CmdSetStateBlock,
+      CmdSetShader,
+      CmdSetShaderConstBuffer,
+      CmdSetTexture,
+      CmdSetCubeTexture,
+      CmdSetVertexBuffer,
+      CmdSetVolatileVertices,
+      CmdSetPrimitiveBuffer,
+      CmdDrawPrimitive,
+      CmdDrawIndexedPrimitive,
+   };
+
+protected:
+
+   struct Command
+   {
+      U32 type;
+
+      /// The texture stage or vertex stream.
+      U32 slot;
+
+      union
+      {
+         GFXStateBlock *stateBlock;
+         GFXShader *shader;
+         GFXShaderConstBuffer *constBuffer;
+         GFXTextureObject *texture;
+         GFXCubemap *cubemap;
+         GFXVertexBuffer *vertexBuffer;
+         const GFXVertexFormat *vertexFormat;
+         GFXPrimitiveBuffer *primBuffer;
+      };
+
+      /// The draw parameters, the vertex stream frequency or
+      /// the offset, size and count of volatile vertices.
+      U32 args[6];
+   };
+
+   Vector<Command> mCommands;
+
+   /// The vertex data of the CmdSetVolatileVertices commands.
+   Vector<U8> mVertexData;
+
+   Command& _addCommand( CommandType type, U32 slot = 0 );
+
+public:
+
+   GFXCommandBuffer();
+
+   /// Removes all the recorded commands.
+   void clear();
+
+   /// Returns the number of recorded commands.  This can be
+   /// used to mark ranges of commands to pass to execute().
+   U32 size() const { return mCommands.size(); }
+
+   bool isEmpty() const { return mCommands.empty(); }
+
+   /// Returns the number of draw commands in the range.
+   U32 getDrawCount( U32 start = 0, U32 end = U32_MAX ) const;
+
+   /// @name Recording
+   /// These mirror the GFXDevice methods of the same name.
+   /// @{
+
+   void setStateBlock( GFXStateBlock *block );
+   void setShader( GFXShader *shader );
+   void setShaderConstBuffer( GFXShaderConstBuffer *buffer );
+   void setTexture( U32 stage, GFXTextureObject *texture );
+   void setCubeTexture( U32 stage, GFXCubemap *cubemap );
+   void setVertexBuffer( GFXVertexBuffer *buffer, U32 stream = 0, U32 frequency = 0 );
+   void setPrimitiveBuffer( GFXPrimitiveBuffer *buffer );
+   void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount );
+   void drawPrimitive( const GFXPrimitive &prim );
+   void drawIndexedPrimitive(  GFXPrimitiveType primType, 
+                               U32 startVertex, 
+                               U32 minIndex, 
+                               U32 numVerts, 
+                               U32 startIndex, 
+                               U32 primitiveCount );
+
+   /// Allocates the vertices of a volatile vertex buffer which is
+   /// created and set on stream zero when the command is replayed.
+   ///
+   /// @param format The vertex format which must stay valid until
+   ///   the buffer has been executed.
+   /// @param vertexSize The size of a vertex in bytes.
+   /// @param numVerts The number of vertices.
+   /// @return The vertex data for the caller to fill in.  It is only
+   ///   valid until the next command is recorded.
+   void* allocVolatileVertices( const GFXVertexFormat *format, U32 vertexSize, U32 numVerts );
+
+   /// A typed helper for allocVolatileVertices().
+   template<class T>
+   T* allocVolatileVertices( U32 numVerts )
+   {
+      return (T*)allocVolatileVertices( getGFXVertexFormat<T>(), sizeof( T ), numVerts );
+   }
+
+   /// @}
+
+   /// Replays the commands in the range [start,end) on the 
+   /// active device.  This must be called on the main thread.
+   void execute( U32 start = 0, U32 end = U32_MAX ) const;
+};
+
+#endif // _GFXCOMMANDBUFFER_H_
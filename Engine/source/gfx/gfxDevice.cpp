@@ -132,6 +132,7 @@ GFXDevice::GFXDevice()
       mCurrentCubemap[i] = NULL;
       mNewCubemap[i] = NULL;
       mTexType[i] = GFXTDT_Normal;
+      mTextureBound[i] = false;
 
       mTextureMatrix[i].identity();
       mTextureMatrixDirty[i] = false;
@@ -284,6 +285,7 @@ GFXDevice::~GFXDevice()
    mCurrentStateBlock = NULL;
 
    mCurrentShaderConstBuffer = NULL;
+   mActiveShaderConstBuffer = NULL;
    /// End Block above BTR
 
    // -- Clear out resource list
@@ -402,8 +404,13 @@ void GFXDevice::updateStates(bool forceSetAll /*=false*/)
                AssertFatal(false, "Unknown texture type!");
                break;
          }
+
+         mTextureBound[i] = true;
       }
 
+      // Make sure the constants are uploaded again.
+      mActiveShaderConstBuffer = NULL;
+
       // Set our material
       setLightMaterialInternal(mCurrentLightMaterial);
 
@@ -504,8 +511,15 @@ void GFXDevice::updateStates(bool forceSetAll /*=false*/)
    // the texture is activated.
    if (mStateBlockDirty)
    {
-      setStateBlockInternal(mNewStateBlock, false);
-      mCurrentStateBlock = mNewStateBlock;
+      // A forced update may have already bound the new block.
+      if ( mNewStateBlock != mCurrentStateBlock )
+      {
+         setStateBlockInternal(mNewStateBlock, false);
+         mCurrentStateBlock = mNewStateBlock;
+      }
+      else
+         mDeviceStatistics.mSkippedStateBlocks++;
+
       mStateBlockDirty = false;
    }
 
@@ -518,6 +532,17 @@ void GFXDevice::updateStates(bool forceSetAll /*=false*/)
             continue;
          mTextureDirty[i] = false;
 
+         // The stage may have been changed and then changed back to
+         // what is already bound before we got here.
+         if (  mTextureBound[i] &&
+               (  mTexType[i] == GFXTDT_Normal ? 
+                  mCurrentTexture[i].getPointer() == mNewTexture[i].getPointer() :
+                  mCurrentCubemap[i].getPointer() == mNewCubemap[i].getPointer() ) )
+         {
+            mDeviceStatistics.mSkippedTextureBinds++;
+            continue;
+         }
+
          switch (mTexType[i])
          {
          case GFXTDT_Normal :
@@ -539,6 +564,8 @@ void GFXDevice::updateStates(bool forceSetAll /*=false*/)
             AssertFatal(false, "Unknown texture type!");
             break;
          }
+
+         mTextureBound[i] = true;
       }
    }
    
@@ -762,6 +789,11 @@ void GFXDevice::setTexture( U32 stage, GFXTextureObject *texture )
    mTexturesDirty = true;
    mTextureDirty[stage] = true;
 
+   // The current cubemap is released below, so the
+   // shadow state no longer describes the stage.
+   if ( mTexType[stage] != GFXTDT_Normal )
+      mTextureBound[stage] = false;
+
    mNewTexture[stage] = texture;
    mTexType[stage] = GFXTDT_Normal;
 
@@ -786,6 +818,9 @@ void GFXDevice::setCubeTexture( U32 stage, GFXCubemap *texture )
    mTexturesDirty = true;
    mTextureDirty[stage] = true;
 
+   if ( mTexType[stage] != GFXTDT_Cube )
+      mTextureBound[stage] = false;
+
    mNewCubemap[stage] = texture;
    mTexType[stage] = GFXTDT_Cube;
 
@@ -433,6 +433,22 @@ protected:
 
    GFXShaderConstBuffer *mCurrentShaderConstBuffer;
 
+   /// @name Shadow State
+   /// The state which was last handed to the internal set methods.  It
+   /// lets updateStates() and _updateShaderConstBuffer() skip binds of
+   /// state the device already has bound.
+   /// @{
+
+   /// Set if mCurrentTexture or mCurrentCubemap, depending on mTexType,
+   /// is what is bound to the stage.  Cleared when the stage changes
+   /// between normal and cube textures.
+   bool mTextureBound[TEXTURE_STAGE_COUNT];
+
+   /// The shader constant buffer which was last activated.
+   GFXShaderConstBufferRef mActiveShaderConstBuffer;
+
+   /// @}
+
    /// A global forced wireframe mode.
    static bool smWireframe;
 
@@ -525,6 +541,25 @@ protected:
    /// Called by base GFXDevice to actually set a const buffer
    virtual void setShaderConstBufferInternal(GFXShaderConstBuffer* buffer) = 0;
 
+   /// Activates the current shader constant buffer unless it is already
+   /// active and no constants were set since.  Devices call this before
+   /// each draw.
+   inline void _updateShaderConstBuffer()
+   {
+      GFXShaderConstBuffer *buffer = mCurrentShaderConstBuffer;
+      if ( !buffer )
+         return;
+
+      if ( buffer == mActiveShaderConstBuffer && !buffer->wasLost() && !buffer->isDirty() )
+      {
+         mDeviceStatistics.mSkippedConstBuffers++;
+         return;
+      }
+
+      setShaderConstBufferInternal( buffer );
+      mActiveShaderConstBuffer = buffer;
+   }
+
    virtual void setTextureInternal(U32 textureUnit, const GFXTextureObject*texture) = 0;
 
    virtual void setLightInternal(U32 lightStage, const GFXLightInfo light, bool lightEnable) = 0;
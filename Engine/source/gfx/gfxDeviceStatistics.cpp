@@ -36,6 +36,12 @@ void GFXDeviceStatistics::setPrefix(const String& prefix)
    vnPolyCount = prefix + "polyCount";
    vnDrawCalls = prefix + "drawCalls";
    vnRenderTargetChanges = prefix + "renderTargetChanges";
+   vnInstancedDrawCalls = prefix + "instancedDrawCalls";
+   vnInstancesDrawn = prefix + "instancesDrawn";
+   vnDrawCallsSaved = prefix + "drawCallsSaved";
+   vnSkippedTextureBinds = prefix + "skippedTextureBinds";
+   vnSkippedStateBlocks = prefix + "skippedStateBlocks";
+   vnSkippedConstBuffers = prefix + "skippedConstBuffers";
 }
 
 /// Clear stats
@@ -44,6 +50,11 @@ void GFXDeviceStatistics::clear()
    mPolyCount = 0;
    mDrawCalls = 0;
    mRenderTargetChanges = 0;
+   mInstancedDrawCalls = 0;
+   mInstancesDrawn = 0;
+   mSkippedTextureBinds = 0;
+   mSkippedStateBlocks = 0;
+   mSkippedConstBuffers = 0;
 }
 
 /// Copy from source (should just be a memcpy, but that may change later) used in 
@@ -54,6 +65,11 @@ void GFXDeviceStatistics::start(GFXDeviceStatistics * source)
    mPolyCount = source->mPolyCount;
    mDrawCalls = source->mDrawCalls;
    mRenderTargetChanges = source->mRenderTargetChanges;
+   mInstancedDrawCalls = source->mInstancedDrawCalls;
+   mInstancesDrawn = source->mInstancesDrawn;
+   mSkippedTextureBinds = source->mSkippedTextureBinds;
+   mSkippedStateBlocks = source->mSkippedStateBlocks;
+   mSkippedConstBuffers = source->mSkippedConstBuffers;
 }
 
 /// Used with start to get a subset of stats on a device.  Basically will do
@@ -63,6 +79,11 @@ void GFXDeviceStatistics::end(GFXDeviceStatistics * source)
    mPolyCount = source->mPolyCount - mPolyCount;
    mDrawCalls = source->mDrawCalls - mDrawCalls;
    mRenderTargetChanges = source->mRenderTargetChanges - mRenderTargetChanges;   
+   mInstancedDrawCalls = source->mInstancedDrawCalls - mInstancedDrawCalls;
+   mInstancesDrawn = source->mInstancesDrawn - mInstancesDrawn;
+   mSkippedTextureBinds = source->mSkippedTextureBinds - mSkippedTextureBinds;
+   mSkippedStateBlocks = source->mSkippedStateBlocks - mSkippedStateBlocks;
+   mSkippedConstBuffers = source->mSkippedConstBuffers - mSkippedConstBuffers;
 }
 
 /// Exports the stats to the console
@@ -71,4 +92,10 @@ void GFXDeviceStatistics::exportToConsole()
    Con::setIntVariable(vnPolyCount, mPolyCount);
    Con::setIntVariable(vnDrawCalls, mDrawCalls);
    Con::setIntVariable(vnRenderTargetChanges, mRenderTargetChanges);
+   Con::setIntVariable(vnInstancedDrawCalls, mInstancedDrawCalls);
+   Con::setIntVariable(vnInstancesDrawn, mInstancesDrawn);
+   Con::setIntVariable(vnDrawCallsSaved, getDrawCallsSaved());
+   Con::setIntVariable(vnSkippedTextureBinds, mSkippedTextureBinds);
+   Con::setIntVariable(vnSkippedStateBlocks, mSkippedStateBlocks);
+   Con::setIntVariable(vnSkippedConstBuffers, mSkippedConstBuffers);
 }
\ No newline at end of file
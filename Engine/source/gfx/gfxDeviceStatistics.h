@@ -35,6 +35,23 @@ public:
    S32 mDrawCalls;
    S32 mRenderTargetChanges;
 
+   /// Number of draw calls which rendered more than one
+   /// instance using hardware instancing.
+   S32 mInstancedDrawCalls;
+
+   /// Total number of instances rendered by the instanced draw calls.
+   S32 mInstancesDrawn;
+
+   /// @name Redundant State
+   /// Number of texture binds, state block changes and shader
+   /// constant buffer activations skipped because the device
+   /// already had the same state bound.
+   /// @{
+   S32 mSkippedTextureBinds;
+   S32 mSkippedStateBlocks;
+   S32 mSkippedConstBuffers;
+   /// @}
+
    GFXDeviceStatistics();
 
    void setPrefix(const String& prefix);
@@ -51,12 +68,28 @@ public:
    /// this->mPolyCount = source->mPolyCount - this->mPolyCount.  (Fancy!)
    void end(GFXDeviceStatistics * source);
 
+   /// Record an instanced draw call which rendered @a instances instances.
+   void addInstancedDraw( U32 instances )
+   {
+      mInstancedDrawCalls++;
+      mInstancesDrawn += instances;
+   }
+
+   /// Returns the number of draw calls saved by instancing.
+   S32 getDrawCallsSaved() const { return mInstancesDrawn - mInstancedDrawCalls; }
+
    /// Exports the stats to the console
    void exportToConsole();
 private:
    String vnPolyCount;
    String vnDrawCalls;
    String vnRenderTargetChanges;
+   String vnInstancedDrawCalls;
+   String vnInstancesDrawn;
+   String vnDrawCallsSaved;
+   String vnSkippedTextureBinds;
+   String vnSkippedStateBlocks;
+   String vnSkippedConstBuffers;
 };
 
 #endif
\ No newline at end of file
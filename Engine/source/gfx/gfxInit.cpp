@@ -25,6 +25,7 @@
 
 #include "gfx/gfxTextureManager.h"
 #include "gfx/gfxAPI.h"
+#include "gfx/Null/gfxRecordingDevice.h"
 #include "console/console.h"
 #include "windowManager/platformWindowMgr.h"
 #include "core/module.h"
@@ -540,3 +541,17 @@ DefineEngineStaticMethod( GFXInit, createNullDevice, void, (),,
  
    newDevice->setAllowRender( false );
 }
+
+DefineEngineStaticMethod( GFXInit, createRecordingDevice, void, (),,
+   "Create a headless device which records the commands submitted to it.\n\n"
+   "Unlike the NULL device, rendering stays enabled so the full render path "
+   "runs.  Used for deterministic CPU-side render benchmarks.\n\n"
+   "@see benchmarkRender" )
+{
+   GFXDevice *newDevice = GFX;
+
+   if(newDevice == NULL)
+      newDevice = GFXInit::createDevice( GFXRecordingDevice::getRecordingAdapter() );
+
+   newDevice->setAllowRender( true );
+}
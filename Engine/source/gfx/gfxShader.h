@@ -149,6 +149,14 @@ public:
    ///
    bool wasLost() const { return mWasLost; }
 
+   /// Returns true if constants were set since the buffer was
+   /// last activated by the device.
+   ///
+   /// The device skips activating a buffer which is already active
+   /// and not dirty.  Buffers which don't track this are always dirty.
+   ///
+   virtual bool isDirty() const { return true; }
+
    /// An inline helper which ensures the handle is valid 
    /// before the virtual set method is called.
    ///
@@ -339,8 +339,7 @@ inline void GFXGLDevice::preDrawPrimitive()
       updateStates();
    }
    
-   if(mCurrentShaderConstBuffer)
-      setShaderConstBufferInternal(mCurrentShaderConstBuffer);
+   _updateShaderConstBuffer();
 }
 
 inline void GFXGLDevice::postDrawPrimitive(U32 primitiveCount)
@@ -131,6 +131,7 @@ GFXGLShaderConstBuffer::GFXGLShaderConstBuffer(GFXGLShader* shader, U32 bufSize,
    mShader = shader;
    mBuffer = new U8[bufSize];
    mWasLost = true;
+   mDirty = true;
 
    // Copy the existing constant buffer to preserve sampler numbers
    /// @warning This preserves a lot more than sampler numbers, obviously. If there
@@ -158,6 +159,7 @@ void GFXGLShaderConstBuffer::internalSet(GFXShaderConstHandle* handle, const Con
    AssertFatal(mShader == _glHandle->mShader, "GFXGLShaderConstBuffer::set - Should only set handles which are owned by our shader");
    
    dMemcpy(mBuffer + _glHandle->mOffset, &param, sizeof(ConstType));
+   mDirty = true;
 }
 
 void GFXGLShaderConstBuffer::set(GFXShaderConstHandle* handle, const F32 fv)
@@ -225,6 +227,7 @@ void GFXGLShaderConstBuffer::internalSet(GFXShaderConstHandle* handle, const Ali
       dMemcpy(mBuffer + _glHandle->mOffset + i * sizeof(ConstType), fvBuffer, sizeof(ConstType));
       fvBuffer += fv.getElementSize();
    }
+   mDirty = true;
 }
 
 void GFXGLShaderConstBuffer::set(GFXShaderConstHandle* handle, const AlignedArray<F32>& fv)
@@ -275,6 +278,7 @@ void GFXGLShaderConstBuffer::set(GFXShaderConstHandle* handle, const MatrixF& ma
 
    GFXGLShaderConstHandle* _glHandle = static_cast<GFXGLShaderConstHandle*>(handle);
    AssertFatal(mShader == _glHandle->mShader, "GFXGLShaderConstBuffer::set - Should only set handles which are owned by our shader");
+   mDirty = true;
    
    switch(matType)
    {
@@ -311,6 +315,7 @@ void GFXGLShaderConstBuffer::set(GFXShaderConstHandle* handle, const MatrixF* ma
 
    GFXGLShaderConstHandle* _glHandle = static_cast<GFXGLShaderConstHandle*>(handle);
    AssertFatal(mShader == _glHandle->mShader, "GFXGLShaderConstBuffer::set - Should only set handles which are owned by our shader");
+   mDirty = true;
    
    switch (matrixType) {
       case GFXSCT_Float4x4:
@@ -326,6 +331,7 @@ void GFXGLShaderConstBuffer::activate()
 {
    mShader->setConstantsFromBuffer(this);
    mWasLost = false;
+   mDirty = false;
 }
 
 const String GFXGLShaderConstBuffer::describeSelf() const
@@ -341,6 +347,7 @@ void GFXGLShaderConstBuffer::onShaderReload( GFXGLShader *shader )
    mBuffer = new U8[mShader->mConstBufferSize];
    dMemset(mBuffer, 0, mShader->mConstBufferSize);
    mWasLost = true;
+   mDirty = true;
 }
 
 GFXGLShader::GFXGLShader() :
@@ -115,6 +115,7 @@ public:
 
    // GFXShaderConstBuffer
    virtual GFXShader* getShader() { return mShader; }
+   virtual bool isDirty() const { return mDirty; }
    virtual void set(GFXShaderConstHandle* handle, const F32 fv);
    virtual void set(GFXShaderConstHandle* handle, const Point2F& fv);
    virtual void set(GFXShaderConstHandle* handle, const Point3F& fv);
@@ -146,6 +147,9 @@ private:
    friend class GFXGLShader;
    U8* mBuffer;
    WeakRefPtr<GFXGLShader> mShader;
+
+   /// Set when constants are set and cleared by activate().
+   bool mDirty;
    
    template<typename ConstType>
    void internalSet(GFXShaderConstHandle* handle, const ConstType& param);
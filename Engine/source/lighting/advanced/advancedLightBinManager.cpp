@@ -33,6 +33,7 @@
 #include "gfx/gfxTransformSaver.h"
 #include "scene/sceneManager.h"
 #include "scene/sceneRenderState.h"
+#include "scene/zones/sceneZoneSpaceManager.h"
 #include "materials/materialManager.h"
 #include "materials/sceneData.h"
 #include "core/util/safeDelete.h"
@@ -47,6 +48,7 @@ const String AdvancedLightBinManager::smBufferName( "lightinfo" );
 ShadowFilterMode AdvancedLightBinManager::smShadowFilterMode = ShadowFilterMode_SoftShadowHighQuality;
 bool AdvancedLightBinManager::smPSSMDebugRender = false;
 bool AdvancedLightBinManager::smUseSSAOMask = false;
+bool AdvancedLightBinManager::smTileCulling = true;
 
 ImplementEnumType( ShadowFilterMode,
    "The shadow filtering modes for Advanced Lighting shadows.\n"
@@ -117,6 +119,7 @@ AdvancedLightBinManager::AdvancedLightBinManager( AdvancedLightManager *lm /* =
                                                  GFXFormat lightBufferFormat /* = GFXFormatR8G8B8A8 */ )
    :  RenderTexTargetBinManager( RIT_LightInfo, 1.0f, 1.0f, lightBufferFormat ), 
       mNumLightsCulled(0), 
+      mMaxTileLights(0),
       mLightManager(lm), 
       mShadowManager(sm),
       mConditioner(NULL)
@@ -168,6 +171,15 @@ void AdvancedLightBinManager::consoleInit()
    Con::addVariable( "$AL::PSSMDebugRender", TypeBool, &smPSSMDebugRender,
       "Enables debug rendering of the PSSM shadows.\n"
       "@ingroup AdvancedLighting\n" );
+
+   Con::addVariable( "$AL::TileCulling", TypeBool, &smTileCulling,
+      "If true, lights are binned into screen tiles before they are rendered and lights "
+      "outside of the view or in hidden zones are skipped.\n"
+      "@ingroup AdvancedLighting\n" );
+
+   Con::addVariable( "$AL::LightTileSize", TypeS32, &LightTileGrid::smTileSize,
+      "The size in pixels of the screen tiles used for light culling.\n"
+      "@ingroup AdvancedLighting\n" );
 }
 
 bool AdvancedLightBinManager::setTargetSize(const Point2I &newTargetSize)
@@ -204,6 +216,7 @@ void AdvancedLightBinManager::addLight( LightInfo *light )
    lEntry.lightInfo = light;
    lEntry.shadowMap = lsm;
    lEntry.lightMaterial = _getLightMaterial( lightType, shadowType, lsp->hasCookieTex() );
+   lEntry.firstTile = 0;
 
    if( lightType == LightInfo::Spot )
       lEntry.vertBuffer = mLightManager->getConeMesh( lEntry.numPrims, lEntry.primBuffer );
@@ -223,9 +236,93 @@ void AdvancedLightBinManager::clearAllLights()
 {
    Con::setIntVariable("lightMetrics::activeLights", mLightBin.size());
    Con::setIntVariable("lightMetrics::culledLights", mNumLightsCulled);
+   Con::setIntVariable("lightMetrics::maxTileLights", mMaxTileLights);
 
    mLightBin.clear();
    mNumLightsCulled = 0;
+   mMaxTileLights = 0;
+}
+
+void AdvancedLightBinManager::_cullLights( const SceneRenderState *state )
+{
+   PROFILE_SCOPE( AdvancedLightBinManager_CullLights );
+
+   if ( !smTileCulling || mLightBin.empty() )
+      return;
+
+   // Skip the lights in zones which aren't visible
+   // or which are hidden behind occluders.
+   const SceneCullingState &cullingState = state->getCullingState();
+   SceneZoneSpaceManager *zoneManager = state->getSceneManager()->getZoneManager();
+
+   Vector<U32> zones;
+   mLightSpheres.clear();
+
+   U32 numLights = 0;
+   for ( U32 i = 0; i < mLightBin.size(); i++ )
+   {
+      const LightInfo *light = mLightBin[i].lightInfo;
+      const SphereF sphere( light->getPosition(), light->getRange().x );
+
+      if ( zoneManager )
+      {
+         const Point3F extents( sphere.radius, sphere.radius, sphere.radius );
+
+         zones.clear();
+         zoneManager->findZones( Box3F( sphere.center - extents, sphere.center + extents ), zones );
+
+         if ( cullingState.isCulled( sphere, zones.address(), zones.size() ) )
+         {
+            mNumLightsCulled++;
+            continue;
+         }
+      }
+
+      mLightBin[ numLights++ ] = mLightBin[i];
+      mLightSpheres.push_back( sphere );
+   }
+
+   mLightBin.setSize( numLights );
+
+   // Bin the remaining lights into screen tiles and
+   // skip the ones which don't touch any tile.
+   if ( mTileGrid.build( state->getCullingFrustum(), state->getViewport(), mLightSpheres.address(), mLightSpheres.size() ) )
+   {
+      numLights = 0;
+      for ( U32 i = 0; i < mLightBin.size(); i++ )
+      {
+         if ( !mTileGrid.isLightVisible( i ) )
+         {
+            mNumLightsCulled++;
+            continue;
+         }
+
+         const LightTileGrid::TileRange &tiles = mTileGrid.getLightTiles( i );
+
+         LightBinEntry &entry = mLightBin[ numLights++ ];
+         entry = mLightBin[i];
+         entry.firstTile = tiles.minY * mTileGrid.getNumTilesX() + tiles.minX;
+      }
+
+      mLightBin.setSize( numLights );
+      mMaxTileLights = getMax( mMaxTileLights, mTileGrid.getMaxTileLightCount() );
+   }
+
+   // Batch the lights by material and then by screen
+   // position so that neighboring lights draw together.
+   mLightBin.sort( _lightBinEntryCmp );
+}
+
+S32 QSORT_CALLBACK AdvancedLightBinManager::_lightBinEntryCmp( const LightBinEntry *a, const LightBinEntry *b )
+{
+   // Keep the point lights ahead of the spot lights.
+   if ( a->lightInfo->getType() != b->lightInfo->getType() )
+      return a->lightInfo->getType() == LightInfo::Point ? -1 : 1;
+
+   if ( a->lightMaterial != b->lightMaterial )
+      return a->lightMaterial < b->lightMaterial ? -1 : 1;
+
+   return S32( a->firstTile ) - S32( b->firstTile );
 }
 
 void AdvancedLightBinManager::render( SceneRenderState *state )
@@ -242,6 +339,9 @@ void AdvancedLightBinManager::render( SceneRenderState *state )
    if( !mLightManager )
       return;
 
+   // Drop the lights which won't be seen.
+   _cullLights( state );
+
    // Get the sunlight. If there's no sun, and no lights in the bins, no draw
    LightInfo *sunLight = mLightManager->getSpecialLight( LightManager::slSunLightType );
    if( !sunLight && mLightBin.empty() )
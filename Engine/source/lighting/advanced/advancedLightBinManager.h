@@ -41,6 +41,9 @@
 #ifndef _SHADOW_COMMON_H_
 #include "lighting/shadowMap/shadowCommon.h"
 #endif
+#ifndef _LIGHTTILEGRID_H_
+#include "lighting/advanced/lightTileGrid.h"
+#endif
 
 
 class AdvancedLightManager;
@@ -71,6 +74,11 @@ public:
 
    virtual bool init( const FeatureSet &features, const GFXVertexFormat *vertexFormat );
    virtual bool setupPass( SceneRenderState *state, const SceneData &sgData );
+
+protected:
+
+   // MatInstance
+   virtual bool _canShareProcessedMaterial() const { return false; }
 };
 
 
@@ -96,6 +104,10 @@ public:
    /// light to compile in the SSAO mask.
    static bool smUseSSAOMask;
 
+   /// If true, lights are binned into screen tiles before rendering
+   /// and lights outside the view or in hidden zones are skipped.
+   static bool smTileCulling;
+
    // Used for console init
    AdvancedLightBinManager( AdvancedLightManager *lm = NULL, 
                             ShadowMapManager *sm = NULL,
@@ -189,6 +201,9 @@ protected:
       GFXPrimitiveBuffer* primBuffer;
       GFXVertexBuffer* vertBuffer;
       U32 numPrims;
+
+      /// The index of the first screen tile touched by the light.
+      U32 firstTile;
    };
 
    Vector<LightBinEntry> mLightBin;
@@ -200,6 +215,23 @@ protected:
    MatrixF mLightMat;
 
    U32 mNumLightsCulled;
+
+   /// The highest number of lights touching a screen tile.
+   U32 mMaxTileLights;
+
+   /// The screen tiles of the lights in the bin.
+   LightTileGrid mTileGrid;
+
+   /// The volumes of the lights in the bin.
+   Vector<SphereF> mLightSpheres;
+
+   /// Removes the lights which are outside of the view or hidden by the
+   /// zone and occlusion culling of the state from the bin, then sorts the
+   /// remaining lights by material and screen position.
+   void _cullLights( const SceneRenderState *state );
+
+   static S32 QSORT_CALLBACK _lightBinEntryCmp( const LightBinEntry *a, const LightBinEntry *b );
+
    AdvancedLightManager *mLightManager;
    ShadowMapManager *mShadowManager;
 
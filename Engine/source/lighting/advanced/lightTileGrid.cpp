@@ -0,0 +1,210 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "lighting/advanced/lightTileGrid.h"
+
+#include "math/util/frustum.h"
+#include "math/mathUtils.h"
+#include "platform/threads/thread.h"
+#include "platform/threads/threadPool.h"
+#include "platform/profiler.h"
+
+
+U32 LightTileGrid::smTileSize = 32;
+U32 LightTileGrid::smMinParallelLights = 32;
+
+
+LightTileGrid::LightTileGrid()
+   :  mWorldToView( true ),
+      mNearDist( 0.0f ),
+      mFarDist( 0.0f ),
+      mMinU( 0.0f ),
+      mMaxV( 0.0f ),
+      mPixelsPerU( 0.0f ),
+      mPixelsPerV( 0.0f ),
+      mNumTilesX( 0 ),
+      mNumTilesY( 0 ),
+      mViewWidth( 0 ),
+      mViewHeight( 0 ),
+      mLights( NULL )
+{
+}
+
+bool LightTileGrid::build( const Frustum &frustum, const RectI &viewport, const SphereF *lights, U32 numLights )
+{
+   PROFILE_SCOPE( LightTileGrid_build );
+
+   mLightRanges.clear();
+   mTileCounts.clear();
+   mNumTilesX = mNumTilesY = 0;
+
+   if (  frustum.isOrtho() || 
+         frustum.getNearDist() <= 0.0f ||
+         viewport.extent.x <= 0 || viewport.extent.y <= 0 ||
+         numLights > U16_MAX )
+      return false;
+
+   const U32 tileSize = getMax( smTileSize, (U32)8 );
+
+   mViewWidth = viewport.extent.x;
+   mViewHeight = viewport.extent.y;
+   mNumTilesX = ( mViewWidth + tileSize - 1 ) / tileSize;
+   mNumTilesY = ( mViewHeight + tileSize - 1 ) / tileSize;
+
+   // The frustum transform goes from view to world space
+   // with x to the right, y forward and z up.
+   mWorldToView = frustum.getTransform();
+   mWorldToView.inverse();
+
+   mNearDist = frustum.getNearDist();
+   mFarDist = frustum.getFarDist();
+
+   mMinU = frustum.getNearLeft() / mNearDist;
+   mMaxV = frustum.getNearTop() / mNearDist;
+   mPixelsPerU = mViewWidth * mNearDist / ( frustum.getNearRight() - frustum.getNearLeft() );
+   mPixelsPerV = mViewHeight * mNearDist / ( frustum.getNearTop() - frustum.getNearBottom() );
+
+   mLights = lights;
+   mLightRanges.setSize( numLights );
+   mTileCounts.setSize( mNumTilesX * mNumTilesY );
+   mTileLights.setSize( mTileCounts.size() * MaxTileLights );
+
+   const bool parallel = numLights >= smMinParallelLights && ThreadManager::isMainThread();
+
+   if ( parallel )
+      ThreadPool::GLOBAL().parallelFor( numLights, 16, _projectLightsJob, this );
+   else
+      _projectLights( 0, numLights );
+
+   // Each row of tiles only writes its own lists, so the
+   // rows can be filled independently of each other.
+   if ( parallel )
+      ThreadPool::GLOBAL().parallelFor( mNumTilesY, 1, _binRowsJob, this );
+   else
+      _binRows( 0, mNumTilesY );
+
+   mLights = NULL;
+
+   return true;
+}
+
+void LightTileGrid::_projectLightsJob( U32 start, U32 end, void *key )
+{
+   static_cast<LightTileGrid*>( key )->_projectLights( start, end );
+}
+
+void LightTileGrid::_binRowsJob( U32 start, U32 end, void *key )
+{
+   static_cast<LightTileGrid*>( key )->_binRows( start, end );
+}
+
+void LightTileGrid::_projectLights( U32 start, U32 end )
+{
+   const U32 tileSize = getMax( smTileSize, (U32)8 );
+   const F32 width = mViewWidth;
+   const F32 height = mViewHeight;
+
+   for ( U32 i = start; i < end; i++ )
+   {
+      const SphereF &light = mLights[i];
+      TileRange &range = mLightRanges[i];
+
+      // Start out with an empty range.
+      range.minX = range.minY = 1;
+      range.maxX = range.maxY = 0;
+
+      Point3F viewCenter;
+      mWorldToView.mulP( light.center, &viewCenter );
+
+      const F32 minDepth = viewCenter.y - light.radius;
+      const F32 maxDepth = viewCenter.y + light.radius;
+
+      if ( maxDepth < mNearDist || minDepth > mFarDist )
+         continue;
+
+      // A light reaching behind the eye covers the whole screen.
+      Point2F minUV, maxUV;
+      if ( !MathUtils::getProjectedSphereExtents( viewCenter, light.radius, &minUV, &maxUV ) )
+      {
+         range.minX = range.minY = 0;
+         range.maxX = mNumTilesX - 1;
+         range.maxY = mNumTilesY - 1;
+         continue;
+      }
+
+      const F32 left = ( minUV.x - mMinU ) * mPixelsPerU;
+      const F32 right = ( maxUV.x - mMinU ) * mPixelsPerU;
+      const F32 top = ( mMaxV - maxUV.y ) * mPixelsPerV;
+      const F32 bottom = ( mMaxV - minUV.y ) * mPixelsPerV;
+
+      if ( right < 0.0f || left >= width || bottom < 0.0f || top >= height )
+         continue;
+
+      range.minX = mClamp( (S32)mFloor( left ) / (S32)tileSize, 0, mNumTilesX - 1 );
+      range.maxX = mClamp( (S32)mFloor( right ) / (S32)tileSize, 0, mNumTilesX - 1 );
+      range.minY = mClamp( (S32)mFloor( top ) / (S32)tileSize, 0, mNumTilesY - 1 );
+      range.maxY = mClamp( (S32)mFloor( bottom ) / (S32)tileSize, 0, mNumTilesY - 1 );
+   }
+}
+
+void LightTileGrid::_binRows( U32 start, U32 end )
+{
+   for ( U32 y = start; y < end; y++ )
+   {
+      U32 *counts = mTileCounts.address() + y * mNumTilesX;
+      U16 *lights = mTileLights.address() + y * mNumTilesX * MaxTileLights;
+
+      dMemset( counts, 0, mNumTilesX * sizeof( U32 ) );
+
+      for ( U32 i = 0; i < mLightRanges.size(); i++ )
+      {
+         const TileRange &range = mLightRanges[i];
+         if ( !range.isValid() || y < range.minY || y > range.maxY )
+            continue;
+
+         for ( U32 x = range.minX; x <= range.maxX; x++ )
+         {
+            U32 &count = counts[x];
+            if ( count < MaxTileLights )
+               lights[ x * MaxTileLights + count ] = i;
+            count++;
+         }
+      }
+   }
+}
+
+const U16* LightTileGrid::getTileLights( U32 x, U32 y, U32 *outCount ) const
+{
+   const U32 tile = y * mNumTilesX + x;
+   *outCount = getMin( mTileCounts[tile], (U32)MaxTileLights );
+   return mTileLights.address() + tile * MaxTileLights;
+}
+
+U32 LightTileGrid::getMaxTileLightCount() const
+{
+   U32 maxCount = 0;
+   for ( U32 i = 0; i < mTileCounts.size(); i++ )
+      maxCount = getMax( maxCount, mTileCounts[i] );
+   return maxCount;
+}
@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _LIGHTTILEGRID_H_
+#define _LIGHTTILEGRID_H_
+
+#ifndef _MMATRIX_H_
+#include "math/mMatrix.h"
+#endif
+#ifndef _MSPHERE_H_
+#include "math/mSphere.h"
+#endif
+#ifndef _MRECT_H_
+#include "math/mRect.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+class Frustum;
+
+
+/// Bins light volumes into screen space tiles.
+///
+/// The screen is split into tiles of #smTileSize pixels.  The projected
+/// bounds of each light sphere are computed first, then the tiles collect
+/// the lights which overlap them.  Both steps run on the global thread pool
+/// when there are enough lights.
+///
+/// Lights which don't overlap any tile are outside of the view and are
+/// reported as not visible.
+class LightTileGrid
+{
+   public:
+
+      enum
+      {
+         /// The maximum number of lights stored per tile.  The
+         /// light counts of the tiles are still exact.
+         MaxTileLights = 64,
+      };
+
+      /// The width and height of the tiles in pixels.
+      static U32 smTileSize;
+
+      /// The minimum number of lights for the grid to be
+      /// built on the global thread pool.
+      static U32 smMinParallelLights;
+
+      /// An inclusive range of tiles.
+      struct TileRange
+      {
+         U16 minX;
+         U16 maxX;
+         U16 minY;
+         U16 maxY;
+
+         /// Returns true if the range contains any tiles.
+         bool isValid() const { return minX <= maxX && minY <= maxY; }
+
+         /// Returns the number of tiles in the range.
+         U32 getNumTiles() const { return isValid() ? ( maxX - minX + 1 ) * ( maxY - minY + 1 ) : 0; }
+      };
+
+   protected:
+
+      /// Transforms world space into the view space of the grid.
+      MatrixF mWorldToView;
+
+      F32 mNearDist;
+      F32 mFarDist;
+
+      /// The x and z over depth ratios at the left and top edges.
+      F32 mMinU;
+      F32 mMaxV;
+
+      /// The number of pixels per unit of the x/y over depth ratios.
+      F32 mPixelsPerU;
+      F32 mPixelsPerV;
+
+      U32 mNumTilesX;
+      U32 mNumTilesY;
+
+      U32 mViewWidth;
+      U32 mViewHeight;
+
+      /// The input light volumes.
+      const SphereF *mLights;
+
+      /// The tiles overlapped by each light.
+      Vector<TileRange> mLightRanges;
+
+      /// The number of lights overlapping each tile.
+      Vector<U32> mTileCounts;
+
+      /// #MaxTileLights light indices per tile.
+      Vector<U16> mTileLights;
+
+      /// Computes the tile ranges of the lights.
+      void _projectLights( U32 start, U32 end );
+
+      /// Fills the light lists of the tile rows.
+      void _binRows( U32 start, U32 end );
+
+      static void _projectLightsJob( U32 start, U32 end, void *key );
+      static void _binRowsJob( U32 start, U32 end, void *key );
+
+   public:
+
+      LightTileGrid();
+
+      /// Bins the light spheres into the tiles of the viewport.  Returns
+      /// false if the grid can't be built for the frustum, in which case
+      /// every light is reported as visible.
+      bool build( const Frustum &frustum, const RectI &viewport, const SphereF *lights, U32 numLights );
+
+      /// Returns true if the light overlaps any of the tiles.
+      bool isLightVisible( U32 light ) const { return light >= mLightRanges.size() || mLightRanges[light].isValid(); }
+
+      /// Returns the tiles overlapped by the light.
+      const TileRange& getLightTiles( U32 light ) const { return mLightRanges[light]; }
+
+      U32 getNumTilesX() const { return mNumTilesX; }
+      U32 getNumTilesY() const { return mNumTilesY; }
+
+      /// Returns the number of lights overlapping the tile.
+      U32 getTileLightCount( U32 x, U32 y ) const { return mTileCounts[ y * mNumTilesX + x ]; }
+
+      /// Returns the lights of the tile.  Only the first #MaxTileLights
+      /// lights are stored if more lights overlap the tile.
+      const U16* getTileLights( U32 x, U32 y, U32 *outCount ) const;
+
+      /// Returns the highest light count of any tile.
+      U32 getMaxTileLightCount() const;
+};
+
+#endif // _LIGHTTILEGRID_H_
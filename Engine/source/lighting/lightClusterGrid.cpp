@@ -0,0 +1,272 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "lighting/lightClusterGrid.h"
+
+#include "lighting/lightInfo.h"
+#include "math/util/frustum.h"
+#include "math/mathUtils.h"
+#include "platform/threads/thread.h"
+#include "platform/threads/threadPool.h"
+#include "platform/profiler.h"
+
+
+bool LightClusterGrid::smEnabled = true;
+U32 LightClusterGrid::smMinParallelLights = 64;
+
+
+LightClusterGrid::LightClusterGrid()
+   :  mIsValid( false ),
+      mWorldToView( true ),
+      mNearDist( 0.0f ),
+      mFarDist( 0.0f ),
+      mMinU( 0.0f ),
+      mMinV( 0.0f ),
+      mTilesPerU( 0.0f ),
+      mTilesPerV( 0.0f ),
+      mSliceScale( 0.0f ),
+      mStamp( 0 )
+{
+}
+
+void LightClusterGrid::clear()
+{
+   mIsValid = false;
+   mGlobalLights.clear();
+   mClusteredLights.clear();
+   mLightRanges.clear();
+}
+
+void LightClusterGrid::build( const Frustum &frustum, const Vector<LightInfo*> &lights )
+{
+   PROFILE_SCOPE( LightClusterGrid_build );
+
+   clear();
+
+   if ( frustum.isOrtho() || frustum.getNearDist() <= 0.0f )
+      return;
+
+   // The frustum transform goes from view to world space
+   // with x to the right, y forward and z up.
+   mWorldToView = frustum.getTransform();
+   mWorldToView.inverse();
+
+   mNearDist = frustum.getNearDist();
+   mFarDist = frustum.getFarDist();
+
+   mMinU = frustum.getNearLeft() / mNearDist;
+   mMinV = frustum.getNearBottom() / mNearDist;
+   mTilesPerU = TilesX * mNearDist / ( frustum.getNearRight() - frustum.getNearLeft() );
+   mTilesPerV = TilesY * mNearDist / ( frustum.getNearTop() - frustum.getNearBottom() );
+   mSliceScale = Slices / mLog( mFarDist / mNearDist );
+
+   // Sort out the lights which go into the clusters.  Point and spot
+   // lights which don't touch the grid can't reach anything inside it.
+   for ( U32 i = 0; i < lights.size(); i++ )
+   {
+      LightInfo *light = lights[i];
+
+      const LightInfo::Type type = light->getType();
+      if ( type != LightInfo::Point && type != LightInfo::Spot )
+      {
+         mGlobalLights.push_back( light );
+         continue;
+      }
+
+      ClusterRange range;
+      if ( !_getClusterRange( light->getPosition(), light->getRange().x, true, &range ) )
+         continue;
+
+      mClusteredLights.push_back( light );
+      mLightRanges.push_back( range );
+   }
+
+   // The clusters store 16bit light indices.
+   if ( mClusteredLights.size() > U16_MAX )
+      return;
+
+   mClusterCounts.setSize( NumClusters );
+   dMemset( mClusterCounts.address(), 0, mClusterCounts.memSize() );
+   mClusterLights.setSize( NumClusters * MaxClusterLights );
+
+   mLightStamps.setSize( mClusteredLights.size() );
+   dMemset( mLightStamps.address(), 0, mLightStamps.memSize() );
+   mStamp = 0;
+
+   // Each slice only writes to its own clusters, so the
+   // slices can be filled independently of each other.
+   if (  mClusteredLights.size() >= smMinParallelLights &&
+         ThreadManager::isMainThread() )
+      ThreadPool::GLOBAL().parallelFor( Slices, 1, _buildSlicesJob, this );
+   else
+      _buildSlices( 0, Slices );
+
+   mIsValid = true;
+}
+
+void LightClusterGrid::_buildSlicesJob( U32 start, U32 end, void *key )
+{
+   static_cast<LightClusterGrid*>( key )->_buildSlices( start, end );
+}
+
+void LightClusterGrid::_buildSlices( U32 start, U32 end )
+{
+   for ( U32 i = 0; i < mLightRanges.size(); i++ )
+   {
+      const ClusterRange &range = mLightRanges[i];
+
+      const U32 minSlice = getMax( start, (U32)range.minSlice );
+      const U32 maxSlice = getMin( end - 1, (U32)range.maxSlice );
+
+      for ( U32 slice = minSlice; slice <= maxSlice; slice++ )
+      {
+         for ( U32 y = range.minY; y <= range.maxY; y++ )
+         {
+            const U32 rowIndex = ( slice * TilesY + y ) * TilesX;
+
+            for ( U32 x = range.minX; x <= range.maxX; x++ )
+            {
+               const U32 cluster = rowIndex + x;
+               U8 &count = mClusterCounts[cluster];
+
+               if ( count < MaxClusterLights )
+                  mClusterLights[ cluster * MaxClusterLights + count++ ] = i;
+               else
+                  count = MaxClusterLights + 1;
+            }
+         }
+      }
+   }
+}
+
+U32 LightClusterGrid::_getSlice( F32 depth ) const
+{
+   if ( depth <= mNearDist )
+      return 0;
+
+   const S32 slice = (S32)mFloor( mLog( depth / mNearDist ) * mSliceScale );
+   return mClamp( slice, 0, Slices - 1 );
+}
+
+bool LightClusterGrid::_getClusterRange( const Point3F &center, F32 radius, bool clamp, ClusterRange *outRange ) const
+{
+   Point3F viewCenter;
+   mWorldToView.mulP( center, &viewCenter );
+
+   const F32 minDepth = viewCenter.y - radius;
+   const F32 maxDepth = viewCenter.y + radius;
+
+   if ( maxDepth < mNearDist || minDepth > mFarDist )
+      return false;
+   if ( !clamp && ( minDepth < mNearDist || maxDepth > mFarDist ) )
+      return false;
+
+   outRange->minSlice = _getSlice( minDepth );
+   outRange->maxSlice = _getSlice( maxDepth );
+
+   // A box reaching behind the eye projects onto the whole
+   // near plane.  Only clamped ranges can get here.
+   Point2F minUV, maxUV;
+   if ( !MathUtils::getProjectedSphereExtents( viewCenter, radius, &minUV, &maxUV ) )
+   {
+      outRange->minX = 0;
+      outRange->maxX = TilesX - 1;
+      outRange->minY = 0;
+      outRange->maxY = TilesY - 1;
+      return true;
+   }
+
+   const F32 minTileX = ( minUV.x - mMinU ) * mTilesPerU;
+   const F32 maxTileX = ( maxUV.x - mMinU ) * mTilesPerU;
+   const F32 minTileY = ( minUV.y - mMinV ) * mTilesPerV;
+   const F32 maxTileY = ( maxUV.y - mMinV ) * mTilesPerV;
+
+   if ( maxTileX < 0.0f || minTileX > TilesX || maxTileY < 0.0f || minTileY > TilesY )
+      return false;
+   if ( !clamp && ( minTileX < 0.0f || maxTileX > TilesX || minTileY < 0.0f || maxTileY > TilesY ) )
+      return false;
+
+   outRange->minX = mClamp( (S32)mFloor( minTileX ), 0, TilesX - 1 );
+   outRange->maxX = mClamp( (S32)mFloor( maxTileX ), 0, TilesX - 1 );
+   outRange->minY = mClamp( (S32)mFloor( minTileY ), 0, TilesY - 1 );
+   outRange->maxY = mClamp( (S32)mFloor( maxTileY ), 0, TilesY - 1 );
+
+   return true;
+}
+
+bool LightClusterGrid::getLights( const SphereF &volume, Vector<LightInfo*> *outLights ) const
+{
+   PROFILE_SCOPE( LightClusterGrid_getLights );
+
+   if ( !mIsValid )
+      return false;
+
+   ClusterRange range;
+   if ( !_getClusterRange( volume.center, volume.radius, false, &range ) )
+      return false;
+
+   // Reset the stamps when the counter wraps around.
+   if ( ++mStamp == 0 )
+   {
+      dMemset( mLightStamps.address(), 0, mLightStamps.memSize() );
+      mStamp = 1;
+   }
+
+   const U32 startSize = outLights->size();
+
+   for ( U32 slice = range.minSlice; slice <= range.maxSlice; slice++ )
+   {
+      for ( U32 y = range.minY; y <= range.maxY; y++ )
+      {
+         const U32 rowIndex = ( slice * TilesY + y ) * TilesX;
+
+         for ( U32 x = range.minX; x <= range.maxX; x++ )
+         {
+            const U32 cluster = rowIndex + x;
+            const U32 count = mClusterCounts[cluster];
+
+            if ( count > MaxClusterLights )
+            {
+               outLights->setSize( startSize );
+               return false;
+            }
+
+            const U16 *indices = mClusterLights.address() + cluster * MaxClusterLights;
+            for ( U32 i = 0; i < count; i++ )
+            {
+               const U32 index = indices[i];
+               if ( mLightStamps[index] == mStamp )
+                  continue;
+
+               mLightStamps[index] = mStamp;
+               outLights->push_back( mClusteredLights[index] );
+            }
+         }
+      }
+   }
+
+   outLights->merge( mGlobalLights );
+
+   return true;
+}
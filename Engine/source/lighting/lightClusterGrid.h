@@ -0,0 +1,181 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _LIGHTCLUSTERGRID_H_
+#define _LIGHTCLUSTERGRID_H_
+
+#ifndef _MMATRIX_H_
+#include "math/mMatrix.h"
+#endif
+
+#ifndef _MSPHERE_H_
+#include "math/mSphere.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class Frustum;
+class LightInfo;
+
+
+/// A grid of view space clusters which stores the point and spot lights
+/// touching each cluster.
+///
+/// The grid is built once per view from the registered lights.  Light
+/// queries for objects inside the view frustum then only look at the lights
+/// stored in the clusters the object touches instead of scoring every light
+/// in the scene.
+///
+/// The clusters split the view frustum into #TilesX by #TilesY tiles across
+/// the near plane and #Slices exponentially spaced depth slices.  Lights are
+/// added to every cluster their bounds touch, so the lights returned for a
+/// volume are a conservative superset of the lights which reach it.
+///
+/// Lights which aren't point or spot lights, like the sun, are returned by
+/// every query.
+class LightClusterGrid
+{
+   public:
+
+      enum
+      {
+         TilesX = 16,
+         TilesY = 8,
+         Slices = 24,
+         NumClusters = TilesX * TilesY * Slices,
+
+         /// The maximum number of lights stored in a cluster.  Queries
+         /// touching a cluster with more lights fail.
+         MaxClusterLights = 32,
+      };
+
+      /// If false, the grid isn't built and light queries score
+      /// every registered light.
+      static bool smEnabled;
+
+      /// The minimum number of clustered lights for the slices to
+      /// be built in parallel on the global thread pool.
+      static U32 smMinParallelLights;
+
+   protected:
+
+      /// An inclusive range of clusters.
+      struct ClusterRange
+      {
+         U8 minX;
+         U8 maxX;
+         U8 minY;
+         U8 maxY;
+         U8 minSlice;
+         U8 maxSlice;
+      };
+
+      /// True if the grid was built for the current view.
+      bool mIsValid;
+
+      /// Transforms world space into the view space of the grid.
+      MatrixF mWorldToView;
+
+      F32 mNearDist;
+      F32 mFarDist;
+
+      /// The x/y over depth ratio at the left and bottom edges.
+      F32 mMinU;
+      F32 mMinV;
+
+      /// The number of tiles per unit of the x/y over depth ratios.
+      F32 mTilesPerU;
+      F32 mTilesPerV;
+
+      /// Converts the log of depth over near distance into slices.
+      F32 mSliceScale;
+
+      /// Lights which are returned by every query.
+      Vector<LightInfo*> mGlobalLights;
+
+      /// The point and spot lights touching the grid.
+      Vector<LightInfo*> mClusteredLights;
+
+      /// The clusters touched by each of the #mClusteredLights.
+      Vector<ClusterRange> mLightRanges;
+
+      /// The number of lights in each cluster or one more
+      /// than #MaxClusterLights if the cluster overflowed.
+      Vector<U8> mClusterCounts;
+
+      /// #MaxClusterLights indices into #mClusteredLights per cluster.
+      Vector<U16> mClusterLights;
+
+      /// The last query which returned each of the clustered
+      /// lights, used to skip lights found in several clusters.
+      mutable Vector<U32> mLightStamps;
+      mutable U32 mStamp;
+
+      /// Returns the clusters touched by a sphere in world space.
+      ///
+      /// If @a clamp is true, ranges are clamped to the grid and false
+      /// is only returned for spheres which are entirely outside of it.
+      /// Otherwise false is returned for any sphere which isn't entirely
+      /// inside the grid.
+      bool _getClusterRange( const Point3F &center, F32 radius, bool clamp, ClusterRange *outRange ) const;
+
+      /// Returns the slice containing the view depth.
+      U32 _getSlice( F32 depth ) const;
+
+      /// Adds the lights to the clusters of the slices.
+      void _buildSlices( U32 start, U32 end );
+
+      static void _buildSlicesJob( U32 start, U32 end, void *key );
+
+   public:
+
+      LightClusterGrid();
+
+      /// Builds the grid for the view frustum and the lights.  Nothing is
+      /// built for orthographic frustums.
+      void build( const Frustum &frustum, const Vector<LightInfo*> &lights );
+
+      /// Invalidates the grid.
+      void clear();
+
+      /// Returns true if the grid was built.
+      bool isValid() const { return mIsValid; }
+
+      /// Returns the number of point and spot lights in the grid.
+      U32 getNumClusteredLights() const { return mClusteredLights.size(); }
+
+      /// Appends the lights which may reach the volume to the list.
+      ///
+      /// Returns false without changing the list if the grid wasn't built,
+      /// the volume isn't entirely inside of the view frustum or it touches
+      /// a cluster which overflowed.  All the lights need to be considered
+      /// in that case.
+      ///
+      /// This isn't thread safe.
+      bool getLights( const SphereF &volume, Vector<LightInfo*> *outLights ) const;
+};
+
+#endif // _LIGHTCLUSTERGRID_H_
@@ -33,14 +33,18 @@
 #include "materials/sceneData.h"
 #include "lighting/lightInfo.h"
 #include "lighting/lightingInterfaces.h"
+#include "lighting/lightProbeGrid.h"
 #include "T3D/gameBase/gameConnection.h"
 #include "gfx/gfxStringEnumTranslate.h"
 #include "console/engineAPI.h"
 #include "renderInstance/renderPrePassMgr.h"
+#include "scene/culling/sceneCullingState.h"
+#include "scene/zones/sceneZoneSpaceManager.h"
 
 
 Signal<void(const char*,bool)> LightManager::smActivateSignal;
 LightManager *LightManager::smActiveLM = NULL;
+bool LightManager::smCullLightsByZone = true;
 
 
 LightManager::LightManager( const char *name, const char *id )
@@ -50,7 +54,8 @@ LightManager::LightManager( const char *name, const char *id )
       mSceneManager( NULL ),
       mDefaultLight( NULL ),
       mAvailableSLInterfaces( NULL ),
-      mCullPos( Point3F::Zero )
+      mCullPos( Point3F::Zero ),
+      mNumZoneCulledLights( 0 )
 { 
    _getLightManagers().insert( mName, this );
 
@@ -198,7 +203,7 @@ void LightManager::setSpecialLight( LightManager::SpecialLightTypesEnum type, Li
    registerGlobalLight( light, NULL );
 }
 
-void LightManager::registerGlobalLights( const Frustum *frustum, bool staticLighting )
+void LightManager::registerGlobalLights( const Frustum *frustum, bool staticLighting, const SceneCullingState *cullingState )
 {
    PROFILE_SCOPE( LightManager_RegisterGlobalLights );
 
@@ -236,11 +241,33 @@ void LightManager::registerGlobalLights( const Frustum *frustum, bool staticLigh
       // the shape bounds and can often get culled.
 
       GameConnection *conn = GameConnection::getConnectionToServer();
-      if ( conn->getControlObject() )
+      GameBase *conObject = conn->getControlObject();
+
+      // Skip the lights which can't reach any of the zones
+      // visible through the portals.
+      if (  cullingState && 
+            smCullLightsByZone &&
+            !cullingState->disableZoneCulling() &&
+            getSceneManager()->getZoneManager() &&
+            getSceneManager()->getZoneManager()->getNumActiveZones() > 1 )
       {
-         GameBase *conObject = conn->getControlObject();
-         activeLights.push_back_unique( conObject );
+         PROFILE_SCOPE( LightManager_RegisterGlobalLights_ZoneCull );
+
+         for ( U32 i = 0; i < activeLights.size(); )
+         {
+            if (  activeLights[i] != conObject &&
+                  _isLightZoneCulled( activeLights[i], *cullingState ) )
+            {
+               activeLights.erase_fast( i );
+               mNumZoneCulledLights++;
+            }
+            else
+               i++;
+         }
       }
+
+      if ( conObject )
+         activeLights.push_back_unique( conObject );
    }
 
    // Let the lights register themselves.
@@ -250,6 +277,26 @@ void LightManager::registerGlobalLights( const Frustum *frustum, bool staticLigh
       if ( lightInterface )
          lightInterface->submitLights( this, staticLighting );
    }
+
+   // Cluster the lights for the light queries of the view.
+   if ( !staticLighting && frustum && LightClusterGrid::smEnabled )
+      mClusterGrid.build( *frustum, mRegisteredLights );
+}
+
+bool LightManager::_isLightZoneCulled( SceneObject *lightObject, const SceneCullingState &cullingState )
+{
+   // Global lights like the sun reach every zone.
+   if ( lightObject->isGlobalBounds() )
+      return false;
+
+   // The zone manager keeps lights in the outdoor zone, so
+   // look up the zones overlapped by the light bounds here.
+   const Box3F &lightBox = lightObject->getWorldBox();
+
+   mLightZones.clear();
+   const U32 numZones = getSceneManager()->getZoneManager()->findZones( lightBox, mLightZones );
+
+   return cullingState.isCulled( lightBox, mLightZones.address(), numZones );
 }
 
 void LightManager::registerGlobalLight( LightInfo *light, SimObject *obj )
@@ -258,11 +305,15 @@ void LightManager::registerGlobalLight( LightInfo *light, SimObject *obj )
       "LightManager::registerGlobalLight - This light is already registered!" );
 
    mRegisteredLights.push_back( light );
+
+   // The grid doesn't know about the light.
+   mClusterGrid.clear();
 }
 
 void LightManager::unregisterGlobalLight( LightInfo *light )
 {
    mRegisteredLights.unregisterLight( light );
+   mClusterGrid.clear();
 
    // If this is the sun... clear the special light too.
    if ( light == mSpecialLights[slSunLightType] )
@@ -281,8 +332,12 @@ void LightManager::unregisterLocalLight( LightInfo *light )
 
 void LightManager::unregisterAllLights()
 {
+   Con::setIntVariable( "lightMetrics::zoneCulledLights", mNumZoneCulledLights );
+   mNumZoneCulledLights = 0;
+
    dMemset( mSpecialLights, 0, sizeof( mSpecialLights ) );
    mRegisteredLights.clear();
+   mClusterGrid.clear();
 }
 
 void LightManager::getAllUnsortedLights( Vector<LightInfo*> *list ) const
@@ -290,6 +345,11 @@ void LightManager::getAllUnsortedLights( Vector<LightInfo*> *list ) const
    list->merge( mRegisteredLights );
 }
 
+bool LightManager::getClusteredLights( const SphereF &volume, Vector<LightInfo*> *list ) const
+{
+   return LightClusterGrid::smEnabled && mClusterGrid.getLights( volume, list );
+}
+
 void LightManager::_update4LightConsts(   const SceneData &sgData,
                                           GFXShaderConstHandle *lightPositionSC,
                                           GFXShaderConstHandle *lightDiffuseSC,
@@ -394,7 +454,14 @@ void LightManager::_update4LightConsts(   const SceneData &sgData,
    // light which is the directional light if 
    // one exists at all in the scene.
    if ( lightAmbientSC->isValid() )
-      shaderConsts->set( lightAmbientSC, sgData.ambientLightColor );
+   {
+      // Objects inside of a baked probe grid get
+      // their ambient from the probes around them.
+      ColorF ambient = sgData.ambientLightColor;
+      LightProbeGrid::findAmbient( sgData.objTrans->getPosition(), &ambient );
+
+      shaderConsts->set( lightAmbientSC, ambient );
+   }
 }
 
 AvailableSLInterfaces* LightManager::getSceneLightingInterface()
@@ -35,6 +35,9 @@
 #ifndef _LIGHTQUERY_H_
 #include "lighting/lightQuery.h"
 #endif
+#ifndef _LIGHTCLUSTERGRID_H_
+#include "lighting/lightClusterGrid.h"
+#endif
 
 class SimObject;
 class LightManager;
@@ -51,6 +54,7 @@ class ShaderConstHandles;
 class SceneRenderState;
 class RenderPrePassMgr;
 class Frustum;
+class SceneCullingState;
 
 ///
 typedef Map<String,LightManager*> LightManagerMap;
@@ -66,6 +70,10 @@ public:
       slSpecialLightTypesCount
    };
 
+   /// If true, registerGlobalLights() skips the lights whose bounds
+   /// don't reach any of the zones visible in the culling state.
+   static bool smCullLightsByZone;
+
    LightManager( const char *name, const char *id );
 
    virtual ~LightManager();
@@ -134,12 +142,29 @@ public:
    virtual void registerLocalLight( LightInfo *light );
    virtual void unregisterLocalLight( LightInfo *light );
 
-   virtual void registerGlobalLights( const Frustum *frustum, bool staticlighting );
+   /// Registers the lights in the frustum or all the lights for
+   /// static lighting.
+   ///
+   /// If a culling state with traversed zones is passed, lights whose
+   /// bounds are culled in all the zones they overlap aren't registered.
+   virtual void registerGlobalLights( const Frustum *frustum, 
+                                      bool staticlighting, 
+                                      const SceneCullingState *cullingState = NULL );
    virtual void unregisterAllLights();
 
    /// Returns all unsorted and un-scored lights (both global and local).
    void getAllUnsortedLights( Vector<LightInfo*> *list ) const;
 
+   /// Returns the unsorted and un-scored lights which may reach the
+   /// volume using the clustered light grid of the current view.
+   ///
+   /// Returns false if the grid can't answer the query, in which case
+   /// getAllUnsortedLights() should be used instead.
+   bool getClusteredLights( const SphereF &volume, Vector<LightInfo*> *list ) const;
+
+   /// Returns the clustered light grid of the current view.
+   const LightClusterGrid& getClusterGrid() const { return mClusterGrid; }
+
    /// Sets shader constants / textures for light infos
    virtual void setLightInfo( ProcessedMaterial *pmat, 
                               const Material *mat, 
@@ -189,6 +214,10 @@ protected:
    /// initialized before the scene is rendered.
    LightInfoList mRegisteredLights;
 
+   /// The clustered light grid built from the registered
+   /// lights for the frustum passed to registerGlobalLights().
+   LightClusterGrid mClusterGrid;
+
    /// The registered special light list.
    LightInfo *mSpecialLights[slSpecialLightTypesCount];
 
@@ -197,6 +226,17 @@ protected:
    /// @see setSpecialLight
    Point3F mCullPos;
 
+   /// The number of lights skipped by zone culling
+   /// since the lights were last unregistered.
+   U32 mNumZoneCulledLights;
+
+   /// The zones overlapped by the light being zone culled.
+   Vector<U32> mLightZones;
+
+   /// Returns true if the light object's bounds are culled in
+   /// all the zones they overlap.
+   bool _isLightZoneCulled( SceneObject *lightObject, const SceneCullingState &cullingState );
+
    /// The scene lighting interfaces for 
    /// lightmap generation.
    AvailableSLInterfaces *mAvailableSLInterfaces;
@@ -0,0 +1,357 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "lighting/lightProbeGrid.h"
+
+#include "lighting/lightInfo.h"
+#include "scene/sceneContainer.h"
+#include "collision/collision.h"
+#include "core/stream/stream.h"
+#include "math/mathIO.h"
+#include "console/console.h"
+#include "platform/profiler.h"
+
+
+bool LightProbeGrid::smEnabled = true;
+Vector<LightProbeGrid*> LightProbeGrid::smGrids;
+
+static const U32 smProbeFileTag = makeFourCCTag( 'L', 'P', 'G', 'R' );
+static const U32 smProbeFileVersion = 1;
+
+
+LightProbeGrid::BakeParams::BakeParams()
+   :  raysPerProbe( 64 ),
+      rayLength( 100.0f ),
+      rayMask( 0 ),
+      albedo( 0.4f, 0.4f, 0.4f ),
+      sun( NULL )
+{
+}
+
+LightProbeGrid::LightProbeGrid()
+   :  mBounds( Box3F::Zero ),
+      mSpacing( Point3F::Zero )
+{
+   mSize[0] = mSize[1] = mSize[2] = 0;
+}
+
+LightProbeGrid::~LightProbeGrid()
+{
+   unregisterGrid();
+}
+
+void LightProbeGrid::setBounds( const Box3F &bounds, F32 spacing )
+{
+   AssertFatal( spacing > 0.0f, "LightProbeGrid::setBounds - The spacing must be positive!" );
+
+   mBounds = bounds;
+
+   const Point3F extents = bounds.getExtents();
+   for ( U32 i = 0; i < 3; i++ )
+   {
+      // Always place probes on both sides of each axis so
+      // that samples can be interpolated.
+      const F32 extent = mMax( extents[i], 0.0f );
+      mSize[i] = mClamp( (S32)mCeil( extent / spacing ) + 1, 2, (S32)MaxProbesPerAxis );
+      mSpacing[i] = extent / ( mSize[i] - 1 );
+   }
+
+   Probe probe;
+   probe.skyVisibility = 1.0f;
+   probe.bounce = ColorF( 0.0f, 0.0f, 0.0f, 0.0f );
+
+   mProbes.setSize( mSize[0] * mSize[1] * mSize[2] );
+   for ( U32 i = 0; i < mProbes.size(); i++ )
+      mProbes[i] = probe;
+}
+
+Point3F LightProbeGrid::_getProbePosition( U32 x, U32 y, U32 z ) const
+{
+   return mBounds.minExtents + Point3F( x * mSpacing.x, y * mSpacing.y, z * mSpacing.z );
+}
+
+void LightProbeGrid::bake( SceneContainer *container, const BakeParams &params )
+{
+   PROFILE_SCOPE( LightProbeGrid_bake );
+
+   AssertFatal( container, "LightProbeGrid::bake - Got no container!" );
+
+   const U32 numRays = mMax( params.raysPerProbe, (U32)4 );
+   const U32 startTime = Platform::getRealMilliseconds();
+
+   // Spread the ray directions evenly over the sphere
+   // with a spherical Fibonacci lattice.
+   Vector<Point3F> dirs;
+   dirs.setSize( numRays );
+   U32 numUpperRays = 0;
+   for ( U32 i = 0; i < numRays; i++ )
+   {
+      const F32 z = 1.0f - ( 2.0f * i + 1.0f ) / numRays;
+      const F32 r = mSqrt( mMax( 1.0f - z * z, 0.0f ) );
+      const F32 phi = i * 2.39996323f;
+      dirs[i].set( mCos( phi ) * r, mSin( phi ) * r, z );
+
+      if ( z > 0.0f )
+         numUpperRays++;
+   }
+
+   // The light arriving at the surfaces hit by the rays.
+   ColorF sunColor( 0.0f, 0.0f, 0.0f );
+   ColorF skyColor( 0.0f, 0.0f, 0.0f );
+   Point3F toSun( 0.0f, 0.0f, 1.0f );
+   if ( params.sun )
+   {
+      sunColor = params.sun->getColor() * params.sun->getBrightness();
+      skyColor = params.sun->getAmbient();
+      toSun = -params.sun->getDirection();
+      toSun.normalizeSafe();
+   }
+
+   Vector<Point3F> starts;
+   Vector<Point3F> ends;
+   Vector<RayInfo> infos;
+   Vector<bool> hits;
+   starts.setSize( numRays );
+   ends.setSize( numRays );
+   infos.setSize( numRays );
+   hits.setSize( numRays );
+
+   Vector<Point3F> shadowStarts;
+   Vector<Point3F> shadowEnds;
+   Vector<RayInfo> shadowInfos;
+   Vector<bool> shadowHits;
+   Vector<U32> shadowRays;
+   shadowStarts.setSize( numRays );
+   shadowEnds.setSize( numRays );
+   shadowInfos.setSize( numRays );
+   shadowHits.setSize( numRays );
+   shadowRays.setSize( numRays );
+
+   for ( U32 z = 0; z < mSize[2]; z++ )
+   {
+      for ( U32 y = 0; y < mSize[1]; y++ )
+      {
+         for ( U32 x = 0; x < mSize[0]; x++ )
+         {
+            const Point3F pos = _getProbePosition( x, y, z );
+            for ( U32 i = 0; i < numRays; i++ )
+            {
+               starts[i] = pos;
+               ends[i] = pos + dirs[i] * params.rayLength;
+            }
+
+            container->castRays( numRays, starts.address(), ends.address(), params.rayMask, infos.address(), hits.address() );
+
+            // Cast shadow rays towards the sun from the front
+            // facing surfaces which were hit.
+            U32 numUpperMisses = 0;
+            U32 numShadowRays = 0;
+            for ( U32 i = 0; i < numRays; i++ )
+            {
+               if ( !hits[i] )
+               {
+                  if ( dirs[i].z > 0.0f )
+                     numUpperMisses++;
+                  continue;
+               }
+
+               if ( !params.sun || mDot( infos[i].normal, dirs[i] ) >= 0.0f || mDot( infos[i].normal, toSun ) <= 0.0f )
+                  continue;
+
+               shadowStarts[numShadowRays] = infos[i].point + infos[i].normal * 0.05f;
+               shadowEnds[numShadowRays] = shadowStarts[numShadowRays] + toSun * params.rayLength;
+               shadowRays[numShadowRays] = i;
+               numShadowRays++;
+            }
+
+            if ( numShadowRays )
+               container->castRays( numShadowRays, shadowStarts.address(), shadowEnds.address(), params.rayMask, shadowInfos.address(), shadowHits.address() );
+
+            // Every front facing hit reflects the sky light and
+            // the sun light if it isn't in shadow.
+            ColorF bounce( 0.0f, 0.0f, 0.0f, 0.0f );
+            for ( U32 i = 0; i < numRays; i++ )
+            {
+               if ( hits[i] && mDot( infos[i].normal, dirs[i] ) < 0.0f )
+                  bounce += skyColor;
+            }
+            for ( U32 i = 0; i < numShadowRays; i++ )
+            {
+               if ( !shadowHits[i] )
+                  bounce += sunColor * mDot( infos[ shadowRays[i] ].normal, toSun );
+            }
+
+            Probe &probe = mProbes[ _getIndex( x, y, z ) ];
+            probe.skyVisibility = numUpperRays ? F32( numUpperMisses ) / numUpperRays : 1.0f;
+            probe.bounce = bounce * params.albedo / F32( numRays );
+            probe.bounce.alpha = 0.0f;
+         }
+      }
+   }
+
+   Con::printf( "LightProbeGrid::bake - Baked %d probes with %d rays each in %dms.",
+      mProbes.size(), numRays, Platform::getRealMilliseconds() - startTime );
+}
+
+bool LightProbeGrid::sampleAmbient( const Point3F &pos, const ColorF &sceneAmbient, ColorF *outAmbient ) const
+{
+   if ( mProbes.empty() || !mBounds.isContained( pos ) )
+      return false;
+
+   // Find the cell and the position within it.
+   U32 cell[3];
+   F32 frac[3];
+   F32 fade = 1.0f;
+   for ( U32 i = 0; i < 3; i++ )
+   {
+      const F32 offset = pos[i] - mBounds.minExtents[i];
+      const F32 coord = mSpacing[i] > 0.0f ? offset / mSpacing[i] : 0.0f;
+      cell[i] = mClamp( (S32)coord, 0, (S32)mSize[i] - 2 );
+      frac[i] = mClampF( coord - cell[i], 0.0f, 1.0f );
+
+      if ( mSpacing[i] > 0.0f )
+      {
+         const F32 edgeDist = getMin( offset, mBounds.maxExtents[i] - pos[i] );
+         fade = getMin( fade, edgeDist / mSpacing[i] );
+      }
+   }
+
+   // Trilinearly interpolate the eight probes around the point.
+   F32 skyVisibility = 0.0f;
+   ColorF bounce( 0.0f, 0.0f, 0.0f, 0.0f );
+   for ( U32 i = 0; i < 8; i++ )
+   {
+      const U32 dx = i & 1;
+      const U32 dy = ( i >> 1 ) & 1;
+      const U32 dz = ( i >> 2 ) & 1;
+
+      const F32 weight = ( dx ? frac[0] : 1.0f - frac[0] ) *
+                         ( dy ? frac[1] : 1.0f - frac[1] ) *
+                         ( dz ? frac[2] : 1.0f - frac[2] );
+
+      const Probe &probe = mProbes[ _getIndex( cell[0] + dx, cell[1] + dy, cell[2] + dz ) ];
+      skyVisibility += probe.skyVisibility * weight;
+      bounce += probe.bounce * weight;
+   }
+
+   ColorF ambient = sceneAmbient * skyVisibility + bounce;
+   ambient.alpha = sceneAmbient.alpha;
+
+   outAmbient->interpolate( sceneAmbient, ambient, mClampF( fade, 0.0f, 1.0f ) );
+   return true;
+}
+
+bool LightProbeGrid::read( Stream &stream )
+{
+   U32 tag, version;
+   if (  !stream.read( &tag ) || tag != smProbeFileTag ||
+         !stream.read( &version ) || version != smProbeFileVersion )
+      return false;
+
+   Box3F bounds;
+   U32 size[3];
+   if (  !mathRead( stream, &bounds ) ||
+         !stream.read( &size[0] ) ||
+         !stream.read( &size[1] ) ||
+         !stream.read( &size[2] ) )
+      return false;
+
+   for ( U32 i = 0; i < 3; i++ )
+   {
+      if ( size[i] < 2 || size[i] > MaxProbesPerAxis )
+         return false;
+   }
+
+   Vector<Probe> probes;
+   probes.setSize( size[0] * size[1] * size[2] );
+   for ( U32 i = 0; i < probes.size(); i++ )
+   {
+      Probe &probe = probes[i];
+      if (  !stream.read( &probe.skyVisibility ) ||
+            !stream.read( &probe.bounce.red ) ||
+            !stream.read( &probe.bounce.green ) ||
+            !stream.read( &probe.bounce.blue ) )
+         return false;
+
+      probe.bounce.alpha = 0.0f;
+   }
+
+   mBounds = bounds;
+   for ( U32 i = 0; i < 3; i++ )
+   {
+      mSize[i] = size[i];
+      mSpacing[i] = bounds.len( i ) / ( size[i] - 1 );
+   }
+   mProbes = probes;
+
+   return true;
+}
+
+bool LightProbeGrid::write( Stream &stream ) const
+{
+   bool success = stream.write( smProbeFileTag );
+   success &= stream.write( smProbeFileVersion );
+   success &= mathWrite( stream, mBounds );
+   success &= stream.write( mSize[0] );
+   success &= stream.write( mSize[1] );
+   success &= stream.write( mSize[2] );
+
+   for ( U32 i = 0; i < mProbes.size(); i++ )
+   {
+      const Probe &probe = mProbes[i];
+      success &= stream.write( probe.skyVisibility );
+      success &= stream.write( probe.bounce.red );
+      success &= stream.write( probe.bounce.green );
+      success &= stream.write( probe.bounce.blue );
+   }
+
+   return success;
+}
+
+void LightProbeGrid::registerGrid()
+{
+   if ( find( smGrids.begin(), smGrids.end(), this ) == smGrids.end() )
+      smGrids.push_back( this );
+}
+
+void LightProbeGrid::unregisterGrid()
+{
+   Vector<LightProbeGrid*>::iterator iter = find( smGrids.begin(), smGrids.end(), this );
+   if ( iter != smGrids.end() )
+      smGrids.erase( iter );
+}
+
+bool LightProbeGrid::findAmbient( const Point3F &pos, ColorF *inOutAmbient )
+{
+   if ( !smEnabled )
+      return false;
+
+   for ( U32 i = 0; i < smGrids.size(); i++ )
+   {
+      if ( smGrids[i]->sampleAmbient( pos, *inOutAmbient, inOutAmbient ) )
+         return true;
+   }
+
+   return false;
+}
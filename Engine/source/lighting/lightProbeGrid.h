@@ -0,0 +1,179 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _LIGHTPROBEGRID_H_
+#define _LIGHTPROBEGRID_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _COLOR_H_
+#include "core/color.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class Stream;
+class SceneContainer;
+class LightInfo;
+
+
+/// A regular grid of ambient light probes baked from the static scene.
+///
+/// Each probe stores the fraction of the sky which is visible from it and
+/// the light bounced towards it by the surrounding geometry.  Objects inside
+/// of a registered grid get their ambient color from the probes around them
+/// instead of the scene wide ambient color:
+///
+/// @code
+/// ambient = sceneAmbient * skyVisibility + bounce
+/// @endcode
+///
+/// The sky term is kept as a fraction of the scene ambient so that it follows
+/// time of day changes.  The bounce term is baked with the sun at the time of
+/// the bake.
+///
+/// Baking only casts rays against the collision geometry of the scene so
+/// it doesn't need a GFX device and runs on dedicated servers.
+class LightProbeGrid
+{
+   public:
+
+      enum
+      {
+         /// The maximum number of probes along each axis.
+         MaxProbesPerAxis = 64,
+      };
+
+      /// If false, the grids are ignored and all objects use
+      /// the scene ambient color.
+      static bool smEnabled;
+
+      struct Probe
+      {
+         /// The fraction of the upper hemisphere which isn't
+         /// blocked by scene geometry.
+         F32 skyVisibility;
+
+         /// The light reflected towards the probe.
+         ColorF bounce;
+      };
+
+      struct BakeParams
+      {
+         /// The number of rays cast from each probe.
+         U32 raysPerProbe;
+
+         /// The distance after which a ray is considered to reach the sky.
+         F32 rayLength;
+
+         /// The object types the rays are cast against.
+         U32 rayMask;
+
+         /// The diffuse reflectance of all the geometry hit by rays.
+         ColorF albedo;
+
+         /// The sun used to light the geometry hit by rays or NULL.
+         const LightInfo *sun;
+
+         BakeParams();
+      };
+
+   protected:
+
+      /// The world space box covered by the probes.
+      Box3F mBounds;
+
+      /// The number of probes along each axis.
+      U32 mSize[3];
+
+      /// The distance between probes along each axis.
+      Point3F mSpacing;
+
+      /// The probes ordered by x, then y, then z.
+      Vector<Probe> mProbes;
+
+      /// The grids used for rendering.
+      static Vector<LightProbeGrid*> smGrids;
+
+      U32 _getIndex( U32 x, U32 y, U32 z ) const { return x + mSize[0] * ( y + mSize[1] * z ); }
+
+      /// Returns the position of the probe.
+      Point3F _getProbePosition( U32 x, U32 y, U32 z ) const;
+
+   public:
+
+      LightProbeGrid();
+      ~LightProbeGrid();
+
+      /// Places the probes in the box no further apart than the spacing
+      /// and resets them to a fully visible sky without any bounce.
+      void setBounds( const Box3F &bounds, F32 spacing );
+
+      const Box3F& getBounds() const { return mBounds; }
+
+      U32 getNumProbes() const { return mProbes.size(); }
+
+      const Probe& getProbe( U32 x, U32 y, U32 z ) const { return mProbes[ _getIndex( x, y, z ) ]; }
+
+      /// Casts rays from all the probes into the container.
+      void bake( SceneContainer *container, const BakeParams &params );
+
+      /// Returns the ambient color for a point inside of the grid.
+      ///
+      /// Points closer to the edges of the grid than one probe spacing
+      /// are blended towards the scene ambient color.
+      ///
+      /// @return False if the point is outside of the grid.
+      bool sampleAmbient( const Point3F &pos, const ColorF &sceneAmbient, ColorF *outAmbient ) const;
+
+      /// @name Serialization
+      /// @{
+
+      bool read( Stream &stream );
+      bool write( Stream &stream ) const;
+
+      /// @}
+
+      /// @name Rendering
+      /// @{
+
+      /// Adds the grid to the grids searched by findAmbient().
+      void registerGrid();
+
+      void unregisterGrid();
+
+      /// Replaces the ambient color with the one from the first registered
+      /// grid containing the point.
+      ///
+      /// @return False if the point isn't inside of a grid.
+      static bool findAmbient( const Point3F &pos, ColorF *inOutAmbient );
+
+      /// @}
+};
+
+#endif // _LIGHTPROBEGRID_H_
@@ -89,8 +89,10 @@ void LightQuery::_scoreLights()
    if ( !LIGHTMGR )
       return;
 
-   // Get all the lights.
-   LIGHTMGR->getAllUnsortedLights( &mLights );
+   // Get the lights which may reach the volume from the
+   // clustered light grid or fall back to all the lights.
+   if ( !LIGHTMGR->getClusteredLights( mVolume, &mLights ) )
+      LIGHTMGR->getAllUnsortedLights( &mLights );
    LightInfo *sun = LIGHTMGR->getSpecialLight( LightManager::slSunLightType );
 
    const Point3F lumDot( 0.2125f, 0.7154f, 0.0721f );
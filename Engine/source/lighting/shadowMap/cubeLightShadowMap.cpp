@@ -116,8 +116,13 @@ void CubeLightShadowMap::_render(   RenderPassManager* renderPass,
       GFX->setFrustum( left, right, bottom, top, 0.1f, mLight->getRange().x );
    }
 
-   // Render the shadowmap!
-   GFX->pushActiveRenderTarget();
+   // Setup the cameras of all the faces first so
+   // that their casters can be gathered at once.
+   SceneManager* sceneManager = diffuseState->getSceneManager();
+   SceneRenderState* faceStates[6];
+   MatrixF faceMatrices[6];
+   const U32 faceMasks[6] = { SHADOW_TYPEMASK, SHADOW_TYPEMASK, SHADOW_TYPEMASK, 
+                              SHADOW_TYPEMASK, SHADOW_TYPEMASK, SHADOW_TYPEMASK };
 
    for( U32 i = 0; i < 6; i++ )
    {
@@ -152,8 +157,6 @@ void CubeLightShadowMap::_render(   RenderPassManager* renderPass,
          break;
       }
 
-      GFXDEBUGEVENT_START( CubeLightShadowMap_Render_Face, ColorI::RED );
-
       // create camera matrix
       VectorF cross = mCross(vUpVec, vLookatPt);
       cross.normalizeSafe();
@@ -166,16 +169,10 @@ void CubeLightShadowMap::_render(   RenderPassManager* renderPass,
       lightMatrix.inverse();
 
       GFX->setWorldMatrix( lightMatrix );
-
-      mTarget->attachTexture(GFXTextureTarget::Color0, mCubemap, i);
-      mTarget->attachTexture(GFXTextureTarget::DepthStencil, _getDepthTarget( mTexSize, mTexSize ));
-      GFX->setActiveRenderTarget(mTarget);
-      GFX->clear( GFXClearTarget | GFXClearStencil | GFXClearZBuffer, ColorI(255,255,255,255), 1.0f, 0 );
+      faceMatrices[i] = lightMatrix;
 
       // Create scene state, prep it
-      SceneManager* sceneManager = diffuseState->getSceneManager();
-      
-      SceneRenderState shadowRenderState
+      faceStates[i] = new SceneRenderState
       (
          sceneManager,
          SPT_Shadow,
@@ -183,15 +180,31 @@ void CubeLightShadowMap::_render(   RenderPassManager* renderPass,
          renderPass
       );
 
-      shadowRenderState.getMaterialDelegate().bind( this, &LightShadowMap::getShadowMaterial );
-      shadowRenderState.renderNonLightmappedMeshes( true );
-      shadowRenderState.renderLightmappedMeshes( bUseLightmappedGeometry );
-      shadowRenderState.setDiffuseCameraTransform( diffuseState->getCameraTransform() );
-      shadowRenderState.setWorldToScreenScale( diffuseState->getWorldToScreenScale() );
+      _initCasterState( faceStates[i], diffuseState, bUseLightmappedGeometry );
+   }
+
+   Vector<SceneObject*> faceCasters[6];
+   sceneManager->gatherSceneObjects( faceStates, faceMasks, 6, faceCasters );
+
+   // Render the shadowmap!
+   GFX->pushActiveRenderTarget();
+
+   for( U32 i = 0; i < 6; i++ )
+   {
+      GFXDEBUGEVENT_START( CubeLightShadowMap_Render_Face, ColorI::RED );
+
+      GFX->setWorldMatrix( faceMatrices[i] );
+
+      mTarget->attachTexture(GFXTextureTarget::Color0, mCubemap, i);
+      mTarget->attachTexture(GFXTextureTarget::DepthStencil, _getDepthTarget( mTexSize, mTexSize ));
+      GFX->setActiveRenderTarget(mTarget);
+      GFX->clear( GFXClearTarget | GFXClearStencil | GFXClearZBuffer, ColorI(255,255,255,255), 1.0f, 0 );
+
+      sceneManager->renderGatheredObjects( faceStates[i], faceCasters[i] );
 
-      sceneManager->renderSceneNoLights( &shadowRenderState, SHADOW_TYPEMASK );
+      _debugRender( faceStates[i] );
 
-      _debugRender( &shadowRenderState );
+      delete faceStates[i];
 
       // Resolve this face
       mTarget->resolve();
@@ -24,6 +24,7 @@
 #include "lighting/shadowMap/lightShadowMap.h"
 
 #include "lighting/shadowMap/shadowMapManager.h"
+#include "lighting/shadowMap/shadowMapPass.h"
 #include "lighting/shadowMap/shadowMatHook.h"
 #include "gfx/gfxDevice.h"
 #include "gfx/gfxTextureManager.h"
@@ -61,6 +62,7 @@ const GFXFormat LightShadowMap::ShadowMapFormat = GFXFormatR32F; // GFXFormatR8G
 
 bool LightShadowMap::smDebugRenderFrustums;
 F32 LightShadowMap::smShadowTexScalar = 1.0f;
+bool LightShadowMap::smCacheStaticCasters = true;
 
 Vector<LightShadowMap*> LightShadowMap::smUsedShadowMaps;
 Vector<LightShadowMap*> LightShadowMap::smShadowMaps;
@@ -97,6 +99,7 @@ LightShadowMap::LightShadowMap( LightInfo *light )
    GFXTextureManager::addEventDelegate( this, &LightShadowMap::_onTextureEvent );
 
    mTarget = GFX->allocRenderToTextureTarget();
+   mStaticTarget = GFX->allocRenderToTextureTarget();
    mVizQuery = GFX->createOcclusionQuery();
 
    smShadowMaps.push_back( this );
@@ -105,6 +108,7 @@ LightShadowMap::LightShadowMap( LightInfo *light )
 LightShadowMap::~LightShadowMap()
 {
    mTarget = NULL;
+   mStaticTarget = NULL;
    SAFE_DELETE( mVizQuery );   
    
    releaseTextures();
@@ -245,6 +249,7 @@ void LightShadowMap::calcLightMatrices( MatrixF &outLightMatrix, const Frustum &
 void LightShadowMap::releaseTextures()
 {
    mShadowMapTex = NULL;
+   mStaticLayers.clear();
    mDebugTarget.setTexture( NULL );
    mLastUpdate = 0;
    smUsedShadowMaps.remove( this );
@@ -426,6 +431,108 @@ S32 QSORT_CALLBACK LightShadowMap::cmpPriority( LightShadowMap *const *lsm1, Lig
    return diff > 0.0f ? -1 : ( diff < 0.0f ? 1 : 0 );
 }
 
+void LightShadowMap::_initCasterState(   SceneRenderState *state,
+                                          const SceneRenderState *diffuseState,
+                                          bool useLightmapped,
+                                          SceneRenderState::ShadowCasterFilter casters )
+{
+   // Use the diffuse state camera position and screen metrics
+   // values so that lod is done the same as in the diffuse pass.
+
+   state->getMaterialDelegate().bind( this, &LightShadowMap::getShadowMaterial );
+   state->renderNonLightmappedMeshes( true );
+   state->renderLightmappedMeshes( useLightmapped );
+   state->setShadowCasterFilter( casters );
+   state->setDiffuseCameraTransform( diffuseState->getCameraTransform() );
+   state->setWorldToScreenScale( diffuseState->getWorldToScreenScale() );
+}
+
+void LightShadowMap::_renderCasters(  RenderPassManager *renderPass,
+                                       const SceneRenderState *diffuseState,
+                                       const SceneCameraState &cameraState,
+                                       U32 objectMask,
+                                       bool useLightmapped,
+                                       SceneRenderState::ShadowCasterFilter casters )
+{
+   SceneManager* sceneManager = diffuseState->getSceneManager();
+
+   SceneRenderState shadowRenderState
+   (
+      sceneManager,
+      SPT_Shadow,
+      cameraState,
+      renderPass
+   );
+
+   _initCasterState( &shadowRenderState, diffuseState, useLightmapped, casters );
+
+   sceneManager->renderSceneNoLights( &shadowRenderState, objectMask );
+
+   _debugRender( &shadowRenderState );
+}
+
+bool LightShadowMap::_updateStaticLayer(  U32 index,
+                                          const Point2I &size,
+                                          RenderPassManager *renderPass,
+                                          const SceneRenderState *diffuseState,
+                                          const SceneCameraState &cameraState,
+                                          U32 objectMask,
+                                          bool useLightmapped )
+{
+   PROFILE_SCOPE( LightShadowMap_updateStaticLayer );
+
+   if ( mStaticLayers.size() <= index )
+      mStaticLayers.setSize( index + 1 );
+
+   StaticLayer &layer = mStaticLayers[index];
+
+   SceneManager *sceneManager = diffuseState->getSceneManager();
+   const MatrixF worldToLightProj = GFX->getProjectionMatrix() * GFX->getWorldMatrix();
+
+   // The layer is still good if it was rendered with the same
+   // camera and nothing static changed within its frustum.
+   if (  layer.tex.isValid() &&
+         layer.tex->getWidth() == size.x &&
+         layer.tex->getHeight() == size.y &&
+         layer.objectMask == objectMask &&
+         layer.useLightmapped == useLightmapped &&
+         dMemcmp( (const F32*)layer.worldToLightProj, (const F32*)worldToLightProj, sizeof( MatrixF ) ) == 0 &&
+         !sceneManager->hasStaticChangesSince( layer.staticChangeCount, layer.frustum ) )
+   {
+      layer.staticChangeCount = sceneManager->getStaticChangeCount();
+      ++ShadowMapPass::smStaticLayersReused;
+      return false;
+   }
+
+   if (  layer.tex.isNull() ||
+         layer.tex->getWidth() != size.x ||
+         layer.tex->getHeight() != size.y )
+      layer.tex.set( size.x, size.y, 
+                     ShadowMapFormat, &ShadowMapProfile, 
+                     "LightShadowMap::StaticLayer" );
+
+   layer.worldToLightProj = worldToLightProj;
+   layer.frustum = cameraState.getFrustum();
+   layer.objectMask = objectMask;
+   layer.useLightmapped = useLightmapped;
+   layer.staticChangeCount = sceneManager->getStaticChangeCount();
+
+   GFX->pushActiveRenderTarget();
+   mStaticTarget->attachTexture( GFXTextureTarget::Color0, layer.tex );
+   mStaticTarget->attachTexture( GFXTextureTarget::DepthStencil, 
+      _getDepthTarget( layer.tex->getWidth(), layer.tex->getHeight() ) );
+   GFX->setActiveRenderTarget( mStaticTarget );
+   GFX->clear( GFXClearStencil | GFXClearZBuffer | GFXClearTarget, ColorI(255,255,255), 1.0f, 0 );
+
+   _renderCasters( renderPass, diffuseState, cameraState, objectMask, useLightmapped, SceneRenderState::StaticShadowCasters );
+
+   mStaticTarget->resolve();
+   GFX->popActiveRenderTarget();
+
+   ++ShadowMapPass::smStaticLayerUpdates;
+   return true;
+}
+
 void LightShadowMap::_debugRender( SceneRenderState* shadowRenderState )
 {
    #ifdef TORQUE_DEBUG
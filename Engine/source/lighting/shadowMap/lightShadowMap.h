@@ -47,10 +47,12 @@
 #ifndef _GFXSHADER_H_
 #include "gfx/gfxShader.h"
 #endif
+#ifndef _SCENERENDERSTATE_H_
+#include "scene/sceneRenderState.h"
+#endif
 
 class ShadowMapManager;
 class SceneManager;
-class SceneRenderState;
 class BaseMatInstance;
 class MaterialParameters;
 class SharedShadowMapObjects;
@@ -61,6 +63,7 @@ class GFXShader;
 class GFXOcclusionQuery;
 class LightManager;
 class RenderPassManager;
+class SceneCameraState;
 
 
 // Shader constant handle lookup
@@ -140,6 +143,11 @@ public:
    /// rendering enabled.
    static bool smDebugRenderFrustums;
 
+   /// Whether to keep the static shadow casters in cached layers
+   /// which are only rendered again when the light or the static
+   /// geometry in its frustum changes.
+   static bool smCacheStaticCasters;
+
 public:
 
    LightShadowMap( LightInfo *light );
@@ -228,6 +236,62 @@ protected:
    /// @note This method only does something in debug builds.
    void _debugRender( SceneRenderState* shadowRenderState );
 
+   /// Setup a shadow render state to use the shadow materials and to pick
+   /// the LOD from the diffuse camera.
+   void _initCasterState(  SceneRenderState *state,
+                           const SceneRenderState *diffuseState,
+                           bool useLightmapped,
+                           SceneRenderState::ShadowCasterFilter casters = SceneRenderState::AllShadowCasters );
+
+   /// Render the casters matching @a objectMask and @a casters from the
+   /// given camera into the active render target.  The LOD is picked from
+   /// the diffuse camera.
+   void _renderCasters( RenderPassManager *renderPass,
+                        const SceneRenderState *diffuseState,
+                        const SceneCameraState &cameraState,
+                        U32 objectMask,
+                        bool useLightmapped,
+                        SceneRenderState::ShadowCasterFilter casters = SceneRenderState::AllShadowCasters );
+
+   /// The static casters rendered for one region of the shadow map.
+   struct StaticLayer
+   {
+      GFXTexHandle tex;
+
+      /// The light view projection the layer was rendered with.
+      MatrixF worldToLightProj;
+
+      /// The culling frustum the layer was rendered with.
+      Frustum frustum;
+
+      U32 objectMask;
+
+      bool useLightmapped;
+
+      /// The static geometry change count of the scene
+      /// at the time the layer was rendered.
+      U32 staticChangeCount;
+   };
+
+   /// The cached static casters, one for each region of the
+   /// shadow map which is rendered with a different camera.
+   Vector<StaticLayer> mStaticLayers;
+
+   /// The target used to render the static layers.
+   GFXTextureTargetRef mStaticTarget;
+
+   /// Render the static casters into the layer of the given size unless
+   /// the cached copy is still valid for the camera set on the device.
+   ///
+   /// @return True if the layer had to be rendered.
+   bool _updateStaticLayer(   U32 index,
+                              const Point2I &size,
+                              RenderPassManager *renderPass,
+                              const SceneRenderState *diffuseState,
+                              const SceneCameraState &cameraState,
+                              U32 objectMask,
+                              bool useLightmapped );
+
    /// Helper for rendering shadow map for debugging.
    NamedTexTarget mDebugTarget;
 
@@ -213,9 +213,18 @@ void PSSMLightShadowMap::_render(   RenderPassManager* renderPass,
    GFXFrustumSaver frustSaver;
    GFXTransformSaver saver;
 
+   // When caching the static casters the splits only render the
+   // dynamic casters here and get merged with the static layers
+   // into the shadowmap at the end.
+   GFXTexHandle dynamicTex;
+   if ( smCacheStaticCasters )
+      dynamicTex.set(   mShadowMapTex->getWidth(), mShadowMapTex->getHeight(), 
+                        ShadowMapFormat, &ShadowMapProfile, 
+                        "PSSMLightShadowMap::_render() - dynamicTex" );
+
    // Set our render target
    GFX->pushActiveRenderTarget();
-   mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
+   mTarget->attachTexture( GFXTextureTarget::Color0, smCacheStaticCasters ? dynamicTex : mShadowMapTex );
    mTarget->attachTexture( GFXTextureTarget::DepthStencil, 
       _getDepthTarget( mShadowMapTex->getWidth(), mShadowMapTex->getHeight() ) );
    GFX->setActiveRenderTarget( mTarget );
@@ -246,6 +255,13 @@ void PSSMLightShadowMap::_render(   RenderPassManager* renderPass,
    TSShapeInstance::smDetailAdjust *= smDetailAdjustScale;
    TSShapeInstance::smSmallestVisiblePixelSize = smSmallestVisiblePixelSize;
 
+   // The casters of all the splits are gathered at once, so
+   // the cameras of the splits are all setup before rendering.
+   SceneManager* sceneManager = diffuseState->getSceneManager();
+   SceneRenderState* splitStates[MAX_SPLITS];
+   U32 splitMasks[MAX_SPLITS];
+   MatrixF splitProjs[MAX_SPLITS];
+
    for (U32 i = 0; i < mNumSplits; i++)
    {
       GFXTransformSaver saver;
@@ -314,11 +330,7 @@ void PSSMLightShadowMap::_render(   RenderPassManager* renderPass,
 
       // Set our new projection
       GFX->setProjectionMatrix(alightProj);
-
-      // Render into the quad of the shadow map we are using.
-      GFX->setViewport(mViewports[i]);
-
-      SceneManager* sceneManager = diffuseState->getSceneManager();
+      splitProjs[i] = alightProj;
 
       // The frustum is currently the  full size and has not had
       // cropping applied.
@@ -347,29 +359,47 @@ void PSSMLightShadowMap::_render(   RenderPassManager* renderPass,
       // camera position and screen metrics values so that
       // lod is done the same as in the diffuse pass.
 
-      SceneRenderState shadowRenderState
-      (
-         sceneManager,
-         SPT_Shadow,
-         SceneCameraState( diffuseState->getViewport(), croppedFrustum,
-                           GFX->getWorldMatrix(), GFX->getProjectionMatrix() ),
-         renderPass
-      );
-
-      shadowRenderState.getMaterialDelegate().bind( this, &LightShadowMap::getShadowMaterial );
-      shadowRenderState.renderNonLightmappedMeshes( true );
-      shadowRenderState.renderLightmappedMeshes( bUseLightmappedGeometry );
-
-      shadowRenderState.setDiffuseCameraTransform( diffuseState->getCameraTransform() );
-      shadowRenderState.setWorldToScreenScale( diffuseState->getWorldToScreenScale() );
+      const SceneCameraState cameraState( diffuseState->getViewport(), croppedFrustum,
+                                          GFX->getWorldMatrix(), GFX->getProjectionMatrix() );
 
       U32 objectMask = SHADOW_TYPEMASK;
       if ( i == mNumSplits-1 && params->lastSplitTerrainOnly )
          objectMask = TerrainObjectType;
 
-      sceneManager->renderSceneNoLights( &shadowRenderState, objectMask );
+      if ( smCacheStaticCasters )
+      {
+         _updateStaticLayer(  i, mViewports[i].extent, 
+                              renderPass, diffuseState, cameraState, 
+                              objectMask, bUseLightmappedGeometry );
+
+         // The terrain is always in the static layer.
+         objectMask &= ~TerrainObjectType;
+      }
 
-      _debugRender( &shadowRenderState );
+      splitStates[i] = new SceneRenderState( sceneManager, SPT_Shadow, cameraState, renderPass );
+      _initCasterState( splitStates[i], diffuseState, bUseLightmappedGeometry,
+                        smCacheStaticCasters ? SceneRenderState::DynamicShadowCasters : SceneRenderState::AllShadowCasters );
+      splitMasks[i] = objectMask;
+   }
+
+   Vector<SceneObject*> splitCasters[MAX_SPLITS];
+   sceneManager->gatherSceneObjects( splitStates, splitMasks, mNumSplits, splitCasters );
+
+   for (U32 i = 0; i < mNumSplits; i++)
+   {
+      GFXTransformSaver saver;
+
+      GFX->setProjectionMatrix(splitProjs[i]);
+
+      // Render into the quad of the shadow map we are using.
+      GFX->setViewport(mViewports[i]);
+
+      if ( splitMasks[i] )
+         sceneManager->renderGatheredObjects( splitStates[i], splitCasters[i] );
+
+      _debugRender( splitStates[i] );
+
+      delete splitStates[i];
    }
 
    // Restore the original TS lod settings.
@@ -379,6 +409,24 @@ void PSSMLightShadowMap::_render(   RenderPassManager* renderPass,
    // Release our render target
    mTarget->resolve();
    GFX->popActiveRenderTarget();
+
+   if ( smCacheStaticCasters )
+   {
+      // Merge the static layers and the dynamic casters
+      // of each split into the shadowmap.
+      GFX->pushActiveRenderTarget();
+      mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
+      GFX->setActiveRenderTarget( mTarget );
+
+      for ( U32 i = 0; i < mNumSplits; i++ )
+      {
+         GFX->setViewport( mViewports[i] );
+         SHADOWMGR->compositeStaticLayer( mStaticLayers[i].tex, dynamicTex, mViewports[i] );
+      }
+
+      mTarget->resolve();
+      GFX->popActiveRenderTarget();
+   }
 }
 
 void PSSMLightShadowMap::setShaderParameters(GFXShaderConstBuffer* params, LightingShaderConstants* lsc)
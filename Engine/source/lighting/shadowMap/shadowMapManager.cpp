@@ -30,6 +30,8 @@
 #include "core/util/safeDelete.h"
 #include "scene/sceneRenderState.h"
 #include "gfx/gfxTextureManager.h"
+#include "gfx/gfxDevice.h"
+#include "materials/shaderData.h"
 #include "core/module.h"
 #include "console/consoleTypes.h"
 
@@ -75,6 +77,15 @@ AFTER_MODULE_INIT( Sim )
       "Used by the editor to disable all shadow rendering.\n"
       "@ingroup AdvancedLighting\n" );
 
+   Con::addVariable( "$pref::Shadows::cacheStaticCasters", 
+      TypeBool, &LightShadowMap::smCacheStaticCasters,
+      "@brief Keeps the static shadow casters in cached layers of the shadow maps.\n"
+      "Only the dynamic casters are rendered when a shadow map is updated unless the light "
+      "or the static geometry within its frustum changed.  Only terrain and shapes without an "
+      "ambient animation are cached.  This uses more texture memory.\n"
+      "@ingroup AdvancedLighting\n" );
+   Con::addVariableNotify( "$pref::Shadows::cacheStaticCasters", callabck );
+
    Con::NotifyDelegate shadowCallback( &ShadowMapManager::updateShadowDisable );
    Con::addVariableNotify( "$pref::Shadows::disable", shadowCallback );
    Con::addVariableNotify( "$Shadows::disable", shadowCallback );
@@ -86,6 +97,9 @@ Signal<void(void)> ShadowMapManager::smShadowDeactivateSignal;
 ShadowMapManager::ShadowMapManager() 
 :  mShadowMapPass(NULL), 
    mCurrentShadowMap(NULL),
+   mCompositeDynamicRectSC(NULL),
+   mCompositeStaticMapSC(NULL),
+   mCompositeDynamicMapSC(NULL),
    mIsActive(false)
 {
 }
@@ -129,6 +143,10 @@ void ShadowMapManager::deactivate()
    SAFE_DELETE(mShadowMapPass);
    mTapRotationTex = NULL;
 
+   mCompositeShader = NULL;
+   mCompositeConsts = NULL;
+   mCompositeSB = NULL;
+
    // Clean up our shadow texture memory.
    LightShadowMap::releaseAllTextures();
    TEXMGR->cleanupPool();
@@ -177,6 +195,103 @@ GFXTextureObject* ShadowMapManager::getTapRotationTex()
    return mTapRotationTex;
 }
 
+bool ShadowMapManager::_initCompositeShader()
+{
+   ShaderData *shaderData;
+   if ( !Sim::findObject( "ShadowMapCompositeShader", shaderData ) )
+   {
+      Con::warnf( "ShadowMapManager::_initCompositeShader - failed to locate shader ShadowMapCompositeShader!" );
+      return false;
+   }
+
+   mCompositeShader = shaderData->getShader();
+   if ( !mCompositeShader )
+      return false;
+
+   mCompositeConsts = mCompositeShader->allocConstBuffer();
+   mCompositeDynamicRectSC = mCompositeShader->getShaderConstHandle( "$dynamicRect" );
+   mCompositeStaticMapSC = mCompositeShader->getShaderConstHandle( "$staticMap" );
+   mCompositeDynamicMapSC = mCompositeShader->getShaderConstHandle( "$dynamicMap" );
+
+   GFXStateBlockDesc desc;
+   desc.samplersDefined = true;
+   desc.samplers[0] = GFXSamplerStateDesc::getClampPoint();
+   desc.samplers[1] = GFXSamplerStateDesc::getClampPoint();
+   desc.zDefined = true;
+   desc.zWriteEnable = false;
+   desc.zEnable = false;
+   desc.cullDefined = true;
+   desc.cullMode = GFXCullNone;
+   mCompositeSB = GFX->createStateBlock( desc );
+
+   return true;
+}
+
+void ShadowMapManager::compositeStaticLayer( GFXTextureObject *staticTex, 
+                                             GFXTextureObject *dynamicTex, 
+                                             const RectI &dynamicRect )
+{
+   if ( !mCompositeShader && !_initCompositeShader() )
+      return;
+
+   PROFILE_SCOPE( ShadowMapManager_compositeStaticLayer );
+
+   // Setup a quad covering the viewport.
+   const RectI &viewport = GFX->getViewport();
+   GFXVertexBufferHandle<GFXVertexPT> vb;
+   {
+      F32 copyOffsetX = 2.0f * GFX->getFillConventionOffset() / (F32)viewport.extent.x;
+      F32 copyOffsetY = 2.0f * GFX->getFillConventionOffset() / (F32)viewport.extent.y;
+
+      const bool needsYFlip = GFX->getAdapterType() == OpenGL;
+
+      GFXVertexPT points[4];
+      points[0].point      = Point3F( -1.0 - copyOffsetX, -1.0 + copyOffsetY, 0.0 );
+      points[0].texCoord   = Point2F(  0.0, needsYFlip ? 0.0f : 1.0f );
+      points[1].point      = Point3F( -1.0 - copyOffsetX,  1.0 + copyOffsetY, 0.0 );
+      points[1].texCoord   = Point2F(  0.0, needsYFlip ? 1.0f : 0.0f );
+      points[2].point      = Point3F(  1.0 - copyOffsetX,  1.0 + copyOffsetY, 0.0 );
+      points[2].texCoord   = Point2F(  1.0, needsYFlip ? 1.0f : 0.0f );
+      points[3].point      = Point3F(  1.0 - copyOffsetX, -1.0 + copyOffsetY, 0.0 );
+      points[3].texCoord   = Point2F(  1.0, needsYFlip ? 0.0f : 1.0f );
+
+      vb.set( GFX, 4, GFXBufferTypeVolatile );
+      GFXVertexPT *ptr = vb.lock();
+      if ( ptr )
+      {
+         dMemcpy( ptr, points, sizeof(GFXVertexPT) * 4 );
+         vb.unlock();
+      }
+   }
+
+   // The viewport origin and the texture origin are both at the
+   // top on D3D and at the bottom on OpenGL, so the same scale and
+   // offset maps the quad into the dynamic rect on both.
+   const F32 texWidth = (F32)dynamicTex->getWidth();
+   const F32 texHeight = (F32)dynamicTex->getHeight();
+   mCompositeConsts->setSafe( mCompositeDynamicRectSC, 
+      Point4F( dynamicRect.point.x / texWidth, 
+               dynamicRect.point.y / texHeight, 
+               dynamicRect.extent.x / texWidth, 
+               dynamicRect.extent.y / texHeight ) );
+
+   GFX->setShader( mCompositeShader );
+   GFX->setShaderConstBuffer( mCompositeConsts );
+   GFX->setStateBlock( mCompositeSB );
+   GFX->setVertexBuffer( vb );
+
+   GFX->setTexture( mCompositeStaticMapSC->getSamplerRegister(), staticTex );
+   GFX->setTexture( mCompositeDynamicMapSC->getSamplerRegister(), dynamicTex );
+
+   GFX->drawPrimitive( GFXTriangleFan, 0, 2 );
+
+   GFX->setTexture( mCompositeStaticMapSC->getSamplerRegister(), NULL );
+   GFX->setTexture( mCompositeDynamicMapSC->getSamplerRegister(), NULL );
+   GFX->setShader( NULL );
+   GFX->setShaderConstBuffer( NULL );
+   GFX->setVertexBuffer( NULL );
+}
+
 void ShadowMapManager::updateShadowDisable()
 {
    bool disable = false;
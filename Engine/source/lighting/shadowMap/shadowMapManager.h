@@ -38,6 +38,12 @@
 #ifndef _MPOINT4_H_
 #include "math/mPoint4.h"
 #endif
+#ifndef _GFXSHADER_H_
+#include "gfx/gfxShader.h"
+#endif
+#ifndef _GFXSTATEBLOCK_H_
+#include "gfx/gfxStateBlock.h"
+#endif
 
 class LightShadowMap;
 class ShadowMapPass;
@@ -75,6 +81,14 @@ public:
 
    GFXTextureObject* getTapRotationTex();
 
+   /// Draws the minimum of the static layer and the dynamic caster shadow
+   /// maps into the current viewport.  The static layer covers the whole
+   /// viewport and the dynamic casters are read from @a dynamicRect, which
+   /// is given in pixels of @a dynamicTex.
+   void compositeStaticLayer( GFXTextureObject *staticTex, 
+                              GFXTextureObject *dynamicTex, 
+                              const RectI &dynamicRect );
+
    /// The shadow map deactivation signal.
    static Signal<void(void)> smShadowDeactivateSignal;
 
@@ -92,6 +106,20 @@ protected:
    ///
    GFXTexHandle mTapRotationTex;
 
+   /// @name Static Layer Composite
+   /// @{
+
+   bool _initCompositeShader();
+
+   GFXShaderRef mCompositeShader;
+   GFXShaderConstBufferRef mCompositeConsts;
+   GFXShaderConstHandle *mCompositeDynamicRectSC;
+   GFXShaderConstHandle *mCompositeStaticMapSC;
+   GFXShaderConstHandle *mCompositeDynamicMapSC;
+   GFXStateBlockRef mCompositeSB;
+
+   /// @}
+
    bool mIsActive;
 
 public:
@@ -50,6 +50,8 @@ U32 ShadowMapPass::smShadowMapPolyCount = 0;
 U32 ShadowMapPass::smRenderTargetChanges = 0;
 U32 ShadowMapPass::smShadowPoolTexturesCount = 0.;
 F32 ShadowMapPass::smShadowPoolMemory = 0.0f;
+U32 ShadowMapPass::smStaticLayerUpdates = 0;
+U32 ShadowMapPass::smStaticLayersReused = 0;
 
 bool ShadowMapPass::smDisableShadows = false;
 bool ShadowMapPass::smDisableShadowsEditor = false;
@@ -109,6 +111,14 @@ ShadowMapPass::ShadowMapPass(LightManager* lightManager, ShadowMapManager* shado
    Con::addVariable( "$ShadowStats::poolTexMemory", TypeF32, &smShadowPoolMemory,
       "The shadow stats showing the approximate texture memory usage of the shadow map texture pool.\n"
       "@ingroup AdvancedLighting\n" );
+
+   Con::addVariable( "$ShadowStats::staticLayerUpdates", TypeS32, &smStaticLayerUpdates,
+      "The shadow stats showing the number of static caster layers rendered this frame.\n"
+      "@ingroup AdvancedLighting\n" );
+
+   Con::addVariable( "$ShadowStats::staticLayersReused", TypeS32, &smStaticLayersReused,
+      "The shadow stats showing the number of cached static caster layers reused this frame.\n"
+      "@ingroup AdvancedLighting\n" );
 }
 
 ShadowMapPass::~ShadowMapPass()
@@ -129,6 +139,8 @@ void ShadowMapPass::render(   SceneManager *sceneManager,
    smActiveShadowMaps = 0;
    smUpdatedShadowMaps = 0;
    smNearShadowMaps = 0;
+   smStaticLayerUpdates = 0;
+   smStaticLayersReused = 0;
    GFXDeviceStatistics stats;
    stats.start( GFX->getDeviceStatistics() );
 
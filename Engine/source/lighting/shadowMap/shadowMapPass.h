@@ -83,6 +83,12 @@ public:
    static bool smDisableShadowsEditor;
    static bool smDisableShadowsPref;
 
+   /// The number of static caster layers rendered this frame.
+   static U32 smStaticLayerUpdates;
+
+   /// The number of static caster layers reused from the cache this frame.
+   static U32 smStaticLayersReused;
+
 private:
 
    static U32 smActiveShadowMaps;
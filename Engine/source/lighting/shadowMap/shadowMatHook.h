@@ -46,6 +46,11 @@ public:
    virtual ~ShadowMatInstance() {}
 
    virtual bool setupPass( SceneRenderState *state, const SceneData &sgData );
+
+protected:
+
+   // MatInstance
+   virtual bool _canShareProcessedMaterial() const { return false; }
 };
 
 class ShadowMaterialHook : public MatInstanceHook
@@ -74,36 +74,58 @@ void SingleLightShadowMap::_render( RenderPassManager* renderPass,
    const MatrixF& lightProj = GFX->getProjectionMatrix();
    mWorldToLightProj = lightProj * lightMatrix;
 
-   // Render the shadowmap!
-   GFX->pushActiveRenderTarget();
-   mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
-   mTarget->attachTexture( GFXTextureTarget::DepthStencil, 
-      _getDepthTarget( mShadowMapTex->getWidth(), mShadowMapTex->getHeight() ) );
-   GFX->setActiveRenderTarget(mTarget);
-   GFX->clear(GFXClearStencil | GFXClearZBuffer | GFXClearTarget, ColorI(255,255,255), 1.0f, 0);
-
-   SceneManager* sceneManager = diffuseState->getSceneManager();
-   
-   SceneRenderState shadowRenderState
-   (
-      sceneManager,
-      SPT_Shadow,
-      SceneCameraState::fromGFXWithViewport( diffuseState->getViewport() ),
-      renderPass
-   );
-
-   shadowRenderState.getMaterialDelegate().bind( this, &LightShadowMap::getShadowMaterial );
-   shadowRenderState.renderNonLightmappedMeshes( true );
-   shadowRenderState.renderLightmappedMeshes( bUseLightmappedGeometry );
-   shadowRenderState.setDiffuseCameraTransform( diffuseState->getCameraTransform() );
-   shadowRenderState.setWorldToScreenScale( diffuseState->getWorldToScreenScale() );
-
-   sceneManager->renderSceneNoLights( &shadowRenderState, SHADOW_TYPEMASK );
-
-   _debugRender( &shadowRenderState );
-
-   mTarget->resolve();
-   GFX->popActiveRenderTarget();
+   const SceneCameraState cameraState = SceneCameraState::fromGFXWithViewport( diffuseState->getViewport() );
+
+   if ( smCacheStaticCasters )
+   {
+      // Refresh the static casters if needed and render the
+      // dynamic casters on their own.
+      _updateStaticLayer(  0, Point2I( mTexSize, mTexSize ), 
+                           renderPass, diffuseState, cameraState, 
+                           SHADOW_TYPEMASK, bUseLightmappedGeometry );
+
+      GFXTexHandle dynamicTex( mTexSize, mTexSize, 
+                               ShadowMapFormat, &ShadowMapProfile, 
+                               "SingleLightShadowMap::_render() - dynamicTex" );
+
+      GFX->pushActiveRenderTarget();
+      mTarget->attachTexture( GFXTextureTarget::Color0, dynamicTex );
+      mTarget->attachTexture( GFXTextureTarget::DepthStencil, 
+         _getDepthTarget( mTexSize, mTexSize ) );
+      GFX->setActiveRenderTarget(mTarget);
+      GFX->clear(GFXClearStencil | GFXClearZBuffer | GFXClearTarget, ColorI(255,255,255), 1.0f, 0);
+
+      _renderCasters(   renderPass, diffuseState, cameraState, SHADOW_TYPEMASK, 
+                        bUseLightmappedGeometry, SceneRenderState::DynamicShadowCasters );
+
+      mTarget->resolve();
+      GFX->popActiveRenderTarget();
+
+      // Merge both into the shadowmap.
+      GFX->pushActiveRenderTarget();
+      mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
+      GFX->setActiveRenderTarget(mTarget);
+
+      SHADOWMGR->compositeStaticLayer( mStaticLayers[0].tex, dynamicTex, RectI( 0, 0, mTexSize, mTexSize ) );
+
+      mTarget->resolve();
+      GFX->popActiveRenderTarget();
+   }
+   else
+   {
+      // Render the shadowmap!
+      GFX->pushActiveRenderTarget();
+      mTarget->attachTexture( GFXTextureTarget::Color0, mShadowMapTex );
+      mTarget->attachTexture( GFXTextureTarget::DepthStencil, 
+         _getDepthTarget( mShadowMapTex->getWidth(), mShadowMapTex->getHeight() ) );
+      GFX->setActiveRenderTarget(mTarget);
+      GFX->clear(GFXClearStencil | GFXClearZBuffer | GFXClearTarget, ColorI(255,255,255), 1.0f, 0);
+
+      _renderCasters( renderPass, diffuseState, cameraState, SHADOW_TYPEMASK, bUseLightmappedGeometry );
+
+      mTarget->resolve();
+      GFX->popActiveRenderTarget();
+   }
 }
 
 void SingleLightShadowMap::setShaderParameters(GFXShaderConstBuffer* params, LightingShaderConstants* lsc)
@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "lighting/lightClusterGrid.h"
+#include "lighting/lightInfo.h"
+#include "math/util/frustum.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestLightClusterGrid, "Lighting/ClusterGrid" )
+{
+   void run()
+   {
+      MRandomLCG rand( 5678 );
+
+      // A camera at the origin looking down the y axis.
+      Frustum frustum;
+      frustum.set( false, mDegToRad( 60.0f ), 16.0f / 9.0f, 0.1f, 500.0f );
+
+      // Many lights in front of and around the camera, plus one
+      // directional light which every query has to return.
+      Vector<LightInfo*> lights;
+      for ( U32 i = 0; i < 2000; i++ )
+      {
+         LightInfo *light = new LightInfo();
+         light->setType( ( i % 4 ) ? LightInfo::Point : LightInfo::Spot );
+         light->setPosition( Point3F( rand.randF( -400.0f, 400.0f ),
+                                      rand.randF( -100.0f, 600.0f ),
+                                      rand.randF( -50.0f, 50.0f ) ) );
+         light->setRange( rand.randF( 1.0f, 20.0f ) );
+         lights.push_back( light );
+      }
+
+      LightInfo *sun = new LightInfo();
+      sun->setType( LightInfo::Vector );
+      lights.push_back( sun );
+
+      LightClusterGrid grid;
+      grid.build( frustum, lights );
+      test( grid.isValid(), "Grid wasn't built" );
+
+      // Every light overlapping a query volume must be among the lights
+      // returned by the grid, so that scoring them gives the same result
+      // as scoring all the lights.
+      U32 numAnswered = 0;
+      U32 numReturned = 0;
+      bool allFound = true;
+      bool sunFound = true;
+
+      for ( U32 i = 0; i < 1000; i++ )
+      {
+         const F32 depth = rand.randF( 1.0f, 450.0f );
+         const SphereF volume( Point3F( rand.randF( -0.5f, 0.5f ) * depth,
+                                        depth,
+                                        rand.randF( -0.25f, 0.25f ) * depth ),
+                               rand.randF( 0.1f, 5.0f ) );
+
+         Vector<LightInfo*> found;
+         if ( !grid.getLights( volume, &found ) )
+            continue;
+
+         numAnswered++;
+         numReturned += found.size();
+         sunFound &= found.contains( sun );
+
+         for ( U32 j = 0; j < lights.size(); j++ )
+         {
+            LightInfo *light = lights[j];
+            if ( light == sun )
+               continue;
+
+            const F32 reach = light->getRange().x + volume.radius;
+            if ( ( light->getPosition() - volume.center ).lenSquared() < mSquared( reach ) )
+               allFound &= found.contains( light );
+         }
+      }
+
+      Con::printf( "LightClusterGrid: %d of 1000 queries answered, %.1f lights per query, %d clustered lights",
+         numAnswered, numAnswered ? F32( numReturned ) / numAnswered : 0.0f, grid.getNumClusteredLights() );
+
+      test( numAnswered > 0, "No query was answered by the grid" );
+      test( allFound, "Grid missed a light overlapping the query volume" );
+      test( sunFound, "Grid didn't return the directional light" );
+
+      for ( U32 i = 0; i < lights.size(); i++ )
+         delete lights[i];
+   }
+};
+
+#endif // !TORQUE_SHIPPING
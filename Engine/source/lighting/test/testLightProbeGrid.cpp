@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "lighting/lightProbeGrid.h"
+#include "core/stream/memStream.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestLightProbeGrid, "Lighting/ProbeGrid" )
+{
+   void run()
+   {
+      LightProbeGrid grid;
+      grid.setBounds( Box3F( Point3F( -10.0f, -10.0f, 0.0f ), Point3F( 10.0f, 10.0f, 5.0f ) ), 4.0f );
+
+      test( grid.getNumProbes() == 6 * 6 * 3, "Wrong number of probes" );
+
+      // Unbaked probes see the whole sky and don't change the ambient.
+      const ColorF sceneAmbient( 0.2f, 0.3f, 0.4f, 1.0f );
+      ColorF ambient;
+      test( grid.sampleAmbient( Point3F( 1.0f, 2.0f, 2.5f ), sceneAmbient, &ambient ), "Point inside of the grid wasn't sampled" );
+      test( ambient == sceneAmbient, "Unbaked probes changed the ambient color" );
+      test( !grid.sampleAmbient( Point3F( 1.0f, 2.0f, 8.0f ), sceneAmbient, &ambient ), "Point outside of the grid was sampled" );
+
+      // Round trip through a stream.
+      MemStream stream( 1024 );
+      test( grid.write( stream ), "Failed to write the grid" );
+      stream.setPosition( 0 );
+
+      LightProbeGrid loaded;
+      test( loaded.read( stream ), "Failed to read the grid" );
+      test( loaded.getNumProbes() == grid.getNumProbes(), "Loaded grid has a different number of probes" );
+      test( loaded.getBounds().minExtents == grid.getBounds().minExtents &&
+            loaded.getBounds().maxExtents == grid.getBounds().maxExtents, "Loaded grid has different bounds" );
+
+      // Only registered grids are searched.
+      ambient = sceneAmbient;
+      test( !LightProbeGrid::findAmbient( Point3F( 1.0f, 2.0f, 2.5f ), &ambient ), "Found an unregistered grid" );
+
+      loaded.registerGrid();
+      test( LightProbeGrid::findAmbient( Point3F( 1.0f, 2.0f, 2.5f ), &ambient ), "Registered grid wasn't found" );
+      loaded.unregisterGrid();
+   }
+};
+
+#endif // !TORQUE_SHIPPING
@@ -0,0 +1,175 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "lighting/advanced/lightTileGrid.h"
+#include "math/util/frustum.h"
+#include "math/mathUtils.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestLightTileGrid, "Lighting/TileGrid" )
+{
+   enum
+   {
+      NUM_LIGHTS = 1000,
+      NUM_SAMPLES = 64
+   };
+
+   /// Returns true if the tile lists of both grids are the same.
+   static bool gridsMatch( const LightTileGrid &grid1, const LightTileGrid &grid2 )
+   {
+      for ( U32 y = 0; y < grid1.getNumTilesY(); y++ )
+      {
+         for ( U32 x = 0; x < grid1.getNumTilesX(); x++ )
+         {
+            if ( grid1.getTileLightCount( x, y ) != grid2.getTileLightCount( x, y ) )
+               return false;
+
+            U32 count1, count2;
+            const U16 *lights1 = grid1.getTileLights( x, y, &count1 );
+            const U16 *lights2 = grid2.getTileLights( x, y, &count2 );
+            if ( count1 != count2 || dMemcmp( lights1, lights2, count1 * sizeof( U16 ) ) != 0 )
+               return false;
+         }
+      }
+
+      return true;
+   }
+
+   void run()
+   {
+      MRandomLCG rand( 9753 );
+
+      // A camera looking down the y axis from a bit above the origin.
+      MatrixF xfm( true );
+      xfm.setPosition( Point3F( 0.0f, 0.0f, 10.0f ) );
+
+      Frustum frustum;
+      frustum.set( false, mDegToRad( 60.0f ), 16.0f / 9.0f, 0.1f, 500.0f, xfm );
+
+      const RectI viewport( 0, 0, 1280, 720 );
+
+      // Lights in front of, around and behind the camera, some of
+      // which contain the camera.
+      Vector<SphereF> lights;
+      for ( U32 i = 0; i < NUM_LIGHTS; i++ )
+      {
+         lights.push_back( SphereF( Point3F( rand.randF( -300.0f, 300.0f ),
+                                             rand.randF( -50.0f, 550.0f ),
+                                             rand.randF( -40.0f, 60.0f ) ),
+                                    rand.randF( 1.0f, 20.0f ) ) );
+      }
+
+      const U32 oldMinParallelLights = LightTileGrid::smMinParallelLights;
+
+      LightTileGrid::smMinParallelLights = U32_MAX;
+      LightTileGrid serialGrid;
+      test( serialGrid.build( frustum, viewport, lights.address(), lights.size() ), "Grid wasn't built" );
+
+      LightTileGrid::smMinParallelLights = 0;
+      LightTileGrid parallelGrid;
+      parallelGrid.build( frustum, viewport, lights.address(), lights.size() );
+
+      LightTileGrid::smMinParallelLights = oldMinParallelLights;
+
+      test( gridsMatch( serialGrid, parallelGrid ), "Serial and parallel grids differ" );
+
+      // Every point of a light sphere that is on screen must fall into
+      // the tile range of the light.
+
+      MatrixF worldToView = frustum.getTransform();
+      worldToView.inverse();
+      MatrixF projection;
+      frustum.getProjectionMatrix( &projection );
+
+      const U32 tileSize = getMax( LightTileGrid::smTileSize, (U32)8 );
+
+      U32 numVisible = 0;
+      bool allCovered = true;
+      for ( U32 i = 0; i < lights.size(); i++ )
+      {
+         const SphereF &light = lights[i];
+         const LightTileGrid::TileRange &range = serialGrid.getLightTiles( i );
+
+         if ( serialGrid.isLightVisible( i ) )
+            numVisible++;
+
+         for ( U32 n = 0; n < NUM_SAMPLES; n++ )
+         {
+            Point3F dir( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ) );
+            dir.normalizeSafe();
+
+            Point3F screen;
+            if ( !MathUtils::mProjectWorldToScreen( light.center + dir * light.radius * 0.99f, &screen, viewport, worldToView, projection ) )
+               continue;
+
+            const U32 x = getMin( (U32)screen.x / tileSize, serialGrid.getNumTilesX() - 1 );
+            const U32 y = getMin( (U32)screen.y / tileSize, serialGrid.getNumTilesY() - 1 );
+
+            allCovered &= ( range.isValid() && x >= range.minX && x <= range.maxX && y >= range.minY && y <= range.maxY );
+         }
+      }
+
+      test( numVisible > 0 && numVisible < NUM_LIGHTS, "Expected some lights to be outside the view" );
+      test( allCovered, "Tile range misses a visible point of a light" );
+
+      // The tile counts must match the tile ranges and the lists must
+      // hold the first lights in index order.
+
+      bool listsMatch = true;
+      for ( U32 y = 0; y < serialGrid.getNumTilesY(); y++ )
+      {
+         for ( U32 x = 0; x < serialGrid.getNumTilesX(); x++ )
+         {
+            Vector<U16> expected;
+            for ( U32 i = 0; i < lights.size(); i++ )
+            {
+               const LightTileGrid::TileRange &range = serialGrid.getLightTiles( i );
+               if ( range.isValid() && x >= range.minX && x <= range.maxX && y >= range.minY && y <= range.maxY )
+                  expected.push_back( i );
+            }
+
+            U32 count;
+            const U16 *tileLights = serialGrid.getTileLights( x, y, &count );
+
+            listsMatch &= ( serialGrid.getTileLightCount( x, y ) == expected.size() &&
+                            count == getMin( (U32)expected.size(), (U32)LightTileGrid::MaxTileLights ) &&
+                            dMemcmp( tileLights, expected.address(), count * sizeof( U16 ) ) == 0 );
+         }
+      }
+
+      test( listsMatch, "Tile light lists don't match the light tile ranges" );
+
+      Con::printf( "LightTileGrid: %d of %d lights visible, %dx%d tiles, at most %d lights per tile",
+         numVisible, NUM_LIGHTS, serialGrid.getNumTilesX(), serialGrid.getNumTilesY(), serialGrid.getMaxTileLightCount() );
+   }
+};
+
+#endif // !TORQUE_SHIPPING
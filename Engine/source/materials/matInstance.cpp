@@ -250,6 +250,10 @@ void MatInstance::construct()
    mHasNormalMaps = false;
    mIsForwardLit = false;
    mIsValid = false;
+   mInitPending = false;
+   mPendingTextureTargets = false;
+   mSharedMaterial = NULL;
+   mUnshared = false;
 
    MATMGR->_track(this);
 }
@@ -259,7 +263,10 @@ void MatInstance::construct()
 //----------------------------------------------------------------------------
 MatInstance::~MatInstance()
 {
-   SAFE_DELETE(mProcessedMaterial);
+   if ( mInitPending )
+      MATMGR->_cancelDeferredInit( this );
+
+   _releaseProcessedMaterial();
    SAFE_DELETE(mDefaultParameters);
    for (U32 i = 0; i < mCurrentHandles.size(); i++)
       SAFE_DELETE(mCurrentHandles[i]);   
@@ -278,19 +285,75 @@ bool MatInstance::init( const FeatureSet &features,
    mFeatureList = features;
    mVertexFormat = vertexFormat;
 
-   SAFE_DELETE(mProcessedMaterial);   
+   _releaseProcessedMaterial();   
+
+   if ( mInitPending )
+   {
+      MATMGR->_cancelDeferredInit( this );
+      mInitPending = false;
+   }
+
+   // Render with the stand-in until the manager gets
+   // around to processing the real material.
+   if ( MATMGR->_canDeferInit( mMaterial ) && _processDeferredInitMaterial() )
+   {
+      mInitPending = true;
+      mPendingTextureTargets = Material::sAllowTextureTargetAssignment;
+      MATMGR->_queueDeferredInit( this );
+      mIsValid = true;
+      return mIsValid;
+   }
+
    mIsValid = processMaterial();         
 
    return mIsValid;
 }
 
+bool MatInstance::_processDeferredInitMaterial()
+{
+   Material *standIn = MATMGR->_getDeferredInitMaterial();
+   if ( !standIn )
+      return false;
+
+   // Swap in the stand-in so that derived instances 
+   // still get their own type of processed material.
+   Material *material = mMaterial;
+   mMaterial = standIn;
+   const bool valid = processMaterial();
+   mMaterial = material;
+
+   return valid;
+}
+
+void MatInstance::_finishDeferredInit()
+{
+   AssertFatal( mInitPending, "MatInstance::_finishDeferredInit - The init wasn't deferred!" );
+   mInitPending = false;
+
+   const bool allowTextureTargets = Material::sAllowTextureTargetAssignment;
+   Material::sAllowTextureTargetAssignment = mPendingTextureTargets;
+
+   // This reloads any handles and parameters given out
+   // while rendering with the stand-in and removes the
+   // hooks which were created from it.
+   reInit();
+
+   Material::sAllowTextureTargetAssignment = allowTextureTargets;
+}
+
 
 //----------------------------------------------------------------------------
 // reInitialize
 //----------------------------------------------------------------------------
 bool MatInstance::reInit()
 {
-   SAFE_DELETE(mProcessedMaterial);
+   if ( mInitPending )
+   {
+      MATMGR->_cancelDeferredInit( this );
+      mInitPending = false;
+   }
+
+   _releaseProcessedMaterial();
    deleteAllHooks();
    mIsValid = processMaterial();
 
@@ -318,6 +381,20 @@ bool MatInstance::processMaterial()
 
    SAFE_DELETE(mDefaultParameters);
 
+   // Use an identical processed material if
+   // another instance has already created one.
+   const String sharedKey = _getSharedMaterialKey();
+   if ( sharedKey.isNotEmpty() )
+   {
+      mSharedMaterial = MATMGR->_findSharedMaterial( sharedKey );
+      if ( mSharedMaterial )
+      {
+         mProcessedMaterial = mSharedMaterial->material;
+         _initFromProcessedMaterial();
+         return true;
+      }
+   }
+
    CustomMaterial *custMat = NULL;
 
    if( dynamic_cast<CustomMaterial*>(mMaterial) )
@@ -354,23 +431,23 @@ bool MatInstance::processMaterial()
 
       FeatureSet features( mFeatureList );
       features.exclude( MATMGR->getExclusionFeatures() );
+
+      // A shared material can outlive our vertex format.
+      const GFXVertexFormat *vertexFormat = mVertexFormat;
+      if ( sharedKey.isNotEmpty() )
+         vertexFormat = MATMGR->_getSharedVertexFormat( mVertexFormat );
       
-      if( !mProcessedMaterial->init(features, mVertexFormat, mFeaturesDelegate) )
+      if( !mProcessedMaterial->init(features, vertexFormat, mFeaturesDelegate) )
       {
          Con::errorf( "Failed to initialize material '%s'", getMaterial()->getName() );
          SAFE_DELETE( mProcessedMaterial );
          return false;
       }
 
-      mDefaultParameters = new MatInstParameters(mProcessedMaterial->getDefaultMaterialParameters());
-      mActiveParameters = mDefaultParameters;
+      if ( sharedKey.isNotEmpty() )
+         mSharedMaterial = MATMGR->_addSharedMaterial( sharedKey, mProcessedMaterial );
 
-      const FeatureSet &finalFeatures = mProcessedMaterial->getFeatures();
-      mHasNormalMaps = finalFeatures.hasFeature( MFT_NormalMap );
-
-      mIsForwardLit =   (  custMat && custMat->mForwardLit ) || 
-                        (  !finalFeatures.hasFeature( MFT_IsEmissive ) &&
-                           finalFeatures.hasFeature( MFT_ForwardShading ) );
+      _initFromProcessedMaterial();
 
       return true;
    }
@@ -378,6 +455,57 @@ bool MatInstance::processMaterial()
    return false;
 }
 
+void MatInstance::_initFromProcessedMaterial()
+{
+   mDefaultParameters = new MatInstParameters(mProcessedMaterial->getDefaultMaterialParameters());
+   mActiveParameters = mDefaultParameters;
+
+   const FeatureSet &finalFeatures = mProcessedMaterial->getFeatures();
+   mHasNormalMaps = finalFeatures.hasFeature( MFT_NormalMap );
+
+   const CustomMaterial *custMat = dynamic_cast<CustomMaterial*>( mMaterial );
+   mIsForwardLit =   (  custMat && custMat->mForwardLit ) || 
+                     (  !finalFeatures.hasFeature( MFT_IsEmissive ) &&
+                        finalFeatures.hasFeature( MFT_ForwardShading ) );
+}
+
+String MatInstance::_getSharedMaterialKey() const
+{
+   if (  !MaterialManager::smShareProcessedMaterials || 
+         mUnshared ||
+         !_canShareProcessedMaterial() )
+      return String::EmptyString;
+
+   // The processed material holds onto these, so 
+   // they would leak between the instances.
+   if (  mUserObject || 
+         !mFeaturesDelegate.empty() ||
+         mFeatureList.hasFeature( MFT_UseInstancing ) )
+      return String::EmptyString;
+
+   String macros;
+   GFXShaderMacro::stringize( mUserMacros, &macros );
+
+   return String::ToString( "%p %s %s %08x %s",
+      mMaterial,
+      mVertexFormat->getDescription().c_str(),
+      mFeatureList.getDescription().c_str(),
+      mUserDefinedState.getHashValue(),
+      macros.c_str() );
+}
+
+void MatInstance::_releaseProcessedMaterial()
+{
+   if ( mSharedMaterial )
+   {
+      MATMGR->_releaseSharedMaterial( mSharedMaterial );
+      mSharedMaterial = NULL;
+      mProcessedMaterial = NULL;
+   }
+   else
+      SAFE_DELETE( mProcessedMaterial );
+}
+
 const MatStateHint& MatInstance::getStateHint() const
 {
    if ( mProcessedMaterial )
@@ -521,6 +649,18 @@ MaterialParameterHandle* MatInstance::getMaterialParameterHandle(const String& n
 MaterialParameters* MatInstance::allocMaterialParameters() 
 {  
    AssertFatal(mProcessedMaterial, "Not init'ed!"); 
+
+   // The processed material holds the active parameters, so
+   // we need our own before the caller can change them.  This
+   // must happen here and not in setMaterialParameters() which
+   // is called in the middle of a pass.
+   if ( mSharedMaterial )
+   {
+      AssertFatal( mCurPass == -1, "MatInstance::allocMaterialParameters - Can't unshare within a pass!" );
+      mUnshared = true;
+      reInit();
+   }
+
    MatInstParameters* mip = new MatInstParameters();
    mip->loadParameters(mProcessedMaterial);
    mCurrentParameters.push_back(mip);
@@ -530,6 +670,10 @@ MaterialParameters* MatInstance::allocMaterialParameters()
 void MatInstance::setMaterialParameters(MaterialParameters* param) 
 { 
    AssertFatal(mProcessedMaterial, "Not init'ed!"); 
+
+   AssertFatal( !mSharedMaterial || param == mDefaultParameters, 
+      "MatInstance::setMaterialParameters - Shared materials only use the default parameters!" );
+
    mProcessedMaterial->setMaterialParameters(param, mCurPass);
    AssertFatal(dynamic_cast<MatInstParameters*>(param), "Incorrect param type!");
    mActiveParameters = static_cast<MatInstParameters*>(param);
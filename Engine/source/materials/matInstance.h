@@ -44,6 +44,7 @@ class ShaderFeature;
 class MatInstanceParameterHandle;
 class MatInstParameters;
 class ProcessedMaterial;
+struct SharedProcessedMaterial;
 
 
 ///
@@ -87,12 +88,18 @@ public:
 
    ProcessedMaterial *getProcessedMaterial() const { return mProcessedMaterial; }
 
+   /// Returns true if the instance is rendering with the stand-in 
+   /// material until the deferred initialization is finished.
+   /// @see MaterialManager::smDeferredInit
+   bool isInitPending() const { return mInitPending; }
+
    virtual const GFXStateBlockDesc &getUserStateBlock() const { return mUserDefinedState; }
 
    virtual bool isCustomMaterial() const { return mCreatedFromCustomMaterial; }
 protected:
 
    friend class Material;
+   friend class MaterialManager;
 
    /// Create a material instance by reference to a Material.
    MatInstance( Material &mat );
@@ -100,6 +107,28 @@ protected:
    virtual bool processMaterial();
    virtual ProcessedMaterial* getShaderMaterial();
 
+   /// Processes the deferred init stand-in material in place 
+   /// of the real material.
+   bool _processDeferredInitMaterial();
+
+   /// Called by the MaterialManager to process the real material.
+   void _finishDeferredInit();
+
+   /// Sets up the default parameters and feature flags
+   /// from the new processed material.
+   void _initFromProcessedMaterial();
+
+   /// Returns the key used to find an identical shared processed
+   /// material or an empty string if this instance can't share.
+   String _getSharedMaterialKey() const;
+
+   /// Derived instances which customize their processed material
+   /// or how it renders must return false to keep their own.
+   virtual bool _canShareProcessedMaterial() const { return true; }
+
+   /// Deletes or releases the processed material.
+   void _releaseProcessedMaterial();
+
    Material* mMaterial;
    ProcessedMaterial* mProcessedMaterial;
 
@@ -127,6 +156,22 @@ protected:
    MatInstParameters* mDefaultParameters;
    
    bool mCreatedFromCustomMaterial;
+
+   /// Set while the instance is queued for deferred initialization.
+   bool mInitPending;
+
+   /// The Material::sAllowTextureTargetAssignment state at the time 
+   /// the init was deferred.
+   bool mPendingTextureTargets;
+
+   /// The shared processed material entry or NULL if the 
+   /// processed material is owned by this instance.
+   SharedProcessedMaterial *mSharedMaterial;
+
+   /// Set once the instance changed state which prevents it 
+   /// from sharing its processed material.
+   bool mUnshared;
+
 private:
    void construct();  
 };
@@ -25,9 +25,12 @@
 
 #include "materials/matInstance.h"
 #include "materials/materialFeatureTypes.h"
+#include "materials/customMaterialDefinition.h"
+#include "materials/processedMaterial.h"
 #include "lighting/lightManager.h"
 #include "core/util/safeDelete.h"
 #include "shaderGen/shaderGen.h"
+#include "gfx/gfxVertexTypes.h"
 #include "core/module.h"
 #include "console/consoleTypes.h"
 
@@ -50,9 +53,16 @@ MODULE_BEGIN( MaterialManager )
 MODULE_END;
 
 
+bool MaterialManager::smDeferredInit = true;
+const char *MaterialManager::smDeferredInitMaterialName = "Torque_DeferredInitMaterial";
+S32 MaterialManager::smDeferredInitBudget = 2;
+bool MaterialManager::smShareProcessedMaterials = true;
+
+
 MaterialManager::MaterialManager()
 {
    VECTOR_SET_ASSOCIATION( mMatInstanceList );
+   VECTOR_SET_ASSOCIATION( mDeferredInits );
 
    mDt = 0.0f; 
    mAccumTime = 0.0f; 
@@ -71,6 +81,26 @@ MaterialManager::MaterialManager()
 
    mFlushAndReInit = false;
 
+   mInstanceGeneration = 0;
+
+   mSyncInitCount = 0;
+
+   Con::addVariable( "$pref::Materials::deferredInit", TypeBool, &smDeferredInit, 
+      "@brief If true material instances render with a stand-in material until "
+      "their shaders and textures are ready.\n\n"
+      "The real material is initialized at the start of a later frame within the "
+      "$pref::Materials::deferredInitBudget.  Translucent, alpha tested and double sided "
+      "materials are always initialized right away.\n\n"
+      "@ingroup Materials");
+   Con::addVariable( "$pref::Materials::deferredInitBudget", TypeS32, &smDeferredInitBudget, 
+      "@brief The milliseconds spent each frame finishing deferred material instances.\n\n"
+      "@ingroup Materials");
+   Con::addVariable( "$pref::Materials::shareProcessedMaterials", TypeBool, &smShareProcessedMaterials, 
+      "@brief If true identical material instances share their shaders, constant buffers "
+      "and pass data.\n\n"
+      "Takes effect as material instances are initialized.\n\n"
+      "@ingroup Materials");
+
    mDefaultAnisotropy = 1;
    Con::addVariable( "$pref::Video::defaultAnisotropy", TypeS32, &mDefaultAnisotropy, 
       "@brief Global variable defining the default anisotropy value.\n\n"
@@ -98,6 +128,12 @@ MaterialManager::~MaterialManager()
 
    SAFE_DELETE( mWarningInst );
 
+   _evictSharedMaterials();
+
+   VertexFormatMap::Iterator formatIter = mSharedVertexFormats.begin();
+   for ( ; formatIter != mSharedVertexFormats.end(); formatIter++ )
+      delete formatIter->value;
+
 #ifndef TORQUE_SHIPPING
    DebugMaterialMap::Iterator itr = mMeshDebugMaterialInsts.begin();
 
@@ -296,6 +332,8 @@ void MaterialManager::flushAndReInitInstances()
    // Clear the flag if its set.
    mFlushAndReInit = false;   
 
+   mInstanceGeneration++;
+
    // Check to see if any shader preferences have changed.
    recalcFeaturesFromPrefs();
 
@@ -304,6 +342,9 @@ void MaterialManager::flushAndReInitInstances()
    SHADERGEN->flushProceduralShaders();   
    mFlushSignal.trigger();
 
+   // Don't let the instances pick up the old shared materials.
+   _evictSharedMaterials();
+
    // First do a pass deleting all hooks as they can contain
    // materials themselves.  This means we have to restart the
    // loop every time we delete any hooks... lame.
@@ -326,9 +367,71 @@ void MaterialManager::flushAndReInitInstances()
       (*iter)->reInit();
 }
 
+U32 MaterialManager::prewarmShaders()
+{
+   PROFILE_SCOPE( MaterialManager_PrewarmShaders );
+
+   // We want the real shaders generated now.
+   SyncInitScope syncInit;
+
+   // Start with the common mesh formats then add the 
+   // ones which are actually in use right now.
+   Vector<const GFXVertexFormat*> formats;
+   formats.push_back( getGFXVertexFormat<GFXVertexPNTT>() );
+   formats.push_back( getGFXVertexFormat<GFXVertexPNTTB>() );
+
+   for ( U32 i=0; i < mMatInstanceList.size(); i++ )
+   {
+      const GFXVertexFormat *format = mMatInstanceList[i]->getVertexFormat();
+      if ( !format )
+         continue;
+
+      bool found = false;
+      for ( U32 j=0; j < formats.size() && !found; j++ )
+         found = formats[j]->isEqual( *format );
+
+      if ( !found )
+         formats.push_back( format );
+   }
+
+   const U32 startSize = SHADERGEN->getCacheIndexSize();
+   U32 numMaterials = 0;
+
+   // The deferred init stand-in gets its shaders on first use.
+   Material *standIn = NULL;
+   Sim::findObject( smDeferredInitMaterialName, standIn );
+
+   SimSet *matSet = getMaterialSet();
+   for ( SimSet::iterator iter = matSet->begin(); iter != matSet->end(); iter++ )
+   {
+      Material *mat = dynamic_cast<Material*>( *iter );
+      if ( !mat || mat == standIn )
+         continue;
+
+      numMaterials++;
+
+      for ( U32 i=0; i < formats.size(); i++ )
+      {
+         BaseMatInstance *matInst = mat->createMatInstance();
+         matInst->init( getDefaultFeatures(), formats[i] );
+         delete matInst;
+      }
+   }
+
+   SHADERGEN->saveCacheIndex();
+
+   const U32 numNew = SHADERGEN->getCacheIndexSize() - startSize;
+   Con::printf( "MaterialManager::prewarmShaders - Added %d shaders to the cache for %d materials and %d vertex formats.",
+      numNew, numMaterials, formats.size() );
+
+   return numNew;
+}
+
 // Used in the materialEditor. This flushes the material preview object so it can be reloaded easily.
 void MaterialManager::flushInstance( BaseMaterialDefinition *target )
 {
+   mInstanceGeneration++;
+
    Vector<BaseMatInstance*>::iterator iter = mMatInstanceList.begin();
    while ( iter != mMatInstanceList.end() )
    {
@@ -343,6 +446,10 @@ void MaterialManager::flushInstance( BaseMaterialDefinition *target )
 
 void MaterialManager::reInitInstance( BaseMaterialDefinition *target )
 {
+   mInstanceGeneration++;
+
+   _evictSharedMaterials( target );
+
    Vector<BaseMatInstance*>::iterator iter = mMatInstanceList.begin();
    for ( ; iter != mMatInstanceList.end(); iter++ )
    {
@@ -406,6 +513,157 @@ void MaterialManager::_track( MatInstance *matInstance )
 void MaterialManager::_untrack( MatInstance *matInstance )
 {
    mMatInstanceList.remove( matInstance );
+   mInstanceGeneration++;
+}
+
+MaterialManager::SyncInitScope::SyncInitScope()
+{
+   MATMGR->mSyncInitCount++;
+}
+
+MaterialManager::SyncInitScope::~SyncInitScope()
+{
+   MATMGR->mSyncInitCount--;
+}
+
+bool MaterialManager::_canDeferInit( Material *mat )
+{
+   if ( !smDeferredInit || mSyncInitCount > 0 || !mat )
+      return false;
+
+   // Only the procedural shader path is expensive enough to defer.
+   if ( GFX->getPixelShaderVersion() <= 0.001f || dynamic_cast<CustomMaterial*>( mat ) )
+      return false;
+
+   // The stand-in is opaque and single sided, so materials which
+   // blend, cut out pixels or show their back faces would render
+   // wrong while waiting.
+   if ( mat->isTranslucent() || mat->mAlphaTest || mat->isDoubleSided() )
+      return false;
+
+   // The stand-in itself must always be ready.
+   return mat != _getDeferredInitMaterial();
+}
+
+Material* MaterialManager::_getDeferredInitMaterial()
+{
+   Material *mat;
+   if ( !Sim::findObject( smDeferredInitMaterialName, mat ) )
+   {
+      mat = allocateAndRegister( smDeferredInitMaterialName );
+      if ( mat )
+         mat->mDiffuse[0].set( 0.5f, 0.5f, 0.5f, 1.0f );
+   }
+
+   return mat;
+}
+
+SharedProcessedMaterial* MaterialManager::_findSharedMaterial( const String &key )
+{
+   SharedMaterialMap::Iterator iter = mSharedMaterials.find( key );
+   if ( iter == mSharedMaterials.end() )
+      return NULL;
+
+   iter->value->refCount++;
+   return iter->value;
+}
+
+SharedProcessedMaterial* MaterialManager::_addSharedMaterial( const String &key, ProcessedMaterial *material )
+{
+   AssertFatal( mSharedMaterials.find( key ) == mSharedMaterials.end(), 
+      "MaterialManager::_addSharedMaterial - The key is already in use!" );
+
+   SharedProcessedMaterial *shared = new SharedProcessedMaterial;
+   shared->key = key;
+   shared->material = material;
+   shared->refCount = 1;
+   shared->isMapped = true;
+
+   mSharedMaterials.insert( key, shared );
+
+   return shared;
+}
+
+void MaterialManager::_releaseSharedMaterial( SharedProcessedMaterial *shared )
+{
+   AssertFatal( shared->refCount > 0, "MaterialManager::_releaseSharedMaterial - Bad ref count!" );
+
+   if ( --shared->refCount > 0 )
+      return;
+
+   if ( shared->isMapped )
+      mSharedMaterials.erase( shared->key );
+
+   delete shared->material;
+   delete shared;
+}
+
+void MaterialManager::_evictSharedMaterials( BaseMaterialDefinition *target )
+{
+   Vector<String> keys;
+
+   SharedMaterialMap::Iterator iter = mSharedMaterials.begin();
+   for ( ; iter != mSharedMaterials.end(); iter++ )
+   {
+      if ( target && iter->value->material->getMaterial() != target )
+         continue;
+
+      iter->value->isMapped = false;
+      keys.push_back( iter->key );
+   }
+
+   for ( U32 i=0; i < keys.size(); i++ )
+      mSharedMaterials.erase( keys[i] );
+}
+
+const GFXVertexFormat* MaterialManager::_getSharedVertexFormat( const GFXVertexFormat *format )
+{
+   GFXVertexFormat *&shared = mSharedVertexFormats[ format->getDescription() ];
+   if ( !shared )
+      shared = new GFXVertexFormat( *format );
+
+   return shared;
+}
+
+void MaterialManager::processDeferredInits()
+{
+   if ( mDeferredInits.empty() )
+      return;
+
+   PROFILE_SCOPE( MaterialManager_ProcessDeferredInits );
+
+   const U32 startTime = Platform::getRealMilliseconds();
+
+   // Always finish at least one instance so that the
+   // queue drains no matter how small the budget is.
+   do
+   {
+      MatInstance *matInst = mDeferredInits.first();
+      mDeferredInits.pop_front();
+      matInst->_finishDeferredInit();
+   }
+   while ( !mDeferredInits.empty() && 
+           ( Platform::getRealMilliseconds() - startTime ) < (U32)getMax( smDeferredInitBudget, 0 ) );
+
+   // The finished instances lost their hooks.
+   mInstanceGeneration++;
+}
+
+void MaterialManager::flushDeferredInits()
+{
+   if ( mDeferredInits.empty() )
+      return;
+
+   PROFILE_SCOPE( MaterialManager_FlushDeferredInits );
+
+   while ( !mDeferredInits.empty() )
+   {
+      MatInstance *matInst = mDeferredInits.first();
+      mDeferredInits.pop_front();
+      matInst->_finishDeferredInit();
+   }
+
+   mInstanceGeneration++;
 }
 
 void MaterialManager::recalcFeaturesFromPrefs()
@@ -441,6 +699,8 @@ bool MaterialManager::_handleGFXEvent( GFXDevice::GFXDeviceEventType event_ )
       case GFXDevice::deStartOfFrame:
          if ( mFlushAndReInit )
             flushAndReInitInstances();
+         else
+            processDeferredInits();
          break;
 
       default:
@@ -457,6 +717,26 @@ ConsoleFunction( reInitMaterials, void, 1, 1,
    MATMGR->flushAndReInitInstances();
 }
 
+ConsoleFunction( prewarmShaderCache, S32, 1, 1, 
+   "@brief Generates the procedural shaders for all the material definitions "
+   "and writes them to the shader cache.\n\n"
+   "Exec the materials of all the levels before calling this to fill the "
+   "cache offline and avoid stalls the first time a material is seen.\n\n"
+   "@return The number of new shaders added to the cache.\n"
+   "@ingroup Materials")
+{
+   return MATMGR->prewarmShaders();
+}
+
+ConsoleFunction( flushDeferredMaterialInits, void, 1, 1, 
+   "@brief Finishes the initialization of all the material instances which "
+   "are still rendering with a stand-in material.\n\n"
+   "@see $pref::Materials::deferredInit\n"
+   "@ingroup Materials")
+{
+   MATMGR->flushDeferredInits();
+}
+
 ConsoleFunction( addMaterialMapping, void, 3, 3, "(string texName, string matName)\n"
    "@brief Maps the given texture to the given material.\n\n"
    "Generates a console warning before overwriting.\n\n"
@@ -37,6 +37,25 @@
 
 class SimSet;
 class MatInstance;
+class ProcessedMaterial;
+
+/// A ProcessedMaterial shared by identical MatInstances.
+/// @see MaterialManager::smShareProcessedMaterials
+struct SharedProcessedMaterial
+{
+   /// The key describing everything the processed material was built from.
+   String key;
+
+   ProcessedMaterial *material;
+
+   /// The number of instances using the material.
+   U32 refCount;
+
+   /// False once the material was evicted from the lookup 
+   /// map and is only waiting for its users to release it.
+   bool isMapped;
+};
+
 
 class MaterialManager : public ManagedSingleton<MaterialManager>
 {
@@ -120,6 +139,69 @@ public:
    /// Re-initializes the material instances for a specific target material.   
    void reInitInstance( BaseMaterialDefinition *target );
 
+   /// Generates the shaders for every material definition so that they
+   /// are found in the persistent shader cache on the next run.  The
+   /// shaders are generated with the default features for the common
+   /// mesh vertex formats and every vertex format in use by the current
+   /// material instances.
+   ///
+   /// @return The number of new shaders added to the cache.
+   /// @see ShaderGen::smUseCacheIndex
+   U32 prewarmShaders();
+
+   /// @name Deferred Initialization
+   ///
+   /// When enabled, material instances initialize with a cheap stand-in
+   /// material and queue the real shader generation and texture loading.
+   /// The queue is processed at the start of each frame within a time 
+   /// budget, so objects streaming into view don't stall the frame.
+   /// @{
+
+   /// If true material instances defer their initialization.  The
+   /// stand-in is opaque and single sided, so translucent, alpha
+   /// tested and double sided materials are never deferred.
+   static bool smDeferredInit;
+
+   /// The time in milliseconds spent each frame finishing deferred 
+   /// material instances.  At least one instance is always finished.
+   static S32 smDeferredInitBudget;
+
+   /// Finishes deferred material instances until the frame budget is spent.
+   void processDeferredInits();
+
+   /// Finishes all the deferred material instances.
+   void flushDeferredInits();
+
+   /// Returns the number of material instances waiting to be finished.
+   U32 getNumDeferredInits() const { return mDeferredInits.size(); }
+
+   /// Forces material instances to initialize immediately while in
+   /// scope.  Use this when rendering offline, like when capturing
+   /// imposters, where the stand-in material would be captured.
+   class SyncInitScope
+   {
+   public:
+      SyncInitScope();
+      ~SyncInitScope();
+   };
+
+   /// @}
+
+   /// If true material instances with the same material, features,
+   /// vertex format, state and macros share one ProcessedMaterial.
+   /// An instance gets its own again when allocMaterialParameters()
+   /// is called on it.
+   static bool smShareProcessedMaterials;
+
+   /// Returns the number of shared processed materials.
+   U32 getNumSharedMaterials() const { return mSharedMaterials.size(); }
+
+   /// Returns a counter which is incremented whenever material instances
+   /// are re-initialized, lose their hooks, or are destroyed.  Systems which
+   /// hold on to material instances across frames use this to detect when
+   /// they need to be refreshed.
+   U32 getInstanceGeneration() const { return mInstanceGeneration; }
+
 protected:
 
    // MatInstance tracks it's instances here
@@ -127,6 +209,40 @@ protected:
    void _track(MatInstance*);
    void _untrack(MatInstance*);
 
+   /// Returns true if an instance of the material can defer its init.
+   bool _canDeferInit( Material *mat );
+
+   void _queueDeferredInit( MatInstance *matInst ) { mDeferredInits.push_back( matInst ); }
+   void _cancelDeferredInit( MatInstance *matInst ) { mDeferredInits.remove( matInst ); }
+
+   /// The name of the stand-in material used by deferred instances.
+   static const char *smDeferredInitMaterialName;
+
+   /// Returns the stand-in material used by deferred instances.
+   Material* _getDeferredInitMaterial();
+
+   /// Returns the shared processed material for the key with 
+   /// a new reference or NULL if there isn't one.
+   SharedProcessedMaterial* _findSharedMaterial( const String &key );
+
+   /// Takes ownership of the processed material and returns 
+   /// its shared entry with one reference.
+   SharedProcessedMaterial* _addSharedMaterial( const String &key, ProcessedMaterial *material );
+
+   /// Releases a reference and deletes the processed 
+   /// material when it was the last one.
+   void _releaseSharedMaterial( SharedProcessedMaterial *shared );
+
+   /// Stops handing out the shared processed materials of the target
+   /// material or all of them if target is NULL.  Existing users keep
+   /// theirs until they are reinitialized.
+   void _evictSharedMaterials( BaseMaterialDefinition *target = NULL );
+
+   /// Returns a copy of the vertex format which lives as long as the 
+   /// manager, as a shared processed material can outlive the format 
+   /// of the instance that created it.
+   const GFXVertexFormat* _getSharedVertexFormat( const GFXVertexFormat *format );
+
    /// @see LightManager::smActivateSignal
    void _onLMActivate( const char *lm, bool activate );
 
@@ -149,6 +265,9 @@ protected:
    /// start of the next rendered frame.
    bool mFlushAndReInit;
 
+   /// @see getInstanceGeneration
+   U32 mInstanceGeneration;
+
    // material map
    typedef Map<String, String> MaterialMap;
    MaterialMap mMaterialMap;
@@ -162,6 +281,22 @@ protected:
 
    BaseMatInstance* mWarningInst;
 
+   /// The material instances waiting to be finished in the order they were queued.
+   Vector<MatInstance*> mDeferredInits;
+
+   /// @see SyncInitScope
+   U32 mSyncInitCount;
+
+   typedef Map<String, SharedProcessedMaterial*> SharedMaterialMap;
+
+   /// The shared processed materials by key.
+   SharedMaterialMap mSharedMaterials;
+
+   typedef Map<String, GFXVertexFormat*> VertexFormatMap;
+
+   /// @see _getSharedVertexFormat
+   VertexFormatMap mSharedVertexFormats;
+
    /// The default max anisotropy used in texture filtering.
    S32 mDefaultAnisotropy;
 
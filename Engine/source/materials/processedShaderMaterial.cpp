@@ -955,29 +955,39 @@ void ProcessedShaderMaterial::_setShaderConstants(SceneRenderState * state, cons
    ShaderConstHandles* handles = _getShaderConstHandles(pass);
    U32 stageNum = getStageFromPass(pass);
 
-   // First we do all the constants which are not
-   // controlled via the material... we have to
-   // set these all the time as they could change.
-
-   if ( handles->mFogDataSC->isValid() )
+   // First we do the constants which only depend on the
+   // render state.  The buffer keeps them between draws, so
+   // they are only set once for each state which uses it.
+   ShaderMaterialParameters *params = static_cast<ShaderMaterialParameters*>( mCurrentParams );
+   const U32 stateId = state ? state->getId() : 0;
+   if (  shaderConsts->wasLost() || 
+         stateId == 0 || 
+         params->getStateConstsId( pass ) != stateId )
    {
-      Point3F fogData;
-      fogData.x = sgData.fogDensity;
-      fogData.y = sgData.fogDensityOffset;
-      fogData.z = sgData.fogHeightFalloff;     
-      shaderConsts->set( handles->mFogDataSC, fogData );
+      params->setStateConstsId( pass, stateId );
+      _setStateConstants( state, sgData, shaderConsts, handles );
    }
 
-   shaderConsts->setSafe(handles->mFogColorSC, sgData.fogColor);
-
-   if( handles->mOneOverFarplane->isValid() )
+   // The same render state can draw into more than one target,
+   // so the target size is set for every draw.
+   if ( handles->mRTSizeSC->isValid() )
    {
-      const F32 &invfp = 1.0f / state->getFarPlane();
-      Point4F oneOverFP(invfp, invfp, invfp, invfp);
-      shaderConsts->set( handles->mOneOverFarplane, oneOverFP );
+      const Point2I &resolution = GFX->getActiveRenderTarget()->getSize();
+      Point2F pixelShaderConstantData;
+
+      pixelShaderConstantData.x = resolution.x;
+      pixelShaderConstantData.y = resolution.y;
+
+      shaderConsts->set( handles->mRTSizeSC, pixelShaderConstantData );
    }
 
-   shaderConsts->setSafe( handles->mAccumTimeSC, MATMGR->getTotalTime() );
+   if ( handles->mOneOverRTSizeSC->isValid() )
+   {
+      const Point2I &resolution = GFX->getActiveRenderTarget()->getSize();
+      Point2F oneOverTargetSize( 1.0f / (F32)resolution.x, 1.0f / (F32)resolution.y );
+
+      shaderConsts->set( handles->mOneOverRTSizeSC, oneOverTargetSize );
+   }
 
    // If the shader constants have not been lost then
    // they contain the content from a previous render pass.
@@ -1007,25 +1017,6 @@ void ProcessedShaderMaterial::_setShaderConstants(SceneRenderState * state, cons
       shaderConsts->set(handles->mSubSurfaceParamsSC, subSurfParams);
    }
 
-   if ( handles->mRTSizeSC->isValid() )
-   {
-      const Point2I &resolution = GFX->getActiveRenderTarget()->getSize();
-      Point2F pixelShaderConstantData;
-
-      pixelShaderConstantData.x = resolution.x;
-      pixelShaderConstantData.y = resolution.y;
-
-      shaderConsts->set( handles->mRTSizeSC, pixelShaderConstantData );
-   }
-
-   if ( handles->mOneOverRTSizeSC->isValid() )
-   {
-      const Point2I &resolution = GFX->getActiveRenderTarget()->getSize();
-      Point2F oneOverTargetSize( 1.0f / (F32)resolution.x, 1.0f / (F32)resolution.y );
-
-      shaderConsts->set( handles->mOneOverRTSizeSC, oneOverTargetSize );
-   }
-
    // set detail scale
    shaderConsts->setSafe(handles->mDetailScaleSC, mMaterial->mDetailScale[stageNum]);
    shaderConsts->setSafe(handles->mDetailBumpStrength, mMaterial->mDetailNormalMapStrength[stageNum]);
@@ -1083,6 +1074,44 @@ void ProcessedShaderMaterial::_setShaderConstants(SceneRenderState * state, cons
    }
 }
 
+void ProcessedShaderMaterial::_setStateConstants( SceneRenderState *state, 
+                                                  const SceneData &sgData, 
+                                                  GFXShaderConstBuffer *shaderConsts, 
+                                                  ShaderConstHandles *handles )
+{
+   PROFILE_SCOPE( ProcessedShaderMaterial_SetStateConstants );
+
+   if ( handles->mFogDataSC->isValid() )
+   {
+      Point3F fogData;
+      fogData.x = sgData.fogDensity;
+      fogData.y = sgData.fogDensityOffset;
+      fogData.z = sgData.fogHeightFalloff;     
+      shaderConsts->set( handles->mFogDataSC, fogData );
+   }
+
+   shaderConsts->setSafe(handles->mFogColorSC, sgData.fogColor);
+
+   if( handles->mOneOverFarplane->isValid() )
+   {
+      const F32 &invfp = 1.0f / state->getFarPlane();
+      Point4F oneOverFP(invfp, invfp, invfp, invfp);
+      shaderConsts->set( handles->mOneOverFarplane, oneOverFP );
+   }
+
+   shaderConsts->setSafe( handles->mAccumTimeSC, MATMGR->getTotalTime() );
+
+   // The camera constants used to be set for every object.
+   if ( state )
+   {
+      shaderConsts->setSafe( handles->mEyePosWorldSC, state->getCameraPosition() );
+      shaderConsts->setSafe( handles->mEyeMatSC, state->getCameraTransform() );
+
+      if ( handles->m_vEyeSC->isValid() )
+         shaderConsts->set( handles->m_vEyeSC, state->getVectorEye() );
+   }
+}
+
 bool ProcessedShaderMaterial::_hasCubemap(U32 pass)
 {
    // Only support cubemap on the first stage
@@ -1126,9 +1155,6 @@ void ProcessedShaderMaterial::setTransforms(const MatrixSet &matrixSet, SceneRen
       // TODO: Could we not remove this constant?  Use mObjTransSC and cast to float3x3 instead?
       shaderConsts->set(handles->mCubeTransSC, matrixSet.getObjectToWorld(), GFXSCT_Float3x3);
    }
-
-   if ( handles->m_vEyeSC->isValid() )
-      shaderConsts->set( handles->m_vEyeSC, state->getVectorEye() );
 }
 
 void ProcessedShaderMaterial::setSceneInfo(SceneRenderState * state, const SceneData& sgData, U32 pass)
@@ -1151,8 +1177,6 @@ void ProcessedShaderMaterial::setSceneInfo(SceneRenderState * state, const Scene
 
    shaderConsts->setSafe(handles->mVisiblitySC, sgData.visibility);
 
-   shaderConsts->setSafe(handles->mEyePosWorldSC, eyePosWorld);   
-
    if ( handles->mEyePosSC->isValid() )
    {
       MatrixF tempMat( *sgData.objTrans );
@@ -1162,8 +1186,6 @@ void ProcessedShaderMaterial::setSceneInfo(SceneRenderState * state, const Scene
       shaderConsts->set(handles->mEyePosSC, eyepos);   
    }
 
-   shaderConsts->setSafe(handles->mEyeMatSC, state->getCameraTransform());   
-
    ShaderRenderPassData *rpd = _getRPD( pass );
    for ( U32 i=0; i < rpd->featureShaderHandles.size(); i++ )
       rpd->featureShaderHandles[i]->setConsts( state, sgData, shaderConsts );
@@ -246,6 +246,13 @@ protected:
    /// Sets all of the necessary shader constants for the given pass
    virtual void _setShaderConstants(SceneRenderState *, const SceneData &sgData, U32 pass);
 
+   /// Sets the constants which only depend on the render state.  These
+   /// are only set once for each render state using the buffer.
+   void _setStateConstants(   SceneRenderState *state, 
+                              const SceneData &sgData, 
+                              GFXShaderConstBuffer *shaderConsts, 
+                              ShaderConstHandles *handles );
+
    /// @}
 
    void _setPrimaryLightConst(const LightInfo* light, const MatrixF& objTrans, const U32 stageNum);
@@ -63,6 +63,7 @@ ShaderMaterialParameters::ShaderMaterialParameters()
 : MaterialParameters()
 {
    VECTOR_SET_ASSOCIATION( mBuffers );
+   VECTOR_SET_ASSOCIATION( mStateConstsIds );
 }
 
 ShaderMaterialParameters::~ShaderMaterialParameters()
@@ -74,6 +75,10 @@ void ShaderMaterialParameters::setBuffers(Vector<GFXShaderConstDesc>& constDesc,
 {
    mShaderConstDesc = constDesc;
    mBuffers = buffers;
+
+   mStateConstsIds.setSize(buffers.size());
+   for (U32 i = 0; i < mStateConstsIds.size(); i++)
+      mStateConstsIds[i] = 0;
 }
 
 void ShaderMaterialParameters::releaseBuffers()
@@ -83,6 +88,7 @@ void ShaderMaterialParameters::releaseBuffers()
       mBuffers[i] = NULL;
    }
    mBuffers.setSize(0);
+   mStateConstsIds.setSize(0);
 }
 
 U32 ShaderMaterialParameters::getAlignmentValue(const GFXShaderConstType constType)
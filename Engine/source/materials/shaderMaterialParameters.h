@@ -63,6 +63,12 @@ public:
    void setBuffers(Vector<GFXShaderConstDesc>& constDesc, Vector<GFXShaderConstBufferRef>& buffers);   
    GFXShaderConstBuffer* getBuffer(U32 i) { return mBuffers[i]; }
 
+   /// Returns the id of the SceneRenderState the scene wide constants
+   /// in the buffer of the pass were last set for or zero.
+   /// @see SceneRenderState::getId
+   U32 getStateConstsId(U32 i) const { return mStateConstsIds[i]; }
+   void setStateConstsId(U32 i, U32 id) { mStateConstsIds[i] = id; }
+
    ///
    /// MaterialParameter interface
    ///
@@ -94,6 +100,10 @@ public:
 private:
    Vector<GFXShaderConstBufferRef> mBuffers;   
 
+   /// The render state ids per buffer.
+   /// @see getStateConstsId
+   Vector<U32> mStateConstsIds;
+
    void releaseBuffers();
 };
 
@@ -480,6 +480,28 @@ void mProjectScreenToWorld(   const Point3F &in,
 
 //-----------------------------------------------------------------------------
 
+bool getProjectedSphereExtents( const Point3F &viewCenter, F32 radius, Point2F *outMin, Point2F *outMax )
+{
+   const F32 minDepth = viewCenter.y - radius;
+   const F32 maxDepth = viewCenter.y + radius;
+
+   if ( minDepth <= POINT_EPSILON )
+      return false;
+
+   // The extremes of x and z over depth are found at the box corners.
+   const F32 minX = viewCenter.x - radius;
+   const F32 maxX = viewCenter.x + radius;
+   const F32 minZ = viewCenter.z - radius;
+   const F32 maxZ = viewCenter.z + radius;
+
+   outMin->set( getMin( minX / minDepth, minX / maxDepth ), getMin( minZ / minDepth, minZ / maxDepth ) );
+   outMax->set( getMax( maxX / minDepth, maxX / maxDepth ), getMax( maxZ / minDepth, maxZ / maxDepth ) );
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
 bool pointInPolygon( const Point2F *verts, U32 vertCount, const Point2F &testPt )
 {
   U32 i, j, c = 0;
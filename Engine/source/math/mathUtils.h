@@ -190,6 +190,16 @@ namespace MathUtils
                                  F32 far, 
                                  F32 near);
 
+   /// Compute the extents of the perspective projection of a sphere onto the
+   /// plane at unit distance in front of the eye.  The sphere is given in a view
+   /// space with x to the right, y forward and z up and the extents are in x/y
+   /// and z/y.  The view space box of the sphere is projected which makes the
+   /// extents slightly conservative.
+   ///
+   /// @return False if the sphere reaches behind the eye.  It then covers the
+   ///   whole view and @a outMin and @a outMax are not set.
+   bool getProjectedSphereExtents( const Point3F &viewCenter, F32 radius, Point2F *outMin, Point2F *outMax );
+
    /// Clip @a inFrustum by the given polygon.
    ///
    /// @note The input polygon is limited to 58 vertices.
@@ -0,0 +1,208 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "math/util/boxSoA.h"
+#include "math/util/frustum.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+#include "core/frameAllocator.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestMathBoxSoA, "Math/BoxSoA" )
+{
+   enum
+   {
+      NUM_BOXES = 10003,
+      NUM_BENCHMARK_PASSES = 100
+   };
+
+   MRandomLCG mRand;
+   Box3FSoA mBoxes;
+
+   void fillBoxes()
+   {
+      mBoxes.clear();
+      for( U32 i = 0; i < NUM_BOXES; ++ i )
+      {
+         const Point3F center( mRand.randF( -500.0f, 500.0f ), mRand.randF( -500.0f, 500.0f ), mRand.randF( -50.0f, 50.0f ) );
+         const Point3F extents( mRand.randF( 0.1f, 20.0f ), mRand.randF( 0.1f, 20.0f ), mRand.randF( 0.1f, 20.0f ) );
+         mBoxes.push_back( Box3F( center - extents, center + extents ) );
+      }
+   }
+
+   /// Compare a kernel against single-box tests.
+   bool verifyKernel( Box3FSoA::TestPlanesFn kernel, const PlaneSetF& planes )
+   {
+      FrameTemp< S8 > results( mBoxes.getPaddedSize() );
+      kernel( mBoxes, planes.getPlanes(), planes.getNumPlanes(), results );
+
+      for( U32 i = 0; i < mBoxes.size(); ++ i )
+      {
+         const Box3F box = mBoxes.get( i );
+         if( results[ i ] != planes.testPotentialIntersection( box ) )
+            return false;
+         if( ( results[ i ] == GeometryInside ) != planes.isContained( box ) )
+            return false;
+      }
+
+      return true;
+   }
+
+   void test_storage()
+   {
+      Box3FSoA boxes;
+      for( U32 i = 0; i < 37; ++ i )
+         boxes.push_back( Box3F( F32( i ), 0.0f, 0.0f, F32( i + 1 ), 1.0f, 1.0f ) );
+
+      test( boxes.size() == 37, "Wrong size" );
+      test( boxes.getPaddedSize() == 40, "Wrong padded size" );
+      test( ( ( dsize_t ) boxes.getMaxZ() & 15 ) == 0, "Component array not aligned" );
+
+      bool allMatch = true;
+      for( U32 i = 0; i < boxes.size(); ++ i )
+         allMatch &= ( boxes.get( i ).minExtents.x == F32( i ) && boxes.get( i ).maxExtents.x == F32( i + 1 ) );
+      test( allMatch, "Boxes not preserved on growth" );
+
+      // Copies must own their storage.
+
+      Box3FSoA copy( boxes );
+      Box3FSoA assigned;
+      assigned.push_back( Box3F( -1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f ) );
+      assigned = boxes;
+
+      test( copy.size() == 37 && assigned.size() == 37, "Wrong size after copy" );
+      test( copy.getMinX() != boxes.getMinX() && assigned.getMinX() != boxes.getMinX(), "Copy shares storage" );
+
+      boxes.set( 0, Box3F( 100.0f, 0.0f, 0.0f, 101.0f, 1.0f, 1.0f ) );
+
+      bool copiesMatch = true;
+      for( U32 i = 0; i < copy.size(); ++ i )
+      {
+         copiesMatch &= ( copy.get( i ).minExtents.x == F32( i ) && copy.get( i ).maxExtents.x == F32( i + 1 ) );
+         copiesMatch &= ( assigned.get( i ).minExtents.x == F32( i ) && assigned.get( i ).maxExtents.x == F32( i + 1 ) );
+      }
+      test( copiesMatch, "Boxes not preserved on copy" );
+   }
+
+   void test_kernels()
+   {
+      fillBoxes();
+
+      bool frustumsMatch = true;
+      bool volumesMatch = true;
+
+      for( U32 i = 0; i < 50; ++ i )
+      {
+         // Random frustum.
+
+         MatrixF xfm( EulerF( mRand.randF( -1.0f, 1.0f ), 0.0f, mRand.randF( 0.0f, M_2PI_F ) ) );
+         xfm.setPosition( Point3F( mRand.randF( -200.0f, 200.0f ), mRand.randF( -200.0f, 200.0f ), 0.0f ) );
+
+         Frustum frustum;
+         frustum.set( false, mDegToRad( mRand.randF( 30.0f, 90.0f ) ), 1.5f, 0.1f, mRand.randF( 50.0f, 1000.0f ), xfm );
+
+         const PlaneSetF frustumPlanes( frustum.getPlanes(), Frustum::PlaneCount );
+
+         frustumsMatch &= verifyKernel( Box3FSoA::testPlanes_C, frustumPlanes );
+         #if defined( TORQUE_CPU_X86 )
+         frustumsMatch &= verifyKernel( Box3FSoA::testPlanes_SSE, frustumPlanes );
+         #endif
+
+         // Random set of planes through points near the origin, such as
+         // generated for portal and occluder volumes.  Include some
+         // axis-aligned normals to hit the zero component edge case.
+
+         PlaneF planes[ 8 ];
+         const U32 numPlanes = mRand.randI( 1, 8 );
+         for( U32 n = 0; n < numPlanes; ++ n )
+         {
+            Point3F normal( mRand.randF( -1.0f, 1.0f ), mRand.randF( -1.0f, 1.0f ), mRand.randF( -1.0f, 1.0f ) );
+            if( n & 1 )
+               normal.z = 0.0f;
+            normal.normalizeSafe();
+
+            planes[ n ] = PlaneF( Point3F( mRand.randF( -100.0f, 100.0f ), mRand.randF( -100.0f, 100.0f ), 0.0f ), normal );
+         }
+
+         const PlaneSetF volumePlanes( planes, numPlanes );
+
+         volumesMatch &= verifyKernel( Box3FSoA::testPlanes_C, volumePlanes );
+         #if defined( TORQUE_CPU_X86 )
+         volumesMatch &= verifyKernel( Box3FSoA::testPlanes_SSE, volumePlanes );
+         #endif
+      }
+
+      test( frustumsMatch, "Kernel results differ from PlaneSetF on frustums" );
+      test( volumesMatch, "Kernel results differ from PlaneSetF on culling volumes" );
+   }
+
+   void test_benchmark()
+   {
+      fillBoxes();
+
+      Frustum frustum;
+      frustum.set( false, mDegToRad( 60.0f ), 1.5f, 0.1f, 500.0f );
+      const PlaneSetF planes( frustum.getPlanes(), Frustum::PlaneCount );
+
+      Vector< Box3F > aos;
+      for( U32 i = 0; i < mBoxes.size(); ++ i )
+         aos.push_back( mBoxes.get( i ) );
+
+      U32 numVisible = 0;
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 pass = 0; pass < NUM_BENCHMARK_PASSES; ++ pass )
+         for( U32 i = 0; i < aos.size(); ++ i )
+            if( planes.testPotentialIntersection( aos[ i ] ) != GeometryOutside )
+               numVisible ++;
+      const U32 scalarTime = Platform::getRealMilliseconds() - start;
+
+      FrameTemp< U32 > indices( mBoxes.size() );
+      U32 numVisibleBatched = 0;
+      start = Platform::getRealMilliseconds();
+      for( U32 pass = 0; pass < NUM_BENCHMARK_PASSES; ++ pass )
+         numVisibleBatched += mBoxes.findPotentiallyIntersecting( planes, indices );
+      const U32 batchedTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "Box3FSoA: %d boxes x%d against frustum: scalar %dms, batched %dms",
+         mBoxes.size(), NUM_BENCHMARK_PASSES, scalarTime, batchedTime );
+
+      test( numVisible == numVisibleBatched, "Batched and scalar culling found different boxes" );
+   }
+
+   void run()
+   {
+      mRand.setSeed( 8765 );
+
+      test_storage();
+      test_kernels();
+      test_benchmark();
+   }
+};
+
+#endif // !TORQUE_SHIPPING
@@ -0,0 +1,254 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "math/util/boxSoA.h"
+
+#include "core/frameAllocator.h"
+#include "core/module.h"
+
+#if defined( TORQUE_CPU_X86 )
+#include <xmmintrin.h>
+#endif
+
+
+Box3FSoA::TestPlanesFn Box3FSoA::smTestPlanes = Box3FSoA::testPlanes_C;
+
+
+MODULE_BEGIN( Box3FSoA )
+
+   MODULE_INIT
+   {
+      Box3FSoA::smTestPlanes = Box3FSoA::testPlanes_C;
+
+   #if defined( TORQUE_CPU_X86 )
+      if( Platform::SystemInfo.processor.properties & CPU_PROP_SSE )
+         Box3FSoA::smTestPlanes = Box3FSoA::testPlanes_SSE;
+   #endif
+   }
+
+MODULE_END;
+
+
+//-----------------------------------------------------------------------------
+
+Box3FSoA::Box3FSoA()
+   : mData( NULL ),
+     mSize( 0 ),
+     mCapacity( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+
+Box3FSoA::Box3FSoA( const Box3FSoA& other )
+   : mData( NULL ),
+     mSize( 0 ),
+     mCapacity( 0 )
+{
+   *this = other;
+}
+
+//-----------------------------------------------------------------------------
+
+Box3FSoA::~Box3FSoA()
+{
+   if( mData )
+      dFree_aligned( mData );
+}
+
+//-----------------------------------------------------------------------------
+
+Box3FSoA& Box3FSoA::operator =( const Box3FSoA& other )
+{
+   if( this == &other )
+      return *this;
+
+   // Don't carry over any boxes past the new size.
+   mSize = 0;
+   setSize( other.mSize );
+
+   const U32 paddedSize = getPaddedSize();
+   if( paddedSize )
+      for( U32 i = 0; i < NumComponents; ++ i )
+         dMemcpy( mData + i * mCapacity, other.mData + i * other.mCapacity, paddedSize * sizeof( F32 ) );
+
+   return *this;
+}
+
+//-----------------------------------------------------------------------------
+
+void Box3FSoA::setSize( U32 size )
+{
+   const U32 oldSize = mSize;
+   const U32 paddedSize = ( size + BoxesPerBlock - 1 ) & ~( BoxesPerBlock - 1 );
+
+   if( paddedSize > mCapacity )
+   {
+      U32 newCapacity = getMax( paddedSize, mCapacity * 2 );
+      newCapacity = getMax( newCapacity, U32( 16 ) );
+
+      F32* newData = ( F32* ) dMalloc_aligned( NumComponents * newCapacity * sizeof( F32 ), 16 );
+
+      if( mData )
+      {
+         for( U32 i = 0; i < NumComponents; ++ i )
+            dMemcpy( newData + i * newCapacity, mData + i * mCapacity, oldSize * sizeof( F32 ) );
+
+         dFree_aligned( mData );
+      }
+
+      mData = newData;
+      mCapacity = newCapacity;
+   }
+
+   // Clear the new boxes including the padding so that the
+   // kernels never read uninitialized memory.
+
+   if( paddedSize > oldSize )
+   {
+      for( U32 i = 0; i < NumComponents; ++ i )
+         dMemset( mData + i * mCapacity + oldSize, 0, ( paddedSize - oldSize ) * sizeof( F32 ) );
+   }
+
+   mSize = size;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 Box3FSoA::findPotentiallyIntersecting( const PlaneSetF& planes, U32* outIndices ) const
+{
+   if( !mSize )
+      return 0;
+
+   FrameTemp< S8 > results( getPaddedSize() );
+   testPotentialIntersection( planes, results );
+
+   U32 numIndices = 0;
+   for( U32 i = 0; i < mSize; ++ i )
+      if( results[ i ] != GeometryOutside )
+         outIndices[ numIndices ++ ] = i;
+
+   return numIndices;
+}
+
+//-----------------------------------------------------------------------------
+
+void Box3FSoA::testPlanes_C( const Box3FSoA& boxes, const PlaneF* planes, U32 numPlanes, S8* outResults )
+{
+   const PlaneSetF planeSet( planes, numPlanes );
+
+   const U32 numBoxes = boxes.size();
+   for( U32 i = 0; i < numBoxes; ++ i )
+      outResults[ i ] = planeSet.testPotentialIntersection( boxes.get( i ) );
+}
+
+//-----------------------------------------------------------------------------
+
+#if defined( TORQUE_CPU_X86 )
+
+void Box3FSoA::testPlanes_SSE( const Box3FSoA& boxes, const PlaneF* planes, U32 numPlanes, S8* outResults )
+{
+   // This mirrors PlaneF::whichSide( Box3F ) operation for operation
+   // so the results are identical to the scalar path.  As the plane is the
+   // same for all four boxes, choosing the p- and n-vertex only requires
+   // selecting between the min and max arrays rather than a per-lane blend.
+
+   const F32* minX = boxes.getMinX();
+   const F32* minY = boxes.getMinY();
+   const F32* minZ = boxes.getMinZ();
+   const F32* maxX = boxes.getMaxX();
+   const F32* maxY = boxes.getMaxY();
+   const F32* maxZ = boxes.getMaxZ();
+
+   const __m128 frontEpsilon = _mm_set1_ps( 0.005f );
+   const __m128 backEpsilon = _mm_set1_ps( -0.005f );
+   const __m128 allSet = _mm_cmpeq_ps( _mm_setzero_ps(), _mm_setzero_ps() );
+
+   const U32 numBoxes = boxes.getPaddedSize();
+   for( U32 i = 0; i < numBoxes; i += BoxesPerBlock )
+   {
+      __m128 outside = _mm_setzero_ps();
+      __m128 inside = allSet;
+
+      for( U32 n = 0; n < numPlanes; ++ n )
+      {
+         const PlaneF& plane = planes[ n ];
+
+         const __m128 planeX = _mm_set1_ps( plane.x );
+         const __m128 planeY = _mm_set1_ps( plane.y );
+         const __m128 planeZ = _mm_set1_ps( plane.z );
+         const __m128 planeD = _mm_set1_ps( plane.d );
+
+         const F32* pX = ( plane.x > 0.0f ) ? maxX : minX;
+         const F32* pY = ( plane.y > 0.0f ) ? maxY : minY;
+         const F32* pZ = ( plane.z > 0.0f ) ? maxZ : minZ;
+         const F32* nX = ( plane.x > 0.0f ) ? minX : maxX;
+         const F32* nY = ( plane.y > 0.0f ) ? minY : maxY;
+         const F32* nZ = ( plane.z > 0.0f ) ? minZ : maxZ;
+
+         // Boxes whose p-vertex is behind the plane are outside.
+
+         __m128 dist = _mm_add_ps(
+            _mm_add_ps(
+               _mm_add_ps( _mm_mul_ps( planeX, _mm_load_ps( pX + i ) ),
+                           _mm_mul_ps( planeY, _mm_load_ps( pY + i ) ) ),
+               _mm_mul_ps( planeZ, _mm_load_ps( pZ + i ) ) ),
+            planeD );
+
+         outside = _mm_or_ps( outside, _mm_cmple_ps( dist, backEpsilon ) );
+
+         // Boxes whose n-vertex is in front of the plane are fully on
+         // the positive side.
+
+         dist = _mm_add_ps(
+            _mm_add_ps(
+               _mm_add_ps( _mm_mul_ps( planeX, _mm_load_ps( nX + i ) ),
+                           _mm_mul_ps( planeY, _mm_load_ps( nY + i ) ) ),
+               _mm_mul_ps( planeZ, _mm_load_ps( nZ + i ) ) ),
+            planeD );
+
+         inside = _mm_and_ps( inside, _mm_cmpge_ps( dist, frontEpsilon ) );
+
+         // Stop early once all boxes in the block are rejected.
+
+         if( _mm_movemask_ps( outside ) == 0xF )
+            break;
+      }
+
+      const S32 outsideMask = _mm_movemask_ps( outside );
+      const S32 insideMask = _mm_movemask_ps( inside );
+
+      for( U32 k = 0; k < BoxesPerBlock; ++ k )
+      {
+         if( outsideMask & ( 1 << k ) )
+            outResults[ i + k ] = GeometryOutside;
+         else if( insideMask & ( 1 << k ) )
+            outResults[ i + k ] = GeometryInside;
+         else
+            outResults[ i + k ] = GeometryIntersecting;
+      }
+   }
+}
+
+#endif // TORQUE_CPU_X86
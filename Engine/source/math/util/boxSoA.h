@@ -0,0 +1,187 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _BOXSOA_H_
+#define _BOXSOA_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _MPLANESET_H_
+#include "math/mPlaneSet.h"
+#endif
+
+
+/// An array of axis-aligned bounding boxes stored as structure-of-arrays.
+///
+/// Each of the six box coordinates is kept in its own 16-byte aligned array
+/// which lets the culling kernels test several boxes against a plane with
+/// a single SIMD instruction.  The arrays are padded to a multiple of
+/// #BoxesPerBlock so kernels never need to handle a tail.
+///
+/// The culling kernels produce exactly the same results as testing each box
+/// with PlaneSet::testPotentialIntersection.  This makes it safe to mix batched
+/// and single-box tests.  For occlusion volumes, a box is occluded exactly when
+/// the result is GeometryInside (see PlaneSet::isContained).
+class Box3FSoA
+{
+   public:
+
+      enum
+      {
+         /// Number of boxes processed in one step by the SIMD kernels.
+         BoxesPerBlock = 4,
+      };
+
+      /// Kernel that tests all boxes in @a boxes against @a numPlanes planes and
+      /// stores one OverlapTestResult (as S8) per box in @a outResults.
+      typedef void ( *TestPlanesFn )( const Box3FSoA& boxes, const PlaneF* planes, U32 numPlanes, S8* outResults );
+
+      /// The kernel used by testPotentialIntersection().  Selected on startup
+      /// based on the CPU features.
+      static TestPlanesFn smTestPlanes;
+
+      /// @name Kernels
+      /// @{
+
+      static void testPlanes_C( const Box3FSoA& boxes, const PlaneF* planes, U32 numPlanes, S8* outResults );
+
+      #if defined( TORQUE_CPU_X86 )
+      static void testPlanes_SSE( const Box3FSoA& boxes, const PlaneF* planes, U32 numPlanes, S8* outResults );
+      #endif
+
+      /// @}
+
+   protected:
+
+      enum Component
+      {
+         MinX,
+         MinY,
+         MinZ,
+         MaxX,
+         MaxY,
+         MaxZ,
+
+         NumComponents
+      };
+
+      /// Single allocation holding all component arrays.
+      F32* mData;
+
+      /// Number of boxes in the array.
+      U32 mSize;
+
+      /// Number of boxes that each component array has room for.
+      U32 mCapacity;
+
+      F32* _getComponent( Component component ) const { return mData + component * mCapacity; }
+
+   public:
+
+      Box3FSoA();
+      Box3FSoA( const Box3FSoA& other );
+      ~Box3FSoA();
+
+      Box3FSoA& operator =( const Box3FSoA& other );
+
+      /// Return the number of boxes in the array.
+      U32 size() const { return mSize; }
+
+      /// Return the number of boxes including padding.  This is always
+      /// a multiple of #BoxesPerBlock.
+      U32 getPaddedSize() const { return ( mSize + BoxesPerBlock - 1 ) & ~( BoxesPerBlock - 1 ); }
+
+      /// Resize the array to hold @a size boxes.  Existing boxes are preserved;
+      /// new boxes are empty.
+      void setSize( U32 size );
+
+      /// Remove all boxes.  Does not release memory.
+      void clear() { setSize( 0 ); }
+
+      /// Set the box at @a index.
+      void set( U32 index, const Box3F& box )
+      {
+         AssertFatal( index < mSize, "Box3FSoA::set - Index out of range!" );
+         _getComponent( MinX )[ index ] = box.minExtents.x;
+         _getComponent( MinY )[ index ] = box.minExtents.y;
+         _getComponent( MinZ )[ index ] = box.minExtents.z;
+         _getComponent( MaxX )[ index ] = box.maxExtents.x;
+         _getComponent( MaxY )[ index ] = box.maxExtents.y;
+         _getComponent( MaxZ )[ index ] = box.maxExtents.z;
+      }
+
+      /// Return the box at @a index.
+      Box3F get( U32 index ) const
+      {
+         AssertFatal( index < mSize, "Box3FSoA::get - Index out of range!" );
+         return Box3F( _getComponent( MinX )[ index ], _getComponent( MinY )[ index ], _getComponent( MinZ )[ index ],
+                       _getComponent( MaxX )[ index ], _getComponent( MaxY )[ index ], _getComponent( MaxZ )[ index ] );
+      }
+
+      /// Append a box at the end of the array.
+      void push_back( const Box3F& box )
+      {
+         setSize( mSize + 1 );
+         set( mSize - 1, box );
+      }
+
+      /// @name Component Access
+      /// Each array is 16-byte aligned and has getPaddedSize() entries.
+      /// @{
+
+      const F32* getMinX() const { return _getComponent( MinX ); }
+      const F32* getMinY() const { return _getComponent( MinY ); }
+      const F32* getMinZ() const { return _getComponent( MinZ ); }
+      const F32* getMaxX() const { return _getComponent( MaxX ); }
+      const F32* getMaxY() const { return _getComponent( MaxY ); }
+      const F32* getMaxZ() const { return _getComponent( MaxZ ); }
+
+      /// @}
+
+      /// @name Culling
+      /// @{
+
+      /// Test all boxes against the volume defined by @a planes.
+      ///
+      /// @param planes Set of planes to test against.
+      /// @param outResults Receives one OverlapTestResult per box.  Must have
+      ///   room for getPaddedSize() entries.
+      void testPotentialIntersection( const PlaneSetF& planes, S8* outResults ) const
+      {
+         smTestPlanes( *this, planes.getPlanes(), planes.getNumPlanes(), outResults );
+      }
+
+      /// Compact @a outIndices to the indices of all boxes that are not outside
+      /// of the volume defined by @a planes.
+      ///
+      /// @param planes Set of planes to test against.
+      /// @param outIndices Receives the indices.  Must have room for size() entries.
+      /// @return Number of indices written to @a outIndices.
+      U32 findPotentiallyIntersecting( const PlaneSetF& planes, U32* outIndices ) const;
+
+      /// @}
+};
+
+#endif // !_BOXSOA_H_
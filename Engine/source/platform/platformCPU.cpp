@@ -26,6 +26,14 @@
 #include "core/stringTable.h"
 #include "core/util/tSignal.h"
 
+#if defined(TORQUE_CPU_X86)
+#  if defined(TORQUE_COMPILER_VISUALC)
+#     include <intrin.h>
+#  elif defined(TORQUE_COMPILER_GCC)
+#     include <cpuid.h>
+#  endif
+#endif
+
 Signal<void(void)> Platform::SystemInfoReady;
 
 enum CPUFlags
@@ -42,8 +50,79 @@ enum CPUFlags
    BIT_SSE3xt  = BIT(9),
    BIT_SSE4_1  = BIT(19),
    BIT_SSE4_2  = BIT(20),
+   BIT_FMA     = BIT(12),
+   BIT_OSXSAVE = BIT(27),
+   BIT_AVX     = BIT(28),
+
+   // Leaf 7 flags
+   BIT_AVX2    = BIT(5),
 };
 
+#if defined(TORQUE_CPU_X86) && ( defined(TORQUE_COMPILER_GCC) || ( defined(TORQUE_COMPILER_VISUALC) && _MSC_FULL_VER >= 160040219 ) )
+#  define TORQUE_CPU_DETECT_AVX
+#endif
+
+#ifdef TORQUE_CPU_DETECT_AVX
+
+static void _cpuid( U32 leaf, U32 subLeaf, U32 regs[4] )
+{
+#if defined(TORQUE_COMPILER_VISUALC)
+   __cpuidex( reinterpret_cast<int*>( regs ), leaf, subLeaf );
+#else
+   __cpuid_count( leaf, subLeaf, regs[0], regs[1], regs[2], regs[3] );
+#endif
+}
+
+static U64 _xgetbv0()
+{
+#if defined(TORQUE_COMPILER_VISUALC)
+   return _xgetbv( 0 );
+#else
+   U32 lo, hi;
+   __asm__ __volatile__( "xgetbv" : "=a" (lo), "=d" (hi) : "c" (0) );
+   return ( (U64)hi << 32 ) | lo;
+#endif
+}
+
+#endif // TORQUE_CPU_DETECT_AVX
+
+/// Returns the CPU_PROP_AVX, CPU_PROP_AVX2 and CPU_PROP_FMA properties.
+///
+/// The detection asm only returns the first CPUID leaf and AVX is only
+/// usable if the OS saves the YMM registers, so this queries the CPU
+/// separately and checks XGETBV.
+static U32 _detectAVXProperties()
+{
+   U32 properties = 0;
+
+#ifdef TORQUE_CPU_DETECT_AVX
+   U32 regs[4];
+   _cpuid( 0, 0, regs );
+   const U32 maxLeaf = regs[0];
+   if ( maxLeaf < 1 )
+      return 0;
+
+   _cpuid( 1, 0, regs );
+   if ( !( regs[2] & BIT_OSXSAVE ) || !( regs[2] & BIT_AVX ) )
+      return 0;
+
+   // The OS must save both the XMM and YMM state.
+   if ( ( _xgetbv0() & 0x6 ) != 0x6 )
+      return 0;
+
+   properties |= CPU_PROP_AVX;
+   properties |= ( regs[2] & BIT_FMA ) ? CPU_PROP_FMA : 0;
+
+   if ( maxLeaf >= 7 )
+   {
+      _cpuid( 7, 0, regs );
+      properties |= ( regs[1] & BIT_AVX2 ) ? CPU_PROP_AVX2 : 0;
+   }
+#endif
+
+   return properties;
+}
+
 // fill the specified structure with information obtained from asm code
 void SetProcessorInfo(Platform::SystemInfo_struct::Processor& pInfo,
    char* vendor, U32 processor, U32 properties, U32 properties2)
@@ -51,6 +130,7 @@ void SetProcessorInfo(Platform::SystemInfo_struct::Processor& pInfo,
    Platform::SystemInfo.processor.properties |= (properties & BIT_FPU)   ? CPU_PROP_FPU : 0;
    Platform::SystemInfo.processor.properties |= (properties & BIT_RDTSC) ? CPU_PROP_RDTSC : 0;
    Platform::SystemInfo.processor.properties |= (properties & BIT_MMX)   ? CPU_PROP_MMX : 0;
+   Platform::SystemInfo.processor.properties |= _detectAVXProperties();
 
    if (dStricmp(vendor, "GenuineIntel") == 0)
    {
@@ -453,6 +453,79 @@ void ThreadPool::flushWorkItems( S32 timeOut )
 
 //--------------------------------------------------------------------------
 
+namespace {
+
+   /// Work item that processes one chunk of a ThreadPool::parallelFor loop
+   /// and signals its completion through a semaphore.
+   class ParallelForWorkItem : public ThreadPool::WorkItem
+   {
+      protected:
+
+         ThreadPool::ParallelForCallback mCallback;
+         void* mKey;
+         U32 mStart;
+         U32 mEnd;
+         Semaphore* mDoneSemaphore;
+
+         virtual void execute()
+         {
+            mCallback( mStart, mEnd, mKey );
+            mDoneSemaphore->release();
+         }
+
+      public:
+
+         ParallelForWorkItem( ThreadPool::ParallelForCallback callback, void* key, U32 start, U32 end, Semaphore* doneSemaphore )
+            : mCallback( callback ),
+              mKey( key ),
+              mStart( start ),
+              mEnd( end ),
+              mDoneSemaphore( doneSemaphore ) {}
+
+         /// The main thread is blocked on these so schedule them
+         /// ahead of background work.
+         virtual F32 getPriority() { return 100.0f; }
+   };
+}
+
+void ThreadPool::parallelFor( U32 count, U32 minChunkSize, ParallelForCallback callback, void* key )
+{
+   if( !count )
+      return;
+
+   minChunkSize = getMax( minChunkSize, U32( 1 ) );
+
+   // Use one chunk per worker thread plus one for the calling thread.
+
+   const U32 numThreads = mNumThreads + 1;
+   const U32 chunkSize = getMax( minChunkSize, ( count + numThreads - 1 ) / numThreads );
+   const U32 numChunks = ( count + chunkSize - 1 ) / chunkSize;
+
+   if( numChunks <= 1 || !ThreadManager::isMainThread() )
+   {
+      callback( 0, count, key );
+      return;
+   }
+
+   Semaphore doneSemaphore( 0 );
+
+   for( U32 i = 1; i < numChunks; ++ i )
+   {
+      const U32 start = i * chunkSize;
+      const U32 end = getMin( start + chunkSize, count );
+      queueWorkItem( new ParallelForWorkItem( callback, key, start, end, &doneSemaphore ) );
+   }
+
+   // Process the first chunk ourselves while the workers are busy.
+
+   callback( 0, getMin( chunkSize, count ), key );
+
+   for( U32 i = 1; i < numChunks; ++ i )
+      doneSemaphore.acquire();
+}
+
+//--------------------------------------------------------------------------
+
 void ThreadPool::queueWorkItemOnMainThread( WorkItem* item )
 {
    smMainThreadQueue.insert( item->getPriority(), item );
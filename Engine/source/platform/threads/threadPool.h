@@ -306,6 +306,26 @@ class ThreadPool
       ///   the queue to flush out.  -1 = infinite.
       void flushWorkItems( S32 timeOut = -1 );
 
+      /// Callback for processing the index range [start,end) of a parallel loop.
+      typedef void ( *ParallelForCallback )( U32 start, U32 end, void* key );
+
+      /// Split the index range [0,count) into chunks and process them concurrently
+      /// on the pool's worker threads and the calling thread.  Returns once all
+      /// chunks have been processed.
+      ///
+      /// Like flushWorkItems(), this must only be called on the main thread when
+      /// used with the global pool.  Calls from other threads are processed
+      /// serially on the calling thread.
+      ///
+      /// @param count Number of indices to process.
+      /// @param minChunkSize Minimum number of indices per chunk.
+      /// @param callback Function to invoke for each chunk.
+      /// @param key User data passed to @a callback.
+      void parallelFor( U32 count, U32 minChunkSize, ParallelForCallback callback, void* key );
+
+      /// Return the number of worker threads spawned by the pool.
+      U32 getNumThreads() const { return mNumThreads; }
+
       /// Add a work item to the main thread's work queue.
       ///
       /// The main thread's work queue will be processed each frame using
@@ -254,6 +254,12 @@ void Processor::init()
 	if ((err==0)&&(lraw==1)) procflags |= CPU_PROP_SSE4_1;
 	err = _getSysCTLvalue<unsigned long>("hw.optional.sse4_2", &lraw);	
 	if ((err==0)&&(lraw==1)) procflags |= CPU_PROP_SSE4_2;
+	err = _getSysCTLvalue<unsigned long>("hw.optional.avx1_0", &lraw);	
+	if ((err==0)&&(lraw==1)) procflags |= CPU_PROP_AVX;
+	err = _getSysCTLvalue<unsigned long>("hw.optional.avx2_0", &lraw);	
+	if ((err==0)&&(lraw==1)) procflags |= CPU_PROP_AVX2;
+	err = _getSysCTLvalue<unsigned long>("hw.optional.fma", &lraw);	
+	if ((err==0)&&(lraw==1)) procflags |= CPU_PROP_FMA;
 	err = _getSysCTLvalue<unsigned long>("hw.optional.altivec", &lraw);	
 	if ((err==0)&&(lraw==1)) procflags |= CPU_PROP_ALTIVEC;
 	// Finally some architecture-wide settings
@@ -184,6 +184,12 @@ void Processor::init()
       Con::printf( "   SSE detected" );
    if( Platform::SystemInfo.processor.properties & CPU_PROP_SSE2 )
       Con::printf( "   SSE2 detected" );
+   if( Platform::SystemInfo.processor.properties & CPU_PROP_AVX )
+      Con::printf( "   AVX detected" );
+   if( Platform::SystemInfo.processor.properties & CPU_PROP_AVX2 )
+      Con::printf( "   AVX2 detected" );
+   if( Platform::SystemInfo.processor.properties & CPU_PROP_FMA )
+      Con::printf( "   FMA detected" );
    if( Platform::SystemInfo.processor.isHyperThreaded )
       Con::printf( "   HT detected" );
    if( Platform::SystemInfo.processor.properties & CPU_PROP_MP )
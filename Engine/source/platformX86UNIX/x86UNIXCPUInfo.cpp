@@ -150,6 +150,12 @@ void Processor::init()
       Con::printf("   3DNow detected");
    if (Platform::SystemInfo.processor.properties & CPU_PROP_SSE)
       Con::printf("   SSE detected");
+   if (Platform::SystemInfo.processor.properties & CPU_PROP_AVX)
+      Con::printf("   AVX detected");
+   if (Platform::SystemInfo.processor.properties & CPU_PROP_AVX2)
+      Con::printf("   AVX2 detected");
+   if (Platform::SystemInfo.processor.properties & CPU_PROP_FMA)
+      Con::printf("   FMA detected");
    Con::printf(" ");
 
    PlatformBlitInit();
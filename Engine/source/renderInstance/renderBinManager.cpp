@@ -27,6 +27,7 @@
 #include "materials/matInstance.h"
 #include "scene/sceneManager.h"
 #include "console/engineAPI.h"
+#include "core/util/tRadixSort.h"
 
 
 IMPLEMENT_CONOBJECT(RenderBinManager);
@@ -36,9 +37,11 @@ RenderBinManager::RenderBinManager( const RenderInstType& ritype, F32 renderOrde
    mRenderInstType( ritype ),
    mRenderOrder( renderOrder ),
    mProcessAddOrder( processAddOrder ),
-   mRenderPass( NULL )
+   mRenderPass( NULL ),
+   mCommandsRecorded( false )
 {
    VECTOR_SET_ASSOCIATION( mElementList );
+   VECTOR_SET_ASSOCIATION( mSortScratch );
    mElementList.reserve( 2048 );
 }
 
@@ -131,11 +134,32 @@ void RenderBinManager::internalAddElement(RenderInst* inst)
 void RenderBinManager::clear()
 {
    mElementList.clear();
+   mCommands.clear();
+   mCommandsRecorded = false;
+}
+
+void RenderBinManager::_ensureCommandsRecorded( const SceneRenderState *state )
+{
+   if ( mCommandsRecorded )
+      return;
+
+   recordCommands( state );
+   mCommandsRecorded = true;
 }
 
 void RenderBinManager::sort()
 {
-   dQsort( mElementList.address(), mElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
+   sortElements( mElementList );
+}
+
+void RenderBinManager::sortElements( Vector< MainSortElem > &elements )
+{
+   PROFILE_SCOPE( RenderBinManager_sortElements );
+
+   if ( mSortScratch.size() < elements.size() )
+      mSortScratch.setSize( elements.size() );
+
+   radixSort( elements.address(), mSortScratch.address(), elements.size(), _getElementSortKey );
 }
 
 S32 FN_CDECL RenderBinManager::cmpKeyFunc(const void* p1, const void* p2)
@@ -143,9 +167,16 @@ S32 FN_CDECL RenderBinManager::cmpKeyFunc(const void* p1, const void* p2)
    const MainSortElem* mse1 = (const MainSortElem*) p1;
    const MainSortElem* mse2 = (const MainSortElem*) p2;
 
-   S32 test1 = S32(mse2->key) - S32(mse1->key);
+   // Compare rather than subtract so that keys which are far
+   // apart, like pointers, cannot overflow the result.
+
+   if ( mse1->key != mse2->key )
+      return ( S32(mse2->key) > S32(mse1->key) ) ? 1 : -1;
+
+   if ( mse1->key2 != mse2->key2 )
+      return ( S32(mse1->key2) > S32(mse2->key2) ) ? 1 : -1;
 
-   return ( test1 == 0 ) ? S32(mse1->key2) - S32(mse2->key2) : test1;
+   return 0;
 }
 
 void RenderBinManager::setupSGData( MeshRenderInst *ri, SceneData &data )
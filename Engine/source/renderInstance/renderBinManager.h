@@ -34,6 +34,9 @@
 #ifndef _UTIL_DELEGATE_H_
 #include "core/util/delegate.h"
 #endif
+#ifndef _GFXCOMMANDBUFFER_H_
+#include "gfx/gfxCommandBuffer.h"
+#endif
 
 class SceneRenderState;
 
@@ -66,6 +69,25 @@ public:
    virtual void render( SceneRenderState *state ) {}
    virtual void clear();
 
+   /// @name Command Recording
+   /// Bins which can turn their sorted elements into GFX commands without
+   /// touching the device or materials record them into #mCommands.  The
+   /// RenderPassManager records these bins in parallel before any bin
+   /// renders and render() then replays the commands in order.
+   /// @{
+
+   /// Returns true if the bin implements recordCommands().
+   virtual bool canRecordCommands() const { return false; }
+
+   /// Records the commands for the sorted elements into #mCommands.
+   /// @note This may be called on a worker thread.
+   virtual void recordCommands( const SceneRenderState *state ) {}
+
+   /// Returns true if the commands for this frame have been recorded.
+   bool hasRecordedCommands() const { return mCommandsRecorded; }
+
+   /// @}
+
    // Manager info
    F32 getProcessAddOrder() const { return mProcessAddOrder; }
    void setProcessAddOrder(F32 processAddOrder) { mProcessAddOrder = processAddOrder; }
@@ -78,9 +100,19 @@ public:
    /// Returns the render pass this bin is registered to.
    RenderPassManager* getRenderPass() const { return mRenderPass; }
 
-   /// QSort callback function
+   /// QSort callback function.  Orders by descending key and then
+   /// by ascending key2, both compared as signed values.
    static S32 FN_CDECL cmpKeyFunc(const void* p1, const void* p2);
 
+   /// Packs the two sort keys of an element into a single 64-bit key
+   /// whose ascending order is the order defined by cmpKeyFunc.
+   static U64 makeSortKey( U32 key, U32 key2 )
+   {
+      // Flipping the sign bit maps signed order onto unsigned
+      // order and inverting the primary key makes it descending.
+      return ( U64( U32( ~( key ^ 0x80000000 ) ) ) << 32 ) | U64( key2 ^ 0x80000000 );
+   }
+
    DECLARE_CONOBJECT(RenderBinManager);
    static void initPersistFields();
 
@@ -95,6 +127,12 @@ protected:
       U32 key2;
    };
 
+   /// Stable radix sort of an element list in cmpKeyFunc order using
+   /// #mSortScratch as the temporary buffer.
+   void sortElements( Vector< MainSortElem > &elements );
+
+   static U64 _getElementSortKey( const MainSortElem &elem ) { return makeSortKey( elem.key, elem.key2 ); }
+
    void setRenderPass( RenderPassManager *rpm );
 
    /// Called from derived bins to add additional
@@ -102,6 +140,7 @@ protected:
    void notifyType( const RenderInstType &type );
 
    Vector< MainSortElem > mElementList; // List of our instances
+   Vector< MainSortElem > mSortScratch; // Reused temporary buffer for sortElements()
    F32 mProcessAddOrder;   // Where in the list do we process RenderInstance additions?
    F32 mRenderOrder;       // Where in the list do we render?
 
@@ -117,6 +156,16 @@ protected:
 
    MaterialOverrideDelegate mMatOverrideDelegate;
 
+   /// The commands recorded by recordCommands().
+   GFXCommandBuffer mCommands;
+
+   /// Set once the commands of the current elements are recorded.
+   bool mCommandsRecorded;
+
+   /// Records the commands on the calling thread if the
+   /// render pass didn't already record them.
+   void _ensureCommandsRecorded( const SceneRenderState *state );
+
    virtual void setupSGData(MeshRenderInst *ri, SceneData &data );
    virtual void internalAddElement(RenderInst* inst);
 
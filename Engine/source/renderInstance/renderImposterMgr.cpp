@@ -131,6 +131,85 @@ void RenderImposterMgr::_renderPrePass( const SceneRenderState *state, RenderPre
    _innerRender( state, prePassBin );
 }
 
+void RenderImposterMgr::recordCommands( const SceneRenderState *state )
+{
+   PROFILE_SCOPE( RenderImposterMgr_RecordCommands );
+
+   mMaterialRanges.clear();
+
+   // The elements are already sorted by material to minimize
+   // switches, so just batch them up as they come.
+   //
+   // NOTE: Its safe to compare matinstances here instead of
+   // the state hint because imposters all share the same 
+   // material instances.... if this changes revise.
+
+   const U32 binSize = mElementList.size();
+
+   for ( U32 i=0; i < binSize; )
+   {
+      mMaterialRanges.increment();
+      MaterialRange &range = mMaterialRanges.last();
+      range.mat = static_cast<ImposterBaseRenderInst*>( mElementList[i].inst )->mat;
+      range.start = mCommands.size();
+      range.numImposters = 0;
+      range.numBatches = 0;
+
+      while ( i < binSize )
+      {
+         ImposterBaseRenderInst *ri = static_cast<ImposterBaseRenderInst*>( mElementList[i].inst );
+         if ( ri->mat != range.mat )
+            break;
+
+         // Cached batches have their own vertex buffer.
+         if ( ri->type == RIT_ImposterBatch )
+         {
+            GFXVertexBuffer *vb = static_cast<ImposterBatchRenderInst*>( ri )->vertBuff->getPointer();
+
+            mCommands.setVertexBuffer( vb );
+            mCommands.drawPrimitive( GFXTriangleList, 0, vb->mNumVerts / 3 );
+
+            i++;
+            continue;
+         }
+
+         // Gather the run of single imposters which fits into
+         // the index buffer and build a dynamic batch of it.
+         U32 count = 0;
+         while (  i + count < binSize &&
+                  count + 1 < smImposterBatchSize )
+         {
+            ImposterBaseRenderInst *next = static_cast<ImposterBaseRenderInst*>( mElementList[i + count].inst );
+            if ( next->type == RIT_ImposterBatch || next->mat != range.mat )
+               break;
+
+            count++;
+         }
+
+         ImposterState *statePtr = mCommands.allocVolatileVertices<ImposterState>( count * 4 );
+
+         for ( U32 j=0; j < count; j++, i++ )
+         {
+            const ImposterState &imposterState = static_cast<ImposterRenderInst*>( mElementList[i].inst )->state;
+
+            for ( U32 corner=0; corner < 4; corner++ )
+            {
+               *statePtr = imposterState;
+               statePtr->corner = corner;
+               statePtr++;
+            }
+         }
+
+         mCommands.drawIndexedPrimitive( GFXTriangleList, 0, 0, count * 4, 0, count * 2 );
+
+         range.numImposters += count;
+         range.numBatches++;
+      }
+
+      range.end = mCommands.size();
+   }
+}
+
 void RenderImposterMgr::_innerRender( const SceneRenderState *state, RenderPrePassMgr *prePassBin )
 {
    PROFILE_SCOPE( RenderImposterMgr_InnerRender );
@@ -197,42 +276,21 @@ void RenderImposterMgr::_innerRender( const SceneRenderState *state, RenderPrePa
    }
    */
 
+   // The imposter vertices are built into the command
+   // buffer which is usually done on a worker thread.
+   _ensureCommandsRecorded( state );
+
    // Set the buffers here once.
    GFX->setPrimitiveBuffer( mIB );
 
-   // Batch up the imposters into the buffer.  These
-   // are already sorted by texture, to minimize switches
-   // so just batch them up and render as they come.
-
-   ImposterState* statePtr = NULL;
-   U32 stateCount;
-   ImposterBaseRenderInst *ri;
-   ImposterRenderInst *imposter;
-   ImposterBatchRenderInst *batch;
-   const U32 binSize = mElementList.size();
-   BaseMatInstance *setupMat, *currMat;
-   GFXVertexBufferHandle<ImposterState> vb;
-
-   // TODO: We could maybe do better with lights when forward
-   // rendering the imposters.  Just pass a light list with it
-   // and do some simple tests to break the batch when the light
-   // list changes.
-
    SceneData sgData;
    sgData.init( state, prePassBin ? SceneData::PrePassBin : SceneData::RegularBin );
    sgData.lights[0] = LIGHTMGR->getDefaultLight();
 
-   // TODO: I should rework this loop to generate the VB first then
-   // do all the material passes... should be easier to read and faster.
-   //
-   // Also consider making this store two element lists... one for
-   // batches and one for individual imposters.
-   //
-      
-   for ( U32 i=0; i < binSize; )
+   for ( U32 i=0; i < mMaterialRanges.size(); i++ )
    {
-      currMat = static_cast<ImposterBaseRenderInst*>( mElementList[i].inst )->mat;      
-      setupMat = prePassBin ? prePassBin->getPrePassMaterial( currMat ) : currMat;
+      const MaterialRange &range = mMaterialRanges[i];
+      BaseMatInstance *setupMat = prePassBin ? prePassBin->getPrePassMaterial( range.mat ) : range.mat;
 
       // TODO: Fix MatInstance to take a const SceneRenderState!
       while ( setupMat->setupPass( (SceneRenderState*)state, sgData ) )
@@ -240,116 +298,12 @@ void RenderImposterMgr::_innerRender( const SceneRenderState *state, RenderPrePa
          setupMat->setSceneInfo( (SceneRenderState*)state, sgData );
          setupMat->setTransforms( matrixSet, (SceneRenderState*)state );
 
-         for ( ; i < binSize; )
-         {
-            ri = static_cast<ImposterBaseRenderInst*>( mElementList[i].inst );
-            
-            // NOTE: Its safe to compare matinstances here instead of
-            // the state hint because imposters all share the same 
-            // material instances.... if this changes revise.            
-            if ( ri->mat != currMat )
-               break;
-
-            // Ok if this is a batch then we can just fire off the draw now.
-            if ( ri->type == RIT_ImposterBatch )
-            {
-               batch = static_cast<ImposterBatchRenderInst*>( ri );
-
-               GFX->setVertexBuffer( batch->vertBuff->getPointer() );
-               GFX->drawPrimitive( GFXTriangleList, 0, batch->vertBuff->getPointer()->mNumVerts / 3 );
-               
-               i++;
-               continue;
-            }
-
-            // This wasn't a batch so build up all the single imposters into
-            // a dynamic batch and render it.
-
-            statePtr = mBuffer;
-            stateCount = 0;
-
-            // Loop for each individual imposter.
-            for ( ; i < binSize; i++ )
-            {
-               if ( mElementList[i].inst->type == RIT_ImposterBatch )
-                  break;
-
-               imposter = static_cast<ImposterRenderInst*>( mElementList[i].inst );
-
-               // Stop the loop if the material changed.
-               if ( imposter->mat != currMat )
-                  break;
-
-               ++smRendered;
-
-               // If we're out of vb space then draw what we got.
-               if ( stateCount + 1 >= smImposterBatchSize )
-               {
-                  smBatches++;
-               
-                  vb.set( GFX, stateCount*4, GFXBufferTypeVolatile );
-                  ImposterState *buf = vb.lock();
-                  if(buf)
-                  {
-                     dMemcpy( buf, mBuffer, stateCount * 4 * sizeof( ImposterState ) );
-                     vb.unlock();
-                  }
-               
-                  //GFX->setVertexBuffer( mCornerVB, 0, stateCount * 4 );
-                  GFX->setVertexBuffer( vb );
-                  ///GFX->setVertexFormat( &mImposterVertDecl );
-
-                  GFX->drawIndexedPrimitive( GFXTriangleList, 0, 0, stateCount * 4, 0, stateCount * 2 );
-                  statePtr = mBuffer;
-                  stateCount = 0;
-               }
-
-               // Setup the imposter state.
-               *statePtr = imposter->state;
-               statePtr->corner = 0;
-               statePtr++;
+         mCommands.execute( range.start, range.end );
 
-               *statePtr = imposter->state;
-               statePtr->corner = 1;
-               statePtr++;
-
-               *statePtr = imposter->state;
-               statePtr->corner = 2;
-               statePtr++;
-
-               *statePtr = imposter->state;
-               statePtr->corner = 3;
-               statePtr++;
-
-               stateCount++;
-
-            } // for ( ; i < binSize; i++ )
-
-            // Any remainder to dump?
-            if ( stateCount > 0 )
-            {
-               smBatches++;
-
-               vb.set( GFX, stateCount*4, GFXBufferTypeVolatile );
-               ImposterState *buf = vb.lock();
-               if(buf)
-               {
-                  dMemcpy( buf, mBuffer, stateCount * 4 * sizeof( ImposterState ) );
-                  vb.unlock();
-               }
-               
-               //GFX->setVertexBuffer( mCornerVB, 0, stateCount * 4 );
-               GFX->setVertexBuffer( vb );
-               ///GFX->setVertexFormat( &mImposterVertDecl );
-
-               GFX->drawIndexedPrimitive( GFXTriangleList, 0, 0, stateCount * 4, 0, stateCount * 2 );
-           }
-
-         } // for( U32 i=0; i < binSize; )
-
-      } // while ( currMat->setupPass( (SceneRenderState*)state, sgData ) )
-
-   } // for ( U32 i=0; i < binSize; )
+         smRendered += range.numImposters;
+         smBatches += range.numBatches;
+      }
+   }
 
    // Capture the GFX stats for this render.
    stats.end( GFX->getDeviceStatistics() );
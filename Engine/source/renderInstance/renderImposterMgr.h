@@ -69,7 +69,18 @@ protected:
    static U32 smPolyCount;
    static U32 smRTChanges;
 
-   ImposterState mBuffer[smImposterBatchSize*4];
+   /// A run of elements with the same material in #mCommands.
+   struct MaterialRange
+   {
+      BaseMatInstance *mat;
+      U32 start;
+      U32 end;
+      U32 numImposters;
+      U32 numBatches;
+   };
+
+   /// The material ranges built by recordCommands().
+   Vector<MaterialRange> mMaterialRanges;
    
    GFXPrimitiveBufferHandle mIB;
    //GFXVertexBufferHandle<ImposterCorner> mCornerVB;   
@@ -94,6 +105,8 @@ public:
 
    // RenderBinManager
    virtual void render( SceneRenderState *state );
+   virtual bool canRecordCommands() const { return true; }
+   virtual void recordCommands( const SceneRenderState *state );
 };
 
 
@@ -150,6 +150,8 @@ void RenderMeshMgr::render(SceneRenderState * state)
 
       while( mat && mat->setupPass(state, sgData ) )
       {
+         U32 instanceCount = 0;
+
          for( a=j; a<binSize; a++ )
          {
             MeshRenderInst *passRI = static_cast<MeshRenderInst*>(mElementList[a].inst);
@@ -173,6 +175,8 @@ void RenderMeshMgr::render(SceneRenderState * state)
             // If we're instanced then don't render yet.
             if ( mat->isInstanced() )
             {
+               instanceCount++;
+
                // Let the material increment the instance buffer, but
                // break the batch if it runs out of room for more.
                if ( !mat->stepInstance() )
@@ -249,6 +253,8 @@ void RenderMeshMgr::render(SceneRenderState * state)
                GFX->drawPrimitive( *ri->prim );
             else
                GFX->drawPrimitive( ri->primBuffIndex );
+
+            GFX->getDeviceStatistics()->addInstancedDraw( instanceCount );
          }
 
          matListEnd = a;
@@ -40,6 +40,9 @@
 #include "core/util/safeDelete.h"
 #include "math/util/matrixSet.h"
 #include "console/engineAPI.h"
+#include "platform/threads/threadPool.h"
+#include "core/frameAllocator.h"
+#include "console/consoleTypes.h"
 
 
 const RenderInstType RenderInstType::Invalid( "" );
@@ -120,8 +123,20 @@ RenderPassManager::RenderBinEventSignal& RenderPassManager::getRenderBinSignal()
    return theSignal;
 }
 
+RenderPassManager::RenderSignal& RenderPassManager::getRenderSignal()
+{
+   static RenderSignal theSignal;
+   return theSignal;
+}
+
+bool RenderPassManager::smParallelRecord = true;
+
 void RenderPassManager::initPersistFields()
 {
+   Con::addVariable( "$RenderPassManager::parallelRecord", TypeBool, &smParallelRecord,
+      "If true, render bins which support it record their GFX commands in parallel "
+      "on the thread pool before the bins are rendered.\n"
+      "@ingroup RenderBin\n" );
 }
 
 RenderPassManager::RenderPassManager()
@@ -237,9 +252,13 @@ void RenderPassManager::render(SceneRenderState * state)
 {
    PROFILE_SCOPE( RenderPassManager_Render );
 
+   getRenderSignal().trigger( this, state );
+
    GFX->pushWorldMatrix();
    MatrixF proj = GFX->getProjectionMatrix();
 
+   if ( smParallelRecord )
+      _recordCommands( state );
    
    for (Vector<RenderBinManager *>::iterator itr = mRenderBins.begin();
       itr != mRenderBins.end(); itr++)
@@ -260,6 +279,57 @@ void RenderPassManager::render(SceneRenderState * state)
       GFX->setTexture(i, NULL);
 }
 
+namespace
+{
+   struct RecordCommandsJobState
+   {
+      const SceneRenderState *state;
+      RenderBinManager **bins;
+   };
+}
+
+void RenderPassManager::_recordCommandsJob( U32 start, U32 end, void *key )
+{
+   PROFILE_SCOPE( RenderPassManager_recordCommandsJob );
+
+   RecordCommandsJobState *job = reinterpret_cast<RecordCommandsJobState*>( key );
+
+   for ( U32 i = start; i < end; i++ )
+   {
+      RenderBinManager *bin = job->bins[i];
+      bin->recordCommands( job->state );
+      bin->mCommandsRecorded = true;
+   }
+}
+
+void RenderPassManager::_recordCommands( const SceneRenderState *state )
+{
+   PROFILE_SCOPE( RenderPassManager_recordCommands );
+
+   FrameTemp<RenderBinManager*> bins( mRenderBins.size() );
+   U32 numBins = 0;
+
+   for ( U32 i = 0; i < mRenderBins.size(); i++ )
+   {
+      RenderBinManager *bin = mRenderBins[i];
+      if (  bin->canRecordCommands() &&
+            !bin->mCommandsRecorded &&
+            !bin->mElementList.empty() )
+         bins[numBins++] = bin;
+   }
+
+   if ( numBins == 0 )
+      return;
+
+   RecordCommandsJobState job;
+   job.state = state;
+   job.bins = bins;
+
+   // Each bin is recorded by a single thread into its own
+   // buffer, so the bins can be spread over the pool.
+   ThreadPool::GLOBAL().parallelFor( numBins, 1, _recordCommandsJob, &job );
+}
+
 void RenderPassManager::renderPass(SceneRenderState * state)
 {
    PROFILE_SCOPE( RenderPassManager_RenderPass );
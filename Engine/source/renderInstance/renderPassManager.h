@@ -222,6 +222,19 @@ public:
    /// @see RenderBinEventSignal
    static RenderBinEventSignal& getRenderBinSignal();
 
+   /// This signal is triggered when a pass is about to be rendered, after
+   /// all the objects have submitted their instances and before any of the
+   /// bins record or draw them.
+   ///
+   /// @param pass   The render pass we're signaling.
+   /// @param state  The current scene state.
+   ///
+   typedef Signal <void (  RenderPassManager *pass,
+                           const SceneRenderState *state )> RenderSignal;
+
+   /// @see RenderSignal
+   static RenderSignal& getRenderSignal();
+
 
    typedef Signal<void(RenderInst *inst)> AddInstSignal;
 
@@ -230,6 +243,11 @@ public:
       return mAddInstSignals.findOrInsert( type )->value; 
    }
 
+   /// If true, the bins which can record their commands do so in
+   /// parallel on the thread pool before the first bin is rendered.
+   /// @see RenderBinManager::recordCommands
+   static bool smParallelRecord;
+
    // ConsoleObject interface
    static void initPersistFields();
    DECLARE_CONOBJECT(RenderPassManager);
@@ -251,6 +269,11 @@ protected:
 
    /// Do a sorted insert into a vector, renderOrder bool controls which test we run for insertion.
    void _insertSort(Vector<RenderBinManager*>& list, RenderBinManager* mgr, bool renderOrder);
+
+   /// Records the commands of the bins which support it.
+   void _recordCommands( const SceneRenderState *state );
+
+   static void _recordCommandsJob( U32 start, U32 end, void *key );
 };
 
 //**************************************************************************
@@ -251,8 +251,8 @@ void RenderPrePassMgr::sort()
 {
    PROFILE_SCOPE( RenderPrePassMgr_sort );
    Parent::sort();
-   dQsort( mTerrainElementList.address(), mTerrainElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
-   dQsort( mObjectElementList.address(), mObjectElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
+   sortElements( mTerrainElementList );
+   sortElements( mObjectElementList );
 }
 
 void RenderPrePassMgr::clear()
@@ -348,6 +348,8 @@ void RenderPrePassMgr::render( SceneRenderState *state )
 
       while ( mat->setupPass( state, sgData ) )
       {
+         U32 instanceCount = 0;
+
          meshItr = itr;
          for ( ; meshItr != mElementList.end(); meshItr++ )
          {
@@ -375,6 +377,8 @@ void RenderPrePassMgr::render( SceneRenderState *state )
             // If we're instanced then don't render yet.
             if ( mat->isInstanced() )
             {
+               instanceCount++;
+
                // Let the material increment the instance buffer, but
                // break the batch if it runs out of room for more.
                if ( !mat->stepInstance() )
@@ -406,6 +410,8 @@ void RenderPrePassMgr::render( SceneRenderState *state )
                GFX->drawPrimitive( *ri->prim );
             else
                GFX->drawPrimitive( ri->primBuffIndex );
+
+            GFX->getDeviceStatistics()->addInstancedDraw( instanceCount );
          }
 
          endOfBatchItr = meshItr;
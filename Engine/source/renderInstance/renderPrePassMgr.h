@@ -136,6 +136,7 @@ public:
 
 protected:      
    virtual ProcessedMaterial* getShaderMaterial();
+   virtual bool _canShareProcessedMaterial() const { return false; }
 
    const RenderPrePassMgr *mPrePassMgr;
 };
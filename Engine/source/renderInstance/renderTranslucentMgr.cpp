@@ -213,6 +213,7 @@ void RenderTranslucentMgr::render( SceneRenderState *state )
          while( mat->setupPass( state, sgData ) )
          {
             U32 a;
+            U32 instanceCount = 0;
             for( a=j; a<binSize; a++ )
             {
                RenderInst* nextRI = mElementList[a].inst;
@@ -236,6 +237,8 @@ void RenderTranslucentMgr::render( SceneRenderState *state )
                // If we're instanced then don't render yet.
                if ( mat->isInstanced() )
                {
+                  instanceCount++;
+
                   // Let the material increment the instance buffer, but
                   // break the batch if it runs out of room for more.
                   if ( !mat->stepInstance() )
@@ -268,6 +271,8 @@ void RenderTranslucentMgr::render( SceneRenderState *state )
                   GFX->drawPrimitive( *ri->prim );
                else
                   GFX->drawPrimitive( ri->primBuffIndex );
+
+               GFX->getDeviceStatistics()->addInstancedDraw( instanceCount );
             }
 
             matListEnd = a;
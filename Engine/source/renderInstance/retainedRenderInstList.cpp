@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "renderInstance/retainedRenderInstList.h"
+
+#include "scene/sceneRenderState.h"
+#include "materials/materialManager.h"
+#include "lighting/lightQuery.h"
+
+
+bool RetainedRenderInstList::smEnabled = true;
+
+
+RetainedRenderInstList::RetainedRenderInstList()
+   :  mObjToWorld( true ),
+      mDetail( -1 ),
+      mRenderPass( NULL ),
+      mMaterialGeneration( 0 ),
+      mIsValid( false ),
+      mIsCapturing( false ),
+      mCaptureCancelled( false )
+{
+   VECTOR_SET_ASSOCIATION( mEntries );
+}
+
+bool RetainedRenderInstList::canRetain( const SceneRenderState *state )
+{
+   return   smEnabled &&
+            state->isDiffusePass() &&
+            state->getMaterialDelegate().empty();
+}
+
+bool RetainedRenderInstList::canSubmit( const SceneRenderState *state, const MatrixF &objToWorld, S32 detail ) const
+{
+   return   mIsValid &&
+            canRetain( state ) &&
+            mDetail == detail &&
+            mRenderPass == state->getRenderPass() &&
+            mMaterialGeneration == MATMGR->getInstanceGeneration() &&
+            dMemcmp( &mObjToWorld, &objToWorld, sizeof( MatrixF ) ) == 0;
+}
+
+void RetainedRenderInstList::submit( const SceneRenderState *state, LightQuery *query )
+{
+   PROFILE_SCOPE( RetainedRenderInstList_submit );
+
+   AssertFatal( mIsValid, "RetainedRenderInstList::submit - Nothing retained!" );
+
+   RenderPassManager *renderPass = state->getRenderPass();
+   const MatrixF *worldToCamera = renderPass->allocSharedXform( RenderPassManager::View );
+   const MatrixF *projection = renderPass->allocSharedXform( RenderPassManager::Projection );
+   const Point3F &camPos = state->getCameraPosition();
+
+   LightInfo *lights[8];
+   bool haveLights = false;
+
+   for ( U32 i = 0; i < mEntries.size(); i++ )
+   {
+      Entry &entry = mEntries[i];
+      MeshRenderInst &ri = entry.inst;
+
+      ri.worldToCamera = worldToCamera;
+      ri.projection = projection;
+
+      if ( entry.useOriginSort )
+         ri.sortDistSq = ( entry.objectToWorld.getPosition() - camPos ).lenSquared();
+      else
+         ri.sortDistSq = entry.worldBox.getSqDistanceToPoint( camPos );
+
+      // Lights can move so query them again, but only once
+      // for all the instances.
+      if ( entry.needsLights )
+      {
+         if ( !haveLights )
+         {
+            dMemset( lights, 0, sizeof( lights ) );
+            if ( query )
+               query->getLights( lights, 8 );
+            haveLights = true;
+         }
+
+         dMemcpy( ri.lights, lights, sizeof( lights ) );
+      }
+
+      renderPass->addInst( &ri );
+   }
+}
+
+void RetainedRenderInstList::beginCapture( const SceneRenderState *state, const MatrixF &objToWorld, S32 detail )
+{
+   AssertFatal( !mIsCapturing, "RetainedRenderInstList::beginCapture - Already capturing!" );
+
+   mEntries.clear();
+   mIsValid = false;
+   mIsCapturing = true;
+   mCaptureCancelled = false;
+
+   mObjToWorld = objToWorld;
+   mDetail = detail;
+   mRenderPass = state->getRenderPass();
+   mMaterialGeneration = MATMGR->getInstanceGeneration();
+}
+
+void RetainedRenderInstList::captureMeshInst( const MeshRenderInst *inst, const Box3F &objBox, bool useOriginSort, bool needsLights )
+{
+   AssertFatal( mIsCapturing, "RetainedRenderInstList::captureMeshInst - Not capturing!" );
+
+   if ( mCaptureCancelled )
+      return;
+
+   mEntries.increment();
+   Entry &entry = mEntries.last();
+
+   entry.inst = *inst;
+   entry.objectToWorld = *inst->objectToWorld;
+   entry.worldBox = objBox;
+   entry.objectToWorld.mul( entry.worldBox );
+   entry.useOriginSort = useOriginSort;
+   entry.needsLights = needsLights;
+
+   // The lights are only valid for this frame.  Instances
+   // that don't need them get none.
+   if ( !needsLights )
+      dMemset( entry.inst.lights, 0, sizeof( entry.inst.lights ) );
+}
+
+void RetainedRenderInstList::endCapture()
+{
+   AssertFatal( mIsCapturing, "RetainedRenderInstList::endCapture - Not capturing!" );
+
+   mIsCapturing = false;
+
+   if ( mCaptureCancelled )
+   {
+      mEntries.clear();
+      return;
+   }
+
+   // Now that the entries won't move anymore point the
+   // instances at their retained transforms.
+   for ( U32 i = 0; i < mEntries.size(); i++ )
+      mEntries[i].inst.objectToWorld = &mEntries[i].objectToWorld;
+
+   mIsValid = true;
+}
+
+void RetainedRenderInstList::invalidate()
+{
+   mEntries.clear();
+   mIsValid = false;
+}
@@ -0,0 +1,142 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _RETAINEDRENDERINSTLIST_H_
+#define _RETAINEDRENDERINSTLIST_H_
+
+#ifndef _RENDERPASSMANAGER_H_
+#include "renderInstance/renderPassManager.h"
+#endif
+
+class SceneRenderState;
+class LightQuery;
+
+
+/// Keeps the MeshRenderInsts an object submitted in one frame so that
+/// they can be submitted again in later frames without being rebuilt.
+///
+/// The owner wraps its normal submission in beginCapture() and endCapture()
+/// and passes the list down to the code which creates the instances, which
+/// records each instance with captureMeshInst().  Code which submits anything
+/// that depends on the camera or on time must call cancelCapture().
+///
+/// On later frames, if canSubmit() returns true for the same inputs, the owner
+/// calls submit() instead of rebuilding the instances.  This patches the per
+/// frame data (sort distance, view and projection transforms, forward lights)
+/// in place and adds the retained instances to the render pass.
+///
+/// Only the diffuse pass without a material override is retained.  The
+/// instances are invalidated automatically when material instances are
+/// re-initialized or destroyed.  Owners must call invalidate() whenever
+/// anything else that affects the instances, such as their shape or skin,
+/// changes.
+class RetainedRenderInstList
+{
+protected:
+
+   struct Entry
+   {
+      /// The retained instance.  Its objectToWorld points to #objectToWorld.
+      MeshRenderInst inst;
+
+      MatrixF objectToWorld;
+
+      /// World space bounds of the mesh used for distance sorting.
+      Box3F worldBox;
+
+      /// Sort by the mesh origin instead of the nearest point on #worldBox.
+      bool useOriginSort;
+
+      /// The material is forward lit and needs the lights refreshed.
+      bool needsLights;
+   };
+
+   Vector< Entry > mEntries;
+
+   /// @name Capture Inputs
+   /// @{
+
+   MatrixF mObjToWorld;
+   S32 mDetail;
+   RenderPassManager *mRenderPass;
+   U32 mMaterialGeneration;
+
+   /// @}
+
+   bool mIsValid;
+   bool mIsCapturing;
+   bool mCaptureCancelled;
+
+public:
+
+   /// If false, nothing is retained.
+   static bool smEnabled;
+
+   RetainedRenderInstList();
+
+   /// Return true if the retained instances can be used for the given inputs.
+   bool canSubmit( const SceneRenderState *state, const MatrixF &objToWorld, S32 detail ) const;
+
+   /// Submit the retained instances to the render pass of @a state.
+   ///
+   /// @param state The scene state being rendered.
+   /// @param query Query used to refresh the lights of forward lit instances.
+   void submit( const SceneRenderState *state, LightQuery *query );
+
+   /// Return true if instances can be retained at all for the given state.
+   static bool canRetain( const SceneRenderState *state );
+
+   /// @name Capturing
+   /// @{
+
+   /// Begin recording the instances submitted for the given inputs.
+   void beginCapture( const SceneRenderState *state, const MatrixF &objToWorld, S32 detail );
+
+   /// Record a mesh instance that was added to the render pass.
+   ///
+   /// @param inst The submitted instance.
+   /// @param objBox Object space bounds of the mesh.
+   /// @param useOriginSort Whether the instance was sorted by origin.
+   /// @param needsLights Whether the material of the instance is forward lit.
+   void captureMeshInst( const MeshRenderInst *inst, const Box3F &objBox, bool useOriginSort, bool needsLights );
+
+   /// Mark the current capture as not retainable.
+   void cancelCapture() { mCaptureCancelled = true; }
+
+   /// Finish recording.  The list becomes valid if the capture wasn't cancelled.
+   void endCapture();
+
+   bool isCapturing() const { return mIsCapturing; }
+
+   /// @}
+
+   /// Discard the retained instances.
+   void invalidate();
+
+   /// Return true if the list holds retained instances.
+   bool isValid() const { return mIsValid; }
+
+   /// Return the number of retained instances.
+   U32 getNumInsts() const { return mEntries.size(); }
+};
+
+#endif // _RETAINEDRENDERINSTLIST_H_
@@ -0,0 +1,135 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "renderInstance/renderBinManager.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Exposes the element sorting of RenderBinManager.
+   class TestRenderBin : public RenderBinManager
+   {
+      public:
+
+         typedef MainSortElem SortElem;
+
+         void sort( Vector< SortElem >& elements ) { sortElements( elements ); }
+   };
+}
+
+CreateUnitTest( TestRenderBinSortKey, "RenderInstance/BinSortKey" )
+{
+   typedef TestRenderBin::SortElem SortElem;
+
+   enum
+   {
+      NUM_ELEMENTS = 5000,
+      NUM_PAIRS = 100000
+   };
+
+   /// cmpKeyFunc with the original position as the final tie breaker,
+   /// which is what the stable sort in the bins must produce.
+   static S32 FN_CDECL cmpStable( const void* p1, const void* p2 )
+   {
+      const S32 result = RenderBinManager::cmpKeyFunc( p1, p2 );
+      if( result )
+         return result;
+
+      const SortElem* e1 = ( const SortElem* ) p1;
+      const SortElem* e2 = ( const SortElem* ) p2;
+      if( e1->inst != e2->inst )
+         return ( e1->inst > e2->inst ) ? 1 : -1;
+      return 0;
+   }
+
+   /// Random key that favors the values around the sign flip and
+   /// the ends of the range.
+   static U32 randKey( MRandomLCG& rand )
+   {
+      static const U32 sEdgeKeys[] = { 0, 1, 0x7FFFFFFF, 0x80000000, 0x80000001, 0xFFFFFFFF };
+
+      if( rand.randI( 0, 3 ) == 0 )
+         return sEdgeKeys[ rand.randI( 0, 5 ) ];
+
+      // randI() only returns 31 bits.
+      return ( rand.randI() << 16 ) ^ rand.randI();
+   }
+
+   void run()
+   {
+      MRandomLCG rand( 1357 );
+
+      // Every pair of keys must compare the same way.
+
+      bool pairsMatch = true;
+      for( U32 i = 0; i < NUM_PAIRS; ++ i )
+      {
+         SortElem e1 = { NULL, randKey( rand ), randKey( rand ) };
+         SortElem e2 = { NULL, randKey( rand ), randKey( rand ) };
+
+         // Make ties on the primary key common.
+         if( i & 1 )
+            e2.key = e1.key;
+
+         const S32 cmp = RenderBinManager::cmpKeyFunc( &e1, &e2 );
+         const U64 k1 = RenderBinManager::makeSortKey( e1.key, e1.key2 );
+         const U64 k2 = RenderBinManager::makeSortKey( e2.key, e2.key2 );
+         const S32 keyCmp = ( k1 < k2 ) ? -1 : ( ( k1 > k2 ) ? 1 : 0 );
+
+         pairsMatch &= ( cmp == keyCmp );
+      }
+
+      test( pairsMatch, "makeSortKey order differs from cmpKeyFunc" );
+
+      // Sorting a bin must give the cmpKeyFunc order and keep
+      // elements with equal keys in the order they were added.
+
+      Vector< SortElem > elements;
+      elements.setSize( NUM_ELEMENTS );
+      for( U32 i = 0; i < NUM_ELEMENTS; ++ i )
+      {
+         elements[ i ].inst = ( RenderInst* ) ( dsize_t ) ( i + 1 );
+         elements[ i ].key = randKey( rand );
+         elements[ i ].key2 = randKey( rand );
+      }
+
+      Vector< SortElem > reference = elements;
+      dQsort( reference.address(), reference.size(), sizeof( SortElem ), cmpStable );
+
+      TestRenderBin* bin = new TestRenderBin;
+      bin->sort( elements );
+      delete bin;
+
+      test( dMemcmp( elements.address(), reference.address(), elements.size() * sizeof( SortElem ) ) == 0,
+         "Sorted bin order differs from cmpKeyFunc order" );
+   }
+};
+
+#endif // !TORQUE_SHIPPING
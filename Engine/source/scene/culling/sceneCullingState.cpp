@@ -31,6 +31,9 @@
 #include "terrain/terrData.h"
 #include "util/tempAlloc.h"
 #include "gfx/sim/debugDraw.h"
+#include "platform/threads/threadPool.h"
+#include "platform/threads/thread.h"
+#include "core/frameAllocator.h"
 
 
 extern bool gEditingMission;
@@ -41,6 +44,9 @@ bool SceneCullingState::smDisableZoneCulling = false;
 U32 SceneCullingState::smMaxOccludersPerZone = 4;
 F32 SceneCullingState::smOccluderMinWidthPercentage = 0.1f;
 F32 SceneCullingState::smOccluderMinHeightPercentage = 0.1f;
+bool SceneCullingState::smParallelCulling = true;
+U32 SceneCullingState::smMinParallelCullObjects = 1024;
+U32 SceneCullingState::smParallelCullChunkSize = 256;
 
 
 
@@ -711,85 +717,259 @@ bool SceneCullingState::isOccluded( const SphereF& sphere, const U32* zones, U32
 
 //-----------------------------------------------------------------------------
 
-U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+U32 SceneCullingState::_cullObject( SceneObject* object, U32 cullOptions, const PlaneF& nearPlane, const PlaneF& farPlane, const S8* frustumResult ) const
 {
-   PROFILE_SCOPE( SceneCullingState_cullObjects );
+   // If we should respect editor overrides, test that now.
 
-   U32 numRemainingObjects = 0;
+   if( !( cullOptions & CullEditorOverrides ) &&
+       gEditingMission &&
+       ( ( object->isCullingDisabledInEditor() && object->isRenderEnabled() ) || object->isSelected() ) )
+   {
+      return ObjectVisible;
+   }
 
-   // We test near and far planes separately in order to not do the tests
-   // repeatedly, so fetch the planes now.
-   const PlaneF& nearPlane = getCullingFrustum().getPlanes()[ Frustum::PlaneNear ];
-   const PlaneF& farPlane = getCullingFrustum().getPlanes()[ Frustum::PlaneFar ];
+   // If the object is render-disabled, it gets culled.  The only
+   // way around this is the editor override above.
 
-   for( U32 i = 0; i < numObjects; ++ i )
+   if( !( cullOptions & DontCullRenderDisabled ) &&
+       !object->isRenderEnabled() )
    {
-      SceneObject* object = objects[ i ];
-      bool isCulled = true;
+      return ObjectCulled;
+   }
 
-      // If we should respect editor overrides, test that now.
+   // Global bounds objects are never culled.  Note that this means
+   // that if these objects are to respect zoning, they need to manually
+   // trigger the respective culling checks for whatever they want to
+   // batch.
 
-      if( !( cullOptions & CullEditorOverrides ) &&
-          gEditingMission &&
-          ( ( object->isCullingDisabledInEditor() && object->isRenderEnabled() ) || object->isSelected() ) )
-      {
-         isCulled = false;
-      }
+   if( object->isGlobalBounds() )
+      return ObjectVisible;
 
-      // If the object is render-disabled, it gets culled.  The only
-      // way around this is the editor override above.
+   bool isCulled;
 
-      else if( !( cullOptions & DontCullRenderDisabled ) &&
-               !object->isRenderEnabled() )
-      {
-         isCulled = true;
-      }
+   // If the object shouldn't be subjected to more fine-grained culling
+   // or if zone culling is disabled, just test against the root frustum.
 
-      // Global bounds objects are never culled.  Note that this means
-      // that if these objects are to respect zoning, they need to manually
-      // trigger the respective culling checks for whatever they want to
-      // batch.
+   if( !( object->getTypeMask() & CULLING_INCLUDE_TYPEMASK ) ||
+       ( object->getTypeMask() & CULLING_EXCLUDE_TYPEMASK ) ||
+       disableZoneCulling() )
+   {
+      if( frustumResult )
+         isCulled = ( *frustumResult == GeometryOutside );
+      else
+         isCulled = getCullingFrustum().isCulled( object->getWorldBox() );
+   }
 
-      else if( object->isGlobalBounds() )
-         isCulled = false;
+   // Go through the zones that the object is assigned to and
+   // test the object against the frustums of each of the zones.
 
-      // If terrain occlusion checks are enabled, run them now.
+   else
+   {
+      CullingTestResult result = _test(
+         object->getWorldBox(),
+         SceneObject::ObjectZonesIterator( object ),
+         nearPlane,
+         farPlane
+      );
 
-      else if( !mDisableTerrainOcclusion &&
-               object->getWorldBox().minExtents.x > -1e5 &&
-               isOccludedByTerrain( object ) )
-      {
-         // Occluded by terrain.
-         isCulled = true;
-      }
+      isCulled = ( result == SceneZoneCullingState::CullingTestNegative ||
+                   result == SceneZoneCullingState::CullingTestPositiveByOcclusion );
+   }
 
-      // If the object shouldn't be subjected to more fine-grained culling
-      // or if zone culling is disabled, just test against the root frustum.
+   if( isCulled )
+      return ObjectCulled;
 
-      else if( !( object->getTypeMask() & CULLING_INCLUDE_TYPEMASK ) ||
-               ( object->getTypeMask() & CULLING_EXCLUDE_TYPEMASK ) ||
-               disableZoneCulling() )
-      {
-         isCulled = getCullingFrustum().isCulled( object->getWorldBox() );
-      }
+   // If terrain occlusion checks are enabled, the object still has to pass
+   // them.  As all tests are side-effect free, running the terrain test last
+   // gives the same result as running it first but saves the expensive ray
+   // casts for objects that are outside the frustum anyway.
 
-      // Go through the zones that the object is assigned to and
-      // test the object against the frustums of each of the zones.
+   if( !mDisableTerrainOcclusion &&
+       object->getWorldBox().minExtents.x > -1e5 )
+      return ObjectNeedsTerrainTest;
 
-      else
+   return ObjectVisible;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneCullingState::_cullObjectsJob( U32 start, U32 end, void* key )
+{
+   PROFILE_SCOPE( SceneCullingState_cullObjectsJob );
+
+   CullObjectsJobState* job = reinterpret_cast< CullObjectsJobState* >( key );
+
+   // Find the list holding the first object of the range.
+
+   U32 listIndex = 0;
+   while( start >= job->listStarts[ listIndex + 1 ] )
+      listIndex ++;
+
+   for( U32 i = start; i < end; ++ i )
+   {
+      while( i >= job->listStarts[ listIndex + 1 ] )
+         listIndex ++;
+
+      const ObjectList& list = job->lists[ listIndex ];
+      const Frustum& frustum = list.state->getCullingFrustum();
+
+      job->results[ i ] = list.state->_cullObject(
+         list.objects[ i - job->listStarts[ listIndex ] ],
+         list.cullOptions,
+         frustum.getPlanes()[ Frustum::PlaneNear ],
+         frustum.getPlanes()[ Frustum::PlaneFar ]
+      );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneCullingState::_cullObjectListsParallel( ObjectList* lists, U32 numLists )
+{
+   AssertFatal( ThreadManager::isMainThread(), "SceneCullingState::_cullObjectListsParallel - Must be called on the main thread!" );
+
+   FrameTemp< U32 > listStarts( numLists + 1 );
+   U32 numObjects = 0;
+
+   for( U32 i = 0; i < numLists; ++ i )
+   {
+      const SceneCullingState* state = lists[ i ].state;
+
+      // Bring the frustum planes up to date before any jobs read from them.
+      state->getCullingFrustum().getPlanes();
+
+      // Testing the volumes of a zone lazily sorts them, so make sure
+      // this has happened before any job touches the zone states.
+
+      for( U32 n = 0; n < state->mZoneStates.size(); ++ n )
+         if( state->mZoneStates[ n ].hasIncluders() )
+            state->mZoneStates[ n ].prepareForTesting();
+
+      listStarts[ i ] = numObjects;
+      numObjects += lists[ i ].numObjects;
+   }
+
+   listStarts[ numLists ] = numObjects;
+
+   if( !numObjects )
+      return;
+
+   FrameTemp< U8 > results( numObjects );
+
+   CullObjectsJobState job;
+   job.lists = lists;
+   job.listStarts = listStarts;
+   job.results = results;
+
+   ThreadPool::GLOBAL().parallelFor( numObjects, getMax( smParallelCullChunkSize, ( U32 ) 1 ), _cullObjectsJob, &job );
+
+   // Compact the lists on this thread in the original order so
+   // that the result is identical to culling serially.
+
+   PROFILE_SCOPE( SceneCullingState_cullObjects_merge );
+
+   for( U32 i = 0; i < numLists; ++ i )
+   {
+      ObjectList& list = lists[ i ];
+      const U8* listResults = &results[ listStarts[ i ] ];
+      U32 numRemainingObjects = 0;
+
+      for( U32 n = 0; n < list.numObjects; ++ n )
       {
-         CullingTestResult result = _test(
-            object->getWorldBox(),
-            SceneObject::ObjectZonesIterator( object ),
-            nearPlane,
-            farPlane
-         );
+         SceneObject* object = list.objects[ n ];
+         const U32 result = listResults[ n ];
 
-         isCulled = ( result == SceneZoneCullingState::CullingTestNegative ||
-                      result == SceneZoneCullingState::CullingTestPositiveByOcclusion );
+         if( result == ObjectVisible ||
+             ( result == ObjectNeedsTerrainTest && !list.state->isOccludedByTerrain( object ) ) )
+            list.objects[ numRemainingObjects ++ ] = object;
       }
 
-      if( !isCulled )
+      list.numObjects = numRemainingObjects;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneCullingState::cullObjectLists( ObjectList* lists, U32 numLists )
+{
+   PROFILE_SCOPE( SceneCullingState_cullObjectLists );
+
+   U32 numObjects = 0;
+   for( U32 i = 0; i < numLists; ++ i )
+      numObjects += lists[ i ].numObjects;
+
+   if( smParallelCulling &&
+       numObjects >= smMinParallelCullObjects &&
+       ThreadManager::isMainThread() )
+   {
+      _cullObjectListsParallel( lists, numLists );
+      return;
+   }
+
+   for( U32 i = 0; i < numLists; ++ i )
+      lists[ i ].numObjects = lists[ i ].state->cullObjects( lists[ i ].objects, lists[ i ].numObjects, lists[ i ].cullOptions );
+}
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+{
+   PROFILE_SCOPE( SceneCullingState_cullObjects );
+
+   // For large object lists, run the tests in parallel.
+
+   if( smParallelCulling &&
+       numObjects >= smMinParallelCullObjects &&
+       ThreadManager::isMainThread() )
+   {
+      ObjectList list;
+      list.state = this;
+      list.objects = objects;
+      list.numObjects = numObjects;
+      list.cullOptions = cullOptions;
+
+      _cullObjectListsParallel( &list, 1 );
+
+      return list.numObjects;
+   }
+
+   // We test near and far planes separately in order to not do the tests
+   // repeatedly, so fetch the planes now.
+   const PlaneF& nearPlane = getCullingFrustum().getPlanes()[ Frustum::PlaneNear ];
+   const PlaneF& farPlane = getCullingFrustum().getPlanes()[ Frustum::PlaneFar ];
+
+   // With zone culling disabled, every object that gets past the editor and
+   // global bounds checks is tested against the root frustum only.  Do these
+   // tests for the whole list in one go on the SoA kernels.  The kernels give
+   // the same results as Frustum::isCulled() so this does not change what
+   // gets culled.
+
+   const bool batchFrustumTests = disableZoneCulling() && numObjects >= Box3FSoA::BoxesPerBlock;
+
+   if( batchFrustumTests )
+   {
+      mObjectBoxes.setSize( numObjects );
+      for( U32 i = 0; i < numObjects; ++ i )
+         mObjectBoxes.set( i, objects[ i ]->getWorldBox() );
+   }
+
+   FrameTemp< S8 > frustumResults( batchFrustumTests ? mObjectBoxes.getPaddedSize() : 1 );
+
+   if( batchFrustumTests )
+   {
+      const Frustum& frustum = getCullingFrustum();
+      mObjectBoxes.testPotentialIntersection( PlaneSetF( frustum.getPlanes(), frustum.getNumPlanes() ), frustumResults );
+   }
+
+   U32 numRemainingObjects = 0;
+
+   for( U32 i = 0; i < numObjects; ++ i )
+   {
+      SceneObject* object = objects[ i ];
+      const U32 result = _cullObject( object, cullOptions, nearPlane, farPlane, batchFrustumTests ? &frustumResults[ i ] : NULL );
+
+      if( result == ObjectVisible ||
+          ( result == ObjectNeedsTerrainTest && !isOccludedByTerrain( object ) ) )
          objects[ numRemainingObjects ++ ] = object;
    }
 
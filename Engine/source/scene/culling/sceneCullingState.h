@@ -47,6 +47,10 @@
 #include "core/bitVector.h"
 #endif
 
+#ifndef _BOXSOA_H_
+#include "math/util/boxSoA.h"
+#endif
+
 
 class SceneObject;
 class SceneManager;
@@ -92,6 +96,22 @@ class SceneCullingState
 
       /// @}
 
+      /// @name Parallel Culling
+      /// @{
+
+      /// If true, cullObjects() will distribute the object tests of large
+      /// object lists across the global thread pool.
+      static bool smParallelCulling;
+
+      /// Minimum number of objects that must be passed to cullObjects() for
+      /// the tests to be distributed across threads.
+      static U32 smMinParallelCullObjects;
+
+      /// Number of objects that are tested in a single job.
+      static U32 smParallelCullChunkSize;
+
+      /// @}
+
    protected:
 
       /// Scene which is being culled.
@@ -129,6 +149,11 @@ class SceneCullingState
       /// frustum.
       bool mDisableZoneCulling;
 
+      /// World boxes of the objects passed to cullObjects() for testing
+      /// them against the root frustum in one batch.  Kept around to reuse
+      /// the memory between calls.
+      mutable Box3FSoA mObjectBoxes;
+
    public:
 
       ///
@@ -176,6 +201,30 @@ class SceneCullingState
       /// @return Number of objects remaining in the list.
       U32 cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions = 0 ) const;
 
+      /// A list of objects to cull against a culling state with cullObjectLists().
+      struct ObjectList
+      {
+         /// The culling state to test the objects against.
+         const SceneCullingState* state;
+
+         /// Array of objects.  This array will be modified in place.
+         SceneObject** objects;
+
+         /// Number of objects in #objects.  Receives the number of
+         /// objects remaining in the list.
+         U32 numObjects;
+
+         /// Combination of CullOptions.
+         U32 cullOptions;
+      };
+
+      /// Cull several object lists, each against its own culling state, with the
+      /// same results as calling cullObjects() on each of them.  The tests for all
+      /// the lists are distributed across the thread pool together so that passes
+      /// rendering many small views, like the splits of a shadow map, get the
+      /// benefit of parallel culling even if each of their lists is small.
+      static void cullObjectLists( ObjectList* lists, U32 numLists );
+
       /// Return true if the given object is culled according to the current culling state.
       bool isCulled( SceneObject* object ) const { return ( cullObjects( &object, 1 ) == 0 ); }
 
@@ -305,6 +354,43 @@ class SceneCullingState
 
       typedef SceneZoneCullingState::CullingTestResult CullingTestResult;
 
+      /// Result of culling a single object in _cullObject().
+      enum ObjectCullResult
+      {
+         ObjectCulled,
+         ObjectVisible,
+
+         /// The object passed all tests except for the terrain occlusion test
+         /// which must still be run.  Terrain ray casts are not thread-safe so
+         /// this test is always deferred to the main thread.
+         ObjectNeedsTerrainTest
+      };
+
+      /// Shared state for the jobs spawned by _cullObjectListsParallel().
+      struct CullObjectsJobState
+      {
+         ObjectList* lists;
+
+         /// Index of the first result of each list plus the total
+         /// number of objects at the end.
+         U32* listStarts;
+
+         U8* results;
+      };
+
+      /// Run all thread-safe culling tests on a single object.
+      /// @param frustumResult If not NULL, the result of testing the object's world
+      ///   box against the root frustum which is then used instead of testing again.
+      /// @return An ObjectCullResult.
+      U32 _cullObject( SceneObject* object, U32 cullOptions, const PlaneF& nearPlane, const PlaneF& farPlane, const S8* frustumResult = NULL ) const;
+
+      /// ThreadPool::parallelFor() callback that culls a range of objects.
+      static void _cullObjectsJob( U32 start, U32 end, void* key );
+
+      /// Cull the given lists on the thread pool.  Must be called on the
+      /// main thread.
+      static void _cullObjectListsParallel( ObjectList* lists, U32 numLists );
+
       // Helper methods to avoid code duplication.
 
       template< bool OCCLUDERS_ONLY, typename T > CullingTestResult _test( const T& bounds, const U32* zones, U32 numZones ) const;
@@ -140,6 +140,10 @@ class SceneZoneCullingState
       /// includers have been added to the zone's rendering state.
       bool isZoneVisible() const { return mHaveIncluders; }
 
+      /// Make sure the culling volumes are sorted so that the testVolumes() methods
+      /// do not modify the state.  Must be called before testing from multiple threads.
+      void prepareForTesting() const { if( !mHaveSortedVolumes ) _sortVolumes(); }
+
       /// Return the list of culling volumes attached to the zone.
       CullingVolumeLink* getCullingVolumes() const { _sortVolumes(); return mCullingVolumes; }
 
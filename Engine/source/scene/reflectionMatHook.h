@@ -39,6 +39,11 @@ public:
    virtual ~ReflectionMatInstance() {}
 
    virtual bool setupPass( SceneRenderState *state, const SceneData &sgData );
+
+protected:
+
+   // MatInstance
+   virtual bool _canShareProcessedMaterial() const { return false; }
 };
 
 class ReflectionMaterialHook : public MatInstanceHook
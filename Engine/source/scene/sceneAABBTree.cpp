@@ -0,0 +1,747 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "scene/sceneAABBTree.h"
+
+#include "math/util/frustum.h"
+#include "platform/profiler.h"
+
+#if defined( TORQUE_CPU_X86 )
+#include <xmmintrin.h>
+#endif
+
+
+F32 SceneAABBTree::smFatMargin = 0.5f;
+
+/// Maximum depth of the traversal stacks.  Balancing keeps the tree height
+/// logarithmic so this is never approached in practice.
+static const U32 sMaxStackDepth = 256;
+
+
+//-----------------------------------------------------------------------------
+
+SceneAABBTree::SceneAABBTree()
+   : mRoot( InvalidProxy ),
+     mFreeList( InvalidProxy ),
+     mNumLeaves( 0 )
+{
+   VECTOR_SET_ASSOCIATION( mNodes );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::clear()
+{
+   mNodes.clear();
+   mRoot = InvalidProxy;
+   mFreeList = InvalidProxy;
+   mNumLeaves = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+inline F32 SceneAABBTree::_getSurfaceArea( const Box3F& box )
+{
+   const F32 x = box.len_x();
+   const F32 y = box.len_y();
+   const F32 z = box.len_z();
+   return 2.0f * ( x * y + y * z + z * x );
+}
+
+//-----------------------------------------------------------------------------
+
+inline Box3F SceneAABBTree::_getUnion( const Box3F& a, const Box3F& b )
+{
+   Box3F result = a;
+   result.intersect( b ); // Box3F::intersect computes the union.
+   return result;
+}
+
+//-----------------------------------------------------------------------------
+
+S32 SceneAABBTree::_allocateNode()
+{
+   S32 nodeId;
+   if( mFreeList == InvalidProxy )
+   {
+      mNodes.increment();
+      nodeId = mNodes.size() - 1;
+   }
+   else
+   {
+      nodeId = mFreeList;
+      mFreeList = mNodes[ nodeId ].parent;
+   }
+
+   Node& node = mNodes[ nodeId ];
+   node.parent = InvalidProxy;
+   node.child1 = InvalidProxy;
+   node.child2 = InvalidProxy;
+   node.height = 0;
+   node.object = NULL;
+
+   return nodeId;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::_freeNode( S32 nodeId )
+{
+   Node& node = mNodes[ nodeId ];
+   node.parent = mFreeList;
+   node.height = -1;
+   node.object = NULL;
+   mFreeList = nodeId;
+}
+
+//-----------------------------------------------------------------------------
+
+SceneAABBTree::ProxyId SceneAABBTree::insert( SceneObject* object, const Box3F& worldBox )
+{
+   PROFILE_SCOPE( SceneAABBTree_insert );
+
+   const S32 leafId = _allocateNode();
+
+   Node& leaf = mNodes[ leafId ];
+   leaf.object = object;
+   leaf.box.minExtents = worldBox.minExtents - Point3F( smFatMargin, smFatMargin, smFatMargin );
+   leaf.box.maxExtents = worldBox.maxExtents + Point3F( smFatMargin, smFatMargin, smFatMargin );
+
+   _insertLeaf( leafId );
+   mNumLeaves ++;
+
+   return leafId;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::remove( ProxyId proxy )
+{
+   AssertFatal( proxy >= 0 && proxy < mNodes.size() && mNodes[ proxy ].isLeaf(),
+      "SceneAABBTree::remove - Invalid proxy!" );
+
+   _removeLeaf( proxy );
+   _freeNode( proxy );
+   mNumLeaves --;
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneAABBTree::update( ProxyId proxy, const Box3F& worldBox )
+{
+   AssertFatal( proxy >= 0 && proxy < mNodes.size() && mNodes[ proxy ].isLeaf(),
+      "SceneAABBTree::update - Invalid proxy!" );
+
+   if( mNodes[ proxy ].box.isContained( worldBox ) )
+      return false;
+
+   PROFILE_SCOPE( SceneAABBTree_update );
+
+   _removeLeaf( proxy );
+
+   Node& leaf = mNodes[ proxy ];
+   leaf.box.minExtents = worldBox.minExtents - Point3F( smFatMargin, smFatMargin, smFatMargin );
+   leaf.box.maxExtents = worldBox.maxExtents + Point3F( smFatMargin, smFatMargin, smFatMargin );
+
+   _insertLeaf( proxy );
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::_insertLeaf( S32 leafId )
+{
+   if( mRoot == InvalidProxy )
+   {
+      mRoot = leafId;
+      mNodes[ mRoot ].parent = InvalidProxy;
+      return;
+   }
+
+   // Walk down the tree picking the child that results in the least
+   // increase in surface area.
+
+   const Box3F leafBox = mNodes[ leafId ].box;
+
+   S32 index = mRoot;
+   while( !mNodes[ index ].isLeaf() )
+   {
+      const Node& node = mNodes[ index ];
+      const S32 child1 = node.child1;
+      const S32 child2 = node.child2;
+
+      const F32 area = _getSurfaceArea( node.box );
+      const F32 combinedArea = _getSurfaceArea( _getUnion( node.box, leafBox ) );
+
+      // Cost of creating a new parent for this node and the new leaf.
+      const F32 cost = 2.0f * combinedArea;
+
+      // Minimum cost of pushing the leaf further down the tree.
+      const F32 inheritanceCost = 2.0f * ( combinedArea - area );
+
+      F32 cost1 = _getSurfaceArea( _getUnion( leafBox, mNodes[ child1 ].box ) ) + inheritanceCost;
+      if( !mNodes[ child1 ].isLeaf() )
+         cost1 -= _getSurfaceArea( mNodes[ child1 ].box );
+
+      F32 cost2 = _getSurfaceArea( _getUnion( leafBox, mNodes[ child2 ].box ) ) + inheritanceCost;
+      if( !mNodes[ child2 ].isLeaf() )
+         cost2 -= _getSurfaceArea( mNodes[ child2 ].box );
+
+      if( cost < cost1 && cost < cost2 )
+         break;
+
+      index = ( cost1 < cost2 ) ? child1 : child2;
+   }
+
+   const S32 siblingId = index;
+
+   // Create a new parent for the sibling and the leaf.  Note that this
+   // may grow the node vector so grab no references before this point.
+
+   const S32 newParentId = _allocateNode();
+   const S32 oldParentId = mNodes[ siblingId ].parent;
+
+   Node& newParent = mNodes[ newParentId ];
+   newParent.parent = oldParentId;
+   newParent.box = _getUnion( leafBox, mNodes[ siblingId ].box );
+   newParent.height = mNodes[ siblingId ].height + 1;
+   newParent.child1 = siblingId;
+   newParent.child2 = leafId;
+
+   if( oldParentId != InvalidProxy )
+   {
+      if( mNodes[ oldParentId ].child1 == siblingId )
+         mNodes[ oldParentId ].child1 = newParentId;
+      else
+         mNodes[ oldParentId ].child2 = newParentId;
+   }
+   else
+      mRoot = newParentId;
+
+   mNodes[ siblingId ].parent = newParentId;
+   mNodes[ leafId ].parent = newParentId;
+
+   _refit( newParentId );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::_removeLeaf( S32 leafId )
+{
+   if( leafId == mRoot )
+   {
+      mRoot = InvalidProxy;
+      return;
+   }
+
+   const S32 parentId = mNodes[ leafId ].parent;
+   const S32 grandParentId = mNodes[ parentId ].parent;
+   const S32 siblingId = ( mNodes[ parentId ].child1 == leafId ) ? mNodes[ parentId ].child2 : mNodes[ parentId ].child1;
+
+   if( grandParentId != InvalidProxy )
+   {
+      // Replace the parent with the sibling.
+
+      if( mNodes[ grandParentId ].child1 == parentId )
+         mNodes[ grandParentId ].child1 = siblingId;
+      else
+         mNodes[ grandParentId ].child2 = siblingId;
+
+      mNodes[ siblingId ].parent = grandParentId;
+      _freeNode( parentId );
+
+      _refit( grandParentId );
+   }
+   else
+   {
+      mRoot = siblingId;
+      mNodes[ siblingId ].parent = InvalidProxy;
+      _freeNode( parentId );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::_refit( S32 nodeId )
+{
+   S32 index = nodeId;
+   while( index != InvalidProxy )
+   {
+      index = _balance( index );
+
+      Node& node = mNodes[ index ];
+      const Node& child1 = mNodes[ node.child1 ];
+      const Node& child2 = mNodes[ node.child2 ];
+
+      node.height = 1 + getMax( child1.height, child2.height );
+      node.box = _getUnion( child1.box, child2.box );
+
+      index = node.parent;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+S32 SceneAABBTree::_balance( S32 iA )
+{
+   Node* A = &mNodes[ iA ];
+   if( A->isLeaf() || A->height < 2 )
+      return iA;
+
+   const S32 iB = A->child1;
+   const S32 iC = A->child2;
+   Node* B = &mNodes[ iB ];
+   Node* C = &mNodes[ iC ];
+
+   const S32 balance = C->height - B->height;
+
+   // Rotate C up.
+
+   if( balance > 1 )
+   {
+      const S32 iF = C->child1;
+      const S32 iG = C->child2;
+      Node* F = &mNodes[ iF ];
+      Node* G = &mNodes[ iG ];
+
+      C->child1 = iA;
+      C->parent = A->parent;
+      A->parent = iC;
+
+      if( C->parent != InvalidProxy )
+      {
+         if( mNodes[ C->parent ].child1 == iA )
+            mNodes[ C->parent ].child1 = iC;
+         else
+            mNodes[ C->parent ].child2 = iC;
+      }
+      else
+         mRoot = iC;
+
+      if( F->height > G->height )
+      {
+         C->child2 = iF;
+         A->child2 = iG;
+         G->parent = iA;
+         A->box = _getUnion( B->box, G->box );
+         C->box = _getUnion( A->box, F->box );
+         A->height = 1 + getMax( B->height, G->height );
+         C->height = 1 + getMax( A->height, F->height );
+      }
+      else
+      {
+         C->child2 = iG;
+         A->child2 = iF;
+         F->parent = iA;
+         A->box = _getUnion( B->box, F->box );
+         C->box = _getUnion( A->box, G->box );
+         A->height = 1 + getMax( B->height, F->height );
+         C->height = 1 + getMax( A->height, G->height );
+      }
+
+      return iC;
+   }
+
+   // Rotate B up.
+
+   if( balance < -1 )
+   {
+      const S32 iD = B->child1;
+      const S32 iE = B->child2;
+      Node* D = &mNodes[ iD ];
+      Node* E = &mNodes[ iE ];
+
+      B->child1 = iA;
+      B->parent = A->parent;
+      A->parent = iB;
+
+      if( B->parent != InvalidProxy )
+      {
+         if( mNodes[ B->parent ].child1 == iA )
+            mNodes[ B->parent ].child1 = iB;
+         else
+            mNodes[ B->parent ].child2 = iB;
+      }
+      else
+         mRoot = iB;
+
+      if( D->height > E->height )
+      {
+         B->child2 = iD;
+         A->child1 = iE;
+         E->parent = iA;
+         A->box = _getUnion( C->box, E->box );
+         B->box = _getUnion( A->box, D->box );
+         A->height = 1 + getMax( C->height, E->height );
+         B->height = 1 + getMax( A->height, D->height );
+      }
+      else
+      {
+         B->child2 = iE;
+         A->child1 = iD;
+         D->parent = iA;
+         A->box = _getUnion( C->box, D->box );
+         B->box = _getUnion( A->box, E->box );
+         A->height = 1 + getMax( C->height, D->height );
+         B->height = 1 + getMax( A->height, E->height );
+      }
+
+      return iB;
+   }
+
+   return iA;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::findObjects( const Box3F& box, QueryCallback callback, void* key ) const
+{
+   if( mRoot == InvalidProxy )
+      return;
+
+   S32 stack[ sMaxStackDepth ];
+   U32 stackSize = 0;
+   stack[ stackSize ++ ] = mRoot;
+
+   while( stackSize > 0 )
+   {
+      const Node& node = mNodes[ stack[ -- stackSize ] ];
+      if( !node.box.isOverlapped( box ) )
+         continue;
+
+      if( node.isLeaf() )
+         callback( node.object, key );
+      else
+      {
+         AssertFatal( stackSize + 2 <= sMaxStackDepth, "SceneAABBTree::findObjects - Stack overflow!" );
+         stack[ stackSize ++ ] = node.child1;
+         stack[ stackSize ++ ] = node.child2;
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::findObjects( const Frustum& frustum, QueryCallback callback, void* key ) const
+{
+   if( mRoot == InvalidProxy )
+      return;
+
+   // Entries with the high bit set denote subtrees that are known to be
+   // fully inside the frustum and need no further testing.
+
+   static const U32 sInsideFlag = 0x80000000;
+
+   U32 stack[ sMaxStackDepth ];
+   U32 stackSize = 0;
+   stack[ stackSize ++ ] = mRoot;
+
+   while( stackSize > 0 )
+   {
+      const U32 entry = stack[ -- stackSize ];
+      const Node& node = mNodes[ entry & ~sInsideFlag ];
+
+      U32 childFlag = entry & sInsideFlag;
+      if( !childFlag )
+      {
+         const OverlapTestResult result = frustum.testPotentialIntersection( node.box );
+         if( result == GeometryOutside )
+            continue;
+         else if( result == GeometryInside )
+            childFlag = sInsideFlag;
+      }
+
+      if( node.isLeaf() )
+         callback( node.object, key );
+      else
+      {
+         AssertFatal( stackSize + 2 <= sMaxStackDepth, "SceneAABBTree::findObjects - Stack overflow!" );
+         stack[ stackSize ++ ] = U32( node.child1 ) | childFlag;
+         stack[ stackSize ++ ] = U32( node.child2 ) | childFlag;
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+/// Slab test of the segment start + dir * [0,maxT] against @a box.
+static inline bool _intersectsSegment( const Box3F& box, const Point3F& start, const Point3F& invDir, const bool* parallel, F32 maxT )
+{
+   F32 tMin = 0.0f;
+   F32 tMax = maxT;
+
+   for( U32 i = 0; i < 3; ++ i )
+   {
+      if( parallel[ i ] )
+      {
+         if( start[ i ] < box.minExtents[ i ] || start[ i ] > box.maxExtents[ i ] )
+            return false;
+      }
+      else
+      {
+         F32 t1 = ( box.minExtents[ i ] - start[ i ] ) * invDir[ i ];
+         F32 t2 = ( box.maxExtents[ i ] - start[ i ] ) * invDir[ i ];
+         if( t1 > t2 )
+            swap( t1, t2 );
+
+         tMin = getMax( tMin, t1 );
+         tMax = getMin( tMax, t2 );
+         if( tMin > tMax )
+            return false;
+      }
+   }
+
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::castRay( const Point3F& start, const Point3F& end, F32 maxT, RayCallback callback, void* key ) const
+{
+   if( mRoot == InvalidProxy )
+      return;
+
+   const Point3F dir = end - start;
+   Point3F invDir;
+   bool parallel[ 3 ];
+   for( U32 i = 0; i < 3; ++ i )
+   {
+      parallel[ i ] = ( mFabs( dir[ i ] ) < 1.0e-9f );
+      invDir[ i ] = parallel[ i ] ? 0.0f : 1.0f / dir[ i ];
+   }
+
+   S32 stack[ sMaxStackDepth ];
+   U32 stackSize = 0;
+   stack[ stackSize ++ ] = mRoot;
+
+   while( stackSize > 0 )
+   {
+      const Node& node = mNodes[ stack[ -- stackSize ] ];
+      if( !_intersectsSegment( node.box, start, invDir, parallel, maxT ) )
+         continue;
+
+      if( node.isLeaf() )
+         maxT = callback( node.object, maxT, key );
+      else
+      {
+         AssertFatal( stackSize + 2 <= sMaxStackDepth, "SceneAABBTree::castRay - Stack overflow!" );
+         stack[ stackSize ++ ] = node.child1;
+         stack[ stackSize ++ ] = node.child2;
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+   /// Rays of a packet in structure-of-arrays layout.  Inverse directions
+   /// of axis-parallel rays are set to a huge value rather than infinity
+   /// so the slab tests never produce NaNs.
+   struct RayPacket
+   {
+      F32 originX[ SceneAABBTree::RayPacketSize ];
+      F32 originY[ SceneAABBTree::RayPacketSize ];
+      F32 originZ[ SceneAABBTree::RayPacketSize ];
+      F32 invDirX[ SceneAABBTree::RayPacketSize ];
+      F32 invDirY[ SceneAABBTree::RayPacketSize ];
+      F32 invDirZ[ SceneAABBTree::RayPacketSize ];
+   };
+}
+
+static inline F32 _getSafeInverse( F32 value )
+{
+   if( mFabs( value ) < 1.0e-9f )
+      return ( value < 0.0f ) ? -1.0e30f : 1.0e30f;
+   return 1.0f / value;
+}
+
+/// Return a bit mask of the rays in @a packet that hit @a box.
+static inline U32 _intersectRayPacket_C( const Box3F& box, const RayPacket& packet, const F32* maxT )
+{
+   U32 result = 0;
+   for( U32 i = 0; i < SceneAABBTree::RayPacketSize; ++ i )
+   {
+      F32 t1 = ( box.minExtents.x - packet.originX[ i ] ) * packet.invDirX[ i ];
+      F32 t2 = ( box.maxExtents.x - packet.originX[ i ] ) * packet.invDirX[ i ];
+      F32 tMin = getMax( 0.0f, getMin( t1, t2 ) );
+      F32 tMax = getMin( maxT[ i ], getMax( t1, t2 ) );
+
+      t1 = ( box.minExtents.y - packet.originY[ i ] ) * packet.invDirY[ i ];
+      t2 = ( box.maxExtents.y - packet.originY[ i ] ) * packet.invDirY[ i ];
+      tMin = getMax( tMin, getMin( t1, t2 ) );
+      tMax = getMin( tMax, getMax( t1, t2 ) );
+
+      t1 = ( box.minExtents.z - packet.originZ[ i ] ) * packet.invDirZ[ i ];
+      t2 = ( box.maxExtents.z - packet.originZ[ i ] ) * packet.invDirZ[ i ];
+      tMin = getMax( tMin, getMin( t1, t2 ) );
+      tMax = getMin( tMax, getMax( t1, t2 ) );
+
+      if( tMin <= tMax )
+         result |= ( 1 << i );
+   }
+   return result;
+}
+
+#if defined( TORQUE_CPU_X86 )
+
+static inline U32 _intersectRayPacket_SSE( const Box3F& box, const RayPacket& packet, const F32* maxT )
+{
+   const __m128 originX = _mm_loadu_ps( packet.originX );
+   const __m128 originY = _mm_loadu_ps( packet.originY );
+   const __m128 originZ = _mm_loadu_ps( packet.originZ );
+
+   __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.minExtents.x ), originX ), _mm_loadu_ps( packet.invDirX ) );
+   __m128 t2 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.maxExtents.x ), originX ), _mm_loadu_ps( packet.invDirX ) );
+   __m128 tMin = _mm_max_ps( _mm_setzero_ps(), _mm_min_ps( t1, t2 ) );
+   __m128 tMax = _mm_min_ps( _mm_loadu_ps( maxT ), _mm_max_ps( t1, t2 ) );
+
+   t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.minExtents.y ), originY ), _mm_loadu_ps( packet.invDirY ) );
+   t2 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.maxExtents.y ), originY ), _mm_loadu_ps( packet.invDirY ) );
+   tMin = _mm_max_ps( tMin, _mm_min_ps( t1, t2 ) );
+   tMax = _mm_min_ps( tMax, _mm_max_ps( t1, t2 ) );
+
+   t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.minExtents.z ), originZ ), _mm_loadu_ps( packet.invDirZ ) );
+   t2 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.maxExtents.z ), originZ ), _mm_loadu_ps( packet.invDirZ ) );
+   tMin = _mm_max_ps( tMin, _mm_min_ps( t1, t2 ) );
+   tMax = _mm_min_ps( tMax, _mm_max_ps( t1, t2 ) );
+
+   return _mm_movemask_ps( _mm_cmple_ps( tMin, tMax ) );
+}
+
+#endif
+
+void SceneAABBTree::castRayPacket( const Point3F* starts, const Point3F* ends, U32 numRays, F32* maxT, RayPacketCallback callback, void* key ) const
+{
+   AssertFatal( numRays <= RayPacketSize, "SceneAABBTree::castRayPacket - Too many rays in packet!" );
+
+   if( mRoot == InvalidProxy || !numRays )
+      return;
+
+   // Set up the packet.  Unused lanes get a negative clip
+   // value so they never hit anything.
+
+   RayPacket packet;
+   F32 packetMaxT[ RayPacketSize ];
+
+   for( U32 i = 0; i < RayPacketSize; ++ i )
+   {
+      const U32 ray = getMin( i, numRays - 1 );
+      const Point3F dir = ends[ ray ] - starts[ ray ];
+
+      packet.originX[ i ] = starts[ ray ].x;
+      packet.originY[ i ] = starts[ ray ].y;
+      packet.originZ[ i ] = starts[ ray ].z;
+      packet.invDirX[ i ] = _getSafeInverse( dir.x );
+      packet.invDirY[ i ] = _getSafeInverse( dir.y );
+      packet.invDirZ[ i ] = _getSafeInverse( dir.z );
+
+      packetMaxT[ i ] = ( i < numRays ) ? maxT[ i ] : -1.0f;
+   }
+
+#if defined( TORQUE_CPU_X86 )
+   const bool useSSE = ( Platform::SystemInfo.processor.properties & CPU_PROP_SSE );
+#endif
+
+   S32 stack[ sMaxStackDepth ];
+   U32 stackSize = 0;
+   stack[ stackSize ++ ] = mRoot;
+
+   while( stackSize > 0 )
+   {
+      const Node& node = mNodes[ stack[ -- stackSize ] ];
+
+      U32 rayMask;
+   #if defined( TORQUE_CPU_X86 )
+      if( useSSE )
+         rayMask = _intersectRayPacket_SSE( node.box, packet, packetMaxT );
+      else
+   #endif
+         rayMask = _intersectRayPacket_C( node.box, packet, packetMaxT );
+
+      if( !rayMask )
+         continue;
+
+      if( node.isLeaf() )
+         callback( node.object, rayMask, packetMaxT, key );
+      else
+      {
+         AssertFatal( stackSize + 2 <= sMaxStackDepth, "SceneAABBTree::castRayPacket - Stack overflow!" );
+         stack[ stackSize ++ ] = node.child1;
+         stack[ stackSize ++ ] = node.child2;
+      }
+   }
+
+   for( U32 i = 0; i < numRays; ++ i )
+      maxT[ i ] = packetMaxT[ i ];
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneAABBTree::validate() const
+{
+#ifdef TORQUE_DEBUG
+   if( mRoot == InvalidProxy )
+   {
+      AssertFatal( mNumLeaves == 0, "SceneAABBTree::validate - Leaves in empty tree!" );
+      return;
+   }
+
+   AssertFatal( mNodes[ mRoot ].parent == InvalidProxy, "SceneAABBTree::validate - Root has a parent!" );
+
+   U32 numLeaves = 0;
+   S32 stack[ sMaxStackDepth ];
+   U32 stackSize = 0;
+   stack[ stackSize ++ ] = mRoot;
+
+   while( stackSize > 0 )
+   {
+      const S32 nodeId = stack[ -- stackSize ];
+      const Node& node = mNodes[ nodeId ];
+
+      if( node.isLeaf() )
+      {
+         AssertFatal( node.height == 0, "SceneAABBTree::validate - Leaf with non-zero height!" );
+         AssertFatal( node.object != NULL, "SceneAABBTree::validate - Leaf without object!" );
+         numLeaves ++;
+         continue;
+      }
+
+      const Node& child1 = mNodes[ node.child1 ];
+      const Node& child2 = mNodes[ node.child2 ];
+
+      AssertFatal( child1.parent == nodeId && child2.parent == nodeId,
+         "SceneAABBTree::validate - Broken parent link!" );
+      AssertFatal( node.height == 1 + getMax( child1.height, child2.height ),
+         "SceneAABBTree::validate - Bad node height!" );
+      AssertFatal( node.box.isContained( child1.box ) && node.box.isContained( child2.box ),
+         "SceneAABBTree::validate - Node box does not contain its children!" );
+
+      stack[ stackSize ++ ] = node.child1;
+      stack[ stackSize ++ ] = node.child2;
+   }
+
+   AssertFatal( numLeaves == mNumLeaves, "SceneAABBTree::validate - Leaf count mismatch!" );
+#endif
+}
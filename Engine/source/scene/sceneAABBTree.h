@@ -0,0 +1,193 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SCENEAABBTREE_H_
+#define _SCENEAABBTREE_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class SceneObject;
+class Frustum;
+
+
+/// A dynamic bounding volume hierarchy over SceneObjects.
+///
+/// Leaves store a "fat" copy of the object's world box that is enlarged
+/// by #smFatMargin so that small movements of an object do not require
+/// the tree to be touched at all.  When an object leaves its fat box, its
+/// leaf is removed and reinserted using a surface area heuristic and the
+/// ancestors are rebalanced with AVL-style rotations.
+///
+/// Unlike the wrapping bin grid, the tree has no notion of world size, so
+/// objects far apart in the world never alias each other and large objects
+/// do not need to be special-cased.
+///
+/// The tree only hands out leaf candidates; callers must still perform
+/// exact tests against the object's real world box.
+class SceneAABBTree
+{
+   public:
+
+      /// Handle to a leaf in the tree.
+      typedef S32 ProxyId;
+
+      enum
+      {
+         /// Returned/stored for objects that are not in the tree.
+         InvalidProxy = -1,
+      };
+
+      ///
+      typedef void ( *QueryCallback )( SceneObject* object, void* key );
+
+      /// Callback for ray traversal.  Receives the candidate object and the
+      /// current clip fraction along the ray and must return the new clip
+      /// fraction; returning a smaller value shortens the remaining traversal.
+      typedef F32 ( *RayCallback )( SceneObject* object, F32 maxT, void* key );
+
+      /// Callback for packet ray traversal.  Invoked for each leaf that is hit by
+      /// at least one ray of the packet, with bit i of @a rayMask set for each
+      /// ray i hitting the leaf.  The callback must lower the entries in @a maxT
+      /// for the rays that hit the object.
+      typedef void ( *RayPacketCallback )( SceneObject* object, U32 rayMask, F32* maxT, void* key );
+
+      enum
+      {
+         /// Maximum number of rays in a packet passed to castRayPacket().
+         RayPacketSize = 4,
+      };
+
+      /// Amount by which leaf boxes are enlarged on each side.
+      static F32 smFatMargin;
+
+   protected:
+
+      struct Node
+      {
+         /// Fat box for leaves, union of children for internal nodes.
+         Box3F box;
+
+         /// Parent node when in the tree, next free node when on the free list.
+         S32 parent;
+
+         S32 child1;
+         S32 child2;
+
+         /// Height of the subtree; 0 for leaves, -1 for free nodes.
+         S32 height;
+
+         /// Object referenced by leaf nodes.
+         SceneObject* object;
+
+         bool isLeaf() const { return ( child1 == InvalidProxy ); }
+      };
+
+      ///
+      Vector< Node > mNodes;
+
+      ///
+      S32 mRoot;
+
+      /// Head of the free node list.
+      S32 mFreeList;
+
+      /// Number of leaves currently in the tree.
+      U32 mNumLeaves;
+
+      S32 _allocateNode();
+      void _freeNode( S32 nodeId );
+      void _insertLeaf( S32 leafId );
+      void _removeLeaf( S32 leafId );
+      S32 _balance( S32 nodeId );
+      void _refit( S32 nodeId );
+
+      static F32 _getSurfaceArea( const Box3F& box );
+      static Box3F _getUnion( const Box3F& a, const Box3F& b );
+
+   public:
+
+      SceneAABBTree();
+
+      /// Remove all leaves and release node storage.
+      void clear();
+
+      /// Add @a object with the given world box.
+      /// @return The proxy to use for subsequent update/remove calls.
+      ProxyId insert( SceneObject* object, const Box3F& worldBox );
+
+      /// Remove the leaf for the given proxy.
+      void remove( ProxyId proxy );
+
+      /// Update the bounds of the given proxy.
+      /// @return True if the leaf had to be reinserted, false if the new box
+      ///   still fit into the leaf's fat box.
+      bool update( ProxyId proxy, const Box3F& worldBox );
+
+      /// Return the object referenced by the given proxy.
+      SceneObject* getObject( ProxyId proxy ) const { return mNodes[ proxy ].object; }
+
+      /// Return the fat box stored for the given proxy.
+      const Box3F& getFatBox( ProxyId proxy ) const { return mNodes[ proxy ].box; }
+
+      /// Return the number of objects in the tree.
+      U32 getNumLeaves() const { return mNumLeaves; }
+
+      /// Return the height of the tree.
+      U32 getHeight() const { return ( mRoot == InvalidProxy ? 0 : mNodes[ mRoot ].height ); }
+
+      /// @name Queries
+      /// @{
+
+      /// Invoke @a callback for every leaf whose fat box overlaps @a box.
+      void findObjects( const Box3F& box, QueryCallback callback, void* key ) const;
+
+      /// Invoke @a callback for every leaf whose fat box is not culled by @a frustum.
+      void findObjects( const Frustum& frustum, QueryCallback callback, void* key ) const;
+
+      /// Traverse the leaves whose fat boxes are hit by the segment from
+      /// @a start to @a end.  Nodes further along the ray than the clip value
+      /// returned by @a callback are skipped.
+      void castRay( const Point3F& start, const Point3F& end, F32 maxT, RayCallback callback, void* key ) const;
+
+      /// Traverse the tree once for a packet of up to #RayPacketSize rays.  On x86,
+      /// the node tests for all rays of the packet are done with SSE.
+      ///
+      /// @param starts Start points of the rays.
+      /// @param ends End points of the rays.
+      /// @param numRays Number of rays in the packet.
+      /// @param maxT Per-ray clip fractions; updated by @a callback.
+      void castRayPacket( const Point3F* starts, const Point3F* ends, U32 numRays, F32* maxT, RayPacketCallback callback, void* key ) const;
+
+      /// @}
+
+      /// Verify the structure of the tree.  Debug builds only.
+      void validate() const;
+};
+
+#endif // !_SCENEAABBTREE_H_
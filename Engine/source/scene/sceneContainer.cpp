@@ -29,6 +29,7 @@
 #include "platform/profiler.h"
 #include "console/engineAPI.h"
 #include "math/util/frustum.h"
+#include "platform/threads/threadPool.h"
 
 
 // [rene, 02-Mar-11]
@@ -52,6 +53,14 @@ static SphereF sBoundingSphere;
 static Box3F sBoundingBox;
 
 
+ImplementEnumType( SceneContainerIndexType,
+   "Spatial index used by a scene container.\n\n"
+   "@ingroup Game" )
+   { SceneContainer::BinIndex,   "Bins",  "Fixed grid of bins that wraps around the world." },
+   { SceneContainer::TreeIndex,  "Tree",  "Dynamic AABB tree." },
+EndImplementEnumType;
+
+
 //=============================================================================
 //    SceneContainer::Link.
 //=============================================================================
@@ -113,6 +122,8 @@ SceneContainer::SceneContainer()
    mOverflowBin.prevInBin = NULL;
    mOverflowBin.nextInObj = NULL;
 
+   mIndexType = BinIndex;
+
    VECTOR_SET_ASSOCIATION( mRefPoolBlocks );
    VECTOR_SET_ASSOCIATION( mSearchList );
    VECTOR_SET_ASSOCIATION( mWaterAndZones );
@@ -227,6 +238,32 @@ void SceneContainer::insertIntoBins(SceneObject* obj)
 {
    AssertFatal(obj != NULL, "No object?");
    AssertFatal(obj->mBinRefHead == NULL, "Error, already have a bin chain!");
+   AssertFatal(obj->mTreeProxy == SceneAABBTree::InvalidProxy, "Error, already in the tree!");
+
+   // With the tree index, everything except global bounds objects
+   // goes into the tree.  The overflow bin takes the rest.
+   if (mIndexType == TreeIndex)
+   {
+      if (!obj->isGlobalBounds())
+      {
+         obj->mTreeProxy = mTree.insert(obj, obj->getWorldBox());
+         return;
+      }
+
+      SceneObjectRef* ref = allocateObjectRef();
+
+      ref->object    = obj;
+      ref->nextInBin = mOverflowBin.nextInBin;
+      ref->prevInBin = &mOverflowBin;
+      ref->nextInObj = NULL;
+
+      if (mOverflowBin.nextInBin)
+         mOverflowBin.nextInBin->prevInBin = ref;
+      mOverflowBin.nextInBin = ref;
+
+      obj->mBinRefHead = ref;
+      return;
+   }
 
    // The first thing we do is find which bins are covered in x and y...
    const Box3F* pWBox = &obj->getWorldBox();
@@ -359,6 +396,12 @@ void SceneContainer::removeFromBins(SceneObject* obj)
    PROFILE_START(RemoveFromBins);
    AssertFatal(obj != NULL, "No object?");
 
+   if (obj->mTreeProxy != SceneAABBTree::InvalidProxy)
+   {
+      mTree.remove(obj->mTreeProxy);
+      obj->mTreeProxy = SceneAABBTree::InvalidProxy;
+   }
+
    SceneObjectRef* chain = obj->mBinRefHead;
    obj->mBinRefHead = NULL;
 
@@ -384,13 +427,29 @@ void SceneContainer::checkBins(SceneObject* obj)
    AssertFatal(obj != NULL, "No object?");
 
    PROFILE_START(CheckBins);
-   if (obj->mBinRefHead == NULL)
+   if (obj->mBinRefHead == NULL && obj->mTreeProxy == SceneAABBTree::InvalidProxy)
    {
       insertIntoBins(obj);
       PROFILE_END();
       return;
    }
 
+   if (mIndexType == TreeIndex)
+   {
+      // Objects that changed global bounds state have to move between the
+      // tree and the overflow bin.  Everything else just refits its leaf.
+      if (obj->isGlobalBounds() != (obj->mBinRefHead != NULL))
+      {
+         removeFromBins(obj);
+         insertIntoBins(obj);
+      }
+      else if (obj->mTreeProxy != SceneAABBTree::InvalidProxy)
+         mTree.update(obj->mTreeProxy, obj->getWorldBox());
+
+      PROFILE_END();
+      return;
+   }
+
    // Otherwise, the object is already in the bins.  Let's see if it has strayed out of
    //  the bins that it's currently in...
    const Box3F* pWBox = &obj->getWorldBox();
@@ -433,6 +492,13 @@ void SceneContainer::findObjects(const Box3F& box, U32 mask, FindCallback callba
    AssertFatal( !mSearchInProgress, "SceneContainer::findObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
+   if ( mIndexType == TreeIndex )
+   {
+      _findTreeObjects( box, NULL, mask, callback, key );
+      mSearchInProgress = false;
+      return;
+   }
+
    U32 minX, maxX, minY, maxY;
    getBinRange(box.minExtents.x, box.maxExtents.x, minX, maxX);
    getBinRange(box.minExtents.y, box.maxExtents.y, minY, maxY);
@@ -511,6 +577,13 @@ void SceneContainer::findObjects( const Frustum &frustum, U32 mask, FindCallback
    AssertFatal( !mSearchInProgress, "SceneContainer::findObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
+   if ( mIndexType == TreeIndex )
+   {
+      _findTreeObjects( searchBox, &frustum, mask, callback, key );
+      mSearchInProgress = false;
+      return;
+   }
+
    U32 minX, maxX, minY, maxY;
    getBinRange(searchBox.minExtents.x, searchBox.maxExtents.x, minX, maxX);
    getBinRange(searchBox.minExtents.y, searchBox.maxExtents.y, minY, maxY);
@@ -608,6 +681,13 @@ void SceneContainer::polyhedronFindObjects(const Polyhedron& polyhedron, U32 mas
    AssertFatal( !mSearchInProgress, "SceneContainer::polyhedronFindObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
+   if ( mIndexType == TreeIndex )
+   {
+      _findTreeObjects( box, NULL, mask, callback, key );
+      mSearchInProgress = false;
+      return;
+   }
+
    U32 minX, maxX, minY, maxY;
    getBinRange(box.minExtents.x, box.maxExtents.x, minX, maxX);
    getBinRange(box.minExtents.y, box.maxExtents.y, minY, maxY);
@@ -664,6 +744,11 @@ void SceneContainer::polyhedronFindObjects(const Polyhedron& polyhedron, U32 mas
 
 //-----------------------------------------------------------------------------
 
+static void _insertIntoVectorCallback( SceneObject* object, void* key )
+{
+   reinterpret_cast< Vector< SceneObject* >* >( key )->push_back( object );
+}
+
 void SceneContainer::findObjectList( const Box3F& searchBox, U32 mask, Vector<SceneObject*> *outFound )
 {
    PROFILE_SCOPE( Container_FindObjectList_Box );
@@ -673,6 +758,13 @@ void SceneContainer::findObjectList( const Box3F& searchBox, U32 mask, Vector<Sc
 
    // TODO: Optimize for water and zones?
 
+   if ( mIndexType == TreeIndex )
+   {
+      _findTreeObjects( searchBox, NULL, mask, _insertIntoVectorCallback, outFound );
+      mSearchInProgress = false;
+      return;
+   }
+
    U32 minX, maxX, minY, maxY;
    getBinRange(searchBox.minExtents.x, searchBox.maxExtents.x, minX, maxX);
    getBinRange(searchBox.minExtents.y, searchBox.maxExtents.y, minY, maxY);
@@ -781,6 +873,68 @@ void SceneContainer::findObjects( U32 mask, FindCallback callback, void *key )
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+   /// State for tree box/frustum queries.
+   struct TreeFindInfo
+   {
+      const Box3F* box;
+      const Frustum* frustum;
+      U32 mask;
+      SceneContainer::FindCallback callback;
+      void* key;
+   };
+}
+
+static void _treeFindCallback( SceneObject* object, void* key )
+{
+   TreeFindInfo* info = reinterpret_cast< TreeFindInfo* >( key );
+
+   if ( ( object->getTypeMask() & info->mask ) == 0 ||
+        !object->isCollisionEnabled() )
+      return;
+
+   // The tree only tests the fat leaf boxes so we still
+   // need to do the exact test here.
+
+   const Box3F& worldBox = object->getWorldBox();
+   if ( !worldBox.isOverlapped( *info->box ) )
+      return;
+   if ( info->frustum && info->frustum->isCulled( worldBox ) )
+      return;
+
+   info->callback( object, info->key );
+}
+
+void SceneContainer::_findTreeObjects( const Box3F& box, const Frustum* frustum, U32 mask, FindCallback callback, void* key )
+{
+   PROFILE_SCOPE( Container_findTreeObjects );
+
+   TreeFindInfo info;
+   info.box = &box;
+   info.frustum = frustum;
+   info.mask = mask;
+   info.callback = callback;
+   info.key = key;
+
+   if ( frustum )
+      mTree.findObjects( *frustum, _treeFindCallback, &info );
+   else
+      mTree.findObjects( box, _treeFindCallback, &info );
+
+   // Global bounds objects live in the overflow bin.
+
+   for ( SceneObjectRef* chain = mOverflowBin.nextInBin; chain != NULL; chain = chain->nextInBin )
+   {
+      SceneObject* object = chain->object;
+      if ( ( object->getTypeMask() & mask ) != 0 &&
+           object->isCollisionEnabled() )
+         callback( object, key );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
 void SceneContainer::_findSpecialObjects( const Vector< SceneObject* >& vector, U32 mask, FindCallback callback, void *key )
 {
    PROFILE_SCOPE( Container_findSpecialObjects );
@@ -839,6 +993,87 @@ bool SceneContainer::castRayRendered( const Point3F& start, const Point3F& end,
 
 //-----------------------------------------------------------------------------
 
+/// Cast the ray from @a start to @a end against a single object and record the
+/// hit in @a info if it is closer than @a currentT.
+/// @return True if @a info and @a currentT were updated.
+static bool _castRayAgainstObject( SceneObject* ptr, bool rendered, const Point3F& start, const Point3F& end,
+                                   U32 mask, RayInfo* info, SceneContainer::CastRayCallback callback, F32& currentT )
+{
+   if ((ptr->getTypeMask() & mask) == 0 ||
+       ptr->isCollisionEnabled() == false)
+      return false;
+
+   if (!ptr->isGlobalBounds() && !ptr->getWorldBox().collideLine(start, end))
+      return false;
+
+   Point3F xformedStart, xformedEnd;
+   ptr->getWorldTransform().mulP(start, &xformedStart);
+   ptr->getWorldTransform().mulP(end,   &xformedEnd);
+   xformedStart.convolveInverse(ptr->getScale());
+   xformedEnd.convolveInverse(ptr->getScale());
+
+   RayInfo ri;
+   ri.generateTexCoord = info->generateTexCoord;
+   bool result = false;
+   if (!rendered)
+      result = ptr->castRay(xformedStart, xformedEnd, &ri);
+   else
+      result = ptr->castRayRendered(xformedStart, xformedEnd, &ri);
+
+   if (result && ri.t < currentT && ( !callback || callback( &ri ) ) )
+   {
+      *info = ri;
+      info->point.interpolate(start, end, info->t);
+      info->distance = (start - info->point).len();
+      currentT = ri.t;
+      return true;
+   }
+
+   return false;
+}
+
+/// Transform the normal of a hit found by _castRayAgainstObject into world space.
+static void _transformRayHitNormal( RayInfo* info )
+{
+   PlaneF fakePlane;
+   fakePlane.x = info->normal.x;
+   fakePlane.y = info->normal.y;
+   fakePlane.z = info->normal.z;
+   fakePlane.d = 0;
+
+   PlaneF result;
+   mTransformPlane(info->object->getTransform(), info->object->getScale(), fakePlane, &result);
+   info->normal = result;
+}
+
+namespace {
+
+   /// State for tree ray casts.
+   struct TreeRayInfo
+   {
+      bool rendered;
+      Point3F start;
+      Point3F end;
+      U32 mask;
+      RayInfo* info;
+      SceneContainer::CastRayCallback callback;
+      F32 currentT;
+   };
+}
+
+static F32 _treeCastRayCallback( SceneObject* ptr, F32 maxT, void* key )
+{
+   TreeRayInfo* state = reinterpret_cast< TreeRayInfo* >( key );
+
+   // Anything further along the ray than a hit can't be the closest hit.
+   if ( _castRayAgainstObject( ptr, state->rendered, state->start, state->end, state->mask, state->info, state->callback, state->currentT ) )
+      return getMin( maxT, state->currentT );
+
+   return maxT;
+}
+
+//-----------------------------------------------------------------------------
+
 // DMMNOTE: There are still some optimizations to be done here.  In particular:
 //           - After checking the overflow bin, we can potentially shorten the line
 //             that we rasterize against the grid if there is a collision with say,
@@ -930,10 +1165,27 @@ bool SceneContainer::_castRay( U32 type, const Point3F& start, const Point3F& en
 //if (normalStart.y == normalEnd.y && minY != maxY)
 //   Con::printf("Y min = %d, max = %d", minY, maxY);
 
-   // We'll optimize the case that the line is contained in one bin row or column, which
-   //  will be quite a few lines.  No sense doing more work than we have to...
+   // With the tree index, the traversal handles clipping the ray against
+   //  the closest hit found so far.  Otherwise, we'll optimize the case that the
+   //  line is contained in one bin row or column, which will be quite a few lines.
+   //  No sense doing more work than we have to...
    //
-   if ((mFabs(normalStart.x - normalEnd.x) < csmTotalBinSize && minX == maxX) ||
+   if (mIndexType == TreeIndex)
+   {
+      TreeRayInfo state;
+      state.rendered = (type == RenderedGeometry);
+      state.start = start;
+      state.end = end;
+      state.mask = mask;
+      state.info = info;
+      state.callback = callback;
+      state.currentT = currentT;
+
+      mTree.castRay(start, end, getMin(currentT, 1.0f), _treeCastRayCallback, &state);
+
+      currentT = state.currentT;
+   }
+   else if ((mFabs(normalStart.x - normalEnd.x) < csmTotalBinSize && minX == maxX) ||
        (mFabs(normalStart.y - normalEnd.y) < csmTotalBinSize && minY == maxY))
    {
       U32 count;
@@ -1106,16 +1358,7 @@ bool SceneContainer::_castRay( U32 type, const Point3F& start, const Point3F& en
    // Bump the normal into worldspace if appropriate.
    if(currentT != 2)
    {
-      PlaneF fakePlane;
-      fakePlane.x = info->normal.x;
-      fakePlane.y = info->normal.y;
-      fakePlane.z = info->normal.z;
-      fakePlane.d = 0;
-
-      PlaneF result;
-      mTransformPlane(info->object->getTransform(), info->object->getScale(), fakePlane, &result);
-      info->normal = result;
-
+      _transformRayHitNormal(info);
       return true;
    }
    else
@@ -1127,6 +1370,139 @@ bool SceneContainer::_castRay( U32 type, const Point3F& start, const Point3F& en
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+   /// State shared by all packets of a SceneContainer::castRays batch.
+   struct BatchRayInfo
+   {
+      const SceneAABBTree* tree;
+      SceneObjectRef* overflow;
+      const Point3F* starts;
+      const Point3F* ends;
+      U32 numRays;
+      U32 mask;
+      RayInfo* infos;
+      bool* hits;
+   };
+
+   /// State for a single packet of a batch.
+   struct RayPacketInfo
+   {
+      const BatchRayInfo* batch;
+      U32 firstRay;
+      F32 currentT[ SceneAABBTree::RayPacketSize ];
+   };
+}
+
+static void _treeRayPacketCallback( SceneObject* object, U32 rayMask, F32* maxT, void* key )
+{
+   RayPacketInfo* packet = reinterpret_cast< RayPacketInfo* >( key );
+   const BatchRayInfo* batch = packet->batch;
+
+   for ( U32 i = 0; i < SceneAABBTree::RayPacketSize; ++ i )
+   {
+      if ( !( rayMask & ( 1 << i ) ) )
+         continue;
+
+      const U32 ray = packet->firstRay + i;
+      if ( _castRayAgainstObject( object, false, batch->starts[ ray ], batch->ends[ ray ], batch->mask,
+                                  &batch->infos[ ray ], NULL, packet->currentT[ i ] ) )
+         maxT[ i ] = getMin( maxT[ i ], packet->currentT[ i ] );
+   }
+}
+
+static void _castRayPackets( U32 startPacket, U32 endPacket, void* key )
+{
+   const BatchRayInfo* batch = reinterpret_cast< const BatchRayInfo* >( key );
+
+   for ( U32 packetIndex = startPacket; packetIndex < endPacket; ++ packetIndex )
+   {
+      RayPacketInfo packet;
+      packet.batch = batch;
+      packet.firstRay = packetIndex * SceneAABBTree::RayPacketSize;
+
+      const U32 numRays = getMin( batch->numRays - packet.firstRay, U32( SceneAABBTree::RayPacketSize ) );
+
+      // Global bounds objects in the overflow bin are hit by everything.
+
+      for ( U32 i = 0; i < numRays; ++ i )
+      {
+         const U32 ray = packet.firstRay + i;
+         packet.currentT[ i ] = 2.0f;
+
+         for ( SceneObjectRef* chain = batch->overflow; chain != NULL; chain = chain->nextInBin )
+            _castRayAgainstObject( chain->object, false, batch->starts[ ray ], batch->ends[ ray ], batch->mask,
+                                   &batch->infos[ ray ], NULL, packet.currentT[ i ] );
+      }
+
+      F32 maxT[ SceneAABBTree::RayPacketSize ];
+      for ( U32 i = 0; i < numRays; ++ i )
+         maxT[ i ] = getMin( packet.currentT[ i ], 1.0f );
+
+      batch->tree->castRayPacket( &batch->starts[ packet.firstRay ], &batch->ends[ packet.firstRay ],
+                                  numRays, maxT, _treeRayPacketCallback, &packet );
+
+      for ( U32 i = 0; i < numRays; ++ i )
+      {
+         const U32 ray = packet.firstRay + i;
+         batch->hits[ ray ] = ( packet.currentT[ i ] != 2.0f );
+         if ( batch->hits[ ray ] )
+            _transformRayHitNormal( &batch->infos[ ray ] );
+      }
+   }
+}
+
+U32 SceneContainer::castRays( U32 numRays, const Point3F* starts, const Point3F* ends, U32 mask, RayInfo* outInfos, bool* outHits, bool useThreadPool )
+{
+   PROFILE_SCOPE( SceneContainer_CastRays );
+
+   U32 numHits = 0;
+
+   // The bin grid relies on the per-object sequence keys so cast the
+   // rays one by one.
+
+   if ( mIndexType != TreeIndex )
+   {
+      for ( U32 i = 0; i < numRays; ++ i )
+      {
+         outHits[ i ] = castRay( starts[ i ], ends[ i ], mask, &outInfos[ i ] );
+         if ( outHits[ i ] )
+            numHits ++;
+      }
+      return numHits;
+   }
+
+   AssertFatal( !mSearchInProgress, "SceneContainer::castRays - Container queries are not re-entrant" );
+   mSearchInProgress = true;
+
+   BatchRayInfo batch;
+   batch.tree = &mTree;
+   batch.overflow = mOverflowBin.nextInBin;
+   batch.starts = starts;
+   batch.ends = ends;
+   batch.numRays = numRays;
+   batch.mask = mask;
+   batch.infos = outInfos;
+   batch.hits = outHits;
+
+   const U32 numPackets = ( numRays + SceneAABBTree::RayPacketSize - 1 ) / SceneAABBTree::RayPacketSize;
+
+   if ( useThreadPool )
+      ThreadPool::GLOBAL().parallelFor( numPackets, 16, _castRayPackets, &batch );
+   else
+      _castRayPackets( 0, numPackets, &batch );
+
+   mSearchInProgress = false;
+
+   for ( U32 i = 0; i < numRays; ++ i )
+      if ( outHits[ i ] )
+         numHits ++;
+
+   return numHits;
+}
+
+//-----------------------------------------------------------------------------
+
 // collide with the objects projected object box
 bool SceneContainer::collideBox(const Point3F &start, const Point3F &end, U32 mask, RayInfo * info)
 {
@@ -1186,6 +1562,27 @@ bool SceneContainer::buildPolyList(PolyListContext context, const Box3F &box, U3
 
 //-----------------------------------------------------------------------------
 
+void SceneContainer::setIndexType( IndexType type )
+{
+   if ( type == mIndexType )
+      return;
+
+   AssertFatal( !mSearchInProgress, "SceneContainer::setIndexType - Cannot switch index during a query" );
+
+   PROFILE_SCOPE( SceneContainer_setIndexType );
+
+   for ( Link* itr = mStart.next; itr != &mEnd; itr = itr->next )
+      removeFromBins( static_cast< SceneObject* >( itr ) );
+
+   mIndexType = type;
+   mTree.clear();
+
+   for ( Link* itr = mStart.next; itr != &mEnd; itr = itr->next )
+      insertIntoBins( static_cast< SceneObject* >( itr ) );
+}
+
+//-----------------------------------------------------------------------------
+
 void SceneContainer::cleanupSearchVectors()
 {
    for (U32 i = 0; i < mSearchList.size(); i++)
@@ -1647,4 +2044,22 @@ DefineEngineFunction( containerRayCast, const char*,
    return(returnBuffer);
 }
 
+//-----------------------------------------------------------------------------
+
+DefineEngineFunction( containerSetIndexType, void, ( SceneContainerIndexType type, bool useClientContainer ), ( false ),
+   "@brief Switch the spatial index used to accelerate container queries.\n\n"
+
+   "All objects in the container are rebinned into the new index.  The tree index avoids the "
+   "aliasing of distant objects into the same bins that happens with the bin grid on large worlds.\n"
+
+   "@param type Either \"Bins\" or \"Tree\".\n"
+   "@param useClientContainer Optionally indicates the client container should be switched.\n"
+
+   "@ingroup Game")
+{
+   SceneContainer* pContainer = useClientContainer ? &gClientContainer : &gServerContainer;
+
+   pContainer->setIndexType( type );
+}
+
 ConsoleFunctionGroupEnd( Containers );
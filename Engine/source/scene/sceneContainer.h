@@ -43,6 +43,10 @@
 #include "console/simObject.h"
 #endif
 
+#ifndef _SCENEAABBTREE_H_
+#include "scene/sceneAABBTree.h"
+#endif
+
 
 /// @file
 /// SceneObject database.
@@ -133,7 +137,10 @@ class SimpleQueryList
 
 /// Database for SceneObjects.
 ///
-/// ScenceContainer implements a grid-based spatial subdivision for the contents of a scene.
+/// ScenceContainer implements a spatial subdivision for the contents of a scene.  By
+/// default, this is a grid of bins that wraps around the world.  Alternatively, objects
+/// can be kept in a dynamic AABB tree (see SceneAABBTree) which does not suffer from
+/// aliasing on large worlds.  The query API is the same for both.
 class SceneContainer
 {
       enum CastRayType
@@ -144,6 +151,16 @@ class SceneContainer
 
    public:
 
+      /// Spatial index used to accelerate container queries.
+      enum IndexType
+      {
+         /// Fixed grid of bins wrapping around the world plus an overflow bin.
+         BinIndex,
+
+         /// Dynamic AABB tree.  Objects with global bounds go to the overflow bin.
+         TreeIndex,
+      };
+
       struct Link
       {
          Link* next;
@@ -180,6 +197,12 @@ class SceneContainer
       SceneObjectRef* mBinArray;
       SceneObjectRef mOverflowBin;
 
+      /// Spatial index currently in use.
+      IndexType mIndexType;
+
+      /// Object tree used when #mIndexType is TreeIndex.
+      SceneAABBTree mTree;
+
       /// A vector that contains just the water and physical zone
       /// object types which is used to optimize searches.
       Vector< SceneObject* > mWaterAndZones;
@@ -203,6 +226,21 @@ class SceneContainer
       /// Return a vector containing all terrain objects in this container.
       const Vector< SceneObject* >& getTerrains() const { return mTerrains; }
 
+      /// @name Spatial index
+      /// @{
+
+      /// Return the spatial index currently used by the container.
+      IndexType getIndexType() const { return mIndexType; }
+
+      /// Switch to a different spatial index.  All objects in the container
+      /// are rebinned into the new index.
+      void setIndexType( IndexType type );
+
+      /// Return the object tree.  Only populated when using TreeIndex.
+      const SceneAABBTree& getTree() const { return mTree; }
+
+      /// @}
+
       /// @name Basic database operations
       /// @{
 
@@ -245,6 +283,25 @@ class SceneContainer
       /// Test against rendered geometry -- slow.
       bool castRayRendered( const Point3F &start, const Point3F &end, U32 mask, RayInfo* info, CastRayCallback callback = NULL );
 
+      /// Test a batch of independent rays against collision geometry.
+      ///
+      /// With the tree index, rays are grouped into packets of four that share a
+      /// single traversal of the object tree.  With the bin grid, the rays are
+      /// cast one by one.
+      ///
+      /// @param numRays Number of rays in the batch.
+      /// @param starts Start points of the rays.
+      /// @param ends End points of the rays.
+      /// @param mask Object type mask (@see SimObjectTypes).
+      /// @param outInfos Receives the closest hit for each ray.  Only valid where
+      ///   the corresponding entry in @a outHits is true.
+      /// @param outHits Receives whether each ray hit anything.
+      /// @param useThreadPool If true, packets are distributed over the global thread
+      ///   pool.  Only use this if the castRay() implementations of all objects matching
+      ///   @a mask are thread-safe.  Must be called on the main thread.
+      /// @return The number of rays that hit something.
+      U32 castRays( U32 numRays, const Point3F* starts, const Point3F* ends, U32 mask, RayInfo* outInfos, bool* outHits, bool useThreadPool = false );
+
       bool collideBox(const Point3F &start, const Point3F &end, U32 mask, RayInfo* info);
 
       /// @}
@@ -303,6 +360,9 @@ class SceneContainer
       void _findSpecialObjects( const Vector< SceneObject* >& vector, U32 mask, FindCallback, void *key = NULL );
       void _findSpecialObjects( const Vector< SceneObject* >& vector, const Box3F &box, U32 mask, FindCallback callback, void *key = NULL );   
 
+      /// Run a box or frustum query against #mTree and the overflow bin.
+      void _findTreeObjects( const Box3F& box, const Frustum* frustum, U32 mask, FindCallback callback, void* key );
+
       static void getBinRange( const F32 min, const F32 max, U32& minBin, U32& maxBin );
 };
 
@@ -311,6 +371,9 @@ class SceneContainer
 extern SceneContainer gServerContainer;
 extern SceneContainer gClientContainer;
 
+typedef SceneContainer::IndexType SceneContainerIndexType;
+DefineEnumType( SceneContainerIndexType );
+
 //-----------------------------------------------------------------------------
 
 inline void SceneContainer::freeObjectRef(SceneObjectRef* trash)
@@ -29,10 +29,13 @@
 #include "scene/zones/sceneRootZone.h"
 #include "scene/zones/sceneZoneSpace.h"
 #include "lighting/lightManager.h"
+#include "lighting/lightProbeGrid.h"
 #include "renderInstance/renderPassManager.h"
+#include "renderInstance/retainedRenderInstList.h"
 #include "gfx/gfxDevice.h"
 #include "gfx/gfxDrawUtil.h"
 #include "gfx/gfxDebugEvent.h"
+#include "core/frameAllocator.h"
 #include "console/engineAPI.h"
 #include "sim/netConnection.h"
 #include "T3D/gameBase/gameConnection.h"
@@ -69,6 +72,36 @@ MODULE_BEGIN( Scene )
          "If true, zone culling will be disabled and the scene contents will only be culled against the root frustum.\n\n"
          "@ingroup Rendering\n" );
 
+      Con::addVariable( "$Scene::parallelCulling", TypeBool, &SceneCullingState::smParallelCulling,
+         "If true, large object lists are culled in parallel on the global thread pool.  The result "
+         "is identical to culling serially.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::minParallelCullObjects", TypeS32, &SceneCullingState::smMinParallelCullObjects,
+         "Minimum number of objects in a culling pass for the tests to be distributed across threads.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::retainRenderInsts", TypeBool, &RetainedRenderInstList::smEnabled,
+         "If true, static shapes reuse the render instances from previous frames as long as their "
+         "transform, detail level and materials don't change.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::clusteredLights", TypeBool, &LightClusterGrid::smEnabled,
+         "If true, the lights of each view are sorted into a grid of view space clusters and objects "
+         "inside the view only score the lights of the clusters they touch.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::zoneCullLights", TypeBool, &LightManager::smCullLightsByZone,
+         "If true, the zones are traversed before the lights are registered and lights whose bounds are "
+         "culled in every zone they overlap aren't registered.  The number of lights skipped is stored in "
+         "$lightMetrics::zoneCulledLights.\n\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable( "$Scene::lightProbes", TypeBool, &LightProbeGrid::smEnabled,
+         "If true, objects inside of a baked LightProbeVolume get their ambient color from the probes "
+         "around them instead of the scene ambient color.\n\n"
+         "@ingroup Rendering\n" );
+
       Con::addVariable( "$Scene::renderBoundingBoxes", TypeBool, &SceneManager::smRenderBoundingBoxes,
          "If true, the bounding boxes of objects will be displayed.\n\n"
          "@ingroup Rendering" );
@@ -115,7 +148,8 @@ SceneManager::SceneManager( bool isClient )
      mVisibleDistance( 500.f ),
      mNearClip( 0.1f ),
      mAmbientLightColor( ColorF( 0.1f, 0.1f, 0.1f, 1.0f ) ),
-     mZoneManager( NULL )
+     mZoneManager( NULL ),
+     mStaticChangeCount( 0 )
 {
    VECTOR_SET_ASSOCIATION( mBatchQueryList );
 
@@ -190,8 +224,21 @@ void SceneManager::renderScene( SceneRenderState* renderState, U32 objectMask, S
 
    // Get the lights for rendering the scene.
 
+   // Traverse the zones before registering the lights so that lights
+   // behind closed portals can be skipped.  Side by side stereo renders
+   // each eye with its own state, so its lights aren't zone culled.
+
+   const SceneCullingState* zoneCullingState = NULL;
+   if( LightManager::smCullLightsByZone &&
+       GFX->getCurrentRenderStyle() != GFXDevice::RS_StereoSideBySide )
+   {
+      Box3F queryBox;
+      _traverseZones( renderState, baseObject, baseZone, &queryBox );
+      zoneCullingState = &renderState->getCullingState();
+   }
+
    PROFILE_START( SceneGraph_registerLights );
-      LIGHTMGR->registerGlobalLights( &renderState->getCullingFrustum(), false );
+      LIGHTMGR->registerGlobalLights( &renderState->getCullingFrustum(), false, zoneCullingState );
    PROFILE_END();
 
    // If its a diffuse pass, update the current ambient light level.
@@ -366,8 +413,89 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
 
    // Update the zoning state and traverse zones.
 
-   if( getZoneManager() )
+   Box3F queryBox;
+   if( !_traverseZones( state, baseObject, baseZone, &queryBox ) )
+      return;
+
+   PROFILE_START( Scene_cullObjects );
+
+   //TODO: We should split the codepaths here based on whether the outdoor zone has visible space.
+   //    If it has, we should use the container query-based path.
+   //    If it hasn't, we should fill the object list directly from the zone lists which will usually
+   //       include way fewer objects.
+   
+   // Gather all objects that intersect the scene render box.
+
+   mBatchQueryList.clear();
+   getContainer()->findObjectList( queryBox, objectMask, &mBatchQueryList );
+
+   // Cull the list.
+
+   U32 numRenderObjects = state->getCullingState().cullObjects(
+      mBatchQueryList.address(),
+      mBatchQueryList.size(),
+      !state->isDiffusePass() ? SceneCullingState::CullEditorOverrides : 0 // Keep forced editor stuff out of non-diffuse passes.
+   );
+
+   mBatchQueryList.setSize( numRenderObjects );
+   _addControlPlayer( mBatchQueryList );
+   numRenderObjects = mBatchQueryList.size();
+
+   PROFILE_END();
+
+   // Render the remaining objects.
+
+   PROFILE_START( Scene_renderObjects );
+   state->renderObjects( mBatchQueryList.address(), numRenderObjects );
+   PROFILE_END();
+
+   // Render bounding boxes, if enabled.
+
+   if( smRenderBoundingBoxes && state->isDiffusePass() )
    {
+      GFXDEBUGEVENT_SCOPE( Scene_renderBoundingBoxes, ColorI::WHITE );
+
+      GameConnection* connection = GameConnection::getConnectionToServer();
+      GameBase* cameraObject = 0;
+      if( connection )
+         cameraObject = connection->getCameraObject();
+
+      GFXStateBlockDesc desc;
+      desc.setFillModeWireframe();
+      desc.setZReadWrite( true, false );
+
+      for( U32 i = 0; i < numRenderObjects; ++ i )
+      {
+         SceneObject* object = mBatchQueryList[ i ];
+
+         // Skip global bounds object.
+         if( object->isGlobalBounds() )
+            continue;
+
+         // Skip camera object as we're viewing the scene from it.
+         if( object == cameraObject )
+            continue;
+
+         const Box3F& worldBox = object->getWorldBox();
+         GFX->getDrawUtil()->drawObjectBox(
+            desc,
+            Point3F( worldBox.len_x(), worldBox.len_y(), worldBox.len_z() ),
+            worldBox.getCenter(),
+            MatrixF::Identity,
+            ColorI::WHITE
+         );
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneManager::_traverseZones( SceneRenderState* state, SceneZoneSpace* baseObject, U32 baseZone, Box3F* outQueryBox )
+{
+   if( getZoneManager() && !state->areZonesTraversed() )
+   {
+      state->setZonesTraversed();
+
       // Update.
 
       getZoneManager()->updateZoningState();
@@ -382,7 +510,7 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
          if( !baseObject )
          {
             getZoneManager()->findZone( state->getCameraPosition(), baseObject, baseZone );
-            AssertFatal( baseObject != NULL, "SceneManager::_renderScene - findZone() did not return an object" );
+            AssertFatal( baseObject != NULL, "SceneManager::_traverseZones - findZone() did not return an object" );
          }
 
          // Traverse zones starting in base object.
@@ -412,36 +540,23 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
       // (remember that the camera isn't where visibility starts, it's the near
       // distance).
 
-      return;
+      return false;
    }
 
-   Box3F queryBox = state->getCullingFrustum().getBounds();
+   *outQueryBox = state->getCullingFrustum().getBounds();
    if( !gEditingMission )
    {
-      queryBox.minExtents.setMax( state->getRenderArea().minExtents );
-      queryBox.maxExtents.setMin( state->getRenderArea().maxExtents );
+      outQueryBox->minExtents.setMax( state->getRenderArea().minExtents );
+      outQueryBox->maxExtents.setMin( state->getRenderArea().maxExtents );
    }
 
-   PROFILE_START( Scene_cullObjects );
-
-   //TODO: We should split the codepaths here based on whether the outdoor zone has visible space.
-   //    If it has, we should use the container query-based path.
-   //    If it hasn't, we should fill the object list directly from the zone lists which will usually
-   //       include way fewer objects.
-   
-   // Gather all objects that intersect the scene render box.
-
-   mBatchQueryList.clear();
-   getContainer()->findObjectList( queryBox, objectMask, &mBatchQueryList );
-
-   // Cull the list.
+   return true;
+}
 
-   U32 numRenderObjects = state->getCullingState().cullObjects(
-      mBatchQueryList.address(),
-      mBatchQueryList.size(),
-      !state->isDiffusePass() ? SceneCullingState::CullEditorOverrides : 0 // Keep forced editor stuff out of non-diffuse passes.
-   );
+//-----------------------------------------------------------------------------
 
+void SceneManager::_addControlPlayer( Vector< SceneObject* >& objects )
+{
    //HACK: If the control object is a Player and it is not in the render list, force
    // it into it.  This really should be solved by collision bounds being separate from
    // object bounds; only because the Player class is using bounds not encompassing
@@ -450,64 +565,119 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
    // is the power of proliferation of things done wrong.
 
    GameConnection* connection = GameConnection::getConnectionToServer();
-   if( connection )
+   if( !connection )
+      return;
+
+   Player* player = dynamic_cast< Player* >( connection->getControlObject() );
+   if( player && !objects.contains( player ) )
+      objects.push_back( player );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneManager::gatherSceneObjects( SceneRenderState* const* states, const U32* objectMasks, U32 numStates, Vector< SceneObject* >* outObjects )
+{
+   AssertFatal( this == gClientSceneGraph, "SceneManager::gatherSceneObjects - Only the client scenegraph can support this call!" );
+
+   PROFILE_SCOPE( SceneManager_gatherSceneObjects );
+
+   FrameTemp< Box3F > queryBoxes( numStates );
+   FrameTemp< U32 > queryMasks( numStates );
+
+   // Traverse the zones for each state and merge the
+   // query boxes and type masks for the container query.
+
+   Box3F unionBox = Box3F::Invalid;
+   U32 unionMask = 0;
+
+   for( U32 i = 0; i < numStates; ++ i )
    {
-      Player* player = dynamic_cast< Player* >( connection->getControlObject() );
-      if( player )
+      SceneRenderState* state = states[ i ];
+
+      outObjects[ i ].clear();
+
+      queryMasks[ i ] = objectMasks[ i ];
+      if( gEditingMission && state->isDiffusePass() )
+         queryMasks[ i ] = EDITOR_RENDER_TYPEMASK;
+
+      // The states share the transforms of their render pass.
+      state->assignSharedTransforms();
+
+      if( !queryMasks[ i ] || !_traverseZones( state, NULL, 0, &queryBoxes[ i ] ) )
       {
-         mBatchQueryList.setSize( numRenderObjects );
-         if( !mBatchQueryList.contains( player ) )
-         {
-            mBatchQueryList.push_back( player );
-            numRenderObjects ++;
-         }
+         queryMasks[ i ] = 0;
+         continue;
       }
+
+      unionBox.intersect( queryBoxes[ i ] );
+      unionMask |= queryMasks[ i ];
    }
 
-   PROFILE_END();
+   if( !unionMask )
+      return;
 
-   // Render the remaining objects.
+   PROFILE_START( Scene_cullObjects );
 
-   PROFILE_START( Scene_renderObjects );
-   state->renderObjects( mBatchQueryList.address(), numRenderObjects );
-   PROFILE_END();
+   // Gather all objects that intersect any of the boxes
+   // and hand out the ones each state would have found
+   // by its own query.
 
-   // Render bounding boxes, if enabled.
+   mBatchQueryList.clear();
+   getContainer()->findObjectList( unionBox, unionMask, &mBatchQueryList );
 
-   if( smRenderBoundingBoxes && state->isDiffusePass() )
+   FrameTemp< SceneCullingState::ObjectList > lists( numStates );
+
+   for( U32 i = 0; i < numStates; ++ i )
    {
-      GFXDEBUGEVENT_SCOPE( Scene_renderBoundingBoxes, ColorI::WHITE );
+      Vector< SceneObject* >& objects = outObjects[ i ];
 
-      GameBase* cameraObject = 0;
-      if( connection )
-         cameraObject = connection->getCameraObject();
+      if( queryMasks[ i ] )
+      {
+         for( U32 n = 0; n < mBatchQueryList.size(); ++ n )
+         {
+            SceneObject* object = mBatchQueryList[ n ];
+            if( ( object->getTypeMask() & queryMasks[ i ] ) &&
+                object->getWorldBox().isOverlapped( queryBoxes[ i ] ) )
+               objects.push_back( object );
+         }
+      }
 
-      GFXStateBlockDesc desc;
-      desc.setFillModeWireframe();
-      desc.setZReadWrite( true, false );
+      lists[ i ].state = &states[ i ]->getCullingState();
+      lists[ i ].objects = objects.address();
+      lists[ i ].numObjects = objects.size();
+      lists[ i ].cullOptions = !states[ i ]->isDiffusePass() ? SceneCullingState::CullEditorOverrides : 0;
+   }
 
-      for( U32 i = 0; i < numRenderObjects; ++ i )
-      {
-         SceneObject* object = mBatchQueryList[ i ];
+   // Cull the lists.
 
-         // Skip global bounds object.
-         if( object->isGlobalBounds() )
-            continue;
+   SceneCullingState::cullObjectLists( lists, numStates );
 
-         // Skip camera object as we're viewing the scene from it.
-         if( object == cameraObject )
-            continue;
+   for( U32 i = 0; i < numStates; ++ i )
+   {
+      outObjects[ i ].setSize( lists[ i ].numObjects );
 
-         const Box3F& worldBox = object->getWorldBox();
-         GFX->getDrawUtil()->drawObjectBox(
-            desc,
-            Point3F( worldBox.len_x(), worldBox.len_y(), worldBox.len_z() ),
-            worldBox.getCenter(),
-            MatrixF::Identity,
-            ColorI::WHITE
-         );
-      }
+      if( queryMasks[ i ] )
+         _addControlPlayer( outObjects[ i ] );
    }
+
+   PROFILE_END();
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneManager::renderGatheredObjects( SceneRenderState* state, Vector< SceneObject* >& objects )
+{
+   mCurrentRenderState = state;
+
+   // Other states may have been created or used for the
+   // render pass since this one so reassign our transforms.
+   state->assignSharedTransforms();
+
+   PROFILE_START( Scene_renderObjects );
+   state->renderObjects( objects.address(), objects.size() );
+   PROFILE_END();
+
+   mCurrentRenderState = NULL;
 }
 
 //-----------------------------------------------------------------------------
@@ -592,6 +762,9 @@ bool SceneManager::addObjectToScene( SceneObject* object )
 
       getContainer()->addObject( object );
 
+      if( object->isStaticShadowCaster() )
+         notifyStaticGeometryChanged( object->getWorldBox() );
+
       // Register the object with the zone manager.
 
       if( getZoneManager() )
@@ -617,6 +790,9 @@ void SceneManager::removeObjectFromScene( SceneObject* obj )
 
    getContainer()->removeObject( obj );
 
+   if( obj->isStaticShadowCaster() )
+      notifyStaticGeometryChanged( obj->getWorldBox() );
+
    // Remove the object from the zoning system.
 
    if( getZoneManager() )
@@ -644,6 +820,29 @@ void SceneManager::notifyObjectDirty( SceneObject* object )
 
 //-----------------------------------------------------------------------------
 
+void SceneManager::notifyStaticGeometryChanged( const Box3F& area )
+{
+   mStaticChanges[ mStaticChangeCount % StaticChangeLogSize ] = area;
+   mStaticChangeCount ++;
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneManager::hasStaticChangesSince( U32 sinceCount, const Frustum& frustum ) const
+{
+   const U32 numChanges = mStaticChangeCount - sinceCount;
+   if( numChanges > StaticChangeLogSize )
+      return true;
+
+   for( U32 i = sinceCount; i != mStaticChangeCount; ++ i )
+      if( !frustum.isCulled( mStaticChanges[ i % StaticChangeLogSize ] ) )
+         return true;
+
+   return false;
+}
+
+//-----------------------------------------------------------------------------
+
 void SceneManager::setDisplayTargetResolution( const Point2I &size )
 {
    mDisplayTargetResolution = size;
@@ -67,6 +67,7 @@ class SceneCameraState;
 class SceneZoneSpace;
 class NetConnection;
 class RenderPassManager;
+class Frustum;
 
 
 /// The type of scene pass.
@@ -117,6 +118,13 @@ class SceneManager
       /// If true, render the AABBs of objects for debugging.
       static bool smRenderBoundingBoxes;
 
+      enum
+      {
+         /// Number of static geometry changes kept in the log.
+         /// @see hasStaticChangesSince
+         StaticChangeLogSize = 64,
+      };
+
    protected:
 
       /// Whether this is the client-side scene.
@@ -189,11 +197,32 @@ class SceneManager
                            SceneZoneSpace* baseObject = NULL,
                            U32 baseZone = 0 );
 
+      /// Traverse the zones for the given state and compute the box to
+      /// query the container with.
+      ///
+      /// @return False if nothing can be visible in the state.
+      bool _traverseZones( SceneRenderState* state, SceneZoneSpace* baseObject, U32 baseZone, Box3F* outQueryBox );
+
+      /// Add the control object to the culled object list if it is a Player
+      /// and isn't in the list already.
+      void _addControlPlayer( Vector< SceneObject* >& objects );
+
       /// Callback for the container query.
       static void _batchObjectCallback( SceneObject* object, void* key );
 
       /// @}
 
+      /// @name Static Geometry Changes
+      /// @{
+
+      /// Ring buffer with the areas of the latest static geometry changes.
+      Box3F mStaticChanges[ StaticChangeLogSize ];
+
+      /// Total number of static geometry changes in the scene.
+      U32 mStaticChangeCount;
+
+      /// @}
+
    public:
 
       SceneManager( bool isClient );
@@ -222,6 +251,27 @@ class SceneManager
 
       /// @}
 
+      /// @name Static Geometry Changes
+      ///
+      /// Static shadow casters which are added, removed or moved are logged so
+      /// that anything rendered from them and cached, like the static layers of
+      /// shadow maps, can be invalidated.
+      ///
+      /// @{
+
+      /// Log a change to the static geometry in the given world space area.
+      void notifyStaticGeometryChanged( const Box3F& area );
+
+      /// Return the number of static geometry changes logged so far.
+      U32 getStaticChangeCount() const { return mStaticChangeCount; }
+
+      /// Return true if any of the static geometry changes logged after the
+      /// first @a sinceCount changes touched @a frustum.  Also returns true if
+      /// those changes have already dropped out of the log.
+      bool hasStaticChangesSince( U32 sinceCount, const Frustum& frustum ) const;
+
+      /// @}
+
       /// @name Rendering
       /// @{
 
@@ -242,6 +292,30 @@ class SceneManager
       /// Render the scene with a custom rendering pass and no lighting set up.
       void renderSceneNoLights( SceneRenderState *state, U32 objectMask = DEFAULT_RENDER_TYPEMASK, SceneZoneSpace* baseObject = NULL, U32 baseZone = 0 );
 
+      /// Find the objects to render for several render states at once.
+      ///
+      /// This is meant for passes which render the scene from several
+      /// cameras in a row, like the splits of a shadow map.  The zones are
+      /// traversed for each state, then a single container query is run over
+      /// the union of the traversed areas and the result is culled against all
+      /// of the states together on the thread pool.
+      ///
+      /// @param states The render states to find the objects for.
+      /// @param objectMasks The object type mask for each of the states.
+      /// @param numStates Number of states in @a states.
+      /// @param outObjects Array of @a numStates lists which receive the objects
+      ///   to render for each state.
+      ///
+      /// @see renderGatheredObjects
+      void gatherSceneObjects(   SceneRenderState* const* states,
+                                 const U32* objectMasks,
+                                 U32 numStates,
+                                 Vector< SceneObject* >* outObjects );
+
+      /// Render the objects found by gatherSceneObjects() for @a state with
+      /// no lighting set up.
+      void renderGatheredObjects( SceneRenderState* state, Vector< SceneObject* >& objects );
+
       /// Returns the currently active scene state or NULL if no state is currently active.
       SceneRenderState* getCurrentRenderState() const { return mCurrentRenderState; }
 
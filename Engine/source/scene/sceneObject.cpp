@@ -127,6 +127,7 @@ SceneObject::SceneObject()
    mBinMaxX = 0xFFFFFFFF;
    mBinMinY = 0xFFFFFFFF;
    mBinMaxY = 0xFFFFFFFF;
+   mTreeProxy = SceneAABBTree::InvalidProxy;
    mLightPlugin = NULL;
 
    mMount.object = NULL;
@@ -146,7 +147,7 @@ SceneObject::SceneObject()
 
 SceneObject::~SceneObject()
 {
-   AssertFatal( mZoneRefHead == NULL && mBinRefHead == NULL,
+   AssertFatal( mZoneRefHead == NULL && mBinRefHead == NULL && mTreeProxy == SceneAABBTree::InvalidProxy,
       "SceneObject::~SceneObject - Object still linked in reference lists!");
    AssertFatal( !mSceneObjectLinks,
       "SceneObject::~SceneObject() - object is still linked to SceneTrackers" );
@@ -384,6 +385,13 @@ void SceneObject::setTransform( const MatrixF& mat )
 
    PROFILE_SCOPE( SceneObject_setTransform );
 
+   // Static shadow casters moving invalidate what was cached from them,
+   // so remember where we were to tell the scene about the change.
+
+   const bool isStaticGeometry = ( mSceneManager != NULL && isStaticShadowCaster() );
+   const Box3F oldWorldBox = mWorldBox;
+   const bool isNewTransform = isStaticGeometry && dMemcmp( ( const F32* ) mat, ( const F32* ) mObjToWorld, sizeof( MatrixF ) ) != 0;
+
    // Update the transforms.
 
    mObjToWorld = mWorldToObj = mat;
@@ -398,6 +406,15 @@ void SceneObject::setTransform( const MatrixF& mat )
    if( mSceneManager != NULL )
       mSceneManager->notifyObjectDirty( this );
 
+   if( isStaticGeometry &&
+       ( isNewTransform ||
+         oldWorldBox.minExtents != mWorldBox.minExtents ||
+         oldWorldBox.maxExtents != mWorldBox.maxExtents ) )
+   {
+      mSceneManager->notifyStaticGeometryChanged( oldWorldBox );
+      mSceneManager->notifyStaticGeometryChanged( mWorldBox );
+   }
+
    setRenderTransform( mat );
 }
 
@@ -695,6 +712,8 @@ bool SceneObject::isRenderEnabled() const
 
 void SceneObject::setRenderEnabled( bool value )
 {
+   _notifyRenderEnabledChange( value );
+
    if( value )
       mObjectFlags.set( RenderEnabledFlag );
    else
@@ -705,6 +724,19 @@ void SceneObject::setRenderEnabled( bool value )
 
 //-----------------------------------------------------------------------------
 
+void SceneObject::_notifyRenderEnabledChange( bool value )
+{
+   // Showing or hiding a static shadow caster changes the shadows
+   // which were cached from it.
+
+   if(   mSceneManager != NULL &&
+         isStaticShadowCaster() &&
+         mObjectFlags.test( RenderEnabledFlag ) != value )
+      mSceneManager->notifyStaticGeometryChanged( mWorldBox );
+}
+
+//-----------------------------------------------------------------------------
+
 const char* SceneObject::_getRenderEnabled( void* object, const char* data )
 {
    SceneObject* obj = reinterpret_cast< SceneObject* >( object );
@@ -809,7 +841,11 @@ void SceneObject::unpackUpdate( NetConnection* conn, BitStream* stream )
    
    // FlagMask
    if ( stream->readFlag() )      
-      mObjectFlags = stream->readRangedU32( 0, getObjectFlagMax() );
+   {
+      const U32 flags = stream->readRangedU32( 0, getObjectFlagMax() );
+      _notifyRenderEnabledChange( ( flags & RenderEnabledFlag ) != 0 );
+      mObjectFlags = flags;
+   }
 
    // MountedMask
    if ( stream->readFlag() ) 
@@ -345,6 +345,9 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       U32 mBinMinY;
       U32 mBinMaxY;
 
+      /// Leaf in the container's object tree or SceneAABBTree::InvalidProxy.
+      S32 mTreeProxy;
+
       /// Returns the container sequence key.
       U32 getContainerSeqKey() const { return mContainerSeqKey; }
 
@@ -404,6 +407,16 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       /// Set whether the object gets rendered.
       void setRenderEnabled( bool value );
 
+      /// Return true if the shadow this object casts only changes when the
+      /// object moves, is added or removed, or is shown or hidden.
+      ///
+      /// Shadow maps keep such casters in a cached layer which is only
+      /// rendered again when the scene reports a static geometry change
+      /// in its frustum, so an object must only return true here if it
+      /// does not animate or deform and it reports any other change to
+      /// its shape with SceneManager::notifyStaticGeometryChanged().
+      virtual bool isStaticShadowCaster() const { return false; }
+
       /// Return true if this object can be selected in the editor.
       bool isSelectionEnabled() const;
 
@@ -754,6 +767,10 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       /// forced to stay in scope.
       bool mIsScopeAlways;
 
+      /// Tell the scene about a change of the render enabled flag to
+      /// @a value if it changes the shadows cached from this object.
+      void _notifyRenderEnabledChange( bool value );
+
       /// @name Protected field getters/setters
       /// @{
 
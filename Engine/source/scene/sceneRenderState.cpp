@@ -27,6 +27,8 @@
 #include "math/util/matrixSet.h"
 
 
+U32 SceneRenderState::smNextId = 1;
+
 
 //-----------------------------------------------------------------------------
 
@@ -44,10 +46,17 @@ SceneRenderState::SceneRenderState( SceneManager* sceneManager,
       mUsePostEffects( usePostEffects ),
       mDisableAdvancedLightingBins( false ),
       mRenderArea( view.getFrustum().getBounds() ),
+      mZonesTraversed( false ),
       mAmbientLightColor( sceneManager->getAmbientLightColor() ),
       mSceneRenderStyle( SRS_Standard ),
-      mRenderField( 0 )
+      mRenderField( 0 ),
+      mShadowCasterFilter( AllShadowCasters )
 {
+   // Skip zero when the ids wrap around.
+   mId = smNextId++;
+   if ( mId == 0 )
+      mId = smNextId++;
+
    // Setup the default parameters for the screen metrics methods.
    mDiffuseCameraTransform = view.getViewWorldMatrix();
 
@@ -68,6 +77,15 @@ SceneRenderState::SceneRenderState( SceneManager* sceneManager,
 
    // Assign shared matrix data to the render pass.
 
+   assignSharedTransforms();
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneRenderState::assignSharedTransforms()
+{
+   const SceneCameraState& view = getCullingState().getCameraState();
+
    mRenderPass->assignSharedXform( RenderPassManager::View, view.getWorldViewMatrix() );
    mRenderPass->assignSharedXform( RenderPassManager::Projection, view.getProjectionMatrix() );
 }
@@ -102,6 +120,11 @@ void SceneRenderState::renderObjects( SceneObject** objects, U32 numObjects )
    for( U32 i = 0; i < numObjects; ++ i )
    {
       SceneObject* object = objects[ i ];
+
+      if(   mShadowCasterFilter != AllShadowCasters &&
+            object->isStaticShadowCaster() != ( mShadowCasterFilter == StaticShadowCasters ) )
+         continue;
+
       object->prepRenderImage( this );
    }
    PROFILE_END();
@@ -61,6 +61,15 @@ class SceneRenderState
       /// @see getOverrideMaterial
       typedef Delegate< BaseMatInstance*( BaseMatInstance* ) > MatDelegate;
 
+      /// Which objects are rendered by renderObjects().
+      /// @see SceneObject::isStaticShadowCaster
+      enum ShadowCasterFilter
+      {
+         AllShadowCasters,
+         StaticShadowCasters,
+         DynamicShadowCasters
+      };
+
    protected:
 
       /// SceneManager being rendered in this state.
@@ -93,6 +102,15 @@ class SceneRenderState
       /// The AABB that encloses the space in the scene that we render.
       Box3F mRenderArea;
 
+      /// True once the zones have been traversed into the culling state.
+      bool mZonesTraversed;
+
+      /// The unique id of this state.
+      U32 mId;
+
+      /// The id given to the next state.
+      static U32 smNextId;
+
       /// The camera vector normalized to 1 / far dist.
       Point3F mVectorEye;
 
@@ -112,6 +130,10 @@ class SceneRenderState
       /// If true (default) non-lightmapped meshes should be rendered.
       bool mRenderNonLightmappedMeshes;
 
+      /// Limits the objects rendered to the static or dynamic shadow
+      /// casters.  Defaults to AllShadowCasters.
+      ShadowCasterFilter mShadowCasterFilter;
+
    public:
 
       /// Construct a new SceneRenderState.
@@ -133,6 +155,10 @@ class SceneRenderState
       /// Return the SceneManager that is being rendered in this SceneRenderState.
       SceneManager* getSceneManager() const { return mSceneManager; }
 
+      /// Returns an id which is unique to this state and never zero.  Used
+      /// to cache constants which only depend on the render state.
+      U32 getId() const { return mId; }
+
       /// If true then bin based post effects are disabled 
       /// during rendering with this scene state.
       bool usePostEffects() const { return mUsePostEffects; }
@@ -151,6 +177,12 @@ class SceneRenderState
       /// Returns the root camera frustum.
       const Frustum& getCameraFrustum() const { return getCullingState().getCameraFrustum(); }
 
+      /// Returns true if the zones have already been traversed for this state.
+      bool areZonesTraversed() const { return mZonesTraversed; }
+
+      /// Marks the zones as traversed so that they aren't traversed again.
+      void setZonesTraversed() { mZonesTraversed = true; }
+
       /// @}
 
       /// @name Rendering
@@ -202,6 +234,9 @@ class SceneRenderState
       bool renderNonLightmappedMeshes() const { return mRenderNonLightmappedMeshes; }
       void renderNonLightmappedMeshes( bool enabled ) { mRenderNonLightmappedMeshes = enabled; }
 
+      ShadowCasterFilter getShadowCasterFilter() const { return mShadowCasterFilter; }
+      void setShadowCasterFilter( ShadowCasterFilter filter ) { mShadowCasterFilter = filter; }
+
       /// @}
 
       /// @name Passes
@@ -257,6 +292,11 @@ class SceneRenderState
       /// Return the project transform matrix.
       const MatrixF& getProjectionMatrix() const;
 
+      /// Assign the view and projection transforms of this state to the render
+      /// pass.  This is done on construction, so it only needs to be called again
+      /// when several states are alive for the same render pass.
+      void assignSharedTransforms();
+
       /// Returns the actual camera position.
       /// @see getDiffuseCameraPosition
       const Point3F& getCameraPosition() const { return getCullingState().getCameraState().getViewPosition(); }
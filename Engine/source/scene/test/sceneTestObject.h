@@ -0,0 +1,80 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _SCENETESTOBJECT_H_
+#define _SCENETESTOBJECT_H_
+
+#ifndef _SCENEOBJECT_H_
+#include "scene/sceneObject.h"
+#endif
+
+
+/// Bare SceneObject for the scene unit tests.  It can be placed in a
+/// container or culled without being registered with the sim or a
+/// scene manager.  Rays collide with its object box.
+class SceneTestObject : public SceneObject
+{
+   public:
+
+      SceneTestObject( const Point3F& position, F32 halfSize, U32 typeMask = StaticObjectType )
+      {
+         mTypeMask = typeMask;
+         mObjBox.set( Point3F( - halfSize, - halfSize, - halfSize ),
+                      Point3F( halfSize, halfSize, halfSize ) );
+
+         MatrixF xfm( true );
+         xfm.setPosition( position );
+         setTransform( xfm );
+      }
+
+      // SceneObject.
+      virtual bool castRay( const Point3F& start, const Point3F& end, RayInfo* info )
+      {
+         F32 t;
+         Point3F normal;
+         if( !mObjBox.collideLine( start, end, &t, &normal ) )
+            return false;
+
+         info->t = t;
+         info->normal = normal;
+         info->object = this;
+         return true;
+      }
+
+      /// Sort callback for dQsort() that orders object pointers by address.
+      /// Used to compare query results independent of the traversal order.
+      static S32 QSORT_CALLBACK cmpAddress( const void* a, const void* b )
+      {
+         const SceneObject* objA = *reinterpret_cast< SceneObject* const* >( a );
+         const SceneObject* objB = *reinterpret_cast< SceneObject* const* >( b );
+
+         if( objA < objB )
+            return -1;
+         else if( objA > objB )
+            return 1;
+
+         return 0;
+      }
+};
+
+#endif // !_SCENETESTOBJECT_H_
@@ -0,0 +1,299 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "scene/sceneContainer.h"
+#include "scene/test/sceneTestObject.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Generates a large, dense world and compares query results and timings
+   /// between the bin grid and the AABB tree.
+   struct ContainerBenchmark
+   {
+      enum
+      {
+         NUM_OBJECTS = 30000,
+         NUM_LARGE_OBJECTS = 200,
+         NUM_QUERIES = 2000,
+      };
+
+      static const F32 WORLD_SIZE;
+
+      Vector< SceneTestObject* > mObjects;
+      Vector< Box3F > mQueryBoxes;
+      Vector< Point3F > mRayStarts;
+      Vector< Point3F > mRayEnds;
+
+      /// Objects found by all box queries of the last run.  The results
+      /// of each query are sorted by address so that index types which
+      /// traverse in different orders can be compared.
+      Vector< SceneObject* > mFoundObjects;
+
+      U32 mTotalFound;
+      U32 mTotalHits;
+      bool mBatchMatches;
+
+      ContainerBenchmark()
+         : mTotalFound( 0 ),
+           mTotalHits( 0 ),
+           mBatchMatches( true )
+      {
+         MRandomLCG rand( 1234 );
+
+         for( U32 i = 0; i < NUM_OBJECTS + NUM_LARGE_OBJECTS; ++ i )
+         {
+            const F32 halfSize = ( i < NUM_OBJECTS ) ? rand.randF( 0.5f, 10.0f ) : rand.randF( 100.0f, 500.0f );
+            const Point3F pos( rand.randF( - WORLD_SIZE, WORLD_SIZE ),
+                               rand.randF( - WORLD_SIZE, WORLD_SIZE ),
+                               rand.randF( 0.0f, 100.0f ) );
+            mObjects.push_back( new SceneTestObject( pos, halfSize ) );
+         }
+
+         for( U32 i = 0; i < NUM_QUERIES; ++ i )
+         {
+            const Point3F center( rand.randF( - WORLD_SIZE, WORLD_SIZE ),
+                                  rand.randF( - WORLD_SIZE, WORLD_SIZE ),
+                                  rand.randF( 0.0f, 100.0f ) );
+            const F32 radius = rand.randF( 5.0f, 100.0f );
+            mQueryBoxes.push_back( Box3F( center - Point3F( radius, radius, radius ),
+                                          center + Point3F( radius, radius, radius ) ) );
+
+            // Rays starting inside of several objects hit all of them at t=0
+            // and which one is reported depends on the traversal order, so
+            // only start rays outside of objects.
+
+            const Point3F dir( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -0.1f, 0.1f ) );
+            if( !isInsideObject( center ) )
+            {
+               mRayStarts.push_back( center );
+               mRayEnds.push_back( center + dir * 500.0f );
+            }
+         }
+      }
+
+      bool isInsideObject( const Point3F& point ) const
+      {
+         for( U32 i = 0; i < mObjects.size(); ++ i )
+            if( mObjects[ i ]->getWorldBox().isContained( point ) )
+               return true;
+
+         return false;
+      }
+
+      ~ContainerBenchmark()
+      {
+         for( U32 i = 0; i < mObjects.size(); ++ i )
+            delete mObjects[ i ];
+      }
+
+      /// Return true if both sets of ray casts hit the same objects
+      /// at the same positions.
+      static bool compareRayHits( const Vector< RayInfo >& infos, const Vector< bool >& hits,
+                                  const Vector< RayInfo >& otherInfos, const Vector< bool >& otherHits )
+      {
+         for( U32 i = 0; i < hits.size(); ++ i )
+         {
+            if( hits[ i ] != otherHits[ i ] )
+               return false;
+
+            if( hits[ i ] &&
+                ( infos[ i ].object != otherInfos[ i ].object ||
+                  infos[ i ].t != otherInfos[ i ].t ) )
+               return false;
+         }
+
+         return true;
+      }
+
+      void run( SceneContainer::IndexType type, const char* name )
+      {
+         SceneContainer container;
+         container.setIndexType( type );
+
+         U32 start = Platform::getRealMilliseconds();
+         for( U32 i = 0; i < mObjects.size(); ++ i )
+            container.addObject( mObjects[ i ] );
+         const U32 insertTime = Platform::getRealMilliseconds() - start;
+
+         mTotalFound = 0;
+         start = Platform::getRealMilliseconds();
+         for( U32 i = 0; i < mQueryBoxes.size(); ++ i )
+         {
+            Vector< SceneObject* > found;
+            container.findObjectList( mQueryBoxes[ i ], StaticObjectType, &found );
+            mTotalFound += found.size();
+         }
+         const U32 boxTime = Platform::getRealMilliseconds() - start;
+
+         // Record the results outside of the timed loop.
+         mFoundObjects.clear();
+         for( U32 i = 0; i < mQueryBoxes.size(); ++ i )
+         {
+            Vector< SceneObject* > found;
+            container.findObjectList( mQueryBoxes[ i ], StaticObjectType, &found );
+            if( found.size() )
+            {
+               dQsort( found.address(), found.size(), sizeof( SceneObject* ), SceneTestObject::cmpAddress );
+               mFoundObjects.merge( found );
+            }
+         }
+
+         mTotalHits = 0;
+         Vector< RayInfo > rayInfos;
+         Vector< bool > rayHits;
+         rayInfos.setSize( mRayStarts.size() );
+         rayHits.setSize( mRayStarts.size() );
+
+         start = Platform::getRealMilliseconds();
+         for( U32 i = 0; i < mRayStarts.size(); ++ i )
+         {
+            rayHits[ i ] = container.castRay( mRayStarts[ i ], mRayEnds[ i ], StaticObjectType, &rayInfos[ i ] );
+            if( rayHits[ i ] )
+               mTotalHits ++;
+         }
+         const U32 rayTime = Platform::getRealMilliseconds() - start;
+
+         Vector< RayInfo > batchInfos;
+         Vector< bool > batchHits;
+         batchInfos.setSize( mRayStarts.size() );
+         batchHits.setSize( mRayStarts.size() );
+
+         start = Platform::getRealMilliseconds();
+         const U32 numBatchHits = container.castRays( mRayStarts.size(), mRayStarts.address(), mRayEnds.address(),
+            StaticObjectType, batchInfos.address(), batchHits.address() );
+         const U32 batchTime = Platform::getRealMilliseconds() - start;
+
+         mBatchMatches = ( numBatchHits == mTotalHits ) && compareRayHits( rayInfos, rayHits, batchInfos, batchHits );
+
+         // Same again on the thread pool.
+
+         container.castRays( mRayStarts.size(), mRayStarts.address(), mRayEnds.address(),
+            StaticObjectType, batchInfos.address(), batchHits.address(), true );
+
+         mBatchMatches &= compareRayHits( rayInfos, rayHits, batchInfos, batchHits );
+
+         // Move every tenth object a bit.
+         start = Platform::getRealMilliseconds();
+         for( U32 i = 0; i < mObjects.size(); i += 10 )
+         {
+            MatrixF xfm = mObjects[ i ]->getTransform();
+            xfm.setPosition( xfm.getPosition() + Point3F( 2.0f, 0.0f, 0.0f ) );
+            mObjects[ i ]->setTransform( xfm );
+            container.checkBins( mObjects[ i ] );
+         }
+         const U32 updateTime = Platform::getRealMilliseconds() - start;
+
+         Con::printf( "%s: insert %dms, %d box queries %dms (%d found), %d rays %dms (batched %dms, %d hits), updates %dms",
+            name, insertTime, mQueryBoxes.size(), boxTime, mTotalFound, mRayStarts.size(), rayTime, batchTime, mTotalHits, updateTime );
+
+         // Move the objects back so the next run sees the same world.
+         for( U32 i = 0; i < mObjects.size(); i += 10 )
+         {
+            MatrixF xfm = mObjects[ i ]->getTransform();
+            xfm.setPosition( xfm.getPosition() - Point3F( 2.0f, 0.0f, 0.0f ) );
+            mObjects[ i ]->setTransform( xfm );
+            container.checkBins( mObjects[ i ] );
+         }
+
+         for( U32 i = 0; i < mObjects.size(); ++ i )
+            container.removeObject( mObjects[ i ] );
+      }
+   };
+
+   const F32 ContainerBenchmark::WORLD_SIZE = 4096.0f;
+}
+
+CreateUnitTest( TestSceneContainerIndex, "Scene/Container/Index" )
+{
+   void run()
+   {
+      ContainerBenchmark benchmark;
+
+      benchmark.run( SceneContainer::BinIndex, "Bins" );
+      const Vector< SceneObject* > binsFound = benchmark.mFoundObjects;
+      const bool binsBatchMatches = benchmark.mBatchMatches;
+
+      benchmark.run( SceneContainer::TreeIndex, "Tree" );
+      const Vector< SceneObject* > treeFound = benchmark.mFoundObjects;
+
+      test( binsFound.size() > 0, "Box queries found no objects" );
+      test( binsFound.size() == treeFound.size() &&
+            dMemcmp( binsFound.address(), treeFound.address(), binsFound.size() * sizeof( SceneObject* ) ) == 0,
+            "Bin grid and AABB tree returned different query results" );
+      test( benchmark.mTotalHits > 0 && benchmark.mTotalHits < benchmark.mRayStarts.size(), "Expected some rays to hit and some to miss" );
+      test( binsBatchMatches && benchmark.mBatchMatches, "Batched and single ray casts returned different results" );
+   }
+};
+
+CreateUnitTest( TestSceneAABBTree, "Scene/Container/AABBTree" )
+{
+   void run()
+   {
+      MRandomLCG rand( 4321 );
+
+      SceneAABBTree tree;
+      Vector< SceneAABBTree::ProxyId > proxies;
+      Vector< SceneTestObject* > objects;
+
+      for( U32 i = 0; i < 1000; ++ i )
+      {
+         const Point3F pos( rand.randF( -1000.0f, 1000.0f ), rand.randF( -1000.0f, 1000.0f ), 0.0f );
+         objects.push_back( new SceneTestObject( pos, rand.randF( 1.0f, 5.0f ) ) );
+         proxies.push_back( tree.insert( objects.last(), objects.last()->getWorldBox() ) );
+      }
+
+      tree.validate();
+      test( tree.getNumLeaves() == 1000, "Wrong number of leaves" );
+      test( tree.getHeight() < 32, "Tree is badly unbalanced" );
+
+      // Remove every other object.
+      for( U32 i = 0; i < proxies.size(); i += 2 )
+         tree.remove( proxies[ i ] );
+
+      tree.validate();
+      test( tree.getNumLeaves() == 500, "Wrong number of leaves after removal" );
+
+      // Every remaining object must be found by a query on its own box.
+      bool allFound = true;
+      for( U32 i = 1; i < proxies.size(); i += 2 )
+      {
+         SimpleQueryList list;
+         tree.findObjects( objects[ i ]->getWorldBox(), SimpleQueryList::insertionCallback, &list );
+         allFound &= ( find( list.mList.begin(), list.mList.end(), objects[ i ] ) != list.mList.end() );
+      }
+      test( allFound, "Object not found in its own box" );
+
+      for( U32 i = 0; i < objects.size(); ++ i )
+         delete objects[ i ];
+   }
+};
+
+#endif // !TORQUE_SHIPPING
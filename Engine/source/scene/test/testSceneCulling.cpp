@@ -0,0 +1,235 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "scene/culling/sceneCullingState.h"
+#include "scene/sceneManager.h"
+#include "scene/zones/sceneZoneSpaceManager.h"
+#include "scene/test/sceneTestObject.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestSceneCullingParallel, "Scene/Culling/Parallel" )
+{
+   enum
+   {
+      NUM_OBJECTS = 30000,
+      NUM_PASSES = 10
+   };
+
+   U32 cull( SceneCullingState& state, const Vector< SceneObject* >& objects, bool parallel, Vector< SceneObject* >& outVisible )
+   {
+      const bool oldParallel = SceneCullingState::smParallelCulling;
+      SceneCullingState::smParallelCulling = parallel;
+
+      const U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < NUM_PASSES; ++ i )
+      {
+         outVisible = objects;
+         outVisible.setSize( state.cullObjects( outVisible.address(), outVisible.size() ) );
+      }
+      const U32 time = Platform::getRealMilliseconds() - start;
+
+      SceneCullingState::smParallelCulling = oldParallel;
+      return time;
+   }
+
+   /// Add the root frustum to the outdoor zone like the zone traversal
+   /// does so that objects in it are tested against the zone volumes.
+   void addRootVolume( SceneCullingState& state )
+   {
+      state.addCullingVolumeToZone( SceneZoneSpaceManager::RootZoneId, state.getRootVolume() );
+   }
+
+   /// Return true if @a subset only contains objects in @a set in the same order.
+   static bool isOrderedSubset( const Vector< SceneObject* >& subset, const Vector< SceneObject* >& set )
+   {
+      U32 n = 0;
+      for( U32 i = 0; i < subset.size(); ++ i )
+      {
+         while( n < set.size() && set[ n ] != subset[ i ] )
+            n ++;
+         if( n == set.size() )
+            return false;
+      }
+
+      return true;
+   }
+
+   void run()
+   {
+      test( gClientSceneGraph != NULL, "Scene culling test needs the client scene graph" );
+      if( !gClientSceneGraph )
+         return;
+
+      MRandomLCG rand( 5678 );
+
+      // Use a type that is subject to zone culling and add the objects to
+      // the scene so they get assigned to zones.
+
+      Vector< SceneObject* > objects;
+      for( U32 i = 0; i < NUM_OBJECTS; ++ i )
+      {
+         const Point3F pos( rand.randF( -2000.0f, 2000.0f ),
+                            rand.randF( -2000.0f, 2000.0f ),
+                            rand.randF( -50.0f, 50.0f ) );
+         objects.push_back( new SceneTestObject( pos, rand.randF( 0.5f, 10.0f ), DynamicShapeObjectType ) );
+         gClientSceneGraph->addObjectToScene( objects.last() );
+      }
+
+      gClientSceneGraph->getZoneManager()->updateZoningState();
+
+      // Camera at the origin looking down +Y.
+
+      Frustum frustum;
+      frustum.set( false, mDegToRad( 60.0f ), 16.0f / 9.0f, 0.1f, 1500.0f );
+
+      MatrixF worldView( true );
+      MatrixF projection( true );
+      SceneCameraState cameraState( RectI( 0, 0, 1280, 720 ), frustum, worldView, projection );
+
+      // Root frustum only.
+
+      SceneCullingState rootState( gClientSceneGraph, cameraState );
+      rootState.disableZoneCulling( true );
+      rootState.setDisableTerrainOcclusion( true );
+
+      Vector< SceneObject* > serialVisible;
+      Vector< SceneObject* > parallelVisible;
+
+      U32 serialTime = cull( rootState, objects, false, serialVisible );
+      U32 parallelTime = cull( rootState, objects, true, parallelVisible );
+
+      Con::printf( "Culling %d objects x%d against root frustum: serial %dms, parallel %dms (%d visible)",
+         NUM_OBJECTS, NUM_PASSES, serialTime, parallelTime, serialVisible.size() );
+
+      test( serialVisible.size() > 0 && serialVisible.size() < NUM_OBJECTS, "Expected some objects to be culled" );
+      test( serialVisible.size() == parallelVisible.size() &&
+            dMemcmp( serialVisible.address(), parallelVisible.address(), serialVisible.size() * sizeof( SceneObject* ) ) == 0,
+            "Serial and parallel culling returned different visible sets" );
+
+      const Vector< SceneObject* > rootVisible = serialVisible;
+
+      // Zone culling with an occluder in front of the camera.
+
+      SceneCullingState zoneState( gClientSceneGraph, cameraState );
+      zoneState.setDisableTerrainOcclusion( true );
+      addRootVolume( zoneState );
+
+      const Point3F occluderVerts[] =
+      {
+         Point3F( -150.0f, 200.0f, -60.0f ),
+         Point3F( -150.0f, 200.0f, 60.0f ),
+         Point3F( 150.0f, 200.0f, 60.0f ),
+         Point3F( 150.0f, 200.0f, -60.0f )
+      };
+
+      SceneCullingVolume occluder;
+      const bool haveOccluder = zoneState.createCullingVolume( occluderVerts, 4, SceneCullingVolume::Occluder, occluder );
+      test( haveOccluder, "Occluder was rejected" );
+      if( haveOccluder )
+         zoneState.addCullingVolumeToZone( SceneZoneSpaceManager::RootZoneId, occluder );
+
+      serialTime = cull( zoneState, objects, false, serialVisible );
+      parallelTime = cull( zoneState, objects, true, parallelVisible );
+
+      Con::printf( "Culling %d objects x%d against zones: serial %dms, parallel %dms (%d visible)",
+         NUM_OBJECTS, NUM_PASSES, serialTime, parallelTime, serialVisible.size() );
+
+      test( serialVisible.size() == parallelVisible.size() &&
+            dMemcmp( serialVisible.address(), parallelVisible.address(), serialVisible.size() * sizeof( SceneObject* ) ) == 0,
+            "Serial and parallel zone culling returned different visible sets" );
+      test( serialVisible.size() > 0 && serialVisible.size() < rootVisible.size() &&
+            isOrderedSubset( serialVisible, rootVisible ),
+            "Expected the occluder to hide some of the objects in the root frustum" );
+
+      bool anyOccludedVisible = false;
+      for( U32 i = 0; i < serialVisible.size(); ++ i )
+         anyOccludedVisible |= occluder.test( serialVisible[ i ]->getWorldBox() );
+      test( haveOccluder && !anyOccludedVisible, "Object inside occluder was not culled" );
+
+      // Cull small lists against four cameras looking in different
+      // directions at once and compare with culling each serially.
+
+      enum { NUM_LISTS = 4 };
+
+      SceneCullingState* listStates[ NUM_LISTS ];
+      Vector< SceneObject* > listObjects[ NUM_LISTS ];
+      SceneCullingState::ObjectList lists[ NUM_LISTS ];
+
+      for( U32 i = 0; i < NUM_LISTS; ++ i )
+      {
+         Frustum listFrustum( frustum );
+         MatrixF listXfm( EulerF( 0.0f, 0.0f, M_HALFPI_F * i ) );
+         listFrustum.setTransform( listXfm );
+
+         listStates[ i ] = new SceneCullingState( gClientSceneGraph, SceneCameraState( RectI( 0, 0, 1280, 720 ), listFrustum, worldView, projection ) );
+         listStates[ i ]->setDisableTerrainOcclusion( true );
+         addRootVolume( *listStates[ i ] );
+
+         for( U32 n = i; n < objects.size(); n += NUM_LISTS )
+            listObjects[ i ].push_back( objects[ n ] );
+
+         lists[ i ].state = listStates[ i ];
+         lists[ i ].objects = listObjects[ i ].address();
+         lists[ i ].numObjects = listObjects[ i ].size();
+         lists[ i ].cullOptions = 0;
+      }
+
+      SceneCullingState::cullObjectLists( lists, NUM_LISTS );
+
+      bool listsMatch = true;
+      for( U32 i = 0; i < NUM_LISTS; ++ i )
+      {
+         Vector< SceneObject* > expected;
+         for( U32 n = i; n < objects.size(); n += NUM_LISTS )
+            expected.push_back( objects[ n ] );
+
+         const bool oldParallel = SceneCullingState::smParallelCulling;
+         SceneCullingState::smParallelCulling = false;
+         expected.setSize( listStates[ i ]->cullObjects( expected.address(), expected.size() ) );
+         SceneCullingState::smParallelCulling = oldParallel;
+
+         listsMatch &= ( expected.size() == lists[ i ].numObjects &&
+                         dMemcmp( expected.address(), listObjects[ i ].address(), expected.size() * sizeof( SceneObject* ) ) == 0 );
+
+         delete listStates[ i ];
+      }
+
+      test( listsMatch, "Culling lists together returned different visible sets" );
+
+      for( U32 i = 0; i < objects.size(); ++ i )
+      {
+         gClientSceneGraph->removeObjectFromScene( objects[ i ] );
+         delete objects[ i ];
+      }
+   }
+};
+
+#endif // !TORQUE_SHIPPING
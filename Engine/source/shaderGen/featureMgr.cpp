@@ -48,7 +48,8 @@ MODULE_END;
 
 
 FeatureMgr::FeatureMgr()
-   : mNeedsSort( false )
+   : mNeedsSort( false ),
+     mChangeCount( 0 )
 {
    VECTOR_SET_ASSOCIATION( mFeatures );
 }
@@ -69,6 +70,7 @@ void FeatureMgr::unregisterAll()
 
    mFeatures.clear();
    mNeedsSort = false;
+   mChangeCount++;
 }
 
 const FeatureInfo& FeatureMgr::getAt( U32 index )
@@ -109,6 +111,7 @@ void FeatureMgr::registerFeature(   const FeatureType &type,
 
    // Make sure we resort the features.
    mNeedsSort = true;
+   mChangeCount++;
 }
 
 S32 QSORT_CALLBACK FeatureMgr::_featureInfoCompare( const FeatureInfo* a, const FeatureInfo* b )
@@ -138,6 +141,7 @@ void FeatureMgr::unregisterFeature( const FeatureType &type )
 
       delete iter->feature;
       mFeatures.erase( iter );
+      mChangeCount++;
       return;
    }
 }
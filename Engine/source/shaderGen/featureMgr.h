@@ -47,6 +47,9 @@ protected:
 
    bool mNeedsSort;
 
+   /// Incremented when a feature is registered or unregistered.
+   U32 mChangeCount;
+
    typedef Vector<FeatureInfo> FeatureInfoVector;
 
    FeatureInfoVector mFeatures;
@@ -61,6 +64,10 @@ public:
    /// Returns the count of registered features.
    U32 getFeatureCount() const { return mFeatures.size(); }
 
+   /// Returns a count which changes every time the
+   /// registered features change.
+   U32 getChangeCount() const { return mChangeCount; }
+
    /// Returns the feature info at the index.
    const FeatureInfo& getAt( U32 index );
 
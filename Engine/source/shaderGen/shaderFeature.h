@@ -66,6 +66,11 @@ public:
    Shaders are generated using the ShaderFeature interface, so all of the
    descendants interact pretty much the same way.
 
+   Generated shaders are reused across runs through the shader cache index,
+   which only notices which features are registered.  When you change the
+   code a feature outputs, bump smCacheIndexVersion in shaderGen.cpp so the
+   cached shaders are generated again.
+
 */
 //**************************************************************************
 
@@ -26,10 +26,14 @@
 #include "shaderGen/conditionerFeature.h"
 #include "core/stream/fileStream.h"
 #include "shaderGen/featureMgr.h"
+#include "shaderGen/featureType.h"
 #include "shaderGen/shaderOp.h"
 #include "gfx/gfxDevice.h"
 #include "core/memVolume.h"
 #include "core/module.h"
+#include "core/util/fourcc.h"
+#include "console/consoleTypes.h"
+#include "app/version.h"
 
 
 MODULE_BEGIN( ShaderGen )
@@ -40,6 +44,11 @@ MODULE_BEGIN( ShaderGen )
    MODULE_INIT
    {
       ManagedSingleton< ShaderGen >::createSingleton();
+
+      Con::addVariable( "$ShaderGen::useCacheIndex", TypeBool, &ShaderGen::smUseCacheIndex,
+         "If true generated shaders are recorded in an index in the shader cache path and "
+         "are reused on the next run without being generated again.\n"
+         "@ingroup Rendering\n" );
    }
    
    MODULE_SHUTDOWN
@@ -50,9 +59,28 @@ MODULE_BEGIN( ShaderGen )
 MODULE_END;
 
 
+bool ShaderGen::smUseCacheIndex = true;
+
+const String ShaderGen::CacheIndexFileName( "shaderCache.idx" );
+
+/// Identifies the shader cache index file.
+static const U32 smCacheIndexTag = makeFourCCTag( 'S', 'G', 'C', 'I' );
+
+/// Bump this when the index layout or the code generated
+/// by ShaderGen or any ShaderFeature changes.  The generator
+/// hash only sees which features are registered, not what
+/// they output, so without a bump the index keeps returning
+/// the shaders generated by the old code until the engine
+/// version changes.
+static const U32 smCacheIndexVersion = 1;
+
+
 ShaderGen::ShaderGen()
 {
    mInit = false;
+   mCacheIndexDirty = false;
+   mGeneratorHash = 0;
+   mGeneratorHashFeatures = U32_MAX;
    GFXDevice::getDeviceEventSignal().notify(this, &ShaderGen::_handleGFXEvent);
    mOutput = NULL;
 }
@@ -61,6 +89,7 @@ ShaderGen::~ShaderGen()
 {
    GFXDevice::getDeviceEventSignal().remove(this, &ShaderGen::_handleGFXEvent);
    _uninit();
+   _clearCacheIndex();
 }
 
 void ShaderGen::registerInitDelegate(GFXAdapterType adapterType, ShaderGenInitDelegate& initDelegate)
@@ -73,11 +102,13 @@ bool ShaderGen::_handleGFXEvent(GFXDevice::GFXDeviceEventType event)
    switch (event)
    {
    case GFXDevice::deInit :
+      mGeneratorHashFeatures = U32_MAX;
       initShaderGen();
       break;
    case GFXDevice::deDestroy :
       {
          flushProceduralShaders();
+         mGeneratorHashFeatures = U32_MAX;
       }
       break;
    default :
@@ -131,6 +162,19 @@ void ShaderGen::initShaderGen()
 
    // Delete the auto-generated conditioner include file.
    Torque::FS::Remove( "shadergen:/" + ConditionerFeature::ConditionerIncludeFileName );
+
+   // The memory file system doesn't outlive the 
+   // process so there is no index to load.
+   if ( !mMemFS && smUseCacheIndex )
+      _loadCacheIndex();
+}
+
+void ShaderGen::_getShaderFiles( const char *cacheName, char *vertFile, char *pixFile )
+{
+   // Note:  We use a postfix of _V/_P here so that it sorts the matching
+   // vert and pixel shaders together when listed alphabetically.   
+   dSprintf( vertFile, 256, "shadergen:/%s_V.%s", cacheName, mFileEnding.c_str() );
+   dSprintf( pixFile, 256, "shadergen:/%s_P.%s", cacheName, mFileEnding.c_str() );
 }
 
 void ShaderGen::generateShader( const MaterialFeatureData &featureData,
@@ -151,11 +195,7 @@ void ShaderGen::generateShader( const MaterialFeatureData &featureData,
 
    char vertShaderName[256];
    char pixShaderName[256];
-
-   // Note:  We use a postfix of _V/_P here so that it sorts the matching
-   // vert and pixel shaders together when listed alphabetically.   
-   dSprintf( vertShaderName, sizeof(vertShaderName), "shadergen:/%s_V.%s", cacheName, mFileEnding.c_str() );
-   dSprintf( pixShaderName, sizeof(pixShaderName), "shadergen:/%s_P.%s", cacheName, mFileEnding.c_str() );
+   _getShaderFiles( cacheName, vertShaderName, pixShaderName );
    
    dStrcpy( vertFile, vertShaderName );
    dStrcpy( pixFile, pixShaderName );   
@@ -475,9 +515,34 @@ GFXShader* ShaderGen::getShader( const MaterialFeatureData &featureData, const G
    if ( match )
       return match;
 
-   // if not, then create it
    char vertFile[256];
    char pixFile[256];
+
+   // If the shader was generated by an earlier run then 
+   // we can skip straight to the shader compile.
+   const CacheEntry *entry = smUseCacheIndex ? _findCacheEntry( cacheKey ) : NULL;
+   if ( entry )
+   {
+      PROFILE_SCOPE( ShaderGen_GetShader_Cached );
+
+      _getShaderFiles( cacheKey, vertFile, pixFile );
+
+      GFXShader *shader = GFX->createShader();
+      shader->mInstancingFormat.copy( entry->instancingFormat );
+      if ( shader->init( vertFile, pixFile, entry->pixVersion, entry->macros ) )
+      {
+         mProcShaders[cacheKey] = shader;
+         return shader;
+      }
+
+      // The cached files are bad... regenerate them below.
+      delete shader;
+      delete entry;
+      mCacheIndex.erase( cacheKey );
+      mCacheIndexDirty = true;
+   }
+
+   // if not, then create it
    F32  pixVersion;
 
    Vector<GFXShaderMacro> shaderMacros;
@@ -496,6 +561,9 @@ GFXShader* ShaderGen::getShader( const MaterialFeatureData &featureData, const G
 
    mProcShaders[cacheKey] = shader;
 
+   if ( smUseCacheIndex && !mMemFS )
+      _addCacheEntry( cacheKey, pixVersion, shaderMacros );
+
    return shader;
 }
 
@@ -504,4 +572,197 @@ void ShaderGen::flushProceduralShaders()
    // The shaders are reference counted, so we
    // just need to clear the map.
    mProcShaders.clear();  
+
+   // This is called when the device goes away and when the
+   // materials are reinitialized, so it is a good time to
+   // persist any new shaders.
+   saveCacheIndex();
+}
+
+U32 ShaderGen::_getGeneratorHash()
+{
+   if ( mGeneratorHashFeatures == FEATUREMGR->getChangeCount() )
+      return mGeneratorHash;
+
+   String desc = String::ToString( "%d %d %d %g %s", smCacheIndexVersion,
+                                   getVersionNumber(),
+                                   GFX->getAdapterType(),
+                                   GFX->getPixelShaderVersion(),
+                                   mFileEnding.c_str() );
+
+   // The lighting systems register different features for
+   // the same feature types, so the registered features 
+   // have to be part of the hash.
+   for ( U32 i=0; i < FEATUREMGR->getFeatureCount(); i++ )
+   {
+      const FeatureInfo &info = FEATUREMGR->getAt( i );
+      desc += " " + info.type->getName() + ":" + info.feature->getName();
+   }
+
+   mGeneratorHash = Torque::hash( (const U8*)desc.c_str(), desc.length(), 0 );
+   mGeneratorHashFeatures = FEATUREMGR->getChangeCount();
+
+   return mGeneratorHash;
+}
+
+const ShaderGen::CacheEntry* ShaderGen::_findCacheEntry( const String &cacheName )
+{
+   CacheIndex::Iterator iter = mCacheIndex.find( cacheName );
+   if ( iter == mCacheIndex.end() )
+      return NULL;
+
+   if ( iter->value->generatorHash != _getGeneratorHash() )
+      return NULL;
+
+   // Someone could have cleaned out the cache folder.
+   char vertFile[256];
+   char pixFile[256];
+   _getShaderFiles( cacheName, vertFile, pixFile );
+   if ( !Torque::FS::IsFile( vertFile ) || !Torque::FS::IsFile( pixFile ) )
+      return NULL;
+
+   return iter->value;
+}
+
+void ShaderGen::_addCacheEntry( const String &cacheName, F32 pixVersion, const Vector<GFXShaderMacro> &macros )
+{
+   CacheEntry *&entry = mCacheIndex[cacheName];
+   if ( !entry )
+      entry = new CacheEntry;
+
+   entry->generatorHash = _getGeneratorHash();
+   entry->pixVersion = pixVersion;
+   entry->macros = macros;
+   entry->instancingFormat.copy( mInstancingFormat );
+
+   mCacheIndexDirty = true;
+}
+
+void ShaderGen::_clearCacheIndex()
+{
+   CacheIndex::Iterator iter = mCacheIndex.begin();
+   for ( ; iter != mCacheIndex.end(); iter++ )
+      delete iter->value;
+
+   mCacheIndex.clear();
+   mCacheIndexDirty = false;
+}
+
+void ShaderGen::_loadCacheIndex()
+{
+   PROFILE_SCOPE( ShaderGen_LoadCacheIndex );
+
+   _clearCacheIndex();
+
+   const String indexPath = "shadergen:/" + CacheIndexFileName;
+   if ( !Torque::FS::IsFile( indexPath ) )
+      return;
+
+   FileStream stream;
+   if ( !stream.open( indexPath, Torque::FS::File::Read ) )
+      return;
+
+   U32 tag, version, count;
+   stream.read( &tag );
+   stream.read( &version );
+   stream.read( &count );
+   if ( tag != smCacheIndexTag || version != smCacheIndexVersion )
+   {
+      Con::warnf( "ShaderGen::_loadCacheIndex - Ignoring out of date shader cache index." );
+      return;
+   }
+
+   for ( U32 i=0; i < count && stream.getStatus() == Stream::Ok; i++ )
+   {
+      String cacheName;
+      stream.read( &cacheName );
+
+      CacheEntry *entry = new CacheEntry;
+      stream.read( &entry->generatorHash );
+      stream.read( &entry->pixVersion );
+
+      U32 numMacros;
+      stream.read( &numMacros );
+      entry->macros.setSize( numMacros );
+      for ( U32 j=0; j < numMacros; j++ )
+      {
+         stream.read( &entry->macros[j].name );
+         stream.read( &entry->macros[j].value );
+      }
+
+      U32 numElements;
+      stream.read( &numElements );
+      for ( U32 j=0; j < numElements; j++ )
+      {
+         String semantic;
+         U32 type, semanticIndex, streamIndex;
+         stream.read( &semantic );
+         stream.read( &type );
+         stream.read( &semanticIndex );
+         stream.read( &streamIndex );
+         entry->instancingFormat.addElement( semantic, (GFXDeclType)type, semanticIndex, streamIndex );
+      }
+
+      // A truncated file... toss the partial entry.
+      if ( stream.getStatus() != Stream::Ok && stream.getStatus() != Stream::EOS )
+      {
+         delete entry;
+         break;
+      }
+
+      CacheEntry *&slot = mCacheIndex[cacheName];
+      delete slot;
+      slot = entry;
+   }
+
+   mCacheIndexDirty = false;
+}
+
+void ShaderGen::saveCacheIndex()
+{
+   if ( !mCacheIndexDirty || mMemFS || !smUseCacheIndex )
+      return;
+
+   PROFILE_SCOPE( ShaderGen_SaveCacheIndex );
+
+   FileStream stream;
+   if ( !stream.open( "shadergen:/" + CacheIndexFileName, Torque::FS::File::Write ) )
+   {
+      Con::errorf( "ShaderGen::saveCacheIndex - Unable to write the shader cache index." );
+      return;
+   }
+
+   stream.write( smCacheIndexTag );
+   stream.write( smCacheIndexVersion );
+   stream.write( (U32)mCacheIndex.size() );
+
+   CacheIndex::Iterator iter = mCacheIndex.begin();
+   for ( ; iter != mCacheIndex.end(); iter++ )
+   {
+      const CacheEntry *entry = iter->value;
+
+      stream.write( iter->key );
+      stream.write( entry->generatorHash );
+      stream.write( entry->pixVersion );
+
+      stream.write( (U32)entry->macros.size() );
+      for ( U32 j=0; j < entry->macros.size(); j++ )
+      {
+         stream.write( entry->macros[j].name );
+         stream.write( entry->macros[j].value );
+      }
+
+      const GFXVertexFormat &format = entry->instancingFormat;
+      stream.write( format.getElementCount() );
+      for ( U32 j=0; j < format.getElementCount(); j++ )
+      {
+         const GFXVertexElement &element = format.getElement( j );
+         stream.write( element.getSemantic() );
+         stream.write( (U32)element.getType() );
+         stream.write( element.getSemanticIndex() );
+         stream.write( element.getStreamIndex() );
+      }
+   }
+
+   mCacheIndexDirty = false;
 }
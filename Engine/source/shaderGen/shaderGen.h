@@ -161,6 +161,19 @@ public:
    // the ShaderFeatures have changed (due to lighting system change, or new plugin)
    virtual void flushProceduralShaders();
 
+   /// Writes the shader cache index to disk if it has changed.
+   /// @see smUseCacheIndex
+   void saveCacheIndex();
+
+   /// Returns the number of entries in the shader cache index.
+   U32 getCacheIndexSize() const { return mCacheIndex.size(); }
+
+   /// If true the generated shaders are recorded in an index
+   /// in the shader cache path which persists between runs.  A 
+   /// shader found in the index is loaded from the cache without
+   /// running the shader features again.
+   static bool smUseCacheIndex;
+
    void setPrinter(ShaderGenPrinter* printer) { mPrinter = printer; }
    void setComponentFactory(ShaderGenComponentFactory* factory) { mComponentFactory = factory; }
    void setFileEnding(String ending) { mFileEnding = ending; }
@@ -195,6 +208,40 @@ protected:
    typedef Map<String, GFXShaderRef> ShaderMap;
    ShaderMap mProcShaders;
 
+   /// An entry in the shader cache index.  It holds the
+   /// outputs of generateShader() that are not stored in
+   /// the generated files themselves.
+   struct CacheEntry
+   {
+      /// The generator hash at the time the shader was generated.
+      /// @see _getGeneratorHash
+      U32 generatorHash;
+
+      F32 pixVersion;
+
+      /// The macros including the ones added by the features.
+      Vector<GFXShaderMacro> macros;
+
+      GFXVertexFormat instancingFormat;
+   };
+
+   /// Map of cache string -> shader cache index entry.
+   typedef Map<String, CacheEntry*> CacheIndex;
+   CacheIndex mCacheIndex;
+
+   /// Set when entries were added since the index was loaded or saved.
+   bool mCacheIndexDirty;
+
+   /// The cached result of _getGeneratorHash().
+   U32 mGeneratorHash;
+
+   /// The FeatureMgr change count mGeneratorHash was computed
+   /// with or U32_MAX if it must be computed again.
+   U32 mGeneratorHashFeatures;
+
+   /// The file name of the shader cache index.
+   static const String CacheIndexFileName;
+
    ShaderGen();
 
    bool _handleGFXEvent(GFXDevice::GFXDeviceEventType event);
@@ -205,6 +252,26 @@ protected:
    void _init();
    void _uninit();
 
+   /// Fills in the generated file names for the cache name.
+   void _getShaderFiles( const char *cacheName, char *vertFile, char *pixFile );
+
+   /// Returns a hash of everything outside of the shader description
+   /// which changes the generated shaders: the engine version, the
+   /// device, the file type and the registered features.
+   ///
+   /// The hash is only computed again when the device or the
+   /// registered features change.
+   U32 _getGeneratorHash();
+
+   /// Returns the cache index entry for the cache name if it was
+   /// generated with the current features and its files exist.
+   const CacheEntry* _findCacheEntry( const String &cacheName );
+
+   void _addCacheEntry( const String &cacheName, F32 pixVersion, const Vector<GFXShaderMacro> &macros );
+
+   void _loadCacheIndex();
+   void _clearCacheIndex();
+
    /// Creates all the various shader components that will be filled in when 
    /// the shader features are processed.
    void _createComponents();
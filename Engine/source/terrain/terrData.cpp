@@ -412,6 +412,9 @@ void TerrainBlock::updateGrid( const Point2I &minPt, const Point2I &maxPt, bool
       _updateBounds();
       mZoningDirty = true;
 
+      if ( getSceneManager() )
+         getSceneManager()->notifyStaticGeometryChanged( getWorldBox() );
+
       smUpdateSignal.trigger( HeightmapUpdate, this, minPt, maxPt );
 
       // Tell the terrain cell that the height changed.
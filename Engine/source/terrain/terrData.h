@@ -406,6 +406,9 @@ public:
 
    void prepRenderImage  ( SceneRenderState* state );
 
+   /// Height edits are reported from updateGrid().
+   bool isStaticShadowCaster() const { return true; }
+
    void buildConvex(const Box3F& box,Convex* convex);
    bool buildPolyList(PolyListContext context, AbstractPolyList* polyList, const Box3F &box, const SphereF &sphere);
    bool castRay(const Point3F &start, const Point3F &end, RayInfo* info);
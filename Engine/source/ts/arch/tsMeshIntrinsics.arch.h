@@ -23,10 +23,20 @@
 #ifndef _TSMESHINTRINSICS_ARCH_H_
 #define _TSMESHINTRINSICS_ARCH_H_
 
+// Default C++ implementations
+extern void zero_vert_normal_bulk_C(const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride);
+extern void m_matF_x_BatchedVertWeightList_C(const MatrixF &mat, const dsize_t count, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch, U8 * const __restrict outPtr, const dsize_t outStride);
+
 #if defined(TORQUE_CPU_X86)
 # // x86 CPU family implementations
 extern void zero_vert_normal_bulk_SSE(const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride);
 extern void m_matF_x_BatchedVertWeightList_SSE(const MatrixF &mat, const dsize_t count, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch, U8 * const __restrict outPtr, const dsize_t outStride);
+#if defined(TORQUE_COMPILER_GCC) || (_MSC_VER >= 1600)
+#  define TORQUE_TS_MESH_INTRINSICS_AVX
+extern void zero_vert_normal_bulk_AVX(const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride);
+extern void m_matF_x_BatchedVertWeightList_AVX(const MatrixF &mat, const dsize_t count, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch, U8 * const __restrict outPtr, const dsize_t outStride);
+extern void m_matF_x_BatchedVertWeightList_FMA(const MatrixF &mat, const dsize_t count, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch, U8 * const __restrict outPtr, const dsize_t outStride);
+#endif
 #if (_MSC_VER >= 1500)
 extern void m_matF_x_BatchedVertWeightList_SSE4(const MatrixF &mat, const dsize_t count, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch, U8 * const __restrict outPtr, const dsize_t outStride);
 #endif
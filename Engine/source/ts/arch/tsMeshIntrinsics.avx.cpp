@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "ts/tsMesh.h"
+
+#if defined(TORQUE_CPU_X86)
+#include "ts/tsMeshIntrinsics.h"
+#include "ts/arch/tsMeshIntrinsics.arch.h"
+
+#ifdef TORQUE_TS_MESH_INTRINSICS_AVX
+#include <immintrin.h>
+
+// These functions are only called when the CPU supports them, so GCC
+// is allowed to use the instructions here without the whole project
+// being built for them.
+#if defined(TORQUE_COMPILER_GCC)
+#  define TS_AVX_FUNCTION __attribute__((target("avx")))
+#  define TS_FMA_FUNCTION __attribute__((target("avx,fma")))
+#else
+#  define TS_AVX_FUNCTION
+#  define TS_FMA_FUNCTION
+#endif
+
+TS_AVX_FUNCTION
+void zero_vert_normal_bulk_AVX(const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride)
+{
+   register char *outData = reinterpret_cast<char *>(outPtr);
+
+   const __m256 vZero = _mm256_setzero_ps();
+
+   for(int i = 0; i < count; i++)
+   {
+      // The position and normal, with the tangent w and tangent x
+      // between them, are the first 8 floats of the vertex.  Blend in
+      // zeros for everything but those two.
+      F32 *curElem = reinterpret_cast<F32 *>(outData);
+      __m256 v = _mm256_loadu_ps(curElem);
+      v = _mm256_blend_ps(vZero, v, 0x88);
+      _mm256_storeu_ps(curElem, v);
+
+      outData += outStride;
+   }
+}
+
+//------------------------------------------------------------------------------
+
+// Skins two batch elements at a time, one in each 128-bit lane.  Without
+// FMA the operations are performed in the same order as the SSE version,
+// so the results are identical to it.  With FMA the multiply-adds are
+// only rounded once, which is slightly more accurate.
+#define TS_DEFINE_BATCHED_VERT_WEIGHT_LIST(name, attribs, madd)                                          \
+attribs                                                                                                  \
+void name(const MatrixF &mat,                                                                            \
+          const dsize_t count,                                                                           \
+          const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch,                             \
+          U8 * const __restrict outPtr,                                                                  \
+          const dsize_t outStride)                                                                       \
+{                                                                                                        \
+   MatrixF transMat;                                                                                     \
+   mat.transposeTo(transMat);                                                                            \
+                                                                                                         \
+   /* The matrix columns, in both lanes. */                                                              \
+   const __m128 col0 = _mm_loadu_ps(&transMat[0]);                                                       \
+   const __m128 col1 = _mm_loadu_ps(&transMat[4]);                                                       \
+   const __m128 col2 = _mm_loadu_ps(&transMat[8]);                                                       \
+   const __m128 col3 = _mm_loadu_ps(&transMat[12]);                                                      \
+   const __m256 mat0 = _mm256_broadcast_ps(&col0);                                                       \
+   const __m256 mat1 = _mm256_broadcast_ps(&col1);                                                       \
+   const __m256 mat2 = _mm256_broadcast_ps(&col2);                                                       \
+   const __m256 mat3 = _mm256_broadcast_ps(&col3);                                                       \
+                                                                                                         \
+   const __m256 wMask = _mm256_setr_ps(1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f);                   \
+                                                                                                         \
+   dsize_t i = 0;                                                                                        \
+   for(; i + 1 < count; i += 2)                                                                          \
+   {                                                                                                     \
+      const TSSkinMesh::BatchData::BatchedVertWeight &inElem0 = batch[i];                                \
+      const TSSkinMesh::BatchData::BatchedVertWeight &inElem1 = batch[i + 1];                            \
+                                                                                                         \
+      /* Both elements must accumulate into different vertices. */                                       \
+      if(inElem0.vidx == inElem1.vidx)                                                                   \
+         break;                                                                                          \
+                                                                                                         \
+      F32 *outVert0 = reinterpret_cast<F32 *>(outPtr + inElem0.vidx * outStride);                         \
+      F32 *outVert1 = reinterpret_cast<F32 *>(outPtr + inElem1.vidx * outStride);                         \
+                                                                                                         \
+      const __m256 inPos = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(inElem0.vert)),       \
+                                                _mm_load_ps(inElem1.vert), 1);                           \
+      const __m256 inNrm = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(inElem0.normal)),     \
+                                                _mm_load_ps(inElem1.normal), 1);                         \
+                                                                                                         \
+      __m256 tempPos = _mm256_mul_ps(_mm256_permute_ps(inPos, _MM_SHUFFLE(0, 0, 0, 0)), mat0);           \
+      __m256 tempNrm = _mm256_mul_ps(_mm256_permute_ps(inNrm, _MM_SHUFFLE(0, 0, 0, 0)), mat0);           \
+      tempPos = madd(_mm256_permute_ps(inPos, _MM_SHUFFLE(1, 1, 1, 1)), mat1, tempPos);                  \
+      tempNrm = madd(_mm256_permute_ps(inNrm, _MM_SHUFFLE(1, 1, 1, 1)), mat1, tempNrm);                  \
+      tempPos = madd(_mm256_permute_ps(inPos, _MM_SHUFFLE(2, 2, 2, 2)), mat2, tempPos);                  \
+      tempNrm = madd(_mm256_permute_ps(inNrm, _MM_SHUFFLE(2, 2, 2, 2)), mat2, tempNrm);                  \
+      tempPos = _mm256_add_ps(tempPos, mat3);                                                            \
+                                                                                                         \
+      /* The bone weight, with w masked off. */                                                          \
+      const __m256 weight = _mm256_mul_ps(_mm256_permute_ps(inPos, _MM_SHUFFLE(3, 3, 3, 3)), wMask);     \
+                                                                                                         \
+      const __m256 outPos = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(outVert0)),          \
+                                                 _mm_load_ps(outVert1), 1);                              \
+      const __m256 outNrm = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(outVert0 + 4)),      \
+                                                 _mm_load_ps(outVert1 + 4), 1);                          \
+                                                                                                         \
+      tempPos = madd(tempPos, weight, outPos);                                                           \
+      tempNrm = madd(tempNrm, weight, outNrm);                                                           \
+                                                                                                         \
+      _mm_store_ps(outVert0, _mm256_castps256_ps128(tempPos));                                           \
+      _mm_store_ps(outVert1, _mm256_extractf128_ps(tempPos, 1));                                         \
+      _mm_store_ps(outVert0 + 4, _mm256_castps256_ps128(tempNrm));                                       \
+      _mm_store_ps(outVert1 + 4, _mm256_extractf128_ps(tempNrm, 1));                                     \
+   }                                                                                                     \
+                                                                                                         \
+   /* The last odd element, or the rest after a repeated vertex. */                                     \
+   if(i < count)                                                                                         \
+      m_matF_x_BatchedVertWeightList_SSE(mat, count - i, batch + i, outPtr, outStride);                  \
+}
+
+TS_AVX_FUNCTION static inline __m256 _madd_AVX(const __m256 &a, const __m256 &b, const __m256 &c)
+{
+   return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+}
+
+TS_FMA_FUNCTION static inline __m256 _madd_FMA(const __m256 &a, const __m256 &b, const __m256 &c)
+{
+   return _mm256_fmadd_ps(a, b, c);
+}
+
+TS_DEFINE_BATCHED_VERT_WEIGHT_LIST(m_matF_x_BatchedVertWeightList_AVX, TS_AVX_FUNCTION, _madd_AVX)
+TS_DEFINE_BATCHED_VERT_WEIGHT_LIST(m_matF_x_BatchedVertWeightList_FMA, TS_FMA_FUNCTION, _madd_FMA)
+
+#undef TS_DEFINE_BATCHED_VERT_WEIGHT_LIST
+
+#endif // TORQUE_TS_MESH_INTRINSICS_AVX
+#endif // TORQUE_CPU_X86
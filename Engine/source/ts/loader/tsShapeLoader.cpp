@@ -29,6 +29,35 @@
 #include "materials/materialManager.h"
 #include "ts/tsShapeInstance.h"
 #include "ts/tsMaterialList.h"
+#include "console/consoleTypes.h"
+#include "core/module.h"
+
+
+MODULE_BEGIN( TSShapeLoader )
+
+   MODULE_INIT
+   {
+      Con::addVariable("$pref::TSShapeLoader::compressAnimation", TypeBool, &TSShapeLoader::smCompressAnimation,
+         "@brief Compress the node animation of imported shapes.\n"
+         "Node rotations and translations are stored as reduced, quantized keys "
+         "within $pref::TSShapeLoader::animRotationTolerance and "
+         "$pref::TSShapeLoader::animTranslationTolerance.  This is lossy, so it is off by "
+         "default and meant for shipping builds where the memory matters more than the "
+         "exact keys.  The default value is false.\n"
+         "@ingroup TSShapeConstructor\n" );
+
+      Con::addVariable("$pref::TSShapeLoader::animRotationTolerance", TypeF32, &TSShapeLoader::smAnimRotationTolerance,
+         "@brief Maximum rotation error, in radians, of compressed node animation.\n"
+         "The default value is 0.001.\n"
+         "@ingroup TSShapeConstructor\n" );
+
+      Con::addVariable("$pref::TSShapeLoader::animTranslationTolerance", TypeF32, &TSShapeLoader::smAnimTranslationTolerance,
+         "@brief Maximum translation error of compressed node animation.\n"
+         "The default value is 0.001.\n"
+         "@ingroup TSShapeConstructor\n" );
+   }
+
+MODULE_END;
 
 
 const F32 TSShapeLoader::DefaultTime = -1.0f;
@@ -37,6 +66,10 @@ const double TSShapeLoader::MaxFrameRate = 60.0f;
 const double TSShapeLoader::AppGroundFrameRate = 10.0f;
 Torque::Path TSShapeLoader::shapePath;
 
+bool TSShapeLoader::smCompressAnimation = false;
+F32 TSShapeLoader::smAnimRotationTolerance = 0.001f;
+F32 TSShapeLoader::smAnimTranslationTolerance = 0.001f;
+
 //------------------------------------------------------------------------------
 // Utility functions
 
@@ -167,6 +200,11 @@ TSShape* TSShapeLoader::generateShape(const Torque::Path& path)
    // Install the TS memory helper into a TSShape object.
    install();
 
+   // Compress node animation.  This is done after install() since
+   // loaders may still adjust node translations in computeBounds().
+   if ( smCompressAnimation )
+      compressAnimation();
+
    return shape;
 }
 
@@ -1214,6 +1252,29 @@ void TSShapeLoader::install()
    shape->init();
 }
 
+void TSShapeLoader::compressAnimation()
+{
+   if (!shape->sequences.size())
+      return;
+
+   updateProgress(Load_InitShape, "Compressing animation...");
+
+   U32 oldSize = shape->getNodeAnimationSize();
+
+   Vector<TSCompressedTracks::Stats> seqStats;
+   if (!shape->compressAnimation(smAnimRotationTolerance, smAnimTranslationTolerance, &seqStats))
+      return;
+
+   TSCompressedTracks::Stats total;
+   for (S32 i = 0; i < seqStats.size(); i++)
+      total.add(seqStats[i]);
+
+   Con::printf("Compressed node animation: %d tracks, %d of %d keys, %d -> %d bytes, "
+      "max error %g rad (avg %g), %g (avg %g)", total.numTracks, total.numKeys, total.numFrames,
+      oldSize, shape->getNodeAnimationSize(), total.maxRotationError, total.getAvgRotationError(),
+      total.maxTranslationError, total.getAvgTranslationError());
+}
+
 void TSShapeLoader::computeBounds(Box3F& bounds)
 {
    // Compute the box that encloses the model geometry
@@ -86,6 +86,16 @@ public:
    static const double MaxFrameRate;
    static const double AppGroundFrameRate;
 
+   /// Compress the node animation of imported shapes.  The compression
+   /// is lossy, so it is off by default.
+   static bool smCompressAnimation;
+
+   /// Maximum rotation error, in radians, of compressed node animation.
+   static F32 smAnimRotationTolerance;
+
+   /// Maximum translation error of compressed node animation.
+   static F32 smAnimTranslationTolerance;
+
 protected:
    // Variables used during loading that must be held until the shape is deleted
    TSShape*                      shape;
@@ -168,6 +178,7 @@ protected:
    // Shape construction
    void sortDetails();
    void install();
+   void compressAnimation();
 
 public:
    TSShapeLoader() : boundsNode(0) { }
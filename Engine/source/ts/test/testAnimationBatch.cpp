@@ -0,0 +1,123 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "ts/tsAnimationBatch.h"
+#include "ts/test/tsTestShape.h"
+#include "console/console.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestTSAnimationBatch, "TS/Animation/Batch" )
+{
+   void run()
+   {
+      const U32 numInstances = 256;
+      const U32 numFrames = 20;
+
+      MRandomLCG rand( 5678 );
+      TSShape *shape = TSTestShape::create( 80, rand );
+
+      Vector<TSShapeInstance*> instances;
+      for ( U32 i = 0; i < numInstances; i++ )
+      {
+         TSShapeInstance *inst = new TSShapeInstance( shape, false );
+
+         TSThread *thread = inst->addThread();
+         inst->setSequence( thread, 0, rand.randF() * 0.99f );
+
+         // Some of the instances play the blend on top.
+         if ( i & 1 )
+         {
+            TSThread *blend = inst->addThread();
+            inst->setSequence( blend, 1, rand.randF() * 0.99f );
+         }
+
+         instances.push_back( inst );
+      }
+
+      bool matches = true;
+      U32 serialTime = 0;
+      U32 batchTime = 0;
+
+      Vector<MatrixF> expected;
+      expected.setSize( numInstances * shape->nodes.size() );
+
+      for ( U32 frame = 0; frame < numFrames; frame++ )
+      {
+         for ( U32 i = 0; i < numInstances; i++ )
+         {
+            TSShapeInstance *inst = instances[i];
+            for ( U32 j = 0; j < inst->threadCount(); j++ )
+               inst->advanceTime( 0.033f, inst->getThread( j ) );
+         }
+
+         U32 start = Platform::getRealMilliseconds();
+         for ( U32 i = 0; i < numInstances; i++ )
+         {
+            instances[i]->animateNodeSubtrees( true );
+            dMemcpy( &expected[ i * shape->nodes.size() ], instances[i]->mNodeTransforms.address(), sizeof( MatrixF ) * shape->nodes.size() );
+         }
+         serialTime += Platform::getRealMilliseconds() - start;
+
+         start = Platform::getRealMilliseconds();
+         for ( U32 i = 0; i < numInstances; i++ )
+         {
+            instances[i]->setDirty( TSShapeInstance::TransformDirty );
+            TSAnimationBatch::queue( instances[i] );
+         }
+         TSAnimationBatch::flushQueue();
+         batchTime += Platform::getRealMilliseconds() - start;
+
+         for ( U32 i = 0; i < numInstances; i++ )
+         {
+            const F32 *a = (const F32*)&expected[ i * shape->nodes.size() ];
+            const F32 *b = (const F32*)instances[i]->mNodeTransforms.address();
+            for ( U32 k = 0; k < 16 * shape->nodes.size(); k++ )
+               matches &= mFabs( a[k] - b[k] ) < 1.0e-5f;
+         }
+      }
+
+      Con::printf( "TSAnimationBatch: %d instances x %d frames, per instance %dms, batched %dms",
+         numInstances, numFrames, serialTime, batchTime );
+
+      test( matches, "Batched node transforms differ from TSShapeInstance::animateNodes" );
+      test( TSAnimationBatch::getQueueSize() == 0, "Queue not emptied by flushQueue" );
+
+      // Deleting a queued instance must remove it from the queue.
+      TSAnimationBatch::queue( instances[0] );
+      delete instances[0];
+      instances[0] = NULL;
+      test( TSAnimationBatch::getQueueSize() == 0, "Deleted instance left in the queue" );
+
+      for ( U32 i = 1; i < numInstances; i++ )
+         delete instances[i];
+      delete shape;
+   }
+};
+
+#endif // !TORQUE_SHIPPING
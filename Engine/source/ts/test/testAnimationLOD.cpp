@@ -0,0 +1,169 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "ts/test/tsTestShape.h"
+#include "ts/tsTransform.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Lets the test throttle the node updates without
+   /// going through setDetailFromDistance().
+   class AnimLODTestInstance : public TSShapeInstance
+   {
+   public:
+
+      AnimLODTestInstance( TSShape *shape )
+         : TSShapeInstance( shape, false )
+      {
+         TSThread *thread = addThread();
+         setSequence( thread, 0, 0.0f );
+      }
+
+      void setAnimLODInterval( U32 interval ) { mAnimLODInterval = interval; }
+
+      void step( F32 dt )
+      {
+         advanceTime( dt, getThread( 0 ) );
+         setDirty( TransformDirty );
+         animate( 0 );
+      }
+   };
+
+   bool _matrixEqual( const MatrixF &a, const MatrixF &b )
+   {
+      const F32 *fa = (const F32*)a;
+      const F32 *fb = (const F32*)b;
+      for ( U32 k = 0; k < 16; k++ )
+      {
+         if ( mFabs( fa[k] - fb[k] ) > 1.0e-4f )
+            return false;
+      }
+
+      return true;
+   }
+}
+
+CreateUnitTest( TestTSAnimationLOD, "TS/Animation/LOD" )
+{
+   void run()
+   {
+      const U32 numFrames = 24;
+      const U32 interval = 3;
+      const F32 dt = 0.033f;
+
+      MRandomLCG rand( 4321 );
+      TSShape *shape = TSTestShape::create( 40, rand );
+      shape->initDetailNodes();
+      const S32 numNodes = shape->nodes.size();
+
+      TSIntegerSet required;
+      required.set( 7 );
+      required.set( 23 );
+      required.set( 38 );
+
+      // The reference animates every node at full rate.
+      AnimLODTestInstance full( shape );
+
+      // Like a server side shape.
+      AnimLODTestInstance requiredOnly( shape );
+      requiredOnly.setRequiredNodes( required );
+      requiredOnly.setAnimateRequiredNodesOnly( true );
+
+      // Like a distant client side shape.
+      AnimLODTestInstance throttled( shape );
+      throttled.setRequiredNodes( required );
+      throttled.setAnimLODInterval( interval );
+
+      const TSIntegerSet &requiredNodes = throttled.getRequiredNodes();
+      test( requiredNodes.test( 0 ), "The root is an ancestor of every required node" );
+
+      Vector<MatrixF> history;
+      history.setSize( numFrames * numNodes );
+
+      bool requiredOnlyMatches = true;
+      bool throttledMatches = true;
+
+      for ( U32 frame = 0; frame < numFrames; frame++ )
+      {
+         full.step( dt );
+         requiredOnly.step( dt );
+         throttled.step( dt );
+
+         dMemcpy( &history[ frame * numNodes ], full.mNodeTransforms.address(), sizeof( MatrixF ) * numNodes );
+
+         // The throttled shape evaluates the nodes every interval and 
+         // shows the previous evaluation on that frame.  The frames in
+         // between move from the previous towards the last evaluation.
+         const U32 step = frame % interval;
+         const U32 last = frame - step;
+         const U32 prev = last >= interval ? last - interval : 0;
+
+         for ( S32 i = requiredNodes.start(); i < numNodes; requiredNodes.next( i ) )
+         {
+            requiredOnlyMatches &= _matrixEqual( requiredOnly.mNodeTransforms[i], full.mNodeTransforms[i] );
+
+            const MatrixF &prevMat = history[ prev * numNodes + i ];
+            const MatrixF &lastMat = history[ last * numNodes + i ];
+
+            QuatF prevRot, lastRot, rot;
+            Point3F prevPos, lastPos, pos;
+            prevRot.set( prevMat );
+            lastRot.set( lastMat );
+            prevMat.getColumn( 3, &prevPos );
+            lastMat.getColumn( 3, &lastPos );
+
+            const F32 t = F32( step ) / F32( interval );
+            TSTransform::interpolate( prevRot, lastRot, t, &rot );
+            TSTransform::interpolate( prevPos, lastPos, t, &pos );
+
+            MatrixF expected;
+            TSTransform::setMatrix( rot, pos, &expected );
+            throttledMatches &= _matrixEqual( throttled.mNodeTransforms[i], expected );
+         }
+      }
+
+      test( requiredOnlyMatches, "Required nodes differ when only the required nodes are animated" );
+      test( throttledMatches, "Required nodes of a throttled shape don't follow the evaluated poses" );
+
+      // Without throttling every node matches the reference.
+      throttled.setAnimLODInterval( 1 );
+      full.step( dt );
+      throttled.step( dt );
+
+      bool fullRateMatches = true;
+      for ( S32 i = 0; i < numNodes; i++ )
+         fullRateMatches &= _matrixEqual( throttled.mNodeTransforms[i], full.mNodeTransforms[i] );
+      test( fullRateMatches, "Nodes skipped while throttled aren't updated at full rate" );
+
+      delete shape;
+   }
+};
+
+#endif // !TORQUE_SHIPPING
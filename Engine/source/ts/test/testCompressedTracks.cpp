@@ -0,0 +1,154 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "ts/tsCompressedTracks.h"
+#include "ts/test/tsTestShape.h"
+#include "math/mQuat.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Angle between two rotations, from the length of the chord between
+   /// the quaternions which is better conditioned than acos for small angles.
+   F64 getAngle( const QuatF &a, const QuatF &b )
+   {
+      F64 dot = F64( a.x ) * b.x + F64( a.y ) * b.y + F64( a.z ) * b.z + F64( a.w ) * b.w;
+      F64 s = ( dot < 0 ) ? -1.0 : 1.0;
+      F64 dx = a.x - s * b.x, dy = a.y - s * b.y, dz = a.z - s * b.z, dw = a.w - s * b.w;
+      F64 chord = mSqrt( dx * dx + dy * dy + dz * dz + dw * dw );
+      return 4.0 * mAsin( getMin( chord * 0.5, 1.0 ) );
+   }
+}
+
+CreateUnitTest( TestTSCompressedTracks, "TS/Animation/CompressedTracks" )
+{
+   void run()
+   {
+      const S32 numFrames = 61;
+      const F32 tolerance = 0.001f;
+
+      MRandomLCG rand( 2345 );
+
+      TSCompressedTracks tracks;
+      TSCompressedTracks::Stats stats;
+
+      Vector<QuatF> rotations;
+      Vector<Point3F> translations;
+      rotations.setSize( numFrames );
+      translations.setSize( numFrames );
+
+      // Smoothly varying tracks as produced by typical skeletal animation.
+      const S32 numTracks = 8;
+      for ( S32 i = 0; i < numTracks; i++ )
+      {
+         const F32 phase = rand.randF( 0.0f, M_2PI_F );
+         const F32 amplitude = rand.randF( 0.1f, 1.5f );
+         for ( S32 j = 0; j < numFrames; j++ )
+         {
+            const F32 t = F32( j ) / ( numFrames - 1 );
+            rotations[j].set( EulerF( amplitude * mSin( M_2PI_F * t + phase ), 0.5f * amplitude * t, 0.2f ) );
+            translations[j].set( 0.1f * i, amplitude * mCos( M_2PI_F * t + phase ), 2.0f * t );
+         }
+
+         tracks.addRotationTrack( rotations.address(), numFrames, tolerance, &stats );
+         tracks.addTranslationTrack( translations.address(), numFrames, tolerance, &stats );
+      }
+
+      // A constant track only needs a single key.
+      for ( S32 j = 0; j < numFrames; j++ )
+         translations[j].set( 1.0f, 2.0f, 3.0f );
+      TSCompressedTracks::Stats constStats;
+      const S32 constTrack = tracks.addTranslationTrack( translations.address(), numFrames, tolerance, &constStats );
+      test( constStats.numKeys == 1, "Constant track should be stored as a single key" );
+      test( ( tracks.getTranslation( constTrack, numFrames / 2 ) - translations[0] ).len() <= tolerance,
+         "Wrong value for constant track" );
+
+      test( stats.compressedBytes < stats.rawBytes, "Compressed tracks are larger than the keyframes" );
+      test( stats.numKeys < stats.numFrames, "No keys were removed" );
+
+      // Regenerate the tracks and check the decoded error against the tolerance.
+      MRandomLCG rand2( 2345 );
+      F64 maxRotError = 0, maxTranError = 0;
+      for ( S32 i = 0; i < numTracks; i++ )
+      {
+         const F32 phase = rand2.randF( 0.0f, M_2PI_F );
+         const F32 amplitude = rand2.randF( 0.1f, 1.5f );
+         for ( S32 j = 0; j < numFrames; j++ )
+         {
+            const F32 t = F32( j ) / ( numFrames - 1 );
+            QuatF rot( EulerF( amplitude * mSin( M_2PI_F * t + phase ), 0.5f * amplitude * t, 0.2f ) );
+            Point3F tran( 0.1f * i, amplitude * mCos( M_2PI_F * t + phase ), 2.0f * t );
+
+            QuatF decoded;
+            tracks.getRotation( i * 2, j, &decoded );
+            maxRotError = getMax( maxRotError, getAngle( rot, decoded ) );
+            maxTranError = getMax( maxTranError, F64( ( tracks.getTranslation( i * 2 + 1, j ) - tran ).len() ) );
+         }
+      }
+
+      test( maxRotError <= tolerance, "Rotation error exceeds the tolerance" );
+      test( maxTranError <= tolerance, "Translation error exceeds the tolerance" );
+
+      Con::printf( "Compressed %d keyframes to %d keys, %d -> %d bytes, max error %g rad, %g",
+         stats.numFrames, stats.numKeys, stats.rawBytes, stats.compressedBytes, maxRotError, maxTranError );
+   }
+};
+
+CreateUnitTest( TestTSUncompressAnimationScope, "TS/Animation/UncompressAnimationScope" )
+{
+   void run()
+   {
+      MRandomLCG rand( 3456 );
+      TSShape *shape = TSTestShape::create( 20, rand );
+      test( shape->compressAnimation( 0.001f, 0.001f ), "Test shape wasn't compressed" );
+
+      const U32 compressedSize = shape->getNodeAnimationSize();
+      const S32 baseRotation = shape->sequences[1].baseRotation;
+      const S32 baseTranslation = shape->sequences[1].baseTranslation;
+
+      {
+         TSShape::UncompressAnimationScope uncompressed( shape );
+         test( !shape->isAnimationCompressed(), "Animation not uncompressed within the scope" );
+         test( shape->nodeRotations.size() > 0, "No raw rotations within the scope" );
+      }
+
+      // Writers use the scope, so it must leave the shape as it was.
+      test( shape->isAnimationCompressed(), "Animation not compressed again after the scope" );
+      test( shape->nodeRotations.empty() && shape->nodeTranslations.empty(), "Raw keyframes left after the scope" );
+      test( shape->getNodeAnimationSize() == compressedSize, "Compressed tracks changed by the scope" );
+      test( shape->sequences[1].baseRotation == baseRotation &&
+            shape->sequences[1].baseTranslation == baseTranslation, "Sequence track bases changed by the scope" );
+
+      delete shape;
+   }
+};
+
+#endif // !TORQUE_SHIPPING
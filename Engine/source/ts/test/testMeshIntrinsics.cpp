@@ -0,0 +1,184 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "ts/tsMesh.h"
+#include "ts/tsMeshIntrinsics.h"
+#include "ts/arch/tsMeshIntrinsics.arch.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   typedef void (*ZeroFunction)(const dsize_t, U8 * __restrict const, const dsize_t);
+   typedef void (*SkinFunction)(const MatrixF &, const dsize_t, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict, U8 * const __restrict, const dsize_t);
+
+   /// Random skinning input for a single bone which touches
+   /// every other vertex of the output buffer.
+   struct SkinBatch
+   {
+      enum
+      {
+         NUM_VERTS = 8191,
+         NUM_ELEMENTS = ( NUM_VERTS + 1 ) / 2,
+         STRIDE = sizeof( TSMesh::__TSMeshVertexBase ),
+      };
+
+      MatrixF mBone;
+      TSSkinMesh::BatchData::BatchedVertWeight *mElements;
+      U8 *mSource;
+      U8 *mOutput;
+
+      SkinBatch()
+      {
+         MRandomLCG rand( 4321 );
+
+         mBone.set( EulerF( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ) ),
+                    Point3F( rand.randF( -5.0f, 5.0f ), rand.randF( -5.0f, 5.0f ), rand.randF( -5.0f, 5.0f ) ) );
+
+         mElements = reinterpret_cast<TSSkinMesh::BatchData::BatchedVertWeight *>( dMalloc_aligned( sizeof( TSSkinMesh::BatchData::BatchedVertWeight ) * NUM_ELEMENTS, 16 ) );
+         for ( U32 i = 0; i < NUM_ELEMENTS; i++ )
+         {
+            TSSkinMesh::BatchData::BatchedVertWeight &elem = mElements[i];
+            elem.vert.set( rand.randF( -2.0f, 2.0f ), rand.randF( -2.0f, 2.0f ), rand.randF( -2.0f, 2.0f ) );
+            elem.normal.set( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ) );
+            elem.weight = rand.randF();
+            elem.vidx = i * 2;
+         }
+
+         mSource = reinterpret_cast<U8 *>( dMalloc_aligned( NUM_VERTS * STRIDE, 16 ) );
+         mOutput = reinterpret_cast<U8 *>( dMalloc_aligned( NUM_VERTS * STRIDE, 16 ) );
+         F32 *src = reinterpret_cast<F32 *>( mSource );
+         for ( U32 i = 0; i < NUM_VERTS * STRIDE / sizeof( F32 ); i++ )
+            src[i] = rand.randF( -1.0f, 1.0f );
+      }
+
+      ~SkinBatch()
+      {
+         dFree_aligned( mElements );
+         dFree_aligned( mSource );
+         dFree_aligned( mOutput );
+      }
+
+      /// Zeroes and skins the source vertices into mOutput.
+      void run( ZeroFunction zeroFn, SkinFunction skinFn )
+      {
+         dMemcpy( mOutput, mSource, NUM_VERTS * STRIDE );
+         zeroFn( NUM_VERTS, mOutput, STRIDE );
+         skinFn( mBone, NUM_ELEMENTS, mElements, mOutput, STRIDE );
+      }
+
+      /// Returns the time in milliseconds to run the functions @a count times.
+      U32 time( ZeroFunction zeroFn, SkinFunction skinFn, U32 count )
+      {
+         const U32 start = Platform::getRealMilliseconds();
+         for ( U32 i = 0; i < count; i++ )
+            run( zeroFn, skinFn );
+         return Platform::getRealMilliseconds() - start;
+      }
+   };
+
+   bool _isNearlyEqual( const U8 *a, const U8 *b, U32 size )
+   {
+      const F32 *fa = reinterpret_cast<const F32 *>( a );
+      const F32 *fb = reinterpret_cast<const F32 *>( b );
+      for ( U32 i = 0; i < size / sizeof( F32 ); i++ )
+      {
+         if ( mFabs( fa[i] - fb[i] ) > 1.0e-5f * getMax( 1.0f, mFabs( fa[i] ) ) )
+            return false;
+      }
+      return true;
+   }
+}
+
+CreateUnitTest( TestTSMeshIntrinsics, "TS/Skinning/Intrinsics" )
+{
+   void run()
+   {
+      enum { BENCHMARK_RUNS = 200 };
+
+      SkinBatch batch;
+      const U32 size = SkinBatch::NUM_VERTS * SkinBatch::STRIDE;
+
+      Vector<U8> expected;
+      expected.setSize( size );
+      batch.run( zero_vert_normal_bulk_C, m_matF_x_BatchedVertWeightList_C );
+      dMemcpy( expected.address(), batch.mOutput, size );
+
+      Con::printf( "Skinning %d verts x %d:", SkinBatch::NUM_ELEMENTS, BENCHMARK_RUNS );
+      Con::printf( "   C: %dms", batch.time( zero_vert_normal_bulk_C, m_matF_x_BatchedVertWeightList_C, BENCHMARK_RUNS ) );
+
+#if defined(TORQUE_CPU_X86)
+      const U32 properties = Platform::SystemInfo.processor.properties;
+
+      // The C version may run with x87 extended precision, so the
+      // SIMD versions are only compared to it with a tolerance.
+      Vector<U8> expectedSSE;
+      if ( properties & CPU_PROP_SSE )
+      {
+         // The SSE zeroing multiplies by zero, which turns negative
+         // positions into negative zeros, so compare the values.
+         batch.run( zero_vert_normal_bulk_SSE, m_matF_x_BatchedVertWeightList_SSE );
+         test( _isNearlyEqual( batch.mOutput, expected.address(), size ), "SSE skinning differs from the C version" );
+         Con::printf( "   SSE: %dms", batch.time( zero_vert_normal_bulk_SSE, m_matF_x_BatchedVertWeightList_SSE, BENCHMARK_RUNS ) );
+
+         expectedSSE.setSize( size );
+         dMemcpy( expectedSSE.address(), batch.mOutput, size );
+      }
+
+#if defined(TORQUE_TS_MESH_INTRINSICS_AVX)
+      if ( properties & CPU_PROP_AVX )
+      {
+         batch.run( zero_vert_normal_bulk_AVX, m_matF_x_BatchedVertWeightList_AVX );
+         test( _isNearlyEqual( batch.mOutput, expected.address(), size ), "AVX skinning differs from the C version" );
+
+         // Without FMA the AVX kernel repeats the SSE operations, so with
+         // the same zeroing the results must be bit exact.
+         if ( !expectedSSE.empty() )
+         {
+            batch.run( zero_vert_normal_bulk_SSE, m_matF_x_BatchedVertWeightList_AVX );
+            test( dMemcmp( batch.mOutput, expectedSSE.address(), size ) == 0, "AVX skinning isn't bit exact with the SSE version" );
+         }
+
+         Con::printf( "   AVX: %dms", batch.time( zero_vert_normal_bulk_AVX, m_matF_x_BatchedVertWeightList_AVX, BENCHMARK_RUNS ) );
+      }
+
+      if ( ( properties & CPU_PROP_AVX ) && ( properties & CPU_PROP_FMA ) )
+      {
+         // Fused multiply-adds round differently.
+         batch.run( zero_vert_normal_bulk_AVX, m_matF_x_BatchedVertWeightList_FMA );
+         test( _isNearlyEqual( batch.mOutput, expected.address(), size ), "FMA skinning differs from the C version" );
+         Con::printf( "   FMA: %dms", batch.time( zero_vert_normal_bulk_AVX, m_matF_x_BatchedVertWeightList_FMA, BENCHMARK_RUNS ) );
+      }
+#endif
+#endif
+   }
+};
+
+#endif // !TORQUE_SHIPPING
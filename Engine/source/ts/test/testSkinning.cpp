@@ -0,0 +1,287 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "ts/tsMesh.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+#include "renderInstance/renderPassManager.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Skinned mesh with random vertices, each weighted to two bones.
+   class TestSkinMesh : public TSSkinMesh
+   {
+      public:
+
+         TestSkinMesh( U32 numVerts, U32 numBones, MRandomLCG &rand )
+         {
+            mVertSize = sizeof( __TSMeshVertexBase );
+
+            for ( U32 i = 0; i < numVerts; i++ )
+            {
+               batchData.initialVerts.push_back( Point3F( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( 0.0f, 2.0f ) ) );
+
+               Point3F normal( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), 1.0f );
+               normal.normalize();
+               batchData.initialNorms.push_back( normal );
+
+               tangents.push_back( Point4F( 1.0f, 0.0f, 0.0f, 1.0f ) );
+               tverts.push_back( Point2F( rand.randF(), rand.randF() ) );
+
+               const F32 w = rand.randF( 0.1f, 0.9f );
+               vertexIndex.push_back( i );
+               boneIndex.push_back( rand.randI( 0, numBones - 1 ) );
+               weight.push_back( w );
+               vertexIndex.push_back( i );
+               boneIndex.push_back( rand.randI( 0, numBones - 1 ) );
+               weight.push_back( 1.0f - w );
+            }
+
+            for ( U32 i = 0; i < numBones; i++ )
+            {
+               MatrixF xfm( EulerF( 0.0f, 0.0f, rand.randF( -1.0f, 1.0f ) ), Point3F( 0.0f, 0.0f, -rand.randF( 0.0f, 2.0f ) ) );
+               batchData.nodeIndex.push_back( i );
+               batchData.initialTransforms.push_back( xfm );
+            }
+
+            convertToAlignedMeshData();
+            createBatchData();
+         }
+
+         void queueSkin( const Vector<MatrixF> &transforms, TSVertexBufferHandle &vb ) { _queueSkin( transforms, vb ); }
+
+         static U32 getScratchSize() { return smSkinScratchSize; }
+   };
+
+   /// Vertex buffer which keeps what is written to it, so that
+   /// the uploaded skinning results can be read back.
+   class TestVertexBuffer : public GFXVertexBuffer
+   {
+      public:
+
+         Vector<U8> mData;
+
+         TestVertexBuffer( U32 numVerts, U32 vertSize )
+            : GFXVertexBuffer( NULL, numVerts, NULL, vertSize, GFXBufferTypeDynamic )
+         {
+            mData.setSize( numVerts * vertSize );
+            dMemset( mData.address(), 0, mData.size() );
+         }
+
+         virtual void lock( U32 vertexStart, U32 vertexEnd, void **vertexPtr ) { *vertexPtr = mData.address() + vertexStart * mVertexSize; }
+         virtual void unlock() {}
+         virtual void prepare() {}
+         virtual void zombify() {}
+         virtual void resurrect() {}
+   };
+
+   /// A queued skinning job and the result it should upload.
+   struct QueuedSkin
+   {
+      TestSkinMesh *mesh;
+      TSVertexBufferHandle vb;
+      U8 *expected;
+
+      QueuedSkin() : mesh( NULL ), expected( NULL ) {}
+      ~QueuedSkin() { if ( expected ) dFree_aligned( expected ); }
+
+   private:
+
+      QueuedSkin( const QueuedSkin& );
+      QueuedSkin& operator=( const QueuedSkin& );
+
+   public:
+
+      /// Queues skinning @a skinMesh with random node transforms and skins
+      /// it directly for comparison.
+      void queue( TestSkinMesh *skinMesh, U32 numBones, MRandomLCG &rand )
+      {
+         mesh = skinMesh;
+         vb = new TestVertexBuffer( mesh->mVertexData.size(), mesh->mVertexData.vertSize() );
+
+         Vector<MatrixF> nodeTransforms;
+         nodeTransforms.setSize( numBones );
+         for ( U32 j = 0; j < numBones; j++ )
+            nodeTransforms[j].set( EulerF( rand.randF( -1.0f, 1.0f ), 0.0f, rand.randF( -1.0f, 1.0f ) ), 
+                                   Point3F( rand.randF(), rand.randF(), rand.randF() ) );
+
+         Vector<MatrixF> bones;
+         bones.setSize( numBones );
+         mesh->computeBoneTransforms( nodeTransforms, bones.address() );
+
+         expected = reinterpret_cast<U8*>( dMalloc_aligned( mesh->mVertexData.mem_size(), 16 ) );
+         mesh->skinVerts( bones.address(), expected );
+
+         mesh->queueSkin( nodeTransforms, vb );
+      }
+
+      bool isUploaded() const
+      {
+         const TestVertexBuffer *testVB = static_cast<const TestVertexBuffer*>( vb.getPointer() );
+         return dMemcmp( testVB->mData.address(), expected, mesh->mVertexData.mem_size() ) == 0;
+      }
+   };
+}
+
+CreateUnitTest( TestTSSkinParallel, "TS/Skinning/Parallel" )
+{
+   enum
+   {
+      NUM_INSTANCES = 64,
+      NUM_VERTS = 4000,
+      NUM_BONES = 40,
+   };
+
+   void run()
+   {
+      MRandomLCG rand( 1234 );
+      TestSkinMesh mesh( NUM_VERTS, NUM_BONES, rand );
+
+      // Animate every instance differently.
+      Vector<MatrixF> bones;
+      bones.setSize( NUM_INSTANCES * NUM_BONES );
+
+      Vector<MatrixF> nodeTransforms;
+      nodeTransforms.setSize( NUM_BONES );
+
+      for ( U32 i = 0; i < NUM_INSTANCES; i++ )
+      {
+         for ( U32 j = 0; j < NUM_BONES; j++ )
+            nodeTransforms[j].set( EulerF( rand.randF( -1.0f, 1.0f ), 0.0f, rand.randF( -1.0f, 1.0f ) ), 
+                                   Point3F( rand.randF(), rand.randF(), rand.randF() ) );
+
+         mesh.computeBoneTransforms( nodeTransforms, bones.address() + i * NUM_BONES );
+      }
+
+      const dsize_t outputSize = mesh.mVertexData.mem_size();
+      U8 *serialOutput = reinterpret_cast<U8*>( dMalloc_aligned( outputSize * NUM_INSTANCES, 16 ) );
+      U8 *parallelOutput = reinterpret_cast<U8*>( dMalloc_aligned( outputSize * NUM_INSTANCES, 16 ) );
+
+      U32 start = Platform::getRealMilliseconds();
+      for ( U32 i = 0; i < NUM_INSTANCES; i++ )
+         mesh.skinVerts( bones.address() + i * NUM_BONES, serialOutput + i * outputSize );
+      const U32 serialTime = Platform::getRealMilliseconds() - start;
+
+      Vector<TSSkinMesh::SkinTask> tasks;
+      tasks.setSize( NUM_INSTANCES );
+      for ( U32 i = 0; i < NUM_INSTANCES; i++ )
+      {
+         tasks[i].mesh = &mesh;
+         tasks[i].boneTransforms = bones.address() + i * NUM_BONES;
+         tasks[i].output = parallelOutput + i * outputSize;
+      }
+
+      start = Platform::getRealMilliseconds();
+      TSSkinMesh::skinParallel( tasks.address(), tasks.size() );
+      const U32 parallelTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "Skinned %d instances of %d verts: serial %dms, parallel %dms", 
+         NUM_INSTANCES, NUM_VERTS, serialTime, parallelTime );
+
+      test( dMemcmp( serialOutput, parallelOutput, outputSize * NUM_INSTANCES ) == 0, 
+         "Parallel skinning results differ from serial skinning" );
+
+      dFree_aligned( serialOutput );
+      dFree_aligned( parallelOutput );
+   }
+};
+
+CreateUnitTest( TestTSSkinQueued, "TS/Skinning/Queued" )
+{
+   enum
+   {
+      NUM_BONES = 20,
+   };
+
+   void run()
+   {
+      MRandomLCG rand( 4321 );
+
+      // The render path flushes the queue from the render pass signal.
+      {
+         TestSkinMesh mesh( 500, NUM_BONES, rand );
+
+         QueuedSkin skins[3];
+         for ( U32 i = 0; i < 3; i++ )
+            skins[i].queue( &mesh, NUM_BONES, rand );
+         test( TSSkinMesh::getNumSkinJobs() == 3, "Skinning was not queued" );
+
+         RenderPassManager::getRenderSignal().trigger( NULL, NULL );
+         test( TSSkinMesh::getNumSkinJobs() == 0, "The render pass signal did not flush the queued skinning" );
+
+         bool uploaded = true;
+         for ( U32 i = 0; i < 3; i++ )
+            uploaded &= skins[i].isUploaded();
+         test( uploaded, "Queued skinning uploaded the wrong vertices" );
+
+         // computeBounds() reads the last skinned instance from mVertexData.
+         test( dMemcmp( mesh.mVertexData.address(), skins[2].expected, mesh.mVertexData.mem_size() ) == 0,
+            "The mesh vertex data does not hold the last skinned instance" );
+      }
+
+      // A larger batch has to grow the scratch buffer and goes wide.
+      {
+         TestSkinMesh mesh( 3000, NUM_BONES, rand );
+
+         const U32 numSkins = 16;
+         QueuedSkin skins[numSkins];
+         for ( U32 i = 0; i < numSkins; i++ )
+            skins[i].queue( &mesh, NUM_BONES, rand );
+
+         TSSkinMesh::flushSkinJobs();
+         test( TestSkinMesh::getScratchSize() >= numSkins * mesh.mVertexData.mem_size(), "The scratch buffer did not grow" );
+
+         bool uploaded = true;
+         for ( U32 i = 0; i < numSkins; i++ )
+            uploaded &= skins[i].isUploaded();
+         test( uploaded, "Queued skinning uploaded the wrong vertices after growing the scratch buffer" );
+      }
+
+      // Deleting a mesh drops the skinning queued for it.
+      {
+         TestSkinMesh mesh( 500, NUM_BONES, rand );
+         TestSkinMesh *doomed = new TestSkinMesh( 500, NUM_BONES, rand );
+
+         QueuedSkin kept, dropped;
+         kept.queue( &mesh, NUM_BONES, rand );
+         dropped.queue( doomed, NUM_BONES, rand );
+         test( TSSkinMesh::getNumSkinJobs() == 2, "Skinning was not queued" );
+
+         dropped.mesh = NULL;
+         delete doomed;
+         test( TSSkinMesh::getNumSkinJobs() == 1, "Deleting a mesh did not drop its queued skinning" );
+
+         TSSkinMesh::flushSkinJobs();
+         test( kept.isUploaded(), "Queued skinning uploaded the wrong vertices after a mesh was deleted" );
+      }
+   }
+};
+
+#endif // !TORQUE_SHIPPING
@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _TSTESTSHAPE_H_
+#define _TSTESTSHAPE_H_
+
+#ifndef _TSSHAPEINSTANCE_H_
+#include "ts/tsShapeInstance.h"
+#endif
+#ifndef _MRANDOM_H_
+#include "math/mRandom.h"
+#endif
+
+
+/// Helpers for building shapes in code for the TS unit tests.
+namespace TSTestShape
+{
+   inline QuatF randomQuat( MRandomLCG &rand )
+   {
+      QuatF q( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ) );
+      q.normalize();
+      return q;
+   }
+
+   /// Adds a sequence with random keys which animates the rotation of 
+   /// every @a rotStep node and the translation of every @a tranStep node.
+   inline void addSequence( TSShape *shape, U32 flags, U32 numKeys, U32 rotStep, U32 tranStep, MRandomLCG &rand )
+   {
+      shape->sequences.increment();
+      TSShape::Sequence &seq = shape->sequences.last();
+
+      seq.nameIndex = -1;
+      seq.numKeyframes = numKeys;
+      seq.duration = 1.0f;
+      seq.baseRotation = shape->nodeRotations.size();
+      seq.baseTranslation = shape->nodeTranslations.size();
+      seq.baseScale = 0;
+      seq.baseObjectState = 0;
+      seq.baseDecalState = 0;
+      seq.firstGroundFrame = 0;
+      seq.numGroundFrames = 0;
+      seq.firstTrigger = 0;
+      seq.numTriggers = 0;
+      seq.toolBegin = 0.0f;
+      seq.priority = 0;
+      seq.flags = flags;
+      seq.dirtyFlags = TSShapeInstance::TransformDirty;
+
+      for ( S32 i = 0; i < shape->nodes.size(); i++ )
+      {
+         if ( ( i % rotStep ) == 0 )
+         {
+            seq.rotationMatters.set( i );
+            for ( U32 k = 0; k < numKeys; k++ )
+            {
+               shape->nodeRotations.increment();
+               shape->nodeRotations.last().set( randomQuat( rand ) );
+            }
+         }
+
+         if ( ( i % tranStep ) == 0 )
+         {
+            seq.translationMatters.set( i );
+            for ( U32 k = 0; k < numKeys; k++ )
+               shape->nodeTranslations.push_back( Point3F( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ) ) );
+         }
+      }
+   }
+
+   /// Builds a shape with a random node hierarchy, a cyclic
+   /// sequence and a blend sequence, but no meshes.
+   inline TSShape* create( U32 numNodes, MRandomLCG &rand )
+   {
+      TSShape *shape = new TSShape;
+      shape->mFlags = 0;
+
+      for ( U32 i = 0; i < numNodes; i++ )
+      {
+         shape->nodes.increment();
+         TSShape::Node &node = shape->nodes.last();
+         node.nameIndex = -1;
+         node.parentIndex = i ? rand.randI( 0, i - 1 ) : -1;
+         node.firstObject = -1;
+         node.firstChild = -1;
+         node.nextSibling = -1;
+
+         shape->defaultRotations.increment();
+         shape->defaultRotations.last().set( randomQuat( rand ) );
+         shape->defaultTranslations.push_back( Point3F( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ) ) );
+      }
+
+      shape->subShapeFirstNode.push_back( 0 );
+      shape->subShapeNumNodes.push_back( numNodes );
+      shape->subShapeFirstObject.push_back( 0 );
+      shape->subShapeNumObjects.push_back( 0 );
+
+      TSShape::Detail detail;
+      dMemset( &detail, 0, sizeof( detail ) );
+      detail.nameIndex = -1;
+      detail.size = 1.0f;
+      shape->details.push_back( detail );
+
+      addSequence( shape, TSShape::Cyclic, 30, 1, 3, rand );
+      addSequence( shape, TSShape::Cyclic | TSShape::Blend, 10, 7, 11, rand );
+
+      return shape;
+   }
+}
+
+#endif // _TSTESTSHAPE_H_
@@ -137,6 +137,16 @@ void TSShapeInstance::animateNodes(S32 ss)
    tranBeenSet.overlap(mHandsOffNodes);
    tranBeenSet.overlap(mCallbackNodes);
 
+   // skip the nodes animation LOD doesn't need...
+   if (mUseAnimNodeMask)
+   {
+      TSIntegerSet skipNodes;
+      skipNodes.setAll(mShape->nodes.size());
+      skipNodes.takeAway(mAnimNodeMask);
+      rotBeenSet.overlap(skipNodes);
+      tranBeenSet.overlap(skipNodes);
+   }
+
    // default scale
    if (scaleCurrentlyAnimated())
       handleDefaultScale(a,b,scaleBeenSet);
@@ -194,6 +204,9 @@ void TSShapeInstance::animateNodes(S32 ss)
    // compute transforms
    for (i=a; i<b; i++)
    {
+      if (mUseAnimNodeMask && !mAnimNodeMask.test(i))
+         continue;
+
       if (!mHandsOffNodes.test(i))
          TSTransform::setMatrix(smNodeCurrentRotations[i],smNodeCurrentTranslations[i],&smNodeLocalTransforms[i]);
       else
@@ -235,6 +248,9 @@ void TSShapeInstance::animateNodes(S32 ss)
    // multiply transforms...
    for (i=a; i<b; i++)
    {
+      if (mUseAnimNodeMask && !mAnimNodeMask.test(i))
+         continue;
+
       S32 parentIdx = mShape->nodes[i].parentIndex;
       if (parentIdx < 0)
          mNodeTransforms[i] = smNodeLocalTransforms[i];
@@ -585,7 +601,7 @@ void TSShapeInstance::handleBlendSequence(TSThread * thread, S32 a, S32 b)
    for (S32 nodeIndex=start; nodeIndex<end; nodeMatters.next(nodeIndex))
    {
       // skip nodes outside of this detail
-      if (start<a || mDisableBlendNodes.test(nodeIndex))
+      if (start<a || mDisableBlendNodes.test(nodeIndex) || (mUseAnimNodeMask && !mAnimNodeMask.test(nodeIndex)))
       {
          if (thread->getSequence()->rotationMatters.test(nodeIndex))
             jrot++;
@@ -848,6 +864,9 @@ void TSShapeInstance::animate(S32 dl)
    if (ss<0)
       return;
 
+   // may dirty the transforms if nodes that were skipped are needed now
+   _updateAnimNodeMask(dl);
+
    U32 dirtyFlags = mDirtyFlags[ss];
 
    if (dirtyFlags & ThreadDirty)
@@ -855,7 +874,15 @@ void TSShapeInstance::animate(S32 dl)
 
    // animate nodes?
    if (dirtyFlags & TransformDirty)
-      animateNodes(ss);
+   {
+      if (_isAnimLODInterpolating(ss))
+         _interpolateAnimLODPose(ss);
+      else
+      {
+         animateNodes(ss);
+         _storeAnimLODPose(ss);
+      }
+   }
 
    // animate objects?
    if (dirtyFlags & VisDirty)
@@ -878,6 +905,9 @@ void TSShapeInstance::animateNodeSubtrees(bool forceFull)
       // force transforms to animate
       setDirty(TransformDirty);
 
+   // all nodes are wanted unless only the required ones are animated
+   _updateAnimNodeMask(-1);
+
    for (S32 i=0; i<mShape->subShapeNumNodes.size(); i++)
    {
       if (mDirtyFlags[i] & TransformDirty)
@@ -906,6 +936,135 @@ void TSShapeInstance::animateSubtrees(bool forceFull)
    }
 }
 
+//-------------------------------------------------------------------------------------
+// Animation LOD
+//-------------------------------------------------------------------------------------
+
+void TSShapeInstance::_updateAnimNodeMask(S32 dl)
+{
+   TSIntegerSet mask = mRequiredNodes;
+   bool useMask = mAnimateRequiredNodesOnly;
+
+   if (!useMask && mAnimLODInterval>1 && dl>=0 && dl<mShape->mDetailNodes.size())
+   {
+      // throttled shapes only evaluate what the detail level needs
+      useMask = true;
+      mask.overlap(mShape->mDetailNodes[dl]);
+   }
+
+   if (useMask)
+   {
+      // nodes driven or read by code are always needed
+      TSIntegerSet codeNodes = mHandsOffNodes;
+      codeNodes.overlap(mCallbackNodes);
+      for (S32 i=codeNodes.start(); i<mShape->nodes.size(); codeNodes.next(i))
+         mShape->addNodeAndAncestors(i,mask);
+   }
+
+   // nodes that were skipped so far have stale transforms
+   bool grew;
+   if (!useMask)
+      grew = mUseAnimNodeMask;
+   else if (!mUseAnimNodeMask)
+      grew = false;
+   else
+   {
+      TSIntegerSet added = mask;
+      added.takeAway(mAnimNodeMask);
+      grew = added.start() < MAX_TS_SET_SIZE;
+   }
+
+   mUseAnimNodeMask = useMask;
+   if (useMask)
+      mAnimNodeMask = mask;
+
+   if (grew)
+   {
+      setDirty(TransformDirty);
+      mAnimLODPoseSubShape = -1;
+   }
+}
+
+void TSShapeInstance::_storeAnimLODPose(S32 ss)
+{
+   if (mAnimLODInterval<=1)
+   {
+      mAnimLODPoseSubShape = -1;
+      return;
+   }
+
+   S32 numNodes = mShape->nodes.size();
+   mAnimLODRotations.setSize(numNodes*2);
+   mAnimLODTranslations.setSize(numNodes*2);
+
+   QuatF * prevRot = mAnimLODRotations.address();
+   QuatF * lastRot = prevRot + numNodes;
+   Point3F * prevTran = mAnimLODTranslations.address();
+   Point3F * lastTran = prevTran + numNodes;
+
+   // The frame after an update shows the previous pose and the following
+   // frames move towards the new one, so the motion stays continuous at
+   // the cost of lagging one interval behind.
+   bool havePrevious = (mAnimLODPoseSubShape==ss);
+
+   S32 a = mShape->subShapeFirstNode[ss];
+   S32 b = a + mShape->subShapeNumNodes[ss];
+   for (S32 i=a; i<b; i++)
+   {
+      if (mUseAnimNodeMask && !mAnimNodeMask.test(i))
+         continue;
+
+      MatrixF & mat = mNodeTransforms[i];
+      if (havePrevious)
+      {
+         prevRot[i] = lastRot[i];
+         prevTran[i] = lastTran[i];
+      }
+
+      lastRot[i].set(mat);
+      mat.getColumn(3,&lastTran[i]);
+
+      if (havePrevious)
+         TSTransform::setMatrix(prevRot[i],prevTran[i],&mat);
+      else
+      {
+         prevRot[i] = lastRot[i];
+         prevTran[i] = lastTran[i];
+      }
+   }
+
+   mAnimLODPoseSubShape = ss;
+   mAnimLODStep = 0;
+}
+
+void TSShapeInstance::_interpolateAnimLODPose(S32 ss)
+{
+   PROFILE_SCOPE( TSShapeInstance_interpolateAnimLODPose );
+
+   mAnimLODStep++;
+   F32 t = F32(mAnimLODStep) / F32(mAnimLODInterval);
+
+   S32 numNodes = mShape->nodes.size();
+   const QuatF * prevRot = mAnimLODRotations.address();
+   const QuatF * lastRot = prevRot + numNodes;
+   const Point3F * prevTran = mAnimLODTranslations.address();
+   const Point3F * lastTran = prevTran + numNodes;
+
+   S32 a = mShape->subShapeFirstNode[ss];
+   S32 b = a + mShape->subShapeNumNodes[ss];
+   for (S32 i=a; i<b; i++)
+   {
+      if (mUseAnimNodeMask && !mAnimNodeMask.test(i))
+         continue;
+
+      QuatF q;
+      Point3F p;
+      TSTransform::interpolate(prevRot[i],lastRot[i],t,&q);
+      TSTransform::interpolate(prevTran[i],lastTran[i],t,&p);
+      TSTransform::setMatrix(q,p,&mNodeTransforms[i]);
+   }
+}
+
 void TSShapeInstance::addPath(TSThread *gt, F32 start, F32 end, MatrixF *mat)
 {
    // never get here while in transition...
@@ -0,0 +1,558 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "ts/tsAnimationBatch.h"
+
+#include "ts/tsShapeInstance.h"
+#include "ts/tsTransform.h"
+#include "platform/profiler.h"
+
+#if defined( TORQUE_CPU_X86 )
+#include <xmmintrin.h>
+#endif
+
+
+bool TSAnimationBatch::smEnabled = true;
+
+Vector<TSShapeInstance*> TSAnimationBatch::smQueue( __FILE__, __LINE__ );
+
+TSAnimationBatch::RotationLanes TSAnimationBatch::smRotationLanes;
+TSAnimationBatch::TranslationLanes TSAnimationBatch::smTranslationLanes;
+
+Vector<QuatF> TSAnimationBatch::smRotations( __FILE__, __LINE__ );
+Vector<Point3F> TSAnimationBatch::smTranslations( __FILE__, __LINE__ );
+
+
+namespace {
+
+   struct QueueEntry
+   {
+      TSShapeInstance *inst;
+      const TSShape *shape;
+      S32 ss;
+   };
+
+   S32 QSORT_CALLBACK _compareQueueEntries( const void *e1, const void *e2 )
+   {
+      const QueueEntry *a = (const QueueEntry*)e1;
+      const QueueEntry *b = (const QueueEntry*)e2;
+
+      if ( a->shape != b->shape )
+         return ( a->shape < b->shape ) ? -1 : 1;
+
+      return a->ss - b->ss;
+   }
+
+   Vector<QueueEntry> sQueueEntries( __FILE__, __LINE__ );
+   Vector<TSShapeInstance*> sGroupInstances( __FILE__, __LINE__ );
+   Vector<TSShapeInstance*> sBatchInstances( __FILE__, __LINE__ );
+
+   inline bool _isEmpty( const TSIntegerSet &set )
+   {
+      return set.start() >= MAX_TS_SET_SIZE;
+   }
+}
+
+
+//-----------------------------------------------------------------------------
+// Lanes
+//-----------------------------------------------------------------------------
+
+void TSAnimationBatch::RotationLanes::clear()
+{
+   x1.clear(); y1.clear(); z1.clear(); w1.clear();
+   x2.clear(); y2.clear(); z2.clear(); w2.clear();
+   t.clear();
+   dest.clear();
+}
+
+void TSAnimationBatch::RotationLanes::push( const QuatF &q1, const QuatF &q2, F32 interp, U32 destIndex )
+{
+   x1.push_back( q1.x ); y1.push_back( q1.y ); z1.push_back( q1.z ); w1.push_back( q1.w );
+   x2.push_back( q2.x ); y2.push_back( q2.y ); z2.push_back( q2.z ); w2.push_back( q2.w );
+   t.push_back( interp );
+   dest.push_back( destIndex );
+}
+
+void TSAnimationBatch::TranslationLanes::clear()
+{
+   x1.clear(); y1.clear(); z1.clear();
+   x2.clear(); y2.clear(); z2.clear();
+   t.clear();
+   dest.clear();
+}
+
+void TSAnimationBatch::TranslationLanes::push( const Point3F &p1, const Point3F &p2, F32 interp, U32 destIndex )
+{
+   x1.push_back( p1.x ); y1.push_back( p1.y ); z1.push_back( p1.z );
+   x2.push_back( p2.x ); y2.push_back( p2.y ); z2.push_back( p2.z );
+   t.push_back( interp );
+   dest.push_back( destIndex );
+}
+
+//-----------------------------------------------------------------------------
+// Interpolation
+//-----------------------------------------------------------------------------
+
+#if defined( TORQUE_CPU_X86 )
+
+/// Interpolates the first @a count lanes, which must be a multiple of four.
+///
+/// This performs the operations of TSTransform::interpolate in the same
+/// order, so the results match the scalar version up to rounding.
+static void _interpolateRotations_SSE( const TSAnimationBatch::RotationLanes &lanes, U32 count, QuatF *out )
+{
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 signBit = _mm_set1_ps( -0.0f );
+   const __m128 split = _mm_set1_ps( 0.857f );
+   const __m128 lo0 = _mm_set1_ps( 0.699368f );
+   const __m128 lo1 = _mm_set1_ps( -1.819985f );
+   const __m128 lo2 = _mm_set1_ps( 2.126369f );
+   const __m128 hi0 = _mm_set1_ps( 0.454012f );
+   const __m128 hi1 = _mm_set1_ps( -1.403517f );
+   const __m128 hi2 = _mm_set1_ps( 1.949542f );
+
+   for ( U32 i = 0; i < count; i += 4 )
+   {
+      __m128 x1 = _mm_loadu_ps( lanes.x1.address() + i );
+      __m128 y1 = _mm_loadu_ps( lanes.y1.address() + i );
+      __m128 z1 = _mm_loadu_ps( lanes.z1.address() + i );
+      __m128 w1 = _mm_loadu_ps( lanes.w1.address() + i );
+      const __m128 x2 = _mm_loadu_ps( lanes.x2.address() + i );
+      const __m128 y2 = _mm_loadu_ps( lanes.y2.address() + i );
+      const __m128 z2 = _mm_loadu_ps( lanes.z2.address() + i );
+      const __m128 w2 = _mm_loadu_ps( lanes.w2.address() + i );
+      const __m128 t = _mm_loadu_ps( lanes.t.address() + i );
+
+      // Flip the first quat where the quats are further than 90 degrees apart.
+      __m128 dot = _mm_mul_ps( x1, x2 );
+      dot = _mm_add_ps( dot, _mm_mul_ps( y1, y2 ) );
+      dot = _mm_add_ps( dot, _mm_mul_ps( z1, z2 ) );
+      dot = _mm_add_ps( dot, _mm_mul_ps( w1, w2 ) );
+
+      const __m128 flip = _mm_and_ps( _mm_cmplt_ps( dot, zero ), signBit );
+      x1 = _mm_xor_ps( x1, flip );
+      y1 = _mm_xor_ps( y1, flip );
+      z1 = _mm_xor_ps( z1, flip );
+      w1 = _mm_xor_ps( w1, flip );
+
+      x1 = _mm_add_ps( x1, _mm_mul_ps( t, _mm_sub_ps( x2, x1 ) ) );
+      y1 = _mm_add_ps( y1, _mm_mul_ps( t, _mm_sub_ps( y2, y1 ) ) );
+      z1 = _mm_add_ps( z1, _mm_mul_ps( t, _mm_sub_ps( z2, z1 ) ) );
+      w1 = _mm_add_ps( w1, _mm_mul_ps( t, _mm_sub_ps( w2, w1 ) ) );
+
+      __m128 dist2 = _mm_mul_ps( x1, x1 );
+      dist2 = _mm_add_ps( dist2, _mm_mul_ps( y1, y1 ) );
+      dist2 = _mm_add_ps( dist2, _mm_mul_ps( z1, z1 ) );
+      dist2 = _mm_add_ps( dist2, _mm_mul_ps( w1, w1 ) );
+
+      // Evaluate both halves of the 1/sqrt polynomial and select per lane.
+      const __m128 lo = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( lo0, dist2 ), lo1 ), dist2 ), lo2 );
+      const __m128 hi = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( hi0, dist2 ), hi1 ), dist2 ), hi2 );
+      const __m128 useLo = _mm_cmplt_ps( dist2, split );
+      const __m128 oneOverL = _mm_or_ps( _mm_and_ps( useLo, lo ), _mm_andnot_ps( useLo, hi ) );
+
+      x1 = _mm_mul_ps( x1, oneOverL );
+      y1 = _mm_mul_ps( y1, oneOverL );
+      z1 = _mm_mul_ps( z1, oneOverL );
+      w1 = _mm_mul_ps( w1, oneOverL );
+
+      _MM_TRANSPOSE4_PS( x1, y1, z1, w1 );
+
+      const U32 *dest = lanes.dest.address() + i;
+      _mm_storeu_ps( &out[ dest[0] ].x, x1 );
+      _mm_storeu_ps( &out[ dest[1] ].x, y1 );
+      _mm_storeu_ps( &out[ dest[2] ].x, z1 );
+      _mm_storeu_ps( &out[ dest[3] ].x, w1 );
+   }
+}
+
+/// Interpolates the first @a count lanes, which must be a multiple of four.
+static void _interpolateTranslations_SSE( const TSAnimationBatch::TranslationLanes &lanes, U32 count, Point3F *out )
+{
+   F32 result[3][4];
+
+   for ( U32 i = 0; i < count; i += 4 )
+   {
+      const __m128 t = _mm_loadu_ps( lanes.t.address() + i );
+
+      const __m128 x1 = _mm_loadu_ps( lanes.x1.address() + i );
+      const __m128 y1 = _mm_loadu_ps( lanes.y1.address() + i );
+      const __m128 z1 = _mm_loadu_ps( lanes.z1.address() + i );
+
+      _mm_storeu_ps( result[0], _mm_add_ps( x1, _mm_mul_ps( t, _mm_sub_ps( _mm_loadu_ps( lanes.x2.address() + i ), x1 ) ) ) );
+      _mm_storeu_ps( result[1], _mm_add_ps( y1, _mm_mul_ps( t, _mm_sub_ps( _mm_loadu_ps( lanes.y2.address() + i ), y1 ) ) ) );
+      _mm_storeu_ps( result[2], _mm_add_ps( z1, _mm_mul_ps( t, _mm_sub_ps( _mm_loadu_ps( lanes.z2.address() + i ), z1 ) ) ) );
+
+      const U32 *dest = lanes.dest.address() + i;
+      for ( U32 k = 0; k < 4; k++ )
+         out[ dest[k] ].set( result[0][k], result[1][k], result[2][k] );
+   }
+}
+
+#endif // TORQUE_CPU_X86
+
+void TSAnimationBatch::interpolate( const RotationLanes &lanes, QuatF *out )
+{
+   PROFILE_SCOPE( TSAnimationBatch_interpolateRotations );
+
+   const U32 count = lanes.size();
+   U32 i = 0;
+
+#if defined( TORQUE_CPU_X86 )
+   if ( Platform::SystemInfo.processor.properties & CPU_PROP_SSE )
+   {
+      i = count & ~3;
+      _interpolateRotations_SSE( lanes, i, out );
+   }
+#endif
+
+   for ( ; i < count; i++ )
+   {
+      const QuatF q1( lanes.x1[i], lanes.y1[i], lanes.z1[i], lanes.w1[i] );
+      const QuatF q2( lanes.x2[i], lanes.y2[i], lanes.z2[i], lanes.w2[i] );
+      TSTransform::interpolate( q1, q2, lanes.t[i], &out[ lanes.dest[i] ] );
+   }
+}
+
+void TSAnimationBatch::interpolate( const TranslationLanes &lanes, Point3F *out )
+{
+   PROFILE_SCOPE( TSAnimationBatch_interpolateTranslations );
+
+   const U32 count = lanes.size();
+   U32 i = 0;
+
+#if defined( TORQUE_CPU_X86 )
+   if ( Platform::SystemInfo.processor.properties & CPU_PROP_SSE )
+   {
+      i = count & ~3;
+      _interpolateTranslations_SSE( lanes, i, out );
+   }
+#endif
+
+   for ( ; i < count; i++ )
+   {
+      const Point3F p1( lanes.x1[i], lanes.y1[i], lanes.z1[i] );
+      const Point3F p2( lanes.x2[i], lanes.y2[i], lanes.z2[i] );
+      TSTransform::interpolate( p1, p2, lanes.t[i], &out[ lanes.dest[i] ] );
+   }
+}
+
+//-----------------------------------------------------------------------------
+// Queue
+//-----------------------------------------------------------------------------
+
+void TSAnimationBatch::queue( TSShapeInstance *inst )
+{
+   if ( !smEnabled || inst->mAnimationQueued )
+      return;
+
+   inst->mAnimationQueued = true;
+   smQueue.push_back( inst );
+}
+
+void TSAnimationBatch::dequeue( TSShapeInstance *inst )
+{
+   if ( !inst->mAnimationQueued )
+      return;
+
+   smQueue.remove( inst );
+   inst->mAnimationQueued = false;
+}
+
+void TSAnimationBatch::flushQueue()
+{
+   if ( smQueue.empty() )
+      return;
+
+   PROFILE_SCOPE( TSAnimationBatch_flushQueue );
+
+   // Only the subshape of the current detail level is animated, instances
+   // which change detail before they're rendered animate the new subshape
+   // in TSShapeInstance::animate as usual.
+   sQueueEntries.clear();
+   for ( U32 i = 0; i < smQueue.size(); i++ )
+   {
+      TSShapeInstance *inst = smQueue[i];
+      inst->mAnimationQueued = false;
+
+      const S32 dl = inst->getCurrentDetail();
+      if ( dl < 0 || dl >= inst->mShape->details.size() )
+         continue;
+
+      const S32 ss = inst->mShape->details[dl].subShapeNum;
+      if ( ss < 0 )
+         continue;
+
+      // Instances throttled by animation LOD interpolate in animate() on
+      // the frames between their updates.
+      inst->_updateAnimNodeMask( dl );
+      if (  !( inst->mDirtyFlags[ss] & TSShapeInstance::TransformDirty ) ||
+            inst->_isAnimLODInterpolating( ss ) )
+         continue;
+
+      sQueueEntries.increment();
+      sQueueEntries.last().inst = inst;
+      sQueueEntries.last().shape = inst->mShape;
+      sQueueEntries.last().ss = ss;
+   }
+   smQueue.clear();
+
+   dQsort( sQueueEntries.address(), sQueueEntries.size(), sizeof( QueueEntry ), _compareQueueEntries );
+
+   for ( U32 start = 0; start < sQueueEntries.size(); )
+   {
+      const QueueEntry &first = sQueueEntries[start];
+
+      sGroupInstances.clear();
+      U32 end = start;
+      for ( ; end < sQueueEntries.size(); end++ )
+      {
+         if ( sQueueEntries[end].shape != first.shape || sQueueEntries[end].ss != first.ss )
+            break;
+         sGroupInstances.push_back( sQueueEntries[end].inst );
+      }
+
+      animateNodes( sGroupInstances.address(), sGroupInstances.size(), first.ss );
+      start = end;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// Animation
+//-----------------------------------------------------------------------------
+
+bool TSAnimationBatch::canBatch( TSShapeInstance *inst )
+{
+   return   inst->mShape->nodes.size() &&
+            inst->mThreadList.size() < 0x8000 &&
+            !inst->inTransition() &&
+            !inst->scaleCurrentlyAnimated() &&
+            inst->mNodeCallbacks.empty() &&
+            _isEmpty( inst->mCallbackNodes ) &&
+            _isEmpty( inst->mHandsOffNodes ) &&
+            _isEmpty( inst->mMaskRotationNodes ) &&
+            _isEmpty( inst->mMaskPosXNodes ) &&
+            _isEmpty( inst->mMaskPosYNodes ) &&
+            _isEmpty( inst->mMaskPosZNodes );
+}
+
+void TSAnimationBatch::_updateNodeSources( TSShapeInstance *inst, S32 ss )
+{
+   const TSShape *shape = inst->mShape;
+   const Vector<TSThread*> &threads = inst->mThreadList;
+
+   // Blend threads are sorted after the others.
+   S32 firstBlend = 0;
+   while ( firstBlend < threads.size() && !threads[firstBlend]->getSequence()->isBlend() )
+      firstBlend++;
+
+   // The sources only change with the sequences of the non-blend threads.
+   Vector<S32> &key = inst->mBatchSourceKey;
+   bool valid =   key.size() == firstBlend + 3 &&
+                  key[0] == ss &&
+                  key[1] == shape->nodes.size() &&
+                  key[2] == shape->sequences.size();
+   for ( S32 i = 0; valid && i < firstBlend; i++ )
+      valid = ( key[i + 3] == threads[i]->sequence );
+
+   if ( valid )
+      return;
+
+   key.setSize( firstBlend + 3 );
+   key[0] = ss;
+   key[1] = shape->nodes.size();
+   key[2] = shape->sequences.size();
+   for ( S32 i = 0; i < firstBlend; i++ )
+      key[i + 3] = threads[i]->sequence;
+
+   const S32 a = shape->subShapeFirstNode[ss];
+   const S32 b = a + shape->subShapeNumNodes[ss];
+
+   Vector<S32> &sources = inst->mBatchNodeSources;
+   sources.setSize( ( b - a ) * 2 );
+   for ( S32 i = 0; i < sources.size(); i++ )
+      sources[i] = -1;
+
+   // As in TSShapeInstance::animateNodes, the first thread which animates
+   // a node wins and j counts the tracks of the sequence.
+   for ( S32 i = 0; i < firstBlend; i++ )
+   {
+      const TSShape::Sequence *seq = threads[i]->getSequence();
+
+      S32 j = 0;
+      for ( S32 nodeIndex = seq->rotationMatters.start(); nodeIndex < b; seq->rotationMatters.next( nodeIndex ), j++ )
+      {
+         if ( nodeIndex >= a && sources[ ( nodeIndex - a ) * 2 ] < 0 )
+            sources[ ( nodeIndex - a ) * 2 ] = ( i << 16 ) | j;
+      }
+
+      j = 0;
+      for ( S32 nodeIndex = seq->translationMatters.start(); nodeIndex < b; seq->translationMatters.next( nodeIndex ), j++ )
+      {
+         if ( nodeIndex >= a && sources[ ( nodeIndex - a ) * 2 + 1 ] < 0 )
+            sources[ ( nodeIndex - a ) * 2 + 1 ] = ( i << 16 ) | j;
+      }
+   }
+}
+
+void TSAnimationBatch::animateNodes( TSShapeInstance *const *instances, U32 count, S32 ss )
+{
+   PROFILE_SCOPE( TSAnimationBatch_animateNodes );
+
+   if ( !count )
+      return;
+
+   const TSShape *shape = instances[0]->mShape;
+   const S32 a = shape->subShapeFirstNode[ss];
+   const S32 numNodes = shape->subShapeNumNodes[ss];
+
+   // Animate the instances the batch doesn't handle on their own
+   // and pack the rest at the front of the group.
+   Vector<TSShapeInstance*> &batched = sBatchInstances;
+   batched.clear();
+
+   for ( U32 k = 0; k < count; k++ )
+   {
+      TSShapeInstance *inst = instances[k];
+      AssertFatal( inst->mShape == shape, "TSAnimationBatch::animateNodes - Instances must share the same shape!" );
+
+      if ( inst->mDirtyFlags[ss] & TSShapeInstance::ThreadDirty )
+         inst->sortThreads();
+
+      if ( !canBatch( inst ) )
+      {
+         inst->animateNodes( ss );
+         inst->_storeAnimLODPose( ss );
+         inst->mDirtyFlags[ss] &= ~TSShapeInstance::TransformDirty;
+         continue;
+      }
+
+      _updateNodeSources( inst, ss );
+      batched.push_back( inst );
+   }
+
+   if ( batched.empty() )
+      return;
+
+   smRotations.setSize( batched.size() * numNodes );
+   smTranslations.setSize( batched.size() * numNodes );
+   smRotationLanes.clear();
+   smTranslationLanes.clear();
+
+   // Gather the keyframes of all animated nodes into the lanes and
+   // write the default transforms of the others directly.
+   {
+      PROFILE_SCOPE( TSAnimationBatch_gather );
+
+      for ( U32 k = 0; k < batched.size(); k++ )
+      {
+         const TSShapeInstance *inst = batched[k];
+         const S32 *sources = inst->mBatchNodeSources.address();
+         const U32 base = k * numNodes;
+
+         for ( S32 i = 0; i < numNodes; i++ )
+         {
+            // Skip the nodes animation LOD doesn't need.
+            if ( inst->mUseAnimNodeMask && !inst->mAnimNodeMask.test( a + i ) )
+               continue;
+
+            const S32 rotSource = sources[ i * 2 ];
+            if ( rotSource < 0 )
+               shape->defaultRotations[ a + i ].getQuatF( &smRotations[ base + i ] );
+            else
+            {
+               const TSThread *th = inst->mThreadList[ rotSource >> 16 ];
+               QuatF q1, q2;
+               shape->getRotation( *th->getSequence(), th->keyNum1, rotSource & 0xFFFF, &q1 );
+               shape->getRotation( *th->getSequence(), th->keyNum2, rotSource & 0xFFFF, &q2 );
+               smRotationLanes.push( q1, q2, th->keyPos, base + i );
+            }
+
+            const S32 tranSource = sources[ i * 2 + 1 ];
+            if ( tranSource < 0 )
+               smTranslations[ base + i ] = shape->defaultTranslations[ a + i ];
+            else
+            {
+               const TSThread *th = inst->mThreadList[ tranSource >> 16 ];
+               const Point3F &p1 = shape->getTranslation( *th->getSequence(), th->keyNum1, tranSource & 0xFFFF );
+               const Point3F &p2 = shape->getTranslation( *th->getSequence(), th->keyNum2, tranSource & 0xFFFF );
+               smTranslationLanes.push( p1, p2, th->keyPos, base + i );
+            }
+         }
+      }
+   }
+
+   interpolate( smRotationLanes, smRotations.address() );
+   interpolate( smTranslationLanes, smTranslations.address() );
+
+   for ( U32 k = 0; k < batched.size(); k++ )
+   {
+      _finishInstance( batched[k], ss, smRotations.address() + k * numNodes, smTranslations.address() + k * numNodes );
+      batched[k]->_storeAnimLODPose( ss );
+      batched[k]->mDirtyFlags[ss] &= ~TSShapeInstance::TransformDirty;
+   }
+}
+
+void TSAnimationBatch::_finishInstance( TSShapeInstance *inst, S32 ss, const QuatF *rotations, const Point3F *translations )
+{
+   const TSShape *shape = inst->mShape;
+   const S32 a = shape->subShapeFirstNode[ss];
+   const S32 b = a + shape->subShapeNumNodes[ss];
+
+   inst->mNodeTransforms.setSize( shape->nodes.size() );
+   TSShapeInstance::smNodeLocalTransforms.setSize( shape->nodes.size() );
+   TSShapeInstance::smNodeLocalTransformDirty.clearAll();
+
+   const bool useMask = inst->mUseAnimNodeMask;
+   const TSIntegerSet &mask = inst->mAnimNodeMask;
+
+   MatrixF *local = TSShapeInstance::smNodeLocalTransforms.address();
+   for ( S32 i = a; i < b; i++ )
+   {
+      if ( !useMask || mask.test( i ) )
+         TSTransform::setMatrix( rotations[ i - a ], translations[ i - a ], &local[i] );
+   }
+
+   // Blend sequences are applied on top of the local transforms.
+   for ( S32 i = 0; i < inst->mThreadList.size(); i++ )
+   {
+      TSThread *th = inst->mThreadList[i];
+      if ( th->getSequence()->isBlend() && !th->blendDisabled )
+         inst->handleBlendSequence( th, a, b );
+   }
+
+   MatrixF *transforms = inst->mNodeTransforms.address();
+   for ( S32 i = a; i < b; i++ )
+   {
+      if ( useMask && !mask.test( i ) )
+         continue;
+
+      const S32 parentIdx = shape->nodes[i].parentIndex;
+      if ( parentIdx < 0 )
+         transforms[i] = local[i];
+      else
+         transforms[i].mul( transforms[ parentIdx ], local[i] );
+   }
+}
@@ -0,0 +1,138 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _TSANIMATIONBATCH_H_
+#define _TSANIMATIONBATCH_H_
+
+#ifndef _MMATH_H_
+#include "math/mMath.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class TSShapeInstance;
+
+
+/// Animates the nodes of many instances of the same TSShape together.
+///
+/// TSShapeInstance::animateNodes walks the thread list and the node sets of
+/// every sequence for every instance and interpolates one quaternion at a
+/// time.  The batch instead caches, per instance, which thread and track
+/// drive each node, gathers the keyframe pairs of all the instances of a
+/// shape into structure of arrays form and interpolates them four at a time
+/// with SSE.  The kernel repeats the operations of animateNodes in the same
+/// order, so the results match it up to rounding; they are not guaranteed to
+/// be bit for bit identical, since the scalar path may be compiled to use x87
+/// extended precision.
+///
+/// Instances are queued with queue() as they're advanced and flushQueue()
+/// animates them grouped by shape and subshape before they're rendered.
+/// Instances using node callbacks, hands off or masked nodes, transitions or
+/// animated scale fall back to TSShapeInstance::animateNodes.
+class TSAnimationBatch
+{
+public:
+
+   /// Keyframe pairs of node rotations in structure of arrays form.
+   struct RotationLanes
+   {
+      Vector<F32> x1, y1, z1, w1;
+      Vector<F32> x2, y2, z2, w2;
+      Vector<F32> t;
+
+      /// The index in the output array of each lane.
+      Vector<U32> dest;
+
+      void clear();
+      void push( const QuatF &q1, const QuatF &q2, F32 interp, U32 destIndex );
+      U32 size() const { return dest.size(); }
+   };
+
+   /// Keyframe pairs of node translations in structure of arrays form.
+   struct TranslationLanes
+   {
+      Vector<F32> x1, y1, z1;
+      Vector<F32> x2, y2, z2;
+      Vector<F32> t;
+
+      /// The index in the output array of each lane.
+      Vector<U32> dest;
+
+      void clear();
+      void push( const Point3F &p1, const Point3F &p2, F32 interp, U32 destIndex );
+      U32 size() const { return dest.size(); }
+   };
+
+   /// Enables batching the node animation of queued instances.
+   static bool smEnabled;
+
+   /// Queues the instance to have its nodes animated by the next flushQueue().
+   static void queue( TSShapeInstance *inst );
+
+   /// Removes the instance from the queue.
+   static void dequeue( TSShapeInstance *inst );
+
+   /// Animates the nodes of the current detail level of all the queued
+   /// instances and empties the queue.
+   static void flushQueue();
+
+   /// Returns the number of queued instances.
+   static U32 getQueueSize() { return smQueue.size(); }
+
+   /// Returns true if the nodes of the instance can be animated by the batch.
+   static bool canBatch( TSShapeInstance *inst );
+
+   /// Animates the nodes of subshape @a ss for instances which all share
+   /// the same shape and clears their TransformDirty flag.
+   static void animateNodes( TSShapeInstance *const *instances, U32 count, S32 ss );
+
+   /// Interpolates the rotation lanes as TSTransform::interpolate does
+   /// and writes the results to @a out at the lane destinations.
+   static void interpolate( const RotationLanes &lanes, QuatF *out );
+
+   /// Interpolates the translation lanes as TSTransform::interpolate does
+   /// and writes the results to @a out at the lane destinations.
+   static void interpolate( const TranslationLanes &lanes, Point3F *out );
+
+protected:
+
+   static Vector<TSShapeInstance*> smQueue;
+
+   static RotationLanes smRotationLanes;
+   static TranslationLanes smTranslationLanes;
+
+   /// The node rotations and translations of the instances being animated.
+   static Vector<QuatF> smRotations;
+   static Vector<Point3F> smTranslations;
+
+   /// Rebuilds the node sources of the instance if its threads changed.
+   static void _updateNodeSources( TSShapeInstance *inst, S32 ss );
+
+   /// Builds the local transforms, applies blend sequences and
+   /// computes the node transforms of one instance of the batch.
+   static void _finishInstance( TSShapeInstance *inst, S32 ss, const QuatF *rotations, const Point3F *translations );
+};
+
+#endif // _TSANIMATIONBATCH_H_
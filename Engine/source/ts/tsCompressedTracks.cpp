@@ -0,0 +1,663 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "ts/tsCompressedTracks.h"
+
+#include "ts/tsTransform.h"
+#include "core/stream/stream.h"
+
+
+namespace
+{
+   /// Returns @a numBits bits starting at bit @a pos.
+   inline U32 readBits( const U32 *words, U32 pos, U32 numBits )
+   {
+      const U32 *w = words + ( pos >> 5 );
+      const U64 v = (U64)w[0] | ( (U64)w[1] << 32 );
+      return (U32)( v >> ( pos & 31 ) ) & ( ( 1 << numBits ) - 1 );
+   }
+
+   inline void writeBits( U32 *words, U32 pos, U32 value, U32 numBits )
+   {
+      for ( U32 i = 0; i < numBits; i++, pos++ )
+      {
+         if ( value & ( 1 << i ) )
+            words[pos >> 5] |= ( 1 << ( pos & 31 ) );
+      }
+   }
+
+   /// Returns the angle between two rotations in radians.
+   F32 getRotationError( const QuatF &a, const QuatF &b )
+   {
+      F64 qa[4] = { a.x, a.y, a.z, a.w };
+      F64 qb[4] = { b.x, b.y, b.z, b.w };
+      const F64 lenA = mSqrtD( qa[0]*qa[0] + qa[1]*qa[1] + qa[2]*qa[2] + qa[3]*qa[3] );
+      const F64 lenB = mSqrtD( qb[0]*qb[0] + qb[1]*qb[1] + qb[2]*qb[2] + qb[3]*qb[3] );
+      if ( lenA <= 0.0 || lenB <= 0.0 )
+         return M_PI_F;
+
+      // The distance between the unit quaternions gives the angle without
+      // the loss of precision acos has near zero.
+      const F64 dot = qa[0]*qb[0] + qa[1]*qb[1] + qa[2]*qb[2] + qa[3]*qb[3];
+      const F64 sign = dot < 0.0 ? -1.0 : 1.0;
+      F64 dist = 0.0;
+      for ( U32 i = 0; i < 4; i++ )
+      {
+         const F64 d = qa[i] / lenA - sign * qb[i] / lenB;
+         dist += d * d;
+      }
+      return F32( 4.0 * mAsin( getMin( mSqrtD( dist ) * 0.5, 1.0 ) ) );
+   }
+
+   F32 getFrameError( U32 numComps, const F32 *a, const F32 *b )
+   {
+      if ( numComps == 4 )
+         return getRotationError( QuatF( a[0], a[1], a[2], a[3] ), QuatF( b[0], b[1], b[2], b[3] ) );
+      return ( Point3F( a[0], a[1], a[2] ) - Point3F( b[0], b[1], b[2] ) ).len();
+   }
+
+   /// Interpolates frames the same way animateNodes interpolates keyframes.
+   void interpolateFrames( U32 numComps, const F32 *a, const F32 *b, F32 t, F32 *out )
+   {
+      if ( numComps == 4 )
+      {
+         QuatF q;
+         TSTransform::interpolate( QuatF( a[0], a[1], a[2], a[3] ), QuatF( b[0], b[1], b[2], b[3] ), t, &q );
+         out[0] = q.x;
+         out[1] = q.y;
+         out[2] = q.z;
+         out[3] = q.w;
+      }
+      else
+      {
+         Point3F p;
+         TSTransform::interpolate( Point3F( a[0], a[1], a[2] ), Point3F( b[0], b[1], b[2] ), t, &p );
+         out[0] = p.x;
+         out[1] = p.y;
+         out[2] = p.z;
+      }
+   }
+
+   /// Selects the frames to keep so that interpolating between them
+   /// rebuilds every frame within the tolerance.
+   void selectKeys( U32 numComps, const F32 *frames, S32 numFrames, F32 tolerance, Vector<bool> &keep )
+   {
+      keep.setSize( numFrames );
+      for ( S32 i = 0; i < numFrames; i++ )
+         keep[i] = false;
+      keep[0] = true;
+
+      // Constant tracks only need one key
+      bool constant = true;
+      for ( S32 i = 1; i < numFrames && constant; i++ )
+         constant = getFrameError( numComps, frames, frames + i*numComps ) <= tolerance;
+      if ( constant )
+         return;
+
+      keep[numFrames-1] = true;
+
+      // Split segments at the frame with the largest error until all
+      // frames are close enough to the interpolated keys.
+      Vector<S32> segments;
+      segments.push_back( 0 );
+      segments.push_back( numFrames-1 );
+      while ( !segments.empty() )
+      {
+         const S32 b = segments.last();
+         segments.pop_back();
+         const S32 a = segments.last();
+         segments.pop_back();
+
+         F32 maxError = 0.0f;
+         S32 maxFrame = -1;
+         for ( S32 i = a+1; i < b; i++ )
+         {
+            F32 interp[4];
+            interpolateFrames( numComps, frames + a*numComps, frames + b*numComps, F32( i - a ) / F32( b - a ), interp );
+            const F32 error = getFrameError( numComps, frames + i*numComps, interp );
+            if ( error > maxError )
+            {
+               maxError = error;
+               maxFrame = i;
+            }
+         }
+
+         if ( maxError > tolerance )
+         {
+            keep[maxFrame] = true;
+            segments.push_back( a );
+            segments.push_back( maxFrame );
+            segments.push_back( maxFrame );
+            segments.push_back( b );
+         }
+      }
+   }
+
+   /// Returns the bits needed to quantize a range with the given maximum error.
+   U32 getQuantizationBits( F32 range, F32 maxError )
+   {
+      if ( range <= 0.0f )
+         return 0;
+
+      const F64 steps = range / ( 2.0 * getMax( maxError, 1.0e-9f ) );
+      U32 bits = 1;
+      while ( bits < TSCompressedTracks::MaxComponentBits && F64( ( 1 << bits ) - 1 ) < steps )
+         bits++;
+      return bits;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void TSCompressedTracks::Stats::clear()
+{
+   numTracks = 0;
+   numFrames = 0;
+   numKeys = 0;
+   rawBytes = 0;
+   compressedBytes = 0;
+   maxRotationError = 0.0f;
+   sumRotationError = 0.0;
+   numRotationFrames = 0;
+   maxTranslationError = 0.0f;
+   sumTranslationError = 0.0;
+   numTranslationFrames = 0;
+}
+
+void TSCompressedTracks::Stats::add( const Stats &stats )
+{
+   numTracks += stats.numTracks;
+   numFrames += stats.numFrames;
+   numKeys += stats.numKeys;
+   rawBytes += stats.rawBytes;
+   compressedBytes += stats.compressedBytes;
+   maxRotationError = getMax( maxRotationError, stats.maxRotationError );
+   sumRotationError += stats.sumRotationError;
+   numRotationFrames += stats.numRotationFrames;
+   maxTranslationError = getMax( maxTranslationError, stats.maxTranslationError );
+   sumTranslationError += stats.sumTranslationError;
+   numTranslationFrames += stats.numTranslationFrames;
+}
+
+//-----------------------------------------------------------------------------
+
+TSCompressedTracks::TSCompressedTracks()
+{
+   VECTOR_SET_ASSOCIATION( mTracks );
+   VECTOR_SET_ASSOCIATION( mKeyFrames );
+   VECTOR_SET_ASSOCIATION( mBits );
+
+   clear();
+}
+
+void TSCompressedTracks::clear()
+{
+   mTracks.clear();
+   mKeyFrames.clear();
+   mBits.setSize( 1 );
+   mBits[0] = 0;
+   mNumBits = 0;
+}
+
+U32 TSCompressedTracks::getMemorySize() const
+{
+   return mTracks.size() * sizeof( Track ) +
+          mKeyFrames.size() * sizeof( U16 ) +
+          mBits.size() * sizeof( U32 );
+}
+
+S32 TSCompressedTracks::addRotationTrack( const QuatF *frames, S32 numFrames, F32 tolerance, Stats *stats )
+{
+   Vector<F32> comps;
+   comps.setSize( numFrames * 4 );
+
+   // Find the component which stays furthest from zero over the whole
+   // track.  Unless it comes close to zero it can be rebuilt from the
+   // other three without losing precision.
+   F32 minAbs[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+   for ( S32 i = 0; i < numFrames; i++ )
+   {
+      QuatF q = frames[i];
+      q.normalize();
+      comps[i*4+0] = q.x;
+      comps[i*4+1] = q.y;
+      comps[i*4+2] = q.z;
+      comps[i*4+3] = q.w;
+
+      for ( U32 j = 0; j < 4; j++ )
+         minAbs[j] = getMin( minAbs[j], mFabs( comps[i*4+j] ) );
+   }
+
+   U8 mode = 0;
+   for ( U8 j = 1; j < 4; j++ )
+   {
+      if ( minAbs[j] > minAbs[mode] )
+         mode = j;
+   }
+   if ( minAbs[mode] < 0.25f )
+      mode = RotationAllComponents;
+
+   return _addTrack( mode, comps.address(), numFrames, tolerance, stats );
+}
+
+S32 TSCompressedTracks::addTranslationTrack( const Point3F *frames, S32 numFrames, F32 tolerance, Stats *stats )
+{
+   return _addTrack( Translation, (const F32*)frames, numFrames, tolerance, stats );
+}
+
+S32 TSCompressedTracks::_addTrack( U8 mode, const F32 *frames, S32 numFrames, F32 tolerance, Stats *stats )
+{
+   AssertFatal( numFrames > 0 && numFrames <= U16_MAX, "TSCompressedTracks::_addTrack - invalid number of frames" );
+
+   const bool isRotation = ( mode != Translation );
+   const U32 numComps = isRotation ? 4 : 3;
+
+   // Half of the error is allowed for removing keys, the other
+   // half for quantizing the keys that are left.
+   const F32 quantError = isRotation ? tolerance * 0.125f : tolerance * 0.5f / mSqrt( 3.0f );
+
+   Vector<bool> keep;
+   selectKeys( numComps, frames, numFrames, tolerance * 0.5f, keep );
+
+   const S32 trackIndex = mTracks.size();
+   const U32 numKeyFramesBefore = mKeyFrames.size();
+   const U32 numBitsBefore = mNumBits;
+
+   Vector<U32> keys;
+   Vector<F32> keyComps;
+   F32 maxError = 0.0f;
+   F64 sumError = 0.0;
+
+   for ( U32 attempt = 0; ; attempt++ )
+   {
+      // Gather the components stored for each key.  Rotations which drop
+      // a component are flipped so that the dropped one is positive.
+      keys.clear();
+      keyComps.clear();
+      for ( S32 i = 0; i < numFrames; i++ )
+      {
+         if ( !keep[i] )
+            continue;
+
+         keys.push_back( i );
+         const F32 *frame = frames + i*numComps;
+         const F32 sign = ( mode < RotationAllComponents && frame[mode] < 0.0f ) ? -1.0f : 1.0f;
+         for ( U32 j = 0; j < numComps; j++ )
+         {
+            if ( j != mode )
+               keyComps.push_back( frame[j] * sign );
+         }
+      }
+
+      Track track;
+      track.bitOffset = mNumBits;
+      track.firstKeyFrame = mKeyFrames.size();
+      track.numFrames = numFrames;
+      track.numKeys = keys.size();
+      track.mode = mode;
+
+      const U32 numStored = track.getNumComponents();
+      F32 minValue[4], maxValue[4];
+      for ( U32 j = 0; j < numStored; j++ )
+      {
+         minValue[j] = maxValue[j] = keyComps[j];
+         for ( U32 k = 1; k < keys.size(); k++ )
+         {
+            minValue[j] = getMin( minValue[j], keyComps[k*numStored+j] );
+            maxValue[j] = getMax( maxValue[j], keyComps[k*numStored+j] );
+         }
+      }
+
+      // Each retry adds a bit to every component
+      track.keyBits = 0;
+      for ( U32 j = 0; j < 4; j++ )
+      {
+         track.bits[j] = 0;
+         track.bias[j] = 0.0f;
+         track.scale[j] = 0.0f;
+         if ( j >= numStored )
+            continue;
+
+         const F32 range = maxValue[j] - minValue[j];
+         U32 bits = getQuantizationBits( range, quantError );
+         if ( bits )
+            bits = getMin( bits + attempt, (U32)MaxComponentBits );
+
+         track.bits[j] = bits;
+         track.bias[j] = minValue[j];
+         track.scale[j] = bits ? range / F32( ( 1 << bits ) - 1 ) : 0.0f;
+         track.keyBits += bits;
+      }
+
+      // Pack the keys
+      if ( track.numKeys > 1 && track.numKeys < track.numFrames )
+      {
+         for ( U32 k = 0; k < keys.size(); k++ )
+            mKeyFrames.push_back( (U16)keys[k] );
+      }
+
+      mNumBits += track.numKeys * track.keyBits;
+      mBits.setSize( ( mNumBits + 31 ) / 32 + 1 );
+      for ( U32 i = ( numBitsBefore + 31 ) / 32; i < mBits.size(); i++ )
+         mBits[i] = 0;
+      if ( numBitsBefore & 31 )
+         mBits[numBitsBefore / 32] &= ( 1 << ( numBitsBefore & 31 ) ) - 1;
+
+      U32 pos = track.bitOffset;
+      for ( U32 k = 0; k < keys.size(); k++ )
+      {
+         for ( U32 j = 0; j < numStored; j++ )
+         {
+            if ( !track.bits[j] )
+               continue;
+
+            const F32 maxQ = F32( ( 1 << track.bits[j] ) - 1 );
+            F32 q = ( keyComps[k*numStored+j] - track.bias[j] ) / track.scale[j];
+            q = mClampF( mFloor( q + 0.5f ), 0.0f, maxQ );
+            writeBits( mBits.address(), pos, (U32)q, track.bits[j] );
+            pos += track.bits[j];
+         }
+      }
+
+      mTracks.push_back( track );
+
+      // Measure the error of the decoded track
+      maxError = 0.0f;
+      sumError = 0.0;
+      for ( S32 i = 0; i < numFrames; i++ )
+      {
+         F32 decoded[4];
+         if ( isRotation )
+         {
+            QuatF q;
+            getRotation( trackIndex, i, &q );
+            decoded[0] = q.x;
+            decoded[1] = q.y;
+            decoded[2] = q.z;
+            decoded[3] = q.w;
+         }
+         else
+         {
+            const Point3F p = getTranslation( trackIndex, i );
+            decoded[0] = p.x;
+            decoded[1] = p.y;
+            decoded[2] = p.z;
+         }
+
+         const F32 error = getFrameError( numComps, frames + i*numComps, decoded );
+         maxError = getMax( maxError, error );
+         sumError += error;
+      }
+
+      bool atMaxBits = true;
+      for ( U32 j = 0; j < numStored; j++ )
+         atMaxBits &= ( track.bits[j] == 0 || track.bits[j] == MaxComponentBits );
+
+      if ( maxError <= tolerance )
+         break;
+
+      if ( atMaxBits )
+      {
+         // Keep every frame if quantizing the reduced keys can't meet the
+         // tolerance, and accept the result if that doesn't either.
+         bool keptAll = true;
+         for ( S32 i = 0; i < numFrames; i++ )
+            keptAll &= keep[i];
+         if ( keptAll )
+            break;
+
+         for ( S32 i = 0; i < numFrames; i++ )
+            keep[i] = true;
+         attempt = U32( -1 );
+      }
+
+      // Undo the track and try again
+      mTracks.pop_back();
+      mKeyFrames.setSize( numKeyFramesBefore );
+      mNumBits = numBitsBefore;
+      mBits.setSize( ( mNumBits + 31 ) / 32 + 1 );
+   }
+
+   if ( stats )
+   {
+      const Track &track = mTracks[trackIndex];
+
+      stats->numTracks++;
+      stats->numFrames += numFrames;
+      stats->numKeys += track.numKeys;
+      stats->rawBytes += numFrames * ( isRotation ? sizeof( Quat16 ) : sizeof( Point3F ) );
+      stats->compressedBytes += sizeof( Track ) + ( mKeyFrames.size() - numKeyFramesBefore ) * sizeof( U16 ) +
+                                ( track.numKeys * track.keyBits + 7 ) / 8;
+
+      if ( isRotation )
+      {
+         stats->maxRotationError = getMax( stats->maxRotationError, maxError );
+         stats->sumRotationError += sumError;
+         stats->numRotationFrames += numFrames;
+      }
+      else
+      {
+         stats->maxTranslationError = getMax( stats->maxTranslationError, maxError );
+         stats->sumTranslationError += sumError;
+         stats->numTranslationFrames += numFrames;
+      }
+   }
+
+   return trackIndex;
+}
+
+//-----------------------------------------------------------------------------
+
+void TSCompressedTracks::_findKeys( const Track &track, S32 keyframe, U32 &key0, U32 &key1, F32 &t ) const
+{
+   AssertFatal( keyframe >= 0 && keyframe < track.numFrames, "TSCompressedTracks::_findKeys - keyframe out of range" );
+
+   t = 0.0f;
+   if ( track.numKeys == track.numFrames )
+   {
+      key0 = key1 = keyframe;
+      return;
+   }
+   if ( track.numKeys == 1 )
+   {
+      key0 = key1 = 0;
+      return;
+   }
+
+   // Find the last key at or before the keyframe
+   const U16 *frames = mKeyFrames.address() + track.firstKeyFrame;
+   U32 lo = 0;
+   U32 hi = track.numKeys - 1;
+   while ( hi - lo > 1 )
+   {
+      const U32 mid = ( lo + hi ) / 2;
+      if ( frames[mid] <= keyframe )
+         lo = mid;
+      else
+         hi = mid;
+   }
+
+   if ( frames[lo] == keyframe )
+      key0 = key1 = lo;
+   else if ( frames[hi] == keyframe )
+      key0 = key1 = hi;
+   else
+   {
+      key0 = lo;
+      key1 = hi;
+      t = F32( keyframe - frames[lo] ) / F32( frames[hi] - frames[lo] );
+   }
+}
+
+void TSCompressedTracks::_decodeKey( const Track &track, U32 key, F32 *out ) const
+{
+   U32 pos = track.bitOffset + key * track.keyBits;
+   const U32 numStored = track.getNumComponents();
+   for ( U32 j = 0; j < numStored; j++ )
+   {
+      out[j] = track.bias[j];
+      if ( track.bits[j] )
+      {
+         out[j] += F32( readBits( mBits.address(), pos, track.bits[j] ) ) * track.scale[j];
+         pos += track.bits[j];
+      }
+   }
+}
+
+void TSCompressedTracks::_buildRotation( const Track &track, const F32 *comps, QuatF *quat )
+{
+   F32 *q = (F32*)quat;
+   if ( track.mode == RotationAllComponents )
+   {
+      q[0] = comps[0];
+      q[1] = comps[1];
+      q[2] = comps[2];
+      q[3] = comps[3];
+      quat->normalize();
+      return;
+   }
+
+   F32 sum = 0.0f;
+   for ( U32 i = 0, j = 0; i < 4; i++ )
+   {
+      if ( i == track.mode )
+         continue;
+      q[i] = comps[j++];
+      sum += q[i] * q[i];
+   }
+   q[track.mode] = mSqrt( getMax( 1.0f - sum, 0.0f ) );
+}
+
+QuatF & TSCompressedTracks::getRotation( S32 trackIndex, S32 keyframe, QuatF *quat ) const
+{
+   const Track &track = mTracks[trackIndex];
+   AssertFatal( track.mode != Translation, "TSCompressedTracks::getRotation - not a rotation track" );
+
+   U32 key0, key1;
+   F32 t;
+   _findKeys( track, keyframe, key0, key1, t );
+
+   F32 comps[4];
+   _decodeKey( track, key0, comps );
+   _buildRotation( track, comps, quat );
+   if ( key1 != key0 )
+   {
+      QuatF q0 = *quat;
+      QuatF q1;
+      _decodeKey( track, key1, comps );
+      _buildRotation( track, comps, &q1 );
+      TSTransform::interpolate( q0, q1, t, quat );
+   }
+
+   return *quat;
+}
+
+Point3F TSCompressedTracks::getTranslation( S32 trackIndex, S32 keyframe ) const
+{
+   const Track &track = mTracks[trackIndex];
+   AssertFatal( track.mode == Translation, "TSCompressedTracks::getTranslation - not a translation track" );
+
+   U32 key0, key1;
+   F32 t;
+   _findKeys( track, keyframe, key0, key1, t );
+
+   Point3F p0;
+   _decodeKey( track, key0, (F32*)&p0 );
+   if ( key1 == key0 )
+      return p0;
+
+   Point3F p1, p;
+   _decodeKey( track, key1, (F32*)&p1 );
+   TSTransform::interpolate( p0, p1, t, &p );
+   return p;
+}
+
+//-----------------------------------------------------------------------------
+
+void TSCompressedTracks::read( Stream *s )
+{
+   clear();
+
+   U32 numTracks;
+   s->read( &numTracks );
+   mTracks.setSize( numTracks );
+   for ( U32 i = 0; i < numTracks; i++ )
+   {
+      Track &track = mTracks[i];
+      s->read( &track.bitOffset );
+      s->read( &track.firstKeyFrame );
+      s->read( &track.numFrames );
+      s->read( &track.numKeys );
+      s->read( &track.mode );
+      s->read( &track.keyBits );
+      for ( U32 j = 0; j < 4; j++ )
+      {
+         s->read( &track.bits[j] );
+         s->read( &track.bias[j] );
+         s->read( &track.scale[j] );
+      }
+   }
+
+   U32 numKeyFrames;
+   s->read( &numKeyFrames );
+   mKeyFrames.setSize( numKeyFrames );
+   for ( U32 i = 0; i < numKeyFrames; i++ )
+      s->read( &mKeyFrames[i] );
+
+   s->read( &mNumBits );
+   mBits.setSize( ( mNumBits + 31 ) / 32 + 1 );
+   for ( U32 i = 0; i < mBits.size() - 1; i++ )
+      s->read( &mBits[i] );
+   mBits.last() = 0;
+}
+
+void TSCompressedTracks::write( Stream *s ) const
+{
+   s->write( mTracks.size() );
+   for ( U32 i = 0; i < mTracks.size(); i++ )
+   {
+      const Track &track = mTracks[i];
+      s->write( track.bitOffset );
+      s->write( track.firstKeyFrame );
+      s->write( track.numFrames );
+      s->write( track.numKeys );
+      s->write( track.mode );
+      s->write( track.keyBits );
+      for ( U32 j = 0; j < 4; j++ )
+      {
+         s->write( track.bits[j] );
+         s->write( track.bias[j] );
+         s->write( track.scale[j] );
+      }
+   }
+
+   s->write( mKeyFrames.size() );
+   for ( U32 i = 0; i < mKeyFrames.size(); i++ )
+      s->write( mKeyFrames[i] );
+
+   // The padding word isn't written
+   s->write( mNumBits );
+   for ( U32 i = 0; i < mBits.size() - 1; i++ )
+      s->write( mBits[i] );
+}
@@ -0,0 +1,199 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _TSCOMPRESSEDTRACKS_H_
+#define _TSCOMPRESSEDTRACKS_H_
+
+#ifndef _MMATH_H_
+#include "math/mMath.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class Stream;
+
+
+/// Error bounded, bit packed storage for node rotation and translation tracks.
+///
+/// Each track is reduced to the keyframes which can't be rebuilt within the
+/// tolerance by interpolating their neighbours, the same way animateNodes
+/// interpolates between keyframes.  The remaining keys are quantized against
+/// the range of the track with as few bits per component as the tolerance
+/// allows and packed into a shared bit stream.
+///
+/// Rotations drop the component with the largest magnitude over the whole
+/// track and rebuild it from the other three when possible, so they usually
+/// need three components per key instead of the four of a Quat16.
+///
+/// Tracks are decoded on demand, one keyframe at a time.
+///
+/// @see TSShape::compressAnimation
+class TSCompressedTracks
+{
+public:
+
+   /// Error and size statistics of a set of tracks.
+   struct Stats
+   {
+      U32 numTracks;
+
+      /// Keyframes before reduction and keys stored after it.
+      U32 numFrames;
+      U32 numKeys;
+
+      /// Size of the keyframes as Quat16 and Point3F and size once compressed.
+      U32 rawBytes;
+      U32 compressedBytes;
+
+      /// Rotation errors in radians.
+      F32 maxRotationError;
+      F64 sumRotationError;
+      U32 numRotationFrames;
+
+      F32 maxTranslationError;
+      F64 sumTranslationError;
+      U32 numTranslationFrames;
+
+      Stats() { clear(); }
+
+      void clear();
+      void add( const Stats &stats );
+
+      F32 getAvgRotationError() const { return numRotationFrames ? F32( sumRotationError / numRotationFrames ) : 0.0f; }
+      F32 getAvgTranslationError() const { return numTranslationFrames ? F32( sumTranslationError / numTranslationFrames ) : 0.0f; }
+   };
+
+   enum
+   {
+      /// The largest number of bits used for a quantized component.
+      MaxComponentBits = 24,
+   };
+
+   TSCompressedTracks();
+
+   bool isEmpty() const { return mTracks.empty(); }
+   U32 getNumTracks() const { return mTracks.size(); }
+
+   void clear();
+
+   /// Compresses a rotation track and returns its index.
+   ///
+   /// @param frames The keyframes of the track.
+   /// @param numFrames The number of keyframes.
+   /// @param tolerance The largest allowed rotation error in radians.
+   /// @param stats If not NULL, the error and size of the track are added to it.
+   S32 addRotationTrack( const QuatF *frames, S32 numFrames, F32 tolerance, Stats *stats = NULL );
+
+   /// Compresses a translation track and returns its index.
+   ///
+   /// @param frames The keyframes of the track.
+   /// @param numFrames The number of keyframes.
+   /// @param tolerance The largest allowed distance from the source keyframes.
+   /// @param stats If not NULL, the error and size of the track are added to it.
+   S32 addTranslationTrack( const Point3F *frames, S32 numFrames, F32 tolerance, Stats *stats = NULL );
+
+   /// Decodes a keyframe of a rotation track.
+   QuatF & getRotation( S32 track, S32 keyframe, QuatF *quat ) const;
+
+   /// Decodes a keyframe of a translation track.
+   Point3F getTranslation( S32 track, S32 keyframe ) const;
+
+   /// Returns the number of bytes used by the tracks.
+   U32 getMemorySize() const;
+
+   /// @name IO
+   /// @{
+
+   void read( Stream *s );
+   void write( Stream *s ) const;
+   /// @}
+
+protected:
+
+   enum
+   {
+      /// Track::mode of rotations storing all four components.
+      RotationAllComponents = 4,
+
+      /// Track::mode of translations.
+      Translation = 5,
+   };
+
+   struct Track
+   {
+      /// The position of the first key in mBits.
+      U32 bitOffset;
+
+      /// The index in mKeyFrames of the keyframe number of the first key,
+      /// only used when keys were removed.
+      U32 firstKeyFrame;
+
+      /// The number of keyframes in the source track and of stored keys.
+      U16 numFrames;
+      U16 numKeys;
+
+      /// The dropped rotation component, RotationAllComponents or Translation.
+      U8 mode;
+
+      /// The bits per key and per component.
+      U8 keyBits;
+      U8 bits[4];
+
+      /// Components are decoded as bias + quantized value * scale.
+      F32 bias[4];
+      F32 scale[4];
+
+      U32 getNumComponents() const { return mode == RotationAllComponents ? 4 : 3; }
+   };
+
+   Vector<Track> mTracks;
+
+   /// The keyframe numbers of the keys of reduced tracks.
+   Vector<U16> mKeyFrames;
+
+   /// The quantized keys of all tracks.  There is always a padding word
+   /// at the end so that reads never need a bounds check.
+   Vector<U32> mBits;
+   U32 mNumBits;
+
+   /// Finds the keys of the track to interpolate for the keyframe.
+   void _findKeys( const Track &track, S32 keyframe, U32 &key0, U32 &key1, F32 &t ) const;
+
+   /// Decodes the components of a key.
+   void _decodeKey( const Track &track, U32 key, F32 *out ) const;
+
+   /// Rebuilds a full rotation from the decoded components of a key.
+   static void _buildRotation( const Track &track, const F32 *comps, QuatF *quat );
+
+   /// Selects the keys, quantizes and packs a track and returns its index.
+   /// The quantization is refined until the decoded track is within the
+   /// tolerance.
+   ///
+   /// @param frames The 4 components of each rotation or the 3 of each
+   ///    translation.
+   S32 _addTrack( U8 mode, const F32 *frames, S32 numFrames, F32 tolerance, Stats *stats );
+};
+
+#endif // _TSCOMPRESSEDTRACKS_H_
@@ -312,6 +312,11 @@ void TSLastDetail::_update()
    Vector<GBitmap*> bitmaps;
    Vector<GBitmap*> normalmaps;
 
+   // The capture renders with its own instances of the shape
+   // materials, which must not be deferred or the imposters
+   // would capture the stand-in material.
+   MaterialManager::SyncInitScope syncInit;
+
    // We need to create our own instance to render with.
    TSShapeInstance *shape = new TSShapeInstance( mShape, true );
 
@@ -41,12 +41,14 @@
 #include "collision/optimizedPolyList.h"
 #include "core/frameAllocator.h"
 #include "platform/profiler.h"
+#include "platform/threads/threadPool.h"
 #include "materials/sceneData.h"
 #include "materials/materialManager.h"
 #include "scene/sceneManager.h"
 #include "scene/sceneRenderState.h"
 #include "materials/matInstance.h"
 #include "renderInstance/renderPassManager.h"
+#include "renderInstance/retainedRenderInstList.h"
 #include "materials/customMaterialDefinition.h"
 #include "gfx/util/triListOpt.h"
 #include "util/triRayCheck.h"
@@ -78,6 +80,15 @@ Vector<S32*>     TSSkinMesh::smBoneIndexList;
 Vector<F32*>     TSSkinMesh::smWeightList;
 Vector<S32*>     TSSkinMesh::smNodeIndexList;
 
+bool TSSkinMesh::smParallelSkinning = true;
+U32 TSSkinMesh::smMinParallelSkinVerts = 2048;
+Vector<TSSkinMesh::SkinJob> TSSkinMesh::smSkinJobs;
+Vector<MatrixF> TSSkinMesh::smSkinBones;
+U8 *TSSkinMesh::smSkinScratch = NULL;
+U32 TSSkinMesh::smSkinScratchSize = 0;
+U32 TSSkinMesh::smSkinScratchUsed = 0;
+U32 TSSkinMesh::smSkinFlushCount = 0;
+
 Vector<Point3F> gNormalStore;
 
 bool TSMesh::smUseTriangles = false; // convert all primitives to triangle lists on load
@@ -179,6 +190,10 @@ void TSMesh::innerRender( TSMaterialList *materials, const TSRenderState &rdata,
 
    if (getFlags(Billboard))
    {
+      // Billboards face the camera and can't be retained.
+      if ( rdata.getRetainedList() )
+         rdata.getRetainedList()->cancelCapture();
+
       Point3F camPos = state->getDiffuseCameraPosition();
       Point3F objPos;
       objToWorld.getColumn(3, &objPos);
@@ -265,6 +280,13 @@ void TSMesh::innerRender( TSMaterialList *materials, const TSRenderState &rdata,
       ri->defaultKey = matInst->getStateHint();
       ri->primBuffIndex = i;
 
+      // Fold the primitive into the secondary key so that the same
+      // primitive of every instance of this mesh sorts together and
+      // can be drawn as one instanced batch.  The vertex buffer is a
+      // member of the mesh, so the keys of different meshes are much
+      // further apart than the number of primitives.
+      ri->defaultKey2 += i;
+
       // Translucent materials need the translucent type.
       if ( matInst->getMaterial()->isTranslucent() )
       {
@@ -273,6 +295,9 @@ void TSMesh::innerRender( TSMaterialList *materials, const TSRenderState &rdata,
       }
 
       renderPass->addInst( ri );
+
+      if ( rdata.getRetainedList() )
+         rdata.getRetainedList()->captureMeshInst( ri, mBounds, rdata.useOriginSort(), matInst->isForwardLit() );
    }
 }
 
@@ -1203,15 +1228,57 @@ void TSSkinMesh::updateSkin( const Vector<MatrixF> &transforms, TSVertexBufferHa
 
    // set up bone transforms
    PROFILE_START(TSSkinMesh_UpdateTransforms);
+   computeBoneTransforms( transforms, sBoneTransforms.address() );
+   const MatrixF * matrices = sBoneTransforms.address();
+   PROFILE_END();
+
+#if defined(USE_MEM_VERTEX_BUFFERS)
+   if ( batchData.vertexBatchOperations.empty() )
+   {
+      dsize_t outStride = mVertexData.vertSize();
+
+      // Initialize it if NULL. 
+      // Skinning includes readbacks from memory (argh) so don't allocate with PAGE_WRITECOMBINE
+      if( instanceVB.isNull() )
+         instanceVB.set( GFX, outStride, mVertexFormat, mNumVerts, GFXBufferTypeDynamic );
+
+      // Grow if needed
+      if( instanceVB.getPointer()->mNumVerts < mNumVerts )
+         instanceVB.resize( mNumVerts );
+
+      // Lock, and skin directly into the final memory destination
+      U8 *outPtr = (U8 *)instanceVB.lock();
+      if(!outPtr) return;
+
+      _skinByTransform( matrices, outPtr, outStride );
+
+      instanceVB.unlock();
+      return;
+   }
+#endif
+
+   // Perform skinning
+   skinVerts( matrices, reinterpret_cast<U8 *>(mVertexData.address()) );
+}
+
+void TSSkinMesh::computeBoneTransforms( const Vector<MatrixF> &transforms, MatrixF *outBones ) const
+{
    for( int i=0; i<batchData.nodeIndex.size(); i++ )
    {
       S32 node = batchData.nodeIndex[i];
-      sBoneTransforms[i].mul( transforms[node], batchData.initialTransforms[i] );
+      outBones[i].mul( transforms[node], batchData.initialTransforms[i] );
    }
-   const MatrixF * matrices = &sBoneTransforms[0];
-   PROFILE_END();
+}
+
+void TSSkinMesh::skinVerts( const MatrixF *boneTransforms, U8 *outPtr ) const
+{
+   const dsize_t outStride = mVertexData.vertSize();
+
+   // Skinning only writes positions and normals, so the
+   // other attributes come from the source vertices.
+   if ( outPtr != reinterpret_cast<U8 *>(mVertexData.address()) )
+      dMemcpy( outPtr, mVertexData.address(), mVertexData.mem_size() );
 
-   // Perform skinning
    const bool bBatchByVert = !batchData.vertexBatchOperations.empty();
    if(bBatchByVert)
    {
@@ -1237,7 +1304,7 @@ void TSSkinMesh::updateSkin( const Vector<MatrixF> &transforms, TSVertexBufferHa
          {      
             const BatchData::TransformOp &transformOp = curVert.transform[tOp];
 
-            const MatrixF& deltaTransform = matrices[transformOp.transformIndex];
+            const MatrixF& deltaTransform = boneTransforms[transformOp.transformIndex];
 
             deltaTransform.mulP( inVerts[curVert.vertexIndex], &srcVtx );
             skinnedVert += ( srcVtx * transformOp.weight );
@@ -1247,50 +1314,172 @@ void TSSkinMesh::updateSkin( const Vector<MatrixF> &transforms, TSVertexBufferHa
          }
 
          // Assign results 
-         __TSMeshVertexBase &dest = mVertexData[curVert.vertexIndex];
+         __TSMeshVertexBase &dest = *reinterpret_cast<__TSMeshVertexBase *>(outPtr + curVert.vertexIndex * outStride);
          dest.vert(skinnedVert);
          dest.normal(skinnedNorm);
       }
    }
    else // Batch by transform
+      _skinByTransform( boneTransforms, outPtr, outStride );
+}
+
+void TSSkinMesh::_skinByTransform( const MatrixF *boneTransforms, U8 *outPtr, dsize_t outStride ) const
+{
+   // Set position/normal to zero so we can accumulate
+   zero_vert_normal_bulk(mNumVerts, outPtr, outStride);
+
+   // Iterate over transforms, and perform batch transform x skin_vert
+   for(Vector<S32>::const_iterator itr = batchData.transformKeys.begin();
+       itr != batchData.transformKeys.end(); itr++)
    {
-      U8 *outPtr = reinterpret_cast<U8 *>(mVertexData.address());
-      dsize_t outStride = mVertexData.vertSize();
+      const S32 boneXfmIdx = *itr;
+      const BatchData::BatchedTransform &curTransform = *batchData.transformBatchOperations.retreive(boneXfmIdx);
+      const MatrixF &curBoneMat = boneTransforms[boneXfmIdx];
+      const S32 numVerts = curTransform.numElements;
 
-#if defined(USE_MEM_VERTEX_BUFFERS)
-      // Initialize it if NULL. 
-      // Skinning includes readbacks from memory (argh) so don't allocate with PAGE_WRITECOMBINE
-      if( instanceVB.isNull() )
-         instanceVB.set( GFX, outStride, mVertexFormat, mNumVerts, GFXBufferTypeDynamic );
+      // Bulk transform points/normals by this transform
+      m_matF_x_BatchedVertWeightList(curBoneMat, numVerts, curTransform.alignedMem,
+         outPtr, outStride);
+   }
+}
 
-      // Grow if needed
-      if( instanceVB.getPointer()->mNumVerts < mNumVerts )
-         instanceVB.resize( mNumVerts );
+void TSSkinMesh::_queueSkin( const Vector<MatrixF> &transforms, TSVertexBufferHandle &vb )
+{
+   PROFILE_SCOPE( TSSkinMesh_QueueSkin );
 
-      // Lock, and skin directly into the final memory destination
-      outPtr = (U8 *)instanceVB.lock();
-      if(!outPtr) return;
-#endif
-      // Set position/normal to zero so we can accumulate
-      zero_vert_normal_bulk(mNumVerts, outPtr, outStride);
+   AssertFatal(batchDataInitialized, "Batch data not initialized. Call createBatchData() before any skin update is called.");
 
-      // Iterate over transforms, and perform batch transform x skin_vert
-      for(Vector<S32>::const_iterator itr = batchData.transformKeys.begin();
-          itr != batchData.transformKeys.end(); itr++)
-      {
-         const S32 boneXfmIdx = *itr;
-         const BatchData::BatchedTransform &curTransform = *batchData.transformBatchOperations.retreive(boneXfmIdx);
-         const MatrixF &curBoneMat = matrices[boneXfmIdx];
-         const S32 numVerts = curTransform.numElements;
-
-         // Bulk transform points/normals by this transform
-         m_matF_x_BatchedVertWeightList(curBoneMat, numVerts, curTransform.alignedMem,
-            outPtr, outStride);
-      }
-#if defined(USE_MEM_VERTEX_BUFFERS)
-      instanceVB.unlock();
-#endif
+   // The vertex buffer is created now so that the render instance
+   // can reference it.  It is filled in by flushSkinJobs().
+   if ( vb == NULL || vb->mNumVerts < mNumVerts )
+      vb.set( GFX, mVertSize, mVertexFormat, mNumVerts, GFXBufferTypeDynamic );
+
+   smSkinJobs.increment();
+   SkinJob &job = smSkinJobs.last();
+   job.mesh = this;
+   job.vb = vb;
+
+   // The node transforms may change before the job runs,
+   // so the bone transforms are computed now.
+   job.boneOffset = smSkinBones.size();
+   smSkinBones.increment( batchData.nodeIndex.size() );
+   computeBoneTransforms( transforms, smSkinBones.address() + job.boneOffset );
+
+   // Keep every output aligned for the SIMD skinning functions.
+   job.outputOffset = smSkinScratchUsed;
+   smSkinScratchUsed += ( mVertexData.mem_size() + 15 ) & ~15;
+}
+
+void TSSkinMesh::_skinJob( U32 start, U32 end, void *key )
+{
+   PROFILE_SCOPE( TSSkinMesh_SkinJob );
+
+   const SkinTask *tasks = reinterpret_cast<const SkinTask*>( key );
+
+   for ( U32 i = start; i < end; i++ )
+      tasks[i].mesh->skinVerts( tasks[i].boneTransforms, tasks[i].output );
+}
+
+void TSSkinMesh::skinParallel( const SkinTask *tasks, U32 count )
+{
+   PROFILE_SCOPE( TSSkinMesh_SkinParallel );
+
+   U32 numVerts = 0;
+   for ( U32 i = 0; i < count; i++ )
+      numVerts += tasks[i].mesh->mNumVerts;
+
+   if ( count > 1 && numVerts >= smMinParallelSkinVerts )
+      ThreadPool::GLOBAL().parallelFor( count, 1, _skinJob, const_cast<SkinTask*>( tasks ) );
+   else
+      _skinJob( 0, count, const_cast<SkinTask*>( tasks ) );
+}
+
+void TSSkinMesh::flushSkinJobs()
+{
+   if ( smSkinJobs.empty() )
+      return;
+
+   PROFILE_SCOPE( TSSkinMesh_FlushSkinJobs );
+
+   if ( smSkinScratchUsed > smSkinScratchSize )
+   {
+      if ( smSkinScratch )
+         dFree_aligned( smSkinScratch );
+
+      smSkinScratchSize = smSkinScratchUsed;
+      smSkinScratch = reinterpret_cast<U8 *>( dMalloc_aligned( smSkinScratchSize, 16 ) );
+      AssertFatal( smSkinScratch, "Aligned malloc failed! Debug!" );
+   }
+
+   const U32 numJobs = smSkinJobs.size();
+   FrameTemp<SkinTask> tasks( numJobs );
+   for ( U32 i = 0; i < numJobs; i++ )
+   {
+      const SkinJob &job = smSkinJobs[i];
+      tasks[i].mesh = job.mesh;
+      tasks[i].boneTransforms = smSkinBones.address() + job.boneOffset;
+      tasks[i].output = smSkinScratch + job.outputOffset;
+   }
+
+   skinParallel( tasks, numJobs );
+
+   // Buffers can only be locked on the main thread, so
+   // the results are uploaded after all jobs are done.
+   PROFILE_START( TSSkinMesh_UploadSkins );
+   for ( U32 i = 0; i < numJobs; i++ )
+   {
+      SkinJob &job = smSkinJobs[i];
+      U8 *vertData = (U8*)job.vb.lock();
+      if ( !vertData )
+         continue;
+
+      dMemcpy( vertData, tasks[i].output, job.mesh->mVertexData.mem_size() );
+      job.vb.unlock();
    }
+   PROFILE_END();
+
+   // The serial path leaves the last skinned instance in mVertexData
+   // and computeBounds() reads it from there, so keep it up to date.
+   smSkinFlushCount++;
+   for ( S32 i = numJobs - 1; i >= 0; i-- )
+   {
+      TSSkinMesh *mesh = smSkinJobs[i].mesh;
+      if ( mesh->mLastSkinFlush == smSkinFlushCount )
+         continue;
+
+      mesh->mLastSkinFlush = smSkinFlushCount;
+      dMemcpy( mesh->mVertexData.address(), tasks[i].output, mesh->mVertexData.mem_size() );
+   }
+
+   smSkinJobs.clear();
+   smSkinBones.clear();
+   smSkinScratchUsed = 0;
+}
+
+void TSSkinMesh::_onRenderPass( RenderPassManager *pass, const SceneRenderState *state )
+{
+   // Finish the skinning queued while the objects were
+   // submitted before any of the bins draw them.
+   flushSkinJobs();
+}
+
+void TSSkinMesh::initParallelSkinning()
+{
+   RenderPassManager::getRenderSignal().notify( &TSSkinMesh::_onRenderPass );
+}
+
+void TSSkinMesh::shutdownParallelSkinning()
+{
+   RenderPassManager::getRenderSignal().remove( &TSSkinMesh::_onRenderPass );
+
+   smSkinJobs.clear();
+   smSkinBones.clear();
+   smSkinScratchUsed = 0;
+
+   if ( smSkinScratch )
+      dFree_aligned( smSkinScratch );
+   smSkinScratch = NULL;
+   smSkinScratchSize = 0;
 }
 
 S32 QSORT_CALLBACK _sort_BatchedVertWeight( const void *a, const void *b )
@@ -1484,6 +1673,10 @@ void TSSkinMesh::render(   TSMaterialList *materials,
 {
    PROFILE_SCOPE(TSSkinMesh_render);
 
+   // Skinned vertices change with the animation.
+   if ( rdata.getRetainedList() )
+      rdata.getRetainedList()->cancelCapture();
+
    if( mNumVerts == 0 )
       return;
 
@@ -1501,11 +1694,27 @@ void TSSkinMesh::render(   TSMaterialList *materials,
 
    if ( primsChanged || vertsChanged || isSkinDirty )
    {
-      // Perform skinning
-      updateSkin( transforms, vertexBuffer, primitiveBuffer );
+      bool queued = false;
+
+#if !defined(USE_MEM_VERTEX_BUFFERS) && !defined(TORQUE_OS_XENON)
+      // Defer the skinning so that all the visible skins
+      // can be done at once on the thread pool.
+      if ( smParallelSkinning && GFXDevice::devicePresent() )
+      {
+         _queueSkin( transforms, vertexBuffer );
+         _createPB( primitiveBuffer );
+         queued = true;
+      }
+#endif
+
+      if ( !queued )
+      {
+         // Perform skinning
+         updateSkin( transforms, vertexBuffer, primitiveBuffer );
       
-      // Update GFX vertex buffer
-      _createVBIB( vertexBuffer, primitiveBuffer );
+         // Update GFX vertex buffer
+         _createVBIB( vertexBuffer, primitiveBuffer );
+      }
    }
 
    // render...
@@ -2406,6 +2615,14 @@ void TSMesh::_createVBIB( TSVertexBufferHandle &vb, GFXPrimitiveBufferHandle &pb
    }
 #endif
 
+   _createPB( pb );
+}
+
+void TSMesh::_createPB( GFXPrimitiveBufferHandle &pb )
+{
+   if ( !GFXDevice::devicePresent() )
+      return;
+
    const bool primsChanged = ( pb.isValid() && pb->mIndexCount != indices.size() );
    if( primsChanged || pb.isNull() )
    {
@@ -2882,6 +3099,17 @@ TSSkinMesh::TSSkinMesh()
    meshType = SkinMeshType;
    mDynamic = true;
    batchDataInitialized = false;
+   mLastSkinFlush = 0;
+}
+
+TSSkinMesh::~TSSkinMesh()
+{
+   // Drop any skinning still queued for this mesh.
+   for ( S32 i = smSkinJobs.size() - 1; i >= 0; i-- )
+   {
+      if ( smSkinJobs[i].mesh == this )
+         smSkinJobs.erase( i );
+   }
 }
 
 //-----------------------------------------------------------------------------
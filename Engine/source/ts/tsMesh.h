@@ -121,6 +121,7 @@ class TSMesh
 
    void _convertToAlignedMeshData( TSMeshVertexArray &vertexData, const Vector<Point3F> &_verts, const Vector<Point3F> &_norms );
    void _createVBIB( TSVertexBufferHandle &vb, GFXPrimitiveBufferHandle &pb );
+   void _createPB( GFXPrimitiveBufferHandle &pb );
 
   public:
 
@@ -512,6 +513,98 @@ public:
    /// set verts and normals...
    void updateSkin( const Vector<MatrixF> &transforms, TSVertexBufferHandle &instanceVB, GFXPrimitiveBufferHandle &instancePB );
 
+   /// @name Parallel Skinning
+   /// Skinning of visible instances can be queued during render() and
+   /// performed on the thread pool by flushSkinJobs() before the render
+   /// bins are drawn.
+   /// @{
+
+   /// A mesh to skin into an output buffer.
+   struct SkinTask
+   {
+      const TSSkinMesh *mesh;
+
+      /// The bone transforms from computeBoneTransforms().
+      const MatrixF *boneTransforms;
+
+      /// The output vertices, mVertexData.mem_size() bytes
+      /// aligned to 16 bytes.
+      U8 *output;
+   };
+
+   /// Enables queueing skinning for flushSkinJobs().
+   static bool smParallelSkinning;
+
+   /// The minimum number of queued vertices for which
+   /// flushSkinJobs() uses the thread pool.
+   static U32 smMinParallelSkinVerts;
+
+   /// Multiplies the node transforms by the initial bone transforms.
+   /// @param outBones Receives batchData.nodeIndex.size() matrices.
+   void computeBoneTransforms( const Vector<MatrixF> &transforms, MatrixF *outBones ) const;
+
+   /// Skins the vertices into @a outPtr.  The vertex attributes which are
+   /// not skinned are copied from mVertexData.  This only reads the mesh
+   /// so it may be called from any thread once the batch data is created.
+   void skinVerts( const MatrixF *boneTransforms, U8 *outPtr ) const;
+
+   /// Performs the tasks on the thread pool and waits for them.
+   static void skinParallel( const SkinTask *tasks, U32 count );
+
+   /// Performs the queued skinning and uploads the results to the
+   /// instance vertex buffers.
+   static void flushSkinJobs();
+
+   /// Returns the number of queued skinning jobs.
+   static U32 getNumSkinJobs() { return smSkinJobs.size(); }
+
+   /// Hooks flushSkinJobs() up to run before each render pass.
+   static void initParallelSkinning();
+
+   /// Drops the queued skinning and frees the scratch buffer.
+   static void shutdownParallelSkinning();
+
+   /// @}
+
+protected:
+
+   struct SkinJob
+   {
+      TSSkinMesh *mesh;
+
+      /// The instance vertex buffer which receives the result.
+      TSVertexBufferHandle vb;
+
+      /// The offset of the bone transforms in smSkinBones.
+      U32 boneOffset;
+
+      /// The offset of the output vertices in smSkinScratch.
+      U32 outputOffset;
+   };
+
+   static Vector<SkinJob> smSkinJobs;
+   static Vector<MatrixF> smSkinBones;
+   static U8 *smSkinScratch;
+   static U32 smSkinScratchSize;
+   static U32 smSkinScratchUsed;
+   static U32 smSkinFlushCount;
+
+   /// The flushSkinJobs() call which last copied a result
+   /// back into mVertexData.
+   U32 mLastSkinFlush;
+
+   /// Queues skinning of this mesh into @a vb for flushSkinJobs().
+   void _queueSkin( const Vector<MatrixF> &transforms, TSVertexBufferHandle &vb );
+
+   /// Skins with the batch by transform operations.
+   void _skinByTransform( const MatrixF *boneTransforms, U8 *outPtr, dsize_t outStride ) const;
+
+   static void _skinJob( U32 start, U32 end, void *key );
+
+   static void _onRenderPass( RenderPassManager *pass, const SceneRenderState *state );
+
+public:
+
    // render methods..
    void render( TSVertexBufferHandle &instanceVB, GFXPrimitiveBufferHandle &instancePB );
    void render(   TSMaterialList *, 
@@ -541,6 +634,7 @@ public:
    static Vector<S32*>     smNodeIndexList;
 
    TSSkinMesh();
+   virtual ~TSSkinMesh();
 };
 
 
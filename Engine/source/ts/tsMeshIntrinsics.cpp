@@ -100,6 +100,17 @@ MODULE_BEGIN( TSMeshIntrinsics )
          zero_vert_normal_bulk = zero_vert_normal_bulk_SSE;
          m_matF_x_BatchedVertWeightList = m_matF_x_BatchedVertWeightList_SSE;
 
+   #if defined(TORQUE_TS_MESH_INTRINSICS_AVX)
+         if(Platform::SystemInfo.processor.properties & CPU_PROP_AVX)
+         {
+            zero_vert_normal_bulk = zero_vert_normal_bulk_AVX;
+            m_matF_x_BatchedVertWeightList = m_matF_x_BatchedVertWeightList_AVX;
+
+            if(Platform::SystemInfo.processor.properties & CPU_PROP_FMA)
+               m_matF_x_BatchedVertWeightList = m_matF_x_BatchedVertWeightList_FMA;
+         }
+   #endif
+
          /* This code still has a bug left in it
    #if (_MSC_VER >= 1500)
          if(Platform::SystemInfo.processor.properties & CPU_PROP_SSE4_1)
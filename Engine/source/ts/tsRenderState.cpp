@@ -32,8 +32,9 @@ TSRenderState::TSRenderState()
       mNoRenderNonTranslucent( false ),
       mMaterialHint( NULL ),
       mCuller( NULL ),
+      mUseOriginSort( false ),
       mLightQuery( NULL ),
-      mUseOriginSort( false )
+      mRetainedList( NULL )
 {
 }
 
@@ -45,7 +46,8 @@ TSRenderState::TSRenderState( const TSRenderState &state )
       mNoRenderNonTranslucent( state.mNoRenderNonTranslucent ),
       mMaterialHint( state.mMaterialHint ),
       mCuller( state.mCuller ),
+      mUseOriginSort( state.mUseOriginSort ),
       mLightQuery( state.mLightQuery ),
-      mUseOriginSort( state.mUseOriginSort )
+      mRetainedList( state.mRetainedList )
 {
 }
@@ -33,6 +33,7 @@ class SceneRenderState;
 class GFXCubemap;
 class Frustum;
 class LightQuery;
+class RetainedRenderInstList;
 
 
 /// A simple class for passing render state through the pre-render pipeline.
@@ -103,6 +104,10 @@ protected:
    /// are forward lit and need lights.
    LightQuery *mLightQuery;
 
+   /// If set, the submitted mesh render instances are
+   /// recorded into this list for reuse in later frames.
+   RetainedRenderInstList *mRetainedList;
+
 public:
 
    TSRenderState();
@@ -147,6 +152,10 @@ public:
    void setLightQuery( LightQuery *query ) { mLightQuery = query; }
    LightQuery* getLightQuery() const { return mLightQuery; }
 
+   ///@see mRetainedList
+   void setRetainedList( RetainedRenderInstList *list ) { mRetainedList = list; }
+   RetainedRenderInstList* getRetainedList() const { return mRetainedList; }
+
    /// @}
 };
 
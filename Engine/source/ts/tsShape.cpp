@@ -42,7 +42,7 @@ extern TSShape* loadColladaShape(const Torque::Path &path);
 #endif
 
 /// most recent version -- this is the version we write
-S32 TSShape::smVersion = 26;
+S32 TSShape::smVersion = 27;
 /// the version currently being read...valid only during a read
 S32 TSShape::smReadVersion = -1;
 const U32 TSShape::smMostRecentExporterVersion = DTS_EXPORTER_CURRENT_VERSION;
@@ -546,9 +546,55 @@ void TSShape::init()
    }
 
    initVertexFeatures();
+   initDetailNodes();
    initMaterialList();
 }
 
+void TSShape::initDetailNodes()
+{
+   mDetailNodes.setSize( details.size() );
+
+   for ( S32 i = 0; i < details.size(); i++ )
+   {
+      TSIntegerSet &detailNodes = mDetailNodes[i];
+      detailNodes.clearAll();
+
+      S32 ss = details[i].subShapeNum;
+      S32 od = details[i].objectDetailNum;
+      if ( ss < 0 )
+         continue;
+
+      S32 start = subShapeFirstObject[ss];
+      S32 end   = start + subShapeNumObjects[ss];
+      for ( S32 j = start; j < end; j++ )
+      {
+         const Object &obj = objects[j];
+         if ( od >= obj.numMeshes )
+            continue;
+
+         const TSMesh *mesh = meshes[obj.startMeshIndex + od];
+         if ( !mesh )
+            continue;
+
+         if ( obj.nodeIndex >= 0 )
+            addNodeAndAncestors( obj.nodeIndex, detailNodes );
+
+         if ( mesh->getMeshType() == TSMesh::SkinMeshType )
+         {
+            const Vector<S32> &bones = static_cast<const TSSkinMesh*>( mesh )->batchData.nodeIndex;
+            for ( S32 k = 0; k < bones.size(); k++ )
+               addNodeAndAncestors( bones[k], detailNodes );
+         }
+      }
+   }
+}
+
+void TSShape::addNodeAndAncestors( S32 nodeIndex, TSIntegerSet &nodeSet ) const
+{
+   for ( ; nodeIndex >= 0; nodeIndex = nodes[nodeIndex].parentIndex )
+      nodeSet.set( nodeIndex );
+}
+
 void TSShape::initVertexFeatures()
 {
    bool hasColors = false;
@@ -1429,6 +1475,179 @@ void TSShape::disassembleShape()
    tsalloc.setGuard();
 }
 
+//-------------------------------------------------
+// animation compression
+//-------------------------------------------------
+
+void TSShape::buildCompressedTracks(F32 rotTol, F32 tranTol, TSCompressedTracks & tracks,
+                                    Vector<S32> & rotationBase, Vector<S32> & translationBase,
+                                    Vector<TSCompressedTracks::Stats> * sequenceStats) const
+{
+   tracks.clear();
+   rotationBase.setSize(sequences.size());
+   translationBase.setSize(sequences.size());
+   if (sequenceStats)
+      sequenceStats->setSize(sequences.size());
+
+   Vector<QuatF> rotations;
+   Vector<Point3F> translations;
+   for (S32 i=0; i<sequences.size(); i++)
+   {
+      const Sequence & seq = sequences[i];
+
+      TSCompressedTracks::Stats * stats = NULL;
+      if (sequenceStats)
+      {
+         stats = &(*sequenceStats)[i];
+         stats->clear();
+      }
+
+      rotations.setSize(seq.numKeyframes);
+      translations.setSize(seq.numKeyframes);
+
+      rotationBase[i] = tracks.getNumTracks();
+      S32 numRotations = seq.rotationMatters.count();
+      for (S32 j=0; j<numRotations; j++)
+      {
+         for (S32 k=0; k<seq.numKeyframes; k++)
+            getRotation(seq,k,j,&rotations[k]);
+         tracks.addRotationTrack(rotations.address(),seq.numKeyframes,rotTol,stats);
+      }
+
+      translationBase[i] = tracks.getNumTracks();
+      S32 numTranslations = seq.translationMatters.count();
+      for (S32 j=0; j<numTranslations; j++)
+      {
+         for (S32 k=0; k<seq.numKeyframes; k++)
+            translations[k] = getTranslation(seq,k,j);
+         tracks.addTranslationTrack(translations.address(),seq.numKeyframes,tranTol,stats);
+      }
+   }
+}
+
+bool TSShape::compressAnimation(F32 rotTol, F32 tranTol, Vector<TSCompressedTracks::Stats> * sequenceStats)
+{
+   if (isAnimationCompressed())
+      return false;
+
+   for (S32 i=0; i<sequences.size(); i++)
+   {
+      if (sequences[i].numKeyframes > U16_MAX)
+         return false;
+   }
+
+   TSCompressedTracks tracks;
+   Vector<S32> rotationBase, translationBase;
+   buildCompressedTracks(rotTol,tranTol,tracks,rotationBase,translationBase,sequenceStats);
+   if (tracks.isEmpty())
+      return false;
+
+   for (S32 i=0; i<sequences.size(); i++)
+   {
+      sequences[i].baseRotation = rotationBase[i];
+      sequences[i].baseTranslation = translationBase[i];
+   }
+
+   mCompressedTracks = tracks;
+
+   nodeRotations.clear();
+   nodeRotations.compact();
+   nodeTranslations.clear();
+   nodeTranslations.compact();
+
+   return true;
+}
+
+void TSShape::uncompressAnimation()
+{
+   if (!isAnimationCompressed())
+      return;
+
+   Vector<Quat16> rotations;
+   Vector<Point3F> translations;
+   Vector<S32> rotationBase, translationBase;
+   rotationBase.setSize(sequences.size());
+   translationBase.setSize(sequences.size());
+
+   for (S32 i=0; i<sequences.size(); i++)
+   {
+      const Sequence & seq = sequences[i];
+
+      rotationBase[i] = rotations.size();
+      S32 numRotations = seq.rotationMatters.count();
+      for (S32 j=0; j<numRotations; j++)
+      {
+         for (S32 k=0; k<seq.numKeyframes; k++)
+         {
+            QuatF q;
+            rotations.increment();
+            rotations.last().set(getRotation(seq,k,j,&q));
+         }
+      }
+
+      translationBase[i] = translations.size();
+      S32 numTranslations = seq.translationMatters.count();
+      for (S32 j=0; j<numTranslations; j++)
+      {
+         for (S32 k=0; k<seq.numKeyframes; k++)
+            translations.push_back(getTranslation(seq,k,j));
+      }
+   }
+
+   for (S32 i=0; i<sequences.size(); i++)
+   {
+      sequences[i].baseRotation = rotationBase[i];
+      sequences[i].baseTranslation = translationBase[i];
+   }
+
+   nodeRotations = rotations;
+   nodeTranslations = translations;
+   mCompressedTracks.clear();
+}
+
+TSShape::UncompressAnimationScope::UncompressAnimationScope( TSShape *shape )
+   : mShape( shape )
+{
+   if ( !mShape || !mShape->isAnimationCompressed() )
+      return;
+
+   mTracks = mShape->mCompressedTracks;
+   mRotationBase.setSize( mShape->sequences.size() );
+   mTranslationBase.setSize( mShape->sequences.size() );
+   for ( S32 i = 0; i < mShape->sequences.size(); i++ )
+   {
+      mRotationBase[i] = mShape->sequences[i].baseRotation;
+      mTranslationBase[i] = mShape->sequences[i].baseTranslation;
+   }
+
+   mShape->uncompressAnimation();
+}
+
+TSShape::UncompressAnimationScope::~UncompressAnimationScope()
+{
+   if ( mTracks.isEmpty() )
+      return;
+
+   for ( S32 i = 0; i < mShape->sequences.size(); i++ )
+   {
+      mShape->sequences[i].baseRotation = mRotationBase[i];
+      mShape->sequences[i].baseTranslation = mTranslationBase[i];
+   }
+
+   mShape->mCompressedTracks = mTracks;
+   mShape->nodeRotations.clear();
+   mShape->nodeRotations.compact();
+   mShape->nodeTranslations.clear();
+   mShape->nodeTranslations.compact();
+}
+
+U32 TSShape::getNodeAnimationSize() const
+{
+   if (isAnimationCompressed())
+      return mCompressedTracks.getMemorySize();
+   return nodeRotations.size() * sizeof(Quat16) + nodeTranslations.size() * sizeof(Point3F);
+}
+
 //-------------------------------------------------
 // write whole shape
 //-------------------------------------------------
@@ -1468,6 +1687,9 @@ bool TSShape::canWriteOldFormat() const
 
 void TSShape::write(Stream * s, bool saveOldFormat)
 {
+   // the old format only stores raw keyframes
+   UncompressAnimationScope uncompressed(saveOldFormat ? this : NULL);
+
    S32 currentVersion = smVersion;
    if (saveOldFormat)
       smVersion = 24;
@@ -1520,6 +1742,10 @@ void TSShape::write(Stream * s, bool saveOldFormat)
    // write material list - write will properly endian-flip.
    materialList->write(*s);
 
+   // write compressed node animation
+   if (smVersion > 26)
+      mCompressedTracks.write(s);
+
    delete [] buffer32;
    delete [] buffer16;
    delete [] buffer8;
@@ -1599,6 +1825,11 @@ bool TSShape::read(Stream * s)
       delete materialList; // just in case...
       materialList = new TSMaterialList;
       materialList->read(*s);
+
+      // read compressed node animation
+      mCompressedTracks.clear();
+      if (mReadVersion > 26)
+         mCompressedTracks.read(s);
    }
 
 	// since we read in the buffers, we need to endian-flip their entire contents...
@@ -35,6 +35,9 @@
 #ifndef _TSSHAPEALLOC_H_
 #include "ts/tsShapeAlloc.h"
 #endif
+#ifndef _TSCOMPRESSEDTRACKS_H_
+#include "ts/tsCompressedTracks.h"
+#endif
 
 
 #define DTS_EXPORTER_CURRENT_VERSION 124
@@ -328,6 +331,13 @@ class TSShape
    Vector<ConvexHullAccelerator*>   detailCollisionAccelerators;
    Vector<String>                   names;
 
+   /// The node rotation and translation tracks of all sequences once the
+   /// animation is compressed.  nodeRotations and nodeTranslations are then
+   /// empty and the baseRotation and baseTranslation of each sequence are
+   /// the index of its first track.
+   /// @see compressAnimation
+   TSCompressedTracks mCompressedTracks;
+
    /// @}
 
    TSMaterialList * materialList;
@@ -378,6 +388,11 @@ class TSShape
    /// level and intra-detail level for each pixel size.
    Vector<LodPair> mDetailLevelLookup;
 
+   /// The nodes each detail level depends on, which are the nodes of its
+   /// meshes, the bones of its skins and all their ancestors.
+   /// @see initDetailNodes()
+   Vector<TSIntegerSet> mDetailNodes;
+
    /// The GFX vertex format for all detail meshes in the shape.
    /// @see initVertexFeatures()
    GFXVertexFormat mVertexFormat;
@@ -410,6 +425,12 @@ class TSShape
    /// all detail meshes in the shape.
    void initVertexFeatures();
 
+   /// Called from init() to find the nodes each detail level depends on.
+   void initDetailNodes();
+
+   /// Adds the node and all its ancestors to the set.
+   void addNodeAndAncestors( S32 nodeIndex, TSIntegerSet &nodeSet ) const;
+
    bool getSequencesConstructed() const { return mSequencesConstructed; }
    void setSequencesConstructed(const bool c) { mSequencesConstructed = c; }
 
@@ -419,13 +440,61 @@ class TSShape
    /// @{
 
    QuatF & getRotation(const Sequence & seq, S32 keyframeNum, S32 rotNum, QuatF *) const;
-   const Point3F & getTranslation(const Sequence & seq, S32 keyframeNum, S32 tranNum) const;
+   Point3F getTranslation(const Sequence & seq, S32 keyframeNum, S32 tranNum) const;
    F32 getUniformScale(const Sequence & seq, S32 keyframeNum, S32 scaleNum) const;
    const Point3F & getAlignedScale(const Sequence & seq, S32 keyframeNum, S32 scaleNum) const;
    TSScale & getArbitraryScale(const Sequence & seq, S32 keyframeNum, S32 scaleNum, TSScale *) const;
    const ObjectState & getObjectState(const Sequence & seq, S32 keyframeNum, S32 objectNum) const;
    /// @}
 
+   /// @name Animation Compression
+   /// Node rotations and translations can be stored as error bounded,
+   /// quantized tracks instead of a Quat16 and a Point3F per keyframe.
+   /// Scales, ground transforms and object states are never compressed.
+   /// @{
+
+   /// Compresses the node rotations and translations of all sequences.
+   ///
+   /// @param rotTol The largest allowed rotation error in radians.
+   /// @param tranTol The largest allowed translation error.
+   /// @param sequenceStats If not NULL, receives the error and size of the
+   ///    tracks of each sequence.
+   /// @return False if the shape was already compressed or has no tracks.
+   bool compressAnimation(F32 rotTol, F32 tranTol, Vector<TSCompressedTracks::Stats> * sequenceStats = NULL);
+
+   /// Compresses the tracks of all sequences into @a tracks without
+   /// changing the shape, to find the size and error compressAnimation()
+   /// would give.
+   void buildCompressedTracks(F32 rotTol, F32 tranTol, TSCompressedTracks & tracks,
+                              Vector<S32> & rotationBase, Vector<S32> & translationBase,
+                              Vector<TSCompressedTracks::Stats> * sequenceStats) const;
+
+   /// Decodes compressed tracks back to nodeRotations and nodeTranslations.
+   /// Called before any change to the sequences or nodes.
+   void uncompressAnimation();
+
+   /// Uncompresses the animation while in scope and puts the compressed
+   /// tracks back afterwards, so writers which store raw keyframes leave
+   /// the shape as it was.  Does nothing if the shape is NULL.
+   class UncompressAnimationScope
+   {
+   public:
+      UncompressAnimationScope( TSShape *shape );
+      ~UncompressAnimationScope();
+
+   protected:
+      TSShape *mShape;
+      TSCompressedTracks mTracks;
+      Vector<S32> mRotationBase;
+      Vector<S32> mTranslationBase;
+   };
+
+   bool isAnimationCompressed() const { return !mCompressedTracks.isEmpty(); }
+
+   /// Returns the number of bytes used by node rotation and translation keyframes.
+   U32 getNodeAnimationSize() const;
+   /// @}
+
    /// build LOS collision detail
    void computeAccelerator(S32 dl);
    bool buildConvexHull(S32 dl) const;
@@ -659,11 +728,15 @@ class TSShape
 
 inline QuatF & TSShape::getRotation(const Sequence & seq, S32 keyframeNum, S32 rotNum, QuatF * quat) const
 {
+   if (!mCompressedTracks.isEmpty())
+      return mCompressedTracks.getRotation(seq.baseRotation + rotNum, keyframeNum, quat);
    return nodeRotations[seq.baseRotation + rotNum*seq.numKeyframes + keyframeNum].getQuatF(quat);
 }
 
-inline const Point3F & TSShape::getTranslation(const Sequence & seq, S32 keyframeNum, S32 tranNum) const
+inline Point3F TSShape::getTranslation(const Sequence & seq, S32 keyframeNum, S32 tranNum) const
 {
+   if (!mCompressedTracks.isEmpty())
+      return mCompressedTracks.getTranslation(seq.baseTranslation + tranNum, keyframeNum);
    return nodeTranslations[seq.baseTranslation + tranNum*seq.numKeyframes + keyframeNum];
 }
 
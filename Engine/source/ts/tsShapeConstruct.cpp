@@ -25,6 +25,7 @@
 
 #include "ts/tsShapeInstance.h"
 #include "ts/tsMaterialList.h"
+#include "ts/loader/tsShapeLoader.h"
 #include "console/consoleTypes.h"
 #include "console/engineAPI.h"
 #include "core/resourceManager.h"
@@ -613,6 +614,56 @@ DefineTSShapeConstructorMethod( saveShape, void, ( const char* filename ),,
    delete dtsStream;
 }}
 
+DefineTSShapeConstructorMethod( reportAnimationCompression, void, ( F32 rotTol, F32 tranTol ), ( -1.0f, -1.0f ),
+   ( rotTol, tranTol ),,
+   "Print the size and error of the node animation of each sequence when "
+   "compressed. The shape itself is not modified.\n"
+   "@param rotTol Maximum rotation error in radians. If not specified, "
+   "$pref::TSShapeLoader::animRotationTolerance is used.\n"
+   "@param tranTol Maximum translation error. If not specified, "
+   "$pref::TSShapeLoader::animTranslationTolerance is used.\n\n"
+   "@tsexample\n"
+   "%this.reportAnimationCompression();\n"
+   "%this.reportAnimationCompression( 0.005, 0.01 );\n"
+   "@endtsexample\n" )
+{
+   if ( rotTol < 0 )
+      rotTol = TSShapeLoader::smAnimRotationTolerance;
+   if ( tranTol < 0 )
+      tranTol = TSShapeLoader::smAnimTranslationTolerance;
+
+   TSCompressedTracks tracks;
+   Vector<S32> rotationBase, translationBase;
+   Vector<TSCompressedTracks::Stats> seqStats;
+   mShape->buildCompressedTracks( rotTol, tranTol, tracks, rotationBase, translationBase, &seqStats );
+
+   Con::printf( "Animation compression of '%s' (rotation %g rad, translation %g):",
+      mShapePath.c_str(), rotTol, tranTol );
+
+   TSCompressedTracks::Stats total;
+   for ( S32 i = 0; i < seqStats.size(); i++ )
+   {
+      const TSCompressedTracks::Stats& stats = seqStats[i];
+      total.add( stats );
+
+      Con::printf( "  %s: %d tracks, %d of %d keys, %d -> %d bytes, "
+         "rotation error %g (avg %g), translation error %g (avg %g)",
+         mShape->getName( mShape->sequences[i].nameIndex ).c_str(),
+         stats.numTracks, stats.numKeys, stats.numFrames, stats.rawBytes, stats.compressedBytes,
+         stats.maxRotationError, stats.getAvgRotationError(),
+         stats.maxTranslationError, stats.getAvgTranslationError() );
+   }
+
+   Con::printf( "  Total: %d tracks, %d of %d keys, %d -> %d bytes, "
+      "rotation error %g (avg %g), translation error %g (avg %g)",
+      total.numTracks, total.numKeys, total.numFrames, total.rawBytes, total.compressedBytes,
+      total.maxRotationError, total.getAvgRotationError(),
+      total.maxTranslationError, total.getAvgTranslationError() );
+
+   Con::printf( "  Current node animation size: %d bytes (%s)", mShape->getNodeAnimationSize(),
+      mShape->isAnimationCompressed() ? "compressed" : "uncompressed" );
+}}
+
 DefineTSShapeConstructorMethod( writeChangeSet, void, (),,
    (),,
    "Write the current change set to a TSShapeConstructor script file. The "
@@ -281,6 +281,7 @@ public:
    ///@{
    void dumpShape( const char* filename );
    void saveShape( const char* filename );
+   void reportAnimationCompression( F32 rotTol, F32 tranTol );
    ///@}
 
    /// @name Nodes
@@ -549,6 +549,7 @@ bool TSShape::removeNode(const String& name)
    }
 
    // Update animation sequences
+   uncompressAnimation();
    for (S32 iSeq = 0; iSeq < sequences.size(); iSeq++)
    {
       TSShape::Sequence& seq = sequences[iSeq];
@@ -1352,6 +1353,9 @@ bool TSShape::addSequence(const Torque::Path& path, const String& fromSeq,
 {
    String oldName(fromSeq);
 
+   // Sequences are always added to uncompressed keyframes
+   uncompressAnimation();
+
    if (path.getExtension().equal("dsq", String::NoCase))
    {
       S32 oldSeqCount = sequences.size();
@@ -1705,9 +1709,18 @@ bool TSShape::addSequence(const Torque::Path& path, const String& fromSeq,
 
       if (seq.translationMatters.test(nodeMap[i]))
       {
-         S32 src = srcSeq->baseTranslation + srcSeq->numKeyframes * srcSeq->translationMatters.count(i) + startFrame;
          S32 dest = seq.baseTranslation + seq.numKeyframes * seq.translationMatters.count(nodeMap[i]);
-         dCopyArray(&nodeTranslations[dest], &srcShape->nodeTranslations[src], seq.numKeyframes);
+         if (srcShape->isAnimationCompressed())
+         {
+            S32 tranNum = srcSeq->translationMatters.count(i);
+            for (S32 j = 0; j < seq.numKeyframes; j++)
+               nodeTranslations[dest + j] = srcShape->getTranslation(*srcSeq, startFrame + j, tranNum);
+         }
+         else
+         {
+            S32 src = srcSeq->baseTranslation + srcSeq->numKeyframes * srcSeq->translationMatters.count(i) + startFrame;
+            dCopyArray(&nodeTranslations[dest], &srcShape->nodeTranslations[src], seq.numKeyframes);
+         }
       }
       else if (padTransKeys && (defaultTranslations[nodeMap[i]] != srcShape->defaultTranslations[i]))
       {
@@ -1719,9 +1732,21 @@ bool TSShape::addSequence(const Torque::Path& path, const String& fromSeq,
 
       if (seq.rotationMatters.test(nodeMap[i]))
       {
-         S32 src = srcSeq->baseRotation + srcSeq->numKeyframes * srcSeq->rotationMatters.count(i) + startFrame;
          S32 dest = seq.baseRotation + seq.numKeyframes * seq.rotationMatters.count(nodeMap[i]);
-         dCopyArray(&nodeRotations[dest], &srcShape->nodeRotations[src], seq.numKeyframes);
+         if (srcShape->isAnimationCompressed())
+         {
+            S32 rotNum = srcSeq->rotationMatters.count(i);
+            for (S32 j = 0; j < seq.numKeyframes; j++)
+            {
+               QuatF rot;
+               nodeRotations[dest + j].set(srcShape->getRotation(*srcSeq, startFrame + j, rotNum, &rot));
+            }
+         }
+         else
+         {
+            S32 src = srcSeq->baseRotation + srcSeq->numKeyframes * srcSeq->rotationMatters.count(i) + startFrame;
+            dCopyArray(&nodeRotations[dest], &srcShape->nodeRotations[src], seq.numKeyframes);
+         }
       }
       else if (padRotKeys && (defaultRotations[nodeMap[i]] != srcShape->defaultRotations[i]))
       {
@@ -1782,6 +1807,8 @@ bool TSShape::removeSequence(const String& name)
       return false;
    }
 
+   uncompressAnimation();
+
    TSShape::Sequence& seq = sequences[seqIndex];
 
    // Remove the node transforms for this sequence
@@ -1966,19 +1993,13 @@ void TSShape::getNodeKeyframe(S32 nodeIndex, const TSShape::Sequence& seq, S32 k
    // Get the node rotation and translation
    QuatF rot;
    if (seq.rotationMatters.test(nodeIndex))
-   {
-      S32 index = seq.rotationMatters.count(nodeIndex) * seq.numKeyframes + keyframe;
-      nodeRotations[seq.baseRotation + index].getQuatF(&rot);
-   }   
+      getRotation(seq, keyframe, seq.rotationMatters.count(nodeIndex), &rot);
    else
       defaultRotations[nodeIndex].getQuatF(&rot);
 
    Point3F trans;
    if (seq.translationMatters.test(nodeIndex))
-   {
-      S32 index = seq.translationMatters.count(nodeIndex) * seq.numKeyframes + keyframe;
-      trans = nodeTranslations[seq.baseTranslation + index];
-   }
+      trans = getTranslation(seq, keyframe, seq.translationMatters.count(nodeIndex));
    else
       trans = defaultTranslations[nodeIndex];
 
@@ -2017,6 +2038,9 @@ bool TSShape::setSequenceBlend(const String& seqName, bool blend, const String&
       return false;
    }
 
+   // The keyframes are rewritten below
+   uncompressAnimation();
+
    // Set the new flag
    if (blend)
       seq.flags |= TSShape::Blend;
@@ -25,12 +25,14 @@
 
 #include "ts/tsLastDetail.h"
 #include "ts/tsMaterialList.h"
+#include "ts/tsAnimationBatch.h"
 #include "console/consoleTypes.h"
 #include "ts/tsDecal.h"
 #include "platform/profiler.h"
 #include "core/frameAllocator.h"
 #include "gfx/gfxDevice.h"
 #include "materials/materialManager.h"
+#include "renderInstance/retainedRenderInstList.h"
 #include "materials/materialFeatureTypes.h"
 #include "materials/sceneData.h"
 #include "materials/matInstance.h"
@@ -76,6 +78,52 @@ MODULE_BEGIN( TSShapeInstance )
          "@brief Enables mesh instancing on non-skin meshes that have less that this count of verts.\n"
          "The default value is 200.  Higher values can degrade performance.\n"
          "@ingroup Rendering\n" );
+
+      Con::addVariable("$pref::TS::parallelSkinning", TypeBool, &TSSkinMesh::smParallelSkinning,
+         "@brief Enables skinning the visible skinned meshes together on the thread pool.\n"
+         "The skinning is queued as the meshes are submitted and performed before the "
+         "render bins are drawn.  The default value is true.\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable("$pref::TS::minParallelSkinVerts", TypeS32, &TSSkinMesh::smMinParallelSkinVerts,
+         "@brief The minimum number of queued skinned vertices for which the skinning is spread "
+         "over the thread pool.\n"
+         "The default value is 2048.\n"
+         "@see $pref::TS::parallelSkinning\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable("$pref::TS::batchAnimation", TypeBool, &TSAnimationBatch::smEnabled,
+         "@brief Enables animating the nodes of visible shapes together, grouped by shape.\n"
+         "Shapes using node callbacks, masked nodes, transitions or animated scale are "
+         "animated individually.  The default value is true.\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable("$pref::TS::animLOD", TypeBool, &TSShapeInstance::smAnimLOD,
+         "@brief Enables animation LOD.\n"
+         "Shapes smaller on screen than $pref::TS::animLODPixelSize update their nodes less "
+         "often, only evaluate the nodes used by their current detail level and interpolate "
+         "between the updates.  The default value is true.\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable("$pref::TS::animLODPixelSize", TypeF32, &TSShapeInstance::smAnimLODPixelSize,
+         "@brief The pixel size below which shapes update their nodes less often.\n"
+         "The number of frames between updates grows as the shape gets smaller on screen. "
+         "The default value is 50.\n"
+         "@see $pref::TS::animLOD\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable("$pref::TS::animLODMaxInterval", TypeS32, &TSShapeInstance::smAnimLODMaxInterval,
+         "@brief The maximum number of frames between the node updates of distant shapes.\n"
+         "The default value is 4.\n"
+         "@see $pref::TS::animLOD\n"
+         "@ingroup Rendering\n" );
+
+      TSSkinMesh::initParallelSkinning();
+   }
+
+   MODULE_SHUTDOWN
+   {
+      TSSkinMesh::shutdownParallelSkinning();
    }
 
 MODULE_END;
@@ -85,6 +133,10 @@ F32                           TSShapeInstance::smDetailAdjust = 1.0f;
 F32                           TSShapeInstance::smSmallestVisiblePixelSize = -1.0f;
 S32                           TSShapeInstance::smNumSkipRenderDetails = 0;
 
+bool                          TSShapeInstance::smAnimLOD = true;
+F32                           TSShapeInstance::smAnimLODPixelSize = 50.0f;
+S32                           TSShapeInstance::smAnimLODMaxInterval = 4;
+
 F32                           TSShapeInstance::smLastScreenErrorTolerance = 0.0f;
 F32                           TSShapeInstance::smLastScaledDistance = 0.0f;
 F32                           TSShapeInstance::smLastPixelSize = 0.0f;
@@ -141,6 +193,9 @@ TSShapeInstance::TSShapeInstance( TSShape *shape, bool loadMaterials )
 
 TSShapeInstance::~TSShapeInstance()
 {
+   if ( mAnimationQueued )
+      TSAnimationBatch::dequeue( this );
+
    mMeshObjects.clear();
 
    while (mThreadList.size())
@@ -163,6 +218,14 @@ void TSShapeInstance::buildInstanceData(TSShape * _shape, bool loadMaterials)
    // all triggers off at start
    mTriggerStates = 0;
 
+   mAnimationQueued = false;
+
+   mAnimateRequiredNodesOnly = false;
+   mUseAnimNodeMask = false;
+   mAnimLODInterval = 1;
+   mAnimLODStep = 0;
+   mAnimLODPoseSubShape = -1;
+
    //
    mAlphaAlways = false;
    mAlphaAlwaysValue = 1.0f;
@@ -521,6 +584,10 @@ void TSShapeInstance::render( const TSRenderState &rdata, S32 dl, F32 intraDL )
    if ( ss < 0 )
    {
       PROFILE_SCOPE( TSShapeInstance_RenderBillboards );
+
+      // Imposters depend on the view direction.
+      if ( rdata.getRetainedList() )
+         rdata.getRetainedList()->cancelCapture();
       
       if ( !rdata.isNoRenderTranslucent() && ( TSLastDetail::smCanShadow || !rdata.getSceneState()->isShadowPass() ) )
          mShape->billboardDetails[ dl ]->render( rdata, mAlphaAlways ? mAlphaAlwaysValue : 1.0f );
@@ -546,6 +613,9 @@ void TSShapeInstance::setCurrentDetail( S32 dl, F32 intraDL )
    mCurrentDetailLevel = mClamp( dl, -1, mShape->mSmallestVisibleDL );
    mCurrentIntraDetailLevel = intraDL > 1.0f ? 1.0f : (intraDL < 0.0f ? 0.0f : intraDL);
 
+   // Detail levels set directly are always animated at full rate.
+   mAnimLODInterval = 1;
+
    // Restrict the chosen detail level by cutoff value.
    if ( smNumSkipRenderDetails > 0 && mCurrentDetailLevel >= 0 )
    {
@@ -580,6 +650,7 @@ S32 TSShapeInstance::setDetailFromDistance( const SceneRenderState *state, F32 s
    if ( scaledDistance <= 0.0f )
    {
       mShape->mDetailLevelLookup[0].get( mCurrentDetailLevel, mCurrentIntraDetailLevel );
+      mAnimLODInterval = 1;
       return mCurrentDetailLevel;
    }
 
@@ -608,6 +679,7 @@ S32 TSShapeInstance::setDetailFromDistance( const SceneRenderState *state, F32 s
       // The pixel size of 1 meter at the input distance.
       F32 pixelRadius = state->projectRadius( scaledDistance, 1.0f ) * pixelScale;
       static const F32 smScreenError = 5.0f;
+      mAnimLODInterval = 1;
       return setDetailFromScreenError( smScreenError / pixelRadius );
    }
 
@@ -623,6 +695,8 @@ S32 TSShapeInstance::setDetailFromDistance( const SceneRenderState *state, F32 s
    // For debugging/metrics.
    smLastPixelSize = pixelSize;
 
+   _updateAnimLODInterval( pixelSize );
+
    // Clamp it to an acceptable range for the lookup table.
    U32 index = (U32)mClampF( pixelSize, 0, mShape->mDetailLevelLookup.size() - 1 );
 
@@ -643,6 +717,43 @@ S32 TSShapeInstance::setDetailFromDistance( const SceneRenderState *state, F32 s
    return mCurrentDetailLevel;
 }
 
+void TSShapeInstance::_updateAnimLODInterval( F32 pixelSize )
+{
+   // Animated scale can't be decomposed into the stored poses and nodes
+   // which are driven by game code have to be updated every frame.
+   if (  !smAnimLOD ||
+         pixelSize >= smAnimLODPixelSize ||
+         mScaleCurrentlyAnimated ||
+         !mNodeCallbacks.empty() ||
+         mHandsOffNodes.start() < MAX_TS_SET_SIZE )
+   {
+      mAnimLODInterval = 1;
+      return;
+   }
+
+   // The interval grows with how much smaller than the threshold the shape is.
+   const S32 interval = (S32)( smAnimLODPixelSize / getMax( pixelSize, 1.0f ) ) + 1;
+   mAnimLODInterval = mClamp( interval, 1, getMax( smAnimLODMaxInterval, 1 ) );
+}
+
+void TSShapeInstance::setRequiredNodes( const TSIntegerSet &nodes )
+{
+   mRequiredNodes.clearAll();
+   for ( S32 i = nodes.start(); i < mShape->nodes.size(); nodes.next( i ) )
+      mShape->addNodeAndAncestors( i, mRequiredNodes );
+
+   // Make sure nodes which were skipped are updated.
+   mUseAnimNodeMask = false;
+   setDirty( TransformDirty );
+}
+
+void TSShapeInstance::setAnimateRequiredNodesOnly( bool requiredOnly )
+{
+   mAnimateRequiredNodesOnly = requiredOnly;
+   mUseAnimNodeMask = false;
+   setDirty( TransformDirty );
+}
+
 S32 TSShapeInstance::setDetailFromScreenError( F32 errorTolerance )
 {
    PROFILE_SCOPE( TSShapeInstance_setDetailFromScreenError );
@@ -102,6 +102,7 @@ class TSShapeInstance
    friend class TSThread;
    friend class TSLastDetail;
    friend class TSPartInstance;
+   friend class TSAnimationBatch;
 
    /// Base class for all renderable objects, including mesh objects and decal objects.
    ///
@@ -254,6 +255,57 @@ protected:
 
    S32 mCurrentDetailLevel;
 
+   /// @name Animation LOD
+   /// @{
+
+   /// Nodes which are always animated, including their ancestors.
+   TSIntegerSet mRequiredNodes;
+
+   /// @see setAnimateRequiredNodesOnly
+   bool mAnimateRequiredNodesOnly;
+
+   /// The nodes animateNodes evaluates when mUseAnimNodeMask is set.
+   TSIntegerSet mAnimNodeMask;
+   bool mUseAnimNodeMask;
+
+   /// Frames between node updates and frames since the last update.
+   U32 mAnimLODInterval;
+   U32 mAnimLODStep;
+
+   /// The subshape of the stored poses or -1 if there are none.
+   S32 mAnimLODPoseSubShape;
+
+   /// The node rotations and translations of the previous and the last
+   /// update, which the frames in between are interpolated from.
+   Vector<QuatF> mAnimLODRotations;
+   Vector<Point3F> mAnimLODTranslations;
+
+   /// Selects the update interval for the given pixel size.
+   void _updateAnimLODInterval( F32 pixelSize );
+
+   /// Selects the nodes to animate for detail level @a dl, or -1 when
+   /// all subshapes are animated, and marks the transforms dirty if
+   /// nodes which were skipped are needed now.
+   void _updateAnimNodeMask( S32 dl );
+
+   /// Returns true if the next node update of subshape @a ss is
+   /// interpolated from the stored poses instead of evaluated.
+   bool _isAnimLODInterpolating( S32 ss ) const
+   {
+      return   mAnimLODInterval > 1 &&
+               mAnimLODPoseSubShape == ss &&
+               mAnimLODStep + 1 < mAnimLODInterval;
+   }
+
+   /// Sets the node transforms to the next interpolation step.
+   void _interpolateAnimLODPose( S32 ss );
+
+   /// Stores the node transforms that were just evaluated as the newest
+   /// pose and restarts the interpolation from the previous one.
+   void _storeAnimLODPose( S32 ss );
+
+   /// @}
+
    /// 0-1, how far along from current to next (higher) detail level...
    ///
    /// 0=at this dl, 1=at higher detail level, where higher means bigger size on screen
@@ -310,6 +362,22 @@ protected:
    /// state variables
    U32 mTriggerStates;
 
+   /// @name Batched animation
+   /// State kept by TSAnimationBatch.
+   /// @{
+
+   /// Is this instance in the TSAnimationBatch queue?
+   bool mAnimationQueued;
+
+   /// The subshape, node count and thread sequences mBatchNodeSources was built for.
+   Vector<S32> mBatchSourceKey;
+
+   /// The thread and track animating the rotation and translation of each
+   /// node of the subshape packed as (thread << 16) | track, or -1 for nodes
+   /// which use the default transform.
+   Vector<S32> mBatchNodeSources;
+   /// @}
+
    bool initGround();
    void addPath(TSThread * gt, F32 start, F32 end, MatrixF * mat = NULL);
 
@@ -461,6 +529,23 @@ protected:
    /// only way to get a visible detail)
    static S32 smNumSkipRenderDetails;
 
+   /// @name Animation LOD
+   /// Shapes smaller on screen than #smAnimLODPixelSize update their nodes
+   /// less often, evaluate only the nodes their current detail level needs
+   /// and interpolate between the sparse updates.
+   /// @{
+
+   /// Enables animation LOD.
+   static bool smAnimLOD;
+
+   /// The pixel size below which node updates are throttled.
+   static F32 smAnimLODPixelSize;
+
+   /// The maximum number of frames between node updates.
+   static S32 smAnimLODMaxInterval;
+
+   /// @}
+
    /// For debugging / metrics.
    static F32 smLastScreenErrorTolerance;
    static F32 smLastScaledDistance;
@@ -537,6 +622,14 @@ protected:
 
    F32 getCurrentIntraDetail() const { return mCurrentIntraDetailLevel; }
 
+   /// Returns true if the current detail level is being alpha
+   /// blended with the next one.  See render().
+   bool isBlendingDetails() const
+   {
+      return   mCurrentDetailLevel >= 0 &&
+               mCurrentIntraDetailLevel <= mShape->alphaIn[mCurrentDetailLevel] + mShape->alphaOut[mCurrentDetailLevel];
+   }
+
    void setCurrentDetail( S32 dl, F32 intraDL = 1.0f );
 
    /// Helper function which internally calls setDetailFromDistance.
@@ -553,6 +646,28 @@ protected:
    /// Sets the current detail level using the legacy screen error metric.
    S32 setDetailFromScreenError( F32 errorTOL );
 
+   /// @name Animation LOD
+   /// @{
+
+   /// Sets the nodes which are animated regardless of the detail level,
+   /// such as mount points or nodes read by game code.  Their ancestors are
+   /// added to the set.
+   void setRequiredNodes( const TSIntegerSet &nodes );
+
+   /// Returns the required nodes and their ancestors.
+   const TSIntegerSet& getRequiredNodes() const { return mRequiredNodes; }
+
+   /// Restricts node animation to the required nodes, hands off nodes and
+   /// callback nodes.  This is meant for instances which are never
+   /// rendered, like the server side of networked objects.
+   void setAnimateRequiredNodesOnly( bool requiredOnly );
+
+   /// Returns the number of frames between node updates selected by the
+   /// last call to setDetailFromDistance.
+   U32 getAnimLODInterval() const { return mAnimLODInterval; }
+
+   /// @}
+
    enum
    {
       TransformDirty =  BIT(0),
@@ -659,7 +774,7 @@ protected:
 
    TSShapeInstance( const Resource<TSShape> & shape, bool loadMaterials = true);
    TSShapeInstance( TSShape * pShape, bool loadMaterials = true);
-   ~TSShapeInstance();
+   virtual ~TSShapeInstance();
 
    void buildInstanceData(TSShape *, bool loadMaterials);
    void initNodeTransforms();
@@ -695,6 +810,7 @@ protected:
 class TSThread
 {
    friend class TSShapeInstance;
+   friend class TSAnimationBatch;
 
    S32 priority;
 
@@ -190,6 +190,9 @@ void TSShape::fixupOldSkins(S32 numMeshes, S32 numSkins, S32 numDetails, S32 * d
 //-------------------------------------------------
 void TSShape::exportSequences(Stream * s)
 {
+   // sequences are exported as raw keyframes
+   UncompressAnimationScope uncompressed(this);
+
    // write version
    s->write(smVersion);
 
@@ -295,6 +298,9 @@ void TSShape::exportSequences(Stream * s)
 //-------------------------------------------------
 void TSShape::exportSequence(Stream * s, const TSShape::Sequence& seq, bool saveOldFormat)
 {
+   // sequences are exported as raw keyframes
+   UncompressAnimationScope uncompressed(this);
+
    S32 currentVersion = smVersion;
    if ( saveOldFormat )
       smVersion = 24;
@@ -429,6 +435,9 @@ void TSShape::exportSequence(Stream * s, const TSShape::Sequence& seq, bool save
 //-------------------------------------------------
 bool TSShape::importSequences(Stream * s, const String& sequencePath)
 {
+   // imported keyframes are appended to the raw arrays
+   uncompressAnimation();
+
    // write version
    s->read(&smReadVersion);
    if (smReadVersion>smVersion)
@@ -88,6 +88,12 @@ if($platform $= "xenon")
 /// to memory and not to disk.
 $shaderGen::cachePath = "shaders/procedural";
 
+/// If true the procedural shaders in the cache path are indexed
+/// and reused on the next run instead of being generated again.
+/// Call prewarmShaderCache() after loading your materials to fill
+/// the cache offline.
+$shaderGen::useCacheIndex = true;
+
 /// The perfered light manager to use at startup.  If blank
 /// or if the selected one doesn't work on this platfom it
 /// will try the defaults below.
@@ -211,6 +217,18 @@ $pref::Shadows::filterMode = "SoftShadow";
 ///
 $pref::Video::defaultAnisotropy = 1;
 
+/// If true new material instances render with a stand-in material
+/// until their shaders and textures are ready, so objects coming into
+/// view don't stall the frame.
+$pref::Materials::deferredInit = true;
+
+/// The milliseconds spent each frame finishing deferred materials.
+$pref::Materials::deferredInitBudget = 2;
+
+/// If true identical material instances share their shaders,
+/// constant buffers and pass data.
+$pref::Materials::shareProcessedMaterials = true;
+
 /// Radius in meters around the camera that ForestItems are affected by wind.
 /// Note that a very large number with a large number of items is not cheap.
 $pref::windEffectRadius = 25;
@@ -161,6 +161,10 @@ function onMissionDownloadComplete()
 {
    // Client will shortly be dropped into the game, so this is
    // good place for any last minute gui cleanup.
+
+   // Finish the materials deferred during the load so that
+   // the first frames don't render with stand-in materials.
+   flushDeferredMaterialInits();
 }
 
 
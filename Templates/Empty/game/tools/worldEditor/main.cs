@@ -103,6 +103,7 @@ function initializeWorldEditor()
    EVisibility.addOption( "Render: Zones", "$Zone::isRenderable", "" );
    EVisibility.addOption( "Render: Portals", "$Portal::isRenderable", "" );
    EVisibility.addOption( "Render: Occlusion Volumes", "$OcclusionVolume::isRenderable", "" );
+   EVisibility.addOption( "Render: Light Probe Volumes", "$LightProbeVolume::isRenderable", "" );
    EVisibility.addOption( "Render: Triggers", "$Trigger::renderTriggers", "" );
    EVisibility.addOption( "Render: PhysicalZones", "$PhysicalZone::renderZones", "" );
    EVisibility.addOption( "Render: Sound Emitters", "$SFXEmitter::renderEmitters", "" );
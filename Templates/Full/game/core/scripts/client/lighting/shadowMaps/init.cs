@@ -30,3 +30,15 @@ new ShaderData(BlurDepthShader)
    OGLPixelShaderFile = "shaders/common/lighting/shadowMap/gl/boxFilterP.glsl";
    pixVersion = 2.0;
 };
+
+/// Used to merge the cached static casters with the
+/// dynamic casters of a shadow map.
+new ShaderData(ShadowMapCompositeShader)
+{
+   DXVertexShaderFile = "shaders/common/lighting/shadowMap/shadowMapCompositeV.hlsl";
+   DXPixelShaderFile  = "shaders/common/lighting/shadowMap/shadowMapCompositeP.hlsl";
+   
+   OGLVertexShaderFile = "shaders/common/lighting/shadowMap/gl/shadowMapCompositeV.glsl";
+   OGLPixelShaderFile = "shaders/common/lighting/shadowMap/gl/shadowMapCompositeP.glsl";
+   pixVersion = 2.0;
+};
@@ -164,7 +164,9 @@ function shadowMetricsCallback()
           "  DrawCalls: " @ $ShadowStats::drawCalls @          
           "   RTChanges: " @ $ShadowStats::rtChanges @          
           "   PoolTexCount: " @ $ShadowStats::poolTexCount @
-          "   PoolTexMB: " @ $ShadowStats::poolTexMemory @ "MB";         
+          "   PoolTexMB: " @ $ShadowStats::poolTexMemory @ "MB" @
+          "   StaticUpdated: " @ $ShadowStats::staticLayerUpdates @
+          "   StaticReused: " @ $ShadowStats::staticLayersReused;         
 }
 
 function basicShadowMetricsCallback()
@@ -179,7 +181,9 @@ function lightMetricsCallback()
 {
    return "  | Deferred Lights |" @
           "  Active: " @ $lightMetrics::activeLights @
-          "  Culled: " @ $lightMetrics::culledLights;
+          "  Culled: " @ $lightMetrics::culledLights @
+          "  Zone Culled: " @ $lightMetrics::zoneCulledLights @
+          "  Max Per Tile: " @ $lightMetrics::maxTileLights;
 }
 
 function particleMetricsCallback()